@@ -0,0 +1,45 @@
+# SPDX-FileCopyrightText: 2023-2023 Istituto Italiano di Tecnologia (IIT)
+# SPDX-License-Identifier: BSD-3-Clause
+
+#########################################################################
+# create_unit_test(<name>
+#                  SOURCES <sources>...
+#                  [LIBRARIES <libraries>...]
+#                  [NETWORK])
+#
+# Creates the test unit::<name>, built from <sources> and the test harness.
+#
+# create_device_test() only loads the device as a plugin. These tests are
+# for the classes of a device that are tested directly, so the sources of
+# the class are listed in <sources>, and for the tests that need a ROS2 node
+# of their own to publish or receive the messages of a device.
+# With NETWORK the harness also initializes the YARP network, as required
+# to open the devices.
+
+function(create_unit_test _name)
+  cmake_parse_arguments(_CUT "NETWORK" "" "SOURCES;LIBRARIES" ${ARGN})
+
+  set(_target harness_unit_${_name})
+  add_executable(${_target})
+  target_sources(${_target} PRIVATE ${_CUT_SOURCES})
+
+  if(_CUT_NETWORK)
+    target_link_libraries(${_target} PRIVATE YARP::YARP_harness)
+  else()
+    target_link_libraries(${_target} PRIVATE YARP::YARP_harness_no_network)
+  endif()
+  target_link_libraries(${_target}
+    PRIVATE
+      YARP::YARP_os
+      ${_CUT_LIBRARIES}
+  )
+
+  add_test(NAME unit::${_name} COMMAND ${YARP_TEST_LAUNCHER} $<TARGET_FILE:${_target}>)
+  set_tests_properties(unit::${_name}
+    PROPERTIES
+      TIMEOUT ${YARP_TEST_TIMEOUT}
+      SKIP_RETURN_CODE 254
+  )
+
+  set_property(TARGET ${_target} PROPERTY FOLDER "Test")
+endfunction()
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+
+# SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""
+Reconstructs the per-frame latency breakdown from the traces written by the
+devices when the YARP_ROS2_TRACE environment variable is set (see Ros2Tracer.h).
+
+Pass all the trace files of a run, from every process involved:
+
+    ros2_trace_latency.py /tmp/trace.*.csv
+    ros2_trace_latency.py --frames --channel /camera/color/image_raw /tmp/trace.*.csv
+"""
+
+import argparse
+import csv
+import sys
+from collections import defaultdict
+
+STAGES = [
+    "capture",
+    "nws_read",
+    "nws_publish",
+    "rmw_sent",
+    "nwc_receive",
+    "nwc_converted",
+    "consumer_read",
+]
+
+
+def load(paths):
+    # frames[channel][key][stage] = earliest time of the stage, in ns
+    frames = defaultdict(lambda: defaultdict(dict))
+    for path in paths:
+        with open(path, newline="") as f:
+            for row in csv.DictReader(f):
+                stage = row["stage"]
+                if stage not in STAGES:
+                    continue
+                time = int(row["time_ns"])
+                stages = frames[row["channel"]][int(row["key_ns"])]
+                # A frame can be read several times by the consumer, only the first read counts
+                if stage not in stages or time < stages[stage]:
+                    stages[stage] = time
+    return frames
+
+
+def breakdown(stages):
+    """Returns the latency of every stage from the previous traced one, and the total, in ms."""
+    result = {}
+    previous = None
+    for stage in STAGES:
+        if stage not in stages:
+            continue
+        if previous is not None:
+            result[stage] = (stages[stage] - stages[previous]) / 1e6
+        previous = stage
+    present = [s for s in STAGES if s in stages]
+    if len(present) > 1:
+        result["total"] = (stages[present[-1]] - stages[present[0]]) / 1e6
+    return result
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[int(p * (len(values) - 1) + 0.5)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("traces", nargs="+", help="trace files written by the devices")
+    parser.add_argument("--channel", help="only report this channel (topic)")
+    parser.add_argument("--frames", action="store_true", help="print the breakdown of every frame as csv")
+    args = parser.parse_args()
+
+    frames = load(args.traces)
+    if args.channel:
+        frames = {args.channel: frames.get(args.channel, {})}
+
+    columns = STAGES[1:] + ["total"]
+
+    if args.frames:
+        writer = csv.writer(sys.stdout)
+        writer.writerow(["channel", "key_ns"] + columns)
+        for channel, keys in sorted(frames.items()):
+            for key, stages in sorted(keys.items()):
+                b = breakdown(stages)
+                writer.writerow([channel, key] + ["%.3f" % b[c] if c in b else "" for c in columns])
+        return 0
+
+    for channel, keys in sorted(frames.items()):
+        samples = defaultdict(list)
+        complete = 0
+        for stages in keys.values():
+            for column, value in breakdown(stages).items():
+                samples[column].append(value)
+            if all(s in stages for s in STAGES):
+                complete += 1
+
+        print("%s: %d frames, %d traced through every stage" % (channel, len(keys), complete))
+        print("  %-14s %8s %10s %10s %10s %10s %10s" % ("stage [ms]", "frames", "min", "p50", "p90", "p99", "max"))
+        for column in columns:
+            values = samples.get(column)
+            if not values:
+                continue
+            print("  %-14s %8d %10.3f %10.3f %10.3f %10.3f %10.3f" % (
+                column,
+                len(values),
+                min(values),
+                percentile(values, 0.50),
+                percentile(values, 0.90),
+                percentile(values, 0.99),
+                max(values)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
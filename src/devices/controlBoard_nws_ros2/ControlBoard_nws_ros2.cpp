@@ -14,9 +14,13 @@
 #include <memory>
 #include <string>
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <numeric>
 
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
 #include <Ros2Utils.h>
 #include <rcutils/logging_macros.h>
 
@@ -52,19 +56,29 @@ void ControlBoard_nws_ros2::closePorts()
 
 bool ControlBoard_nws_ros2::close()
 {
-    if(m_spinner){
-        if(m_spinner->isRunning()){
-            m_spinner->stop();
-        }
+    if(m_parameters){
+        m_parameters->stop();
     }
     // Ensure that the device is not running
+    if (m_clockDriver) {
+        m_clockDriver->stop();
+    }
     if (isRunning()) {
         stop();
     }
 
+    // No command may reach the device while it is being closed
+    stopRos2Control();
+    m_streamSpinner.reset();
+    m_serviceSpinner.reset();
+
     closeDevice();
     closePorts();
 
+    if (m_recorder) {
+        m_recorder->close();
+    }
+
     return true;
 }
 
@@ -112,17 +126,287 @@ bool ControlBoard_nws_ros2::open(Searchable& config)
     }
     yCInfo(CONTROLBOARD_ROS2) << "topic_name is " << m_jointStateTopicName;
 
+    // The default group publishes every joint not claimed by the other groups
+    m_jointGroups.clear();
+    m_jointGroups.emplace_back();
+    m_jointGroups[0].name = "default";
+    m_jointGroups[0].topicName = m_jointStateTopicName;
+    m_jointGroups[0].period = m_period;
+    if (!parseJointGroup(config, m_jointGroups[0])) {
+        return false;
+    }
+
+    m_deadbandConfig.clear();
+    if (config.check("deadband")) {
+        const Value& deadband = config.find("deadband");
+        if (deadband.isList()) {
+            for (size_t i = 0; i < deadband.asList()->size(); i++) {
+                m_deadbandConfig.push_back(deadband.asList()->get(i).asFloat64());
+            }
+        } else {
+            m_deadbandConfig.push_back(deadband.asFloat64());
+        }
+        for (const auto& value : m_deadbandConfig) {
+            if (value < 0) {
+                yCError(CONTROLBOARD_ROS2) << "'deadband' values cannot be negative";
+                return false;
+            }
+        }
+        m_keyframePeriod = config.check("keyframe_period", Value(m_default_keyframe_period)).asFloat64();
+        if (m_keyframePeriod <= 0) {
+            yCError(CONTROLBOARD_ROS2) << "'keyframe_period' parameter is not valid, read value is" << m_keyframePeriod;
+            return false;
+        }
+    }
+
+    if (config.check("joint_groups")) {
+        Bottle* groupNames = config.find("joint_groups").asList();
+        if (!groupNames) {
+            yCError(CONTROLBOARD_ROS2) << "'joint_groups' parameter must be a list of group names";
+            return false;
+        }
+        for (size_t i = 0; i < groupNames->size(); i++) {
+            JointGroup group;
+            group.name = groupNames->get(i).asString();
+            Bottle& groupConfig = config.findGroup(group.name);
+            if (groupConfig.isNull()) {
+                yCError(CONTROLBOARD_ROS2) << "Missing configuration group for joint group" << group.name;
+                return false;
+            }
+            if (!groupConfig.check("topic_name")) {
+                yCError(CONTROLBOARD_ROS2) << "Joint group" << group.name << "has no topic_name";
+                return false;
+            }
+            group.topicName = groupConfig.find("topic_name").asString();
+            Bottle* joints = groupConfig.find("joints").asList();
+            if (!joints || joints->size() == 0) {
+                yCError(CONTROLBOARD_ROS2) << "Joint group" << group.name << "needs a non empty 'joints' list";
+                return false;
+            }
+            for (size_t j = 0; j < joints->size(); j++) {
+                group.jointNames.push_back(joints->get(j).asString());
+            }
+            group.period = m_period;
+            if (!parseJointGroup(groupConfig, group)) {
+                return false;
+            }
+            m_jointGroups.push_back(std::move(group));
+        }
+    }
+
+    updateJointGroupsDecimation();
+
+    Ros2BagRecorder::Options recorderOptions;
+    if (!Ros2BagRecorder::parseOptions(config, recorderOptions)) {
+        return false;
+    }
+    if (!recorderOptions.uri.empty()) {
+        m_recorder = std::make_unique<Ros2BagRecorder>();
+        if (!m_recorder->open(recorderOptions)) {
+            return false;
+        }
+    }
+
     m_node = NodeCreator::createNode(m_nodeName);
-    m_publisher = m_node->create_publisher<sensor_msgs::msg::JointState>(m_jointStateTopicName, 10);
+    if (!createJointGroupsPublishers()) {
+        return false;
+    }
+    m_clockDriver = std::make_unique<Ros2ClockDriver>(m_node, [this]() { run(); });
+    if (!m_clockDriver->configure(config)) {
+        return false;
+    }
+    if (!initParameters()) {
+        return false;
+    }
 
     if (config.check("msgs_name")) {
         m_msgs_name = config.find("msgs_name").asString();
+        if (m_msgs_name[0] != '/') {
+            m_msgs_name = "/"+m_msgs_name;
+        }
+        initRos2ControlSpinners();
     }
 
     return true;
 }
 
 
+void ControlBoard_nws_ros2::updateJointGroupsDecimation()
+{
+    // The thread runs at the rate of the fastest group, the others are decimated
+    m_threadPeriod = m_jointGroups[0].period;
+    for (const auto& group : m_jointGroups) {
+        m_threadPeriod = std::min(m_threadPeriod, group.period);
+    }
+    for (auto& group : m_jointGroups) {
+        group.decimation = std::max<size_t>(1, static_cast<size_t>(std::lround(group.period / m_threadPeriod)));
+        group.counter = 0;
+        if (std::fabs(group.decimation * m_threadPeriod - group.period) > 1e-6) {
+            yCWarning(CONTROLBOARD_ROS2) << "Period of joint group" << group.name << "is not a multiple of" << m_threadPeriod
+                                         << ", it will be published every" << group.decimation * m_threadPeriod << "s";
+        }
+    }
+}
+
+
+bool ControlBoard_nws_ros2::initParameters()
+{
+    m_parameters = std::make_unique<Ros2Parameters>(m_node);
+
+    for (size_t g = 0; g < m_jointGroups.size(); g++) {
+        std::string name = (g == 0) ? "period" : m_jointGroups[g].name + ".period";
+        bool ok = m_parameters->addDouble(name, m_jointGroups[g].period, [this, g](double period) {
+            if (period <= 0) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(m_groupsMutex);
+            m_jointGroups[g].period = period;
+            if (g == 0) {
+                m_period = period;
+            }
+            updateJointGroupsDecimation();
+            m_clockDriver->setPeriod(m_threadPeriod);
+            setPeriod(m_threadPeriod);
+            return true;
+        });
+        if (!ok) {
+            return false;
+        }
+    }
+
+    if (!m_deadbandConfig.empty()) {
+        bool ok = m_parameters->addDouble("keyframe_period", m_keyframePeriod, [this](double period) {
+            if (period <= 0) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(m_groupsMutex);
+            m_keyframePeriod = period;
+            return true;
+        });
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return m_parameters->start();
+}
+
+
+bool ControlBoard_nws_ros2::parseJointGroup(yarp::os::Searchable& config, JointGroup& group)
+{
+    if (group.topicName.empty() || group.topicName[0] != '/') {
+        yCError(CONTROLBOARD_ROS2) << "topic_name of joint group" << group.name << "must begin with an initial /";
+        return false;
+    }
+    if (config.check("period")) {
+        group.period = config.find("period").asFloat64();
+        if (group.period <= 0) {
+            yCError(CONTROLBOARD_ROS2) << "'period' of joint group" << group.name << "is not valid, read value is" << group.period;
+            return false;
+        }
+    }
+    if (config.check("qos_depth")) {
+        int depth = config.find("qos_depth").asInt32();
+        if (depth <= 0) {
+            yCError(CONTROLBOARD_ROS2) << "'qos_depth' of joint group" << group.name << "must be positive";
+            return false;
+        }
+        group.qosDepth = static_cast<size_t>(depth);
+    }
+    if (config.check("qos_reliability")) {
+        std::string reliability = config.find("qos_reliability").asString();
+        if (reliability == "best_effort") {
+            group.bestEffort = true;
+        } else if (reliability == "reliable") {
+            group.bestEffort = false;
+        } else {
+            yCError(CONTROLBOARD_ROS2) << "'qos_reliability' of joint group" << group.name << "must be reliable or best_effort, not" << reliability;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool ControlBoard_nws_ros2::createJointGroupsPublishers()
+{
+    for (auto& group : m_jointGroups) {
+        rclcpp::QoS qos(group.qosDepth);
+        if (group.bestEffort) {
+            qos.best_effort();
+        } else {
+            qos.reliable();
+        }
+        group.publisher = m_node->create_publisher<sensor_msgs::msg::JointState>(group.topicName, qos);
+        if (!group.publisher) {
+            yCError(CONTROLBOARD_ROS2) << "Could not create the publisher of joint group" << group.name;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool ControlBoard_nws_ros2::resolveJointGroups()
+{
+    std::vector<bool> assigned(m_subdevice_joints, false);
+
+    for (size_t g = 1; g < m_jointGroups.size(); g++) {
+        auto& group = m_jointGroups[g];
+        group.indices.clear();
+        for (const auto& jointName : group.jointNames) {
+            auto it = std::find(m_jointNames.begin(), m_jointNames.end(), jointName);
+            if (it == m_jointNames.end()) {
+                yCError(CONTROLBOARD_ROS2) << "Joint" << jointName << "of group" << group.name << "is not a joint of the attached device";
+                return false;
+            }
+            size_t index = static_cast<size_t>(std::distance(m_jointNames.begin(), it));
+            if (assigned[index]) {
+                yCError(CONTROLBOARD_ROS2) << "Joint" << jointName << "belongs to more than one joint group";
+                return false;
+            }
+            assigned[index] = true;
+            group.indices.push_back(index);
+        }
+    }
+
+    m_jointGroups[0].indices.clear();
+    for (size_t i = 0; i < m_subdevice_joints; i++) {
+        if (!assigned[i]) {
+            m_jointGroups[0].indices.push_back(i);
+        }
+    }
+
+    // Preallocate the messages, so that publishing never reallocates
+    for (auto& group : m_jointGroups) {
+        const size_t size = group.indices.size();
+        group.msg.name.resize(size);
+        group.msg.position.resize(size);
+        group.msg.velocity.resize(size);
+        group.msg.effort.resize(size);
+        for (size_t i = 0; i < size; i++) {
+            group.msg.name[i] = m_jointNames[group.indices[i]];
+        }
+        group.counter = 0;
+        group.lastPublishTime = -std::numeric_limits<double>::infinity();
+    }
+
+    return true;
+}
+
+
+void ControlBoard_nws_ros2::initRos2ControlSpinners()
+{
+    // The topics and services are created at every attach, in these groups
+    m_streamCallbackGroup = m_node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+    m_serviceCallbackGroup = m_node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+    m_streamSpinner = std::make_unique<Ros2Spinner>(m_node, m_streamCallbackGroup);
+    m_serviceSpinner = std::make_unique<Ros2Spinner>(m_node, m_serviceCallbackGroup);
+}
+
+
 bool ControlBoard_nws_ros2::initRos2Control(const std::string& name){
 
     m_posTopicName = name+"/position";
@@ -133,12 +417,22 @@ bool ControlBoard_nws_ros2::initRos2Control(const std::string& name){
     m_getAvailableModesSrvName = name+"/get_available_modes";
     m_getJointsNamesSrvName = name+"/get_joints_names";
 
+    // The names are cached once, callbacks only read them
+    m_quickJointRef.clear();
+    for(size_t i=0; i<m_subdevice_joints; i++){
+        m_quickJointRef[m_jointNames[i]] = i;
+    }
+
     // Creating topics ------------------------------------------------------------------------------------------------- //
 
+    rclcpp::SubscriptionOptions streamOptions;
+    streamOptions.callback_group = m_streamCallbackGroup;
+
     if(m_iPositionControl){
         m_posSubscription = m_node->create_subscription<yarp_control_msgs::msg::Position>(m_posTopicName, 10,
                                                                                         std::bind(&ControlBoard_nws_ros2::positionTopic_callback,
-                                                                                        this, std::placeholders::_1));
+                                                                                        this, std::placeholders::_1),
+                                                                                        streamOptions);
         if(!m_posSubscription){
             yCError(CONTROLBOARD_ROS2) << "Could not initialize the Position msg subscription";
             RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the Position msg subscription");
@@ -149,7 +443,8 @@ bool ControlBoard_nws_ros2::initRos2Control(const std::string& name){
     if(m_iPositionDirect){
         m_posDirectSubscription = m_node->create_subscription<yarp_control_msgs::msg::PositionDirect>(m_posDirTopicName, 10,
                                                                                                     std::bind(&ControlBoard_nws_ros2::positionDirectTopic_callback,
-                                                                                                                this, std::placeholders::_1));
+                                                                                                                this, std::placeholders::_1),
+                                                                                                    streamOptions);
         if(!m_posDirectSubscription){
             yCError(CONTROLBOARD_ROS2) << "Could not initialize the Position direct msg subscription";
             RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the Position direct msg subscription");
@@ -160,7 +455,8 @@ bool ControlBoard_nws_ros2::initRos2Control(const std::string& name){
     if(m_iVelocityControl){
         m_velSubscription = m_node->create_subscription<yarp_control_msgs::msg::Velocity>(m_velTopicName, 10,
                                                                                         std::bind(&ControlBoard_nws_ros2::velocityTopic_callback,
-                                                                                        this, std::placeholders::_1));
+                                                                                        this, std::placeholders::_1),
+                                                                                        streamOptions);
         if(!m_velSubscription){
             yCError(CONTROLBOARD_ROS2) << "Could not initialize the Velocity msg subscription";
             RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the Velocity msg subscription");
@@ -171,27 +467,41 @@ bool ControlBoard_nws_ros2::initRos2Control(const std::string& name){
 
     // Creating services ----------------------------------------------------------------------------------------------- //
 
+    m_getJointsNamesSrv = m_node->create_service<yarp_control_msgs::srv::GetJointsNames>(m_getJointsNamesSrvName,
+                                                                                         std::bind(&ControlBoard_nws_ros2::getJointsNamesCallback,
+                                                                                                   this,std::placeholders::_1,std::placeholders::_2,
+                                                                                                   std::placeholders::_3),
+                                                                                         rmw_qos_profile_services_default,
+                                                                                         m_serviceCallbackGroup);
+    if(!m_getJointsNamesSrv){
+        yCError(CONTROLBOARD_ROS2) << "Could not initialize the GetJointsNames service";
+        RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the GetJointsNames service");
+
+        return false;
+    }
+    m_getAvailableModesSrv = m_node->create_service<yarp_control_msgs::srv::GetAvailableControlModes>(m_getAvailableModesSrvName,
+                                                                                                      std::bind(&ControlBoard_nws_ros2::getAvailableModesCallback,
+                                                                                                                this,std::placeholders::_1,std::placeholders::_2,
+                                                                                                                std::placeholders::_3),
+                                                                                                      rmw_qos_profile_services_default,
+                                                                                                      m_serviceCallbackGroup);
+    if(!m_getAvailableModesSrv){
+        yCError(CONTROLBOARD_ROS2) << "Could not initialize the GetAvailableModes service";
+        RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the GetAvailableModes service");
+
+        return false;
+    }
+
     if(!m_iControlMode){
         return true;
     }
 
-    rmw_qos_profile_t qos;
-    qos.history = RMW_QOS_POLICY_HISTORY_SYSTEM_DEFAULT;
-    qos.depth=10;
-    rmw_time_t time;
-    time.sec=10000;
-    time.nsec = 0;
-    qos.deadline= time;
-    qos.lifespan=time;
-    qos.liveliness_lease_duration=time;
-    qos.reliability = RMW_QOS_POLICY_RELIABILITY_SYSTEM_DEFAULT;
-    qos.durability = RMW_QOS_POLICY_DURABILITY_SYSTEM_DEFAULT;
-    qos.liveliness = RMW_QOS_POLICY_LIVELINESS_SYSTEM_DEFAULT;
-    qos.avoid_ros_namespace_conventions = true;
     m_getControlModesSrv = m_node->create_service<yarp_control_msgs::srv::GetControlModes>(m_getModesSrvName,
                                                                                            std::bind(&ControlBoard_nws_ros2::getControlModesCallback,
                                                                                                      this,std::placeholders::_1,std::placeholders::_2,
-                                                                                                     std::placeholders::_3));
+                                                                                                     std::placeholders::_3),
+                                                                                           rmw_qos_profile_services_default,
+                                                                                           m_serviceCallbackGroup);
     if(!m_getControlModesSrv){
         yCError(CONTROLBOARD_ROS2) << "Could not initialize the GetControlModes service";
         RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the GetControlModes service");
@@ -201,51 +511,15 @@ bool ControlBoard_nws_ros2::initRos2Control(const std::string& name){
     m_setControlModesSrv = m_node->create_service<yarp_control_msgs::srv::SetControlModes>(m_setModesSrvName,
                                                                                            std::bind(&ControlBoard_nws_ros2::setControlModesCallback,
                                                                                                      this,std::placeholders::_1,std::placeholders::_2,
-                                                                                                     std::placeholders::_3));
+                                                                                                     std::placeholders::_3),
+                                                                                           rmw_qos_profile_services_default,
+                                                                                           m_serviceCallbackGroup);
     if(!m_setControlModesSrv){
         yCError(CONTROLBOARD_ROS2) << "Could not initialize the SetControlModes service";
         RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the SetControlModes service");
 
         return false;
     }
-    m_getAvailableModesSrv = m_node->create_service<yarp_control_msgs::srv::GetAvailableControlModes>(m_getAvailableModesSrvName,
-                                                                                                      std::bind(&ControlBoard_nws_ros2::getAvailableModesCallback,
-                                                                                                                this,std::placeholders::_1,std::placeholders::_2,
-                                                                                                                std::placeholders::_3));
-    if(!m_getAvailableModesSrv){
-        yCError(CONTROLBOARD_ROS2) << "Could not initialize the GetAvailableModes service";
-        RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the GetAvailableModes service");
-
-        return false;
-    }
-    m_getJointsNamesSrv = m_node->create_service<yarp_control_msgs::srv::GetJointsNames>(m_getJointsNamesSrvName,
-                                                                                         std::bind(&ControlBoard_nws_ros2::getJointsNamesCallback,
-                                                                                                   this,std::placeholders::_1,std::placeholders::_2,
-                                                                                                   std::placeholders::_3));
-    if(!m_getJointsNamesSrv){
-        yCError(CONTROLBOARD_ROS2) << "Could not initialize the GetJointsNames service";
-        RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the GetJointsNames service");
-
-        return false;
-    }
-
-    m_spinner = new Ros2Spinner(m_node);
-    if (!m_spinner){
-        yCError(CONTROLBOARD_ROS2) << "Could not initialize the GetJointsNames service";
-        RCLCPP_ERROR(m_node->get_logger(),"Could not initialize the GetJointsNames service");
-
-        return false;
-    }
-
-    std::string tmpName;
-    for(size_t i=0; i<m_subdevice_joints; i++){
-        if(!m_iAxisInfo->getAxisName(i,tmpName)){
-            yCError(CONTROLBOARD_ROS2) << "Error retrieving axis" << i << "name. For this device to work, every joint needs a name";
-
-            return false;
-        }
-        m_quickJointRef[tmpName] = i;
-    }
 
     return true;
 }
@@ -316,19 +590,56 @@ bool ControlBoard_nws_ros2::setDevice(yarp::dev::DeviceDriver* driver)
         return false;
     }
 
+    // The joint types do not change at runtime, no need to query them at every cycle
+    m_isRevolute.assign(m_subdevice_joints, false);
+    for (size_t i = 0; i < m_subdevice_joints; i++) {
+        JointTypeEnum jType;
+        if (m_iAxisInfo->getJointType(i, jType)) {
+            m_isRevolute[i] = (jType == VOCAB_JOINTTYPE_REVOLUTE);
+        }
+    }
+
+    if (m_deadbandConfig.size() > 1 && m_deadbandConfig.size() != m_subdevice_joints) {
+        yCError(CONTROLBOARD_ROS2) << "'deadband' has" << m_deadbandConfig.size() << "values, but the attached device has" << m_subdevice_joints << "joints";
+        return false;
+    }
+    if (m_deadbandConfig.size() == 1) {
+        m_deadband.assign(m_subdevice_joints, m_deadbandConfig[0]);
+    } else {
+        m_deadband = m_deadbandConfig;
+    }
+
+    if (!resolveJointGroups()) {
+        return false;
+    }
+
     return true;
 }
 
 
 void ControlBoard_nws_ros2::closeDevice()
 {
+    for (auto* reader : m_partReaders) {
+        reader->stop();
+        delete reader;
+    }
+    m_partReaders.clear();
+    m_parts.clear();
+    if (m_remapper.isValid()) {
+        m_remapper.close();
+    }
+
     m_subdevice_ptr = nullptr;
     m_subdevice_joints = 0;
 
     m_times.clear();
+    m_isRevolute.clear();
 
     // Clear all interfaces
     m_iPositionControl = nullptr;
+    m_iPositionDirect = nullptr;
+    m_iVelocityControl = nullptr;
+    m_iControlMode = nullptr;
     m_iEncodersTimed = nullptr;
     m_iTorqueControl = nullptr;
     m_iAxisInfo = nullptr;
@@ -340,17 +651,103 @@ bool ControlBoard_nws_ros2::attach(yarp::dev::PolyDriver* poly)
         return false;
     }
 
-    setPeriod(m_period);
-    if (!start()) {
+    return startStreaming();
+}
+
+bool ControlBoard_nws_ros2::attachAll(const yarp::dev::PolyDriverList& p)
+{
+    if (p.size() == 0) {
+        yCError(CONTROLBOARD_ROS2) << "attachAll() called with an empty list of devices";
+        return false;
+    }
+    if (p.size() == 1) {
+        return attach(p[0]->poly);
+    }
+
+    // Collect the parts and the names of their joints, in order of attachment
+    Bottle axesNames;
+    Bottle& names = axesNames.addList();
+    size_t offset = 0;
+    m_parts.clear();
+    for (int k = 0; k < p.size(); k++) {
+        Part part;
+        part.key = p[k]->key;
+        yarp::dev::IAxisInfo* iAxisInfo = nullptr;
+        if (!p[k]->poly || !p[k]->poly->view(part.iEncodersTimed) || !p[k]->poly->view(iAxisInfo)) {
+            yCError(CONTROLBOARD_ROS2) << "Part" << part.key << "does not provide IEncodersTimed and IAxisInfo";
+            m_parts.clear();
+            return false;
+        }
+        p[k]->poly->view(part.iTorqueControl);
+
+        int axes = 0;
+        if (!part.iEncodersTimed->getAxes(&axes) || axes <= 0) {
+            yCError(CONTROLBOARD_ROS2) << "Part" << part.key << "has an invalid number of joints";
+            m_parts.clear();
+            return false;
+        }
+        for (int j = 0; j < axes; j++) {
+            std::string axisName;
+            if (!iAxisInfo->getAxisName(j, axisName)) {
+                yCError(CONTROLBOARD_ROS2) << "Joint name for axis" << j << "of part" << part.key << "not found!";
+                m_parts.clear();
+                return false;
+            }
+            names.addString(axisName);
+        }
+        part.offset = offset;
+        part.joints = static_cast<size_t>(axes);
+        offset += part.joints;
+        m_parts.push_back(part);
+    }
+
+    // Commands and services go through a remapper, that knows how to route each joint to its part
+    Property remapperConfig;
+    remapperConfig.put("device", "controlBoardRemapper");
+    remapperConfig.put("axesNames", axesNames.get(0));
+    yarp::dev::IMultipleWrapper* remapperWrapper = nullptr;
+    if (!m_remapper.open(remapperConfig) || !m_remapper.view(remapperWrapper) || !remapperWrapper->attachAll(p)) {
+        yCError(CONTROLBOARD_ROS2) << "Unable to merge the parts through a controlBoardRemapper";
+        closeDevice();
+        return false;
+    }
+
+    if (!setDevice(&m_remapper) || m_subdevice_joints != offset) {
+        closeDevice();
+        return false;
+    }
+
+    // The first part is read by the publishing thread itself, the others by their own thread
+    for (size_t k = 1; k < m_parts.size(); k++) {
+        auto* reader = new PartReader(*this, m_parts[k]);
+        if (!reader->start()) {
+            yCError(CONTROLBOARD_ROS2) << "Unable to start the reader of part" << m_parts[k].key;
+            delete reader;
+            closeDevice();
+            return false;
+        }
+        m_partReaders.push_back(reader);
+    }
+
+    return startStreaming();
+}
+
+bool ControlBoard_nws_ros2::detachAll()
+{
+    return detach();
+}
+
+bool ControlBoard_nws_ros2::startStreaming()
+{
+    setPeriod(m_threadPeriod);
+    m_clockDriver->setPeriod(m_threadPeriod);
+    if (m_clockDriver->enabled() ? !m_clockDriver->start() : !start()) {
         yCError(CONTROLBOARD_ROS2) << "Error starting thread";
         return false;
     }
 
     if(!m_msgs_name.empty())
     {
-        if (m_msgs_name[0] != '/') {
-            m_msgs_name = "/"+m_msgs_name;
-        }
         if(!initRos2Control(m_msgs_name)){
             yCError(CONTROLBOARD_ROS2) << "Error initializing the ROS2 control related topics and services";
             RCLCPP_ERROR(m_node->get_logger(),"Error initializing the ROS2 control related topics and services");
@@ -358,9 +755,14 @@ bool ControlBoard_nws_ros2::attach(yarp::dev::PolyDriver* poly)
         }
     }
 
-    if(m_spinner){
-        if(!m_spinner->start()){
-            yCError(CONTROLBOARD_ROS2) << "Error starting the spinner";
+    if(m_streamSpinner){
+        if(!m_streamSpinner->start()){
+            yCError(CONTROLBOARD_ROS2) << "Error starting the streaming commands spinner";
+        }
+    }
+    if(m_serviceSpinner){
+        if(!m_serviceSpinner->start()){
+            yCError(CONTROLBOARD_ROS2) << "Error starting the services spinner";
         }
     }
 
@@ -370,15 +772,39 @@ bool ControlBoard_nws_ros2::attach(yarp::dev::PolyDriver* poly)
 bool ControlBoard_nws_ros2::detach()
 {
     // Ensure that the device is not running
+    if (m_clockDriver) {
+        m_clockDriver->stop();
+    }
     if (isRunning()) {
         stop();
     }
 
+    // No command may reach the device after it is detached
+    stopRos2Control();
+
     closeDevice();
 
     return true;
 }
 
+void ControlBoard_nws_ros2::stopRos2Control()
+{
+    // Stopping joins the spinners, so no callback is running after this
+    if (m_streamSpinner && m_streamSpinner->isRunning()) {
+        m_streamSpinner->stop();
+    }
+    if (m_serviceSpinner && m_serviceSpinner->isRunning()) {
+        m_serviceSpinner->stop();
+    }
+    m_posSubscription.reset();
+    m_posDirectSubscription.reset();
+    m_velSubscription.reset();
+    m_getJointsNamesSrv.reset();
+    m_getAvailableModesSrv.reset();
+    m_getControlModesSrv.reset();
+    m_setControlModesSrv.reset();
+}
+
 bool ControlBoard_nws_ros2::updateAxisName()
 {
     // IMPORTANT!! This function has to be called BEFORE the thread starts,
@@ -404,47 +830,142 @@ bool ControlBoard_nws_ros2::updateAxisName()
     return true;
 }
 
-void ControlBoard_nws_ros2::run()
+ControlBoard_nws_ros2::PartReader::PartReader(ControlBoard_nws_ros2& owner, const Part& part) :
+        m_owner(owner),
+        m_part(part)
 {
-    yCAssert(CONTROLBOARD_ROS2, m_iEncodersTimed);
-    yCAssert(CONTROLBOARD_ROS2, m_iAxisInfo);
+}
 
-    bool positionsOk = m_iEncodersTimed->getEncodersTimed(m_ros_struct.position.data(), m_times.data());
+void ControlBoard_nws_ros2::PartReader::trigger()
+{
+    m_go.post();
+}
+
+void ControlBoard_nws_ros2::PartReader::waitDone()
+{
+    m_done.wait();
+}
+
+void ControlBoard_nws_ros2::PartReader::run()
+{
+    while (true) {
+        m_go.wait();
+        if (isStopping()) {
+            break;
+        }
+        m_owner.readPart(m_part);
+        m_done.post();
+    }
+}
+
+void ControlBoard_nws_ros2::PartReader::onStop()
+{
+    m_go.post();
+}
+
+void ControlBoard_nws_ros2::readPart(const Part& part)
+{
+    // Each part writes only its own slice of the full state
+    bool positionsOk = part.iEncodersTimed->getEncodersTimed(m_ros_struct.position.data() + part.offset, m_times.data() + part.offset);
     YARP_UNUSED(positionsOk);
 
-    bool speedsOk = m_iEncodersTimed->getEncoderSpeeds(m_ros_struct.velocity.data());
+    bool speedsOk = part.iEncodersTimed->getEncoderSpeeds(m_ros_struct.velocity.data() + part.offset);
     YARP_UNUSED(speedsOk);
 
-    if (m_iTorqueControl) {
-        bool torqueOk = m_iTorqueControl->getTorques(m_ros_struct.effort.data());
+    if (part.iTorqueControl) {
+        bool torqueOk = part.iTorqueControl->getTorques(m_ros_struct.effort.data() + part.offset);
         YARP_UNUSED(torqueOk);
     }
+}
+
+void ControlBoard_nws_ros2::publishJointGroup(JointGroup& group)
+{
+    const size_t size = group.indices.size();
+    for (size_t i = 0; i < size; i++) {
+        const size_t index = group.indices[i];
+        group.msg.position[i] = m_ros_struct.position[index];
+        group.msg.velocity[i] = m_ros_struct.velocity[index];
+        group.msg.effort[i] = m_ros_struct.effort[index];
+    }
+    group.msg.header.stamp = m_ros_struct.header.stamp;
+
+    if (m_recorder) {
+        m_recorder->publish(group.publisher, group.msg);
+    } else {
+        group.publisher->publish(group.msg);
+    }
+}
+
+bool ControlBoard_nws_ros2::jointGroupMoved(const JointGroup& group) const
+{
+    // group.msg still holds the positions of the last published message
+    const size_t size = group.indices.size();
+    for (size_t i = 0; i < size; i++) {
+        const size_t index = group.indices[i];
+        if (std::fabs(m_ros_struct.position[index] - group.msg.position[i]) > m_deadband[index]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ControlBoard_nws_ros2::run()
+{
+    yCAssert(CONTROLBOARD_ROS2, m_iEncodersTimed);
+    yCAssert(CONTROLBOARD_ROS2, m_iAxisInfo);
+
+    if (m_parts.empty()) {
+        bool positionsOk = m_iEncodersTimed->getEncodersTimed(m_ros_struct.position.data(), m_times.data());
+        YARP_UNUSED(positionsOk);
+
+        bool speedsOk = m_iEncodersTimed->getEncoderSpeeds(m_ros_struct.velocity.data());
+        YARP_UNUSED(speedsOk);
+
+        if (m_iTorqueControl) {
+            bool torqueOk = m_iTorqueControl->getTorques(m_ros_struct.effort.data());
+            YARP_UNUSED(torqueOk);
+        }
+    } else {
+        for (auto* reader : m_partReaders) {
+            reader->trigger();
+        }
+        readPart(m_parts[0]);
+        for (auto* reader : m_partReaders) {
+            reader->waitDone();
+        }
+    }
 
     // Update the port envelope time by averaging all timestamps
     m_time.update(std::accumulate(m_times.begin(), m_times.end(), 0.0) / m_subdevice_joints);
     yarp::os::Stamp averageTime = m_time;
 
     // Data from HW have been gathered few lines before
-    JointTypeEnum jType;
     for (size_t i = 0; i < m_subdevice_joints; i++) {
-        m_iAxisInfo->getJointType(i, jType);
-        if (jType == VOCAB_JOINTTYPE_REVOLUTE) {
+        if (m_isRevolute[i]) {
             m_ros_struct.position[i] = convertDegreesToRadians(m_ros_struct.position[i]);
             m_ros_struct.velocity[i] = convertDegreesToRadians(m_ros_struct.velocity[i]);
         }
     }
 
-    m_ros_struct.name = m_jointNames;
-    m_ros_struct.header.stamp.sec = int(averageTime.getTime()); // FIXME
-    m_ros_struct.header.stamp.nanosec = static_cast<int>(1000000000 * (averageTime.getTime() - int(averageTime.getTime()))); // FIXME
-
-//    m_ros_struct.header.stamp = m_node->get_clock()->now();    //@@@@@@@@@@@ FIXME: averageTime.getTime();
-//     m_ros_struct.header.frame_id = m_frame_id; // FIXME
-
+    m_ros_struct.header.stamp = ros2TimeFromYarp(averageTime.getTime());
 
     // FIXME
     ++m_counter;
 //     m_ros_struct.header.seq = m_counter++;
 
-    m_publisher->publish(m_ros_struct);
+    const double now = yarp::os::Time::now();
+    std::lock_guard<std::mutex> lock(m_groupsMutex);
+    for (auto& group : m_jointGroups) {
+        if (group.indices.empty()) {
+            continue;
+        }
+        if (group.counter == 0) {
+            if (m_deadband.empty() || now - group.lastPublishTime >= m_keyframePeriod || jointGroupMoved(group)) {
+                publishJointGroup(group);
+                group.lastPublishTime = now;
+            }
+        }
+        group.counter = (group.counter + 1) % group.decimation;
+    }
 }
@@ -8,7 +8,12 @@
 
 #include <yarp/dev/DeviceDriver.h>
 #include <yarp/dev/WrapperSingle.h>
+#include <yarp/dev/IMultipleWrapper.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/PolyDriverList.h>
 #include <yarp/os/PeriodicThread.h>
+#include <yarp/os/Semaphore.h>
+#include <yarp/os/Thread.h>
 
 #include <yarp/dev/IPositionControl.h>
 #include <yarp/dev/IVelocityControl.h>
@@ -18,6 +23,9 @@
 #include <yarp/dev/IControlMode.h>
 #include <yarp/dev/IAxisInfo.h>
 #include <Ros2Spinner.h>
+#include <Ros2Parameters.h>
+#include <Ros2ClockDriver.h>
+#include <Ros2BagRecorder.h>
 
 #include <yarp/os/Stamp.h>
 #include <yarp/sig/Vector.h>
@@ -30,6 +38,8 @@
 #include <std_msgs/msg/header.hpp>
 #include <std_msgs/msg/float64_multi_array.hpp>
 #include <map>
+#include <memory>
+#include <mutex>
 
 //Custom ros2 interfaces
 #include <yarp_control_msgs/srv/get_control_modes.hpp>
@@ -40,8 +50,6 @@
 #include <yarp_control_msgs/msg/velocity.hpp>
 #include <yarp_control_msgs/msg/position_direct.hpp>
 
-#include <mutex>
-
 
 
 /**
@@ -58,6 +66,53 @@
  * | topic_name     |      -         | string  | -              |   -           | Yes                         | set the name for ROS topic                                        | must start with a leading '/' |
  * | msgs_name      |      -         | string  | -              |   -           | No                          | set the base name for the topics and interfaces                   | If it is not specified, the control related topics and services will not be initialized |
  * | period         |      -         | double  | s              |   0.02        | No                          | refresh period of the broadcasted values in s                     | optional, default 20ms |
+ * | qos_depth      |      -         | int     | -              |   10          | No                          | history depth of the topic_name publisher                         | |
+ * | qos_reliability|      -         | string  | -              |   reliable    | No                          | reliability of the topic_name publisher                           | can be `reliable` or `best_effort` |
+ * | deadband       |      -         | double or vector of doubles | rad or m | - | No                         | minimum position change of a joint that triggers a publication   | a single value for all joints, or one value per joint. If set, messages are published only when a joint moved or a keyframe is due |
+ * | keyframe_period|      -         | double  | s              |   1.0         | No                          | maximum time between two publications when deadband is set        | bounds the staleness of the published state |
+ * | clock_source   |      -         | string  | -              |   system      | No                          | clock the publishing cycle runs on                                | `system` or `ros`, see Ros2ClockDriver |
+ * | clock_topic    |      -         | string  | -              |   /clock      | No                          | clock topic used when clock_source is `ros`                       | |
+ * | record_uri     |      -         | string  | -              |   -           | No                          | record all the published joint states in this MCAP bag            | see Ros2BagRecorder for the other `record_*` parameters |
+ * | joint_groups   |      -         | vector of strings | -    |   -           | No                          | names of the joint groups published on their own topics           | each name must match a group of parameters as described below |
+ * | <group name>   | joints         | vector of strings | -    |   -           | Yes                         | names of the joints published by the group                        | a joint can belong to a single group |
+ * | <group name>   | topic_name     | string  | -              |   -           | Yes                         | topic the group is published on                                   | must start with a leading '/' |
+ * | <group name>   | period         | double  | s              |   period      | No                          | publishing period of the group                                    | rounded to a multiple of the fastest period |
+ * | <group name>   | qos_depth      | int     | -              |   10          | No                          | history depth of the group publisher                              | |
+ * | <group name>   | qos_reliability| string  | -              |   reliable    | No                          | reliability of the group publisher                                | can be `reliable` or `best_effort` |
+ *
+ * The encoders are read once per cycle, at the rate of the fastest group, and
+ * each group publishes its own subset of joints with the requested decimation.
+ * When joint groups are specified, `topic_name` carries only the joints that do
+ * not belong to any group.
+ *
+ * The periods (`period` and `<group name>.period`) and `keyframe_period` are
+ * also declared as ROS 2 parameters of the node, and can be changed while the
+ * device is running, e.g. with `ros2 param set <node_name> period 0.01`.
+ *
+ * With `deadband`, every topic still publishes the full state of its joints, but
+ * a cycle is skipped when no joint of the topic moved more than its deadband
+ * since the last message and less than `keyframe_period` has elapsed.
+ *
+ * Several controlboard parts can be attached at once through `attachAll()`. In
+ * this case the joints of all the parts are concatenated in the order of
+ * attachment, the encoders of the parts are read in parallel and a single
+ * JointState, stamped with the average time of all the joints, is published.
+ * Commands and services are routed to the parts through an internal
+ * `controlBoardRemapper`, so joint names must be unique across the parts.
+ *
+ * The command topics and the services are served by two separate threads:
+ * position, position direct and velocity commands are never delayed by
+ * service requests.
+ *
+ * Example:
+ * \code{.unparsed}
+ * joint_groups (hands)
+ * [hands]
+ * joints     (l_thumb l_index r_thumb r_index)
+ * topic_name /robot/hands/joint_states
+ * period     0.001
+ * qos_reliability best_effort
+ * \endcode
  *
  * ROS message type used is sensor_msgs/JointState.msg (http://docs.ros.org/api/sensor_msgs/html/msg/JointState.html)
  */
@@ -65,10 +120,64 @@
 class ControlBoard_nws_ros2 :
         public yarp::dev::DeviceDriver,
         public yarp::os::PeriodicThread,
-        public yarp::dev::WrapperSingle
+        public yarp::dev::WrapperSingle,
+        public yarp::dev::IMultipleWrapper
 {
 private:
-    sensor_msgs::msg::JointState m_ros_struct;
+    // A part attached through attachAll(), with the slice of the full state it fills
+    struct Part
+    {
+        std::string                key;
+        yarp::dev::IEncodersTimed* iEncodersTimed {nullptr};
+        yarp::dev::ITorqueControl* iTorqueControl {nullptr};
+        size_t                     offset {0};
+        size_t                     joints {0};
+    };
+
+    // Reads one part when triggered by the publishing thread
+    class PartReader : public yarp::os::Thread
+    {
+    private:
+        ControlBoard_nws_ros2& m_owner;
+        const Part&            m_part;
+        yarp::os::Semaphore    m_go {0};
+        yarp::os::Semaphore    m_done {0};
+
+    public:
+        PartReader(ControlBoard_nws_ros2& owner, const Part& part);
+
+        void trigger();
+        void waitDone();
+
+        void run() override;
+        void onStop() override;
+    };
+    struct JointGroup
+    {
+        std::string              name;
+        std::string              topicName;
+        std::vector<std::string> jointNames; // empty for the default group
+        std::vector<size_t>      indices;    // resolved when the device is attached
+        double                   period {0.0};
+        size_t                   qosDepth {10};
+        bool                     bestEffort {false};
+        size_t                   decimation {1};
+        size_t                   counter {0};
+        double                   lastPublishTime {0.0};
+        sensor_msgs::msg::JointState msg; // holds the last published state
+        rclcpp::Publisher<sensor_msgs::msg::JointState>::SharedPtr publisher;
+    };
+
+    sensor_msgs::msg::JointState m_ros_struct; // full state, read once per cycle
+    std::vector<JointGroup>      m_jointGroups; // the first one is the default group on topic_name
+    std::mutex                   m_groupsMutex; // rates can be changed at runtime through ROS 2 parameters
+    std::vector<bool>            m_isRevolute;
+
+    // Change-only publishing
+    std::vector<double>          m_deadbandConfig; // as read from the configuration
+    std::vector<double>          m_deadband;       // one value per joint
+    static constexpr double      m_default_keyframe_period = 1.0; // s
+    double                       m_keyframePeriod {m_default_keyframe_period};
 
     yarp::sig::Vector m_times; // time for each joint
 
@@ -83,8 +192,7 @@ private:
     std::string                  m_setModesSrvName;
     std::string                  m_getJointsNamesSrvName;
     std::string                  m_getAvailableModesSrvName;
-    std::map<std::string,size_t> m_quickJointRef;
-    mutable std::mutex           m_cmdMutex;
+    std::map<std::string,size_t> m_quickJointRef; // filled before the spinners start, read-only afterwards
 
 //     yarp::os::Node* node; // ROS node
     std::uint32_t m_counter {0}; // incremental counter in the ROS message
@@ -92,16 +200,21 @@ private:
 //     yarp::os::PortWriterBuffer<yarp::rosmsg::sensor_msgs::JointState> rosOutputState_buffer; // Buffer associated to the ROS topic
 //     yarp::os::Publisher<yarp::rosmsg::sensor_msgs::JointState> rosPublisherPort;             // Dedicated ROS topic publisher
 
-    rclcpp::Publisher<sensor_msgs::msg::JointState>::SharedPtr m_publisher;
     rclcpp::Node::SharedPtr m_node;
 
     static constexpr double m_default_period = 0.02; // s
     double m_period {m_default_period};
+    double m_threadPeriod {m_default_period}; // period of the fastest group
 
     yarp::os::Stamp m_time; // envelope to attach to the state port
 
     size_t m_subdevice_joints {0};
 
+    // Multiple parts
+    std::vector<Part>        m_parts;
+    std::vector<PartReader*> m_partReaders;
+    yarp::dev::PolyDriver    m_remapper;
+
     // Devices
     yarp::dev::DeviceDriver*     m_subdevice_ptr{nullptr};
     yarp::dev::IAxisInfo*        m_iAxisInfo{nullptr};
@@ -113,7 +226,16 @@ private:
     yarp::dev::IPositionControl* m_iPositionControl{nullptr};
 
     // Ros2 related attributes
-    Ros2Spinner*            m_spinner{nullptr};
+    // Streaming commands and services live in different callback groups, each
+    // one spun by its own thread, so that services never delay the commands.
+    rclcpp::CallbackGroup::SharedPtr m_streamCallbackGroup;
+    rclcpp::CallbackGroup::SharedPtr m_serviceCallbackGroup;
+    // Created once at open, stopped at every detach
+    std::unique_ptr<Ros2Spinner> m_streamSpinner;
+    std::unique_ptr<Ros2Spinner> m_serviceSpinner;
+    std::unique_ptr<Ros2Parameters> m_parameters;
+    std::unique_ptr<Ros2ClockDriver> m_clockDriver;
+    std::unique_ptr<Ros2BagRecorder> m_recorder;
     rclcpp::Subscription<yarp_control_msgs::msg::Position>::SharedPtr            m_posSubscription;
     rclcpp::Subscription<yarp_control_msgs::msg::PositionDirect>::SharedPtr      m_posDirectSubscription;
     rclcpp::Subscription<yarp_control_msgs::msg::Velocity>::SharedPtr            m_velSubscription;
@@ -123,7 +245,18 @@ private:
     rclcpp::Service<yarp_control_msgs::srv::GetAvailableControlModes>::SharedPtr m_getAvailableModesSrv;
 
     bool setDevice(yarp::dev::DeviceDriver* device);
+    bool startStreaming();
+    void readPart(const Part& part);
+    void initRos2ControlSpinners();
     bool initRos2Control(const std::string& name);
+    void stopRos2Control();
+    bool parseJointGroup(yarp::os::Searchable& config, JointGroup& group);
+    bool createJointGroupsPublishers();
+    void updateJointGroupsDecimation();
+    bool initParameters();
+    bool resolveJointGroups();
+    void publishJointGroup(JointGroup& group);
+    bool jointGroupMoved(const JointGroup& group) const;
 
     void closeDevice();
     void closePorts();
@@ -170,6 +303,10 @@ public:
     bool attach(yarp::dev::PolyDriver* poly) override;
     bool detach() override;
 
+    // yarp::dev::IMultipleWrapper
+    bool attachAll(const yarp::dev::PolyDriverList& p) override;
+    bool detachAll() override;
+
     // yarp::os::PeriodicThread
     void run() override;
 };
@@ -178,18 +178,16 @@ bool ControlBoard_nws_ros2::messageVectorsCheck(const std::string &valueName, co
 
 
 void ControlBoard_nws_ros2::positionTopic_callback(const yarp_control_msgs::msg::Position::SharedPtr msg) {
-
-    std::lock_guard <std::mutex> lg(m_cmdMutex);
-
-    bool noJoints = msg->names.size() == 0;
-    bool noSpeed = msg->ref_velocities.size() == 0;
-
     if(!msg){
         yCError(CONTROLBOARD_ROS2) << "Invalid message";
         RCLCPP_ERROR(m_node->get_logger(),"Invalid message");
 
         return;
     }
+
+    bool noJoints = msg->names.size() == 0;
+    bool noSpeed = msg->ref_velocities.size() == 0;
+
     if(!messageVectorsCheck("Position",msg->names,msg->positions,msg->ref_velocities)){
 
         return;
@@ -197,17 +195,15 @@ void ControlBoard_nws_ros2::positionTopic_callback(const yarp_control_msgs::msg:
 
     double tempVel;
     double tempPos;
-    JointTypeEnum jType;
     std::vector<double> convertedPos;
     std::vector<int> selectedJoints;
     std::vector<double> convertedVel;
 
     for(size_t i=0; i<(noJoints ? m_subdevice_joints : msg->positions.size()); i++){
-        size_t index = noJoints ? i : m_quickJointRef[msg->names[i]];
+        size_t index = noJoints ? i : m_quickJointRef.at(msg->names[i]);
         if(!noJoints) {selectedJoints.push_back(index);}
-        m_iAxisInfo->getJointType(index, jType);
         if(!noSpeed){
-            if(jType == VOCAB_JOINTTYPE_REVOLUTE){
+            if(m_isRevolute[index]){
                 tempVel = convertRadiansToDegrees(msg->ref_velocities[i]);
             }
             else{
@@ -216,7 +212,7 @@ void ControlBoard_nws_ros2::positionTopic_callback(const yarp_control_msgs::msg:
             convertedVel.push_back(tempVel);
         }
 
-        if(jType == VOCAB_JOINTTYPE_REVOLUTE){
+        if(m_isRevolute[index]){
             tempPos = convertRadiansToDegrees(msg->positions[i]);
         }
         else{
@@ -240,10 +236,6 @@ void ControlBoard_nws_ros2::positionTopic_callback(const yarp_control_msgs::msg:
 
 
 void ControlBoard_nws_ros2::positionDirectTopic_callback(const yarp_control_msgs::msg::PositionDirect::SharedPtr msg) {
-    std::lock_guard <std::mutex> lg(m_cmdMutex);
-
-    bool noJoints = msg->names.size() == 0;
-
     if(!msg){
         yCError(CONTROLBOARD_ROS2) << "Invalid message";
         RCLCPP_ERROR(m_node->get_logger(),"Invalid message");
@@ -251,21 +243,21 @@ void ControlBoard_nws_ros2::positionDirectTopic_callback(const yarp_control_msgs
         return;
     }
 
+    bool noJoints = msg->names.size() == 0;
+
     if(!messageVectorsCheck("Position",msg->names,msg->positions)){
 
         return;
     }
 
     double tempPos;
-    JointTypeEnum jType;
     std::vector<double> convertedPos;
     std::vector<int> selectedJoints;
 
-    for(size_t i=0; i<noJoints ? m_subdevice_joints : msg->positions.size(); i++){
-        size_t index = noJoints ? i : m_quickJointRef[msg->names[i]];
+    for(size_t i=0; i<(noJoints ? m_subdevice_joints : msg->positions.size()); i++){
+        size_t index = noJoints ? i : m_quickJointRef.at(msg->names[i]);
         if(!noJoints) {selectedJoints.push_back(index);}
-        m_iAxisInfo->getJointType(index, jType);
-        if(jType == VOCAB_JOINTTYPE_REVOLUTE){
+        if(m_isRevolute[index]){
             tempPos = convertRadiansToDegrees(msg->positions[i]);
         }
         else{
@@ -284,18 +276,16 @@ void ControlBoard_nws_ros2::positionDirectTopic_callback(const yarp_control_msgs
 
 
 void ControlBoard_nws_ros2::velocityTopic_callback(const yarp_control_msgs::msg::Velocity::SharedPtr msg) {
-
-    std::lock_guard <std::mutex> lg(m_cmdMutex);
-
-    bool noJoints = msg->names.size() == 0;
-    bool noAccel = msg->ref_accelerations.size() == 0;
-
     if(!msg){
         yCError(CONTROLBOARD_ROS2) << "Invalid message";
         RCLCPP_ERROR(m_node->get_logger(),"Invalid message");
 
         return;
     }
+
+    bool noJoints = msg->names.size() == 0;
+    bool noAccel = msg->ref_accelerations.size() == 0;
+
     if(!messageVectorsCheck("Velocities",msg->names,msg->velocities,msg->ref_accelerations)){
 
         return;
@@ -303,17 +293,15 @@ void ControlBoard_nws_ros2::velocityTopic_callback(const yarp_control_msgs::msg:
 
     double tempVel;
     double tempAccel;
-    JointTypeEnum jType;
     std::vector<double> convertedVel;
     std::vector<int> selectedJoints;
     std::vector<double> convertedAccel;
 
-    for(size_t i=0; i<noJoints ? m_subdevice_joints : msg->velocities.size(); i++){
-        size_t index = noJoints ? i : m_quickJointRef[msg->names[i]];
+    for(size_t i=0; i<(noJoints ? m_subdevice_joints : msg->velocities.size()); i++){
+        size_t index = noJoints ? i : m_quickJointRef.at(msg->names[i]);
         if(!noJoints) {selectedJoints.push_back(index);}
-        m_iAxisInfo->getJointType(index, jType);
         if(!noAccel){
-            if(jType == VOCAB_JOINTTYPE_REVOLUTE){
+            if(m_isRevolute[index]){
                 tempAccel = convertRadiansToDegrees(msg->ref_accelerations[i]);
             }
             else{
@@ -321,7 +309,7 @@ void ControlBoard_nws_ros2::velocityTopic_callback(const yarp_control_msgs::msg:
             }
             convertedAccel.push_back(tempAccel);
         }
-        if(jType == VOCAB_JOINTTYPE_REVOLUTE){
+        if(m_isRevolute[index]){
             tempVel = convertRadiansToDegrees(msg->velocities[i]);
         }
         else{
@@ -329,7 +317,7 @@ void ControlBoard_nws_ros2::velocityTopic_callback(const yarp_control_msgs::msg:
         }
         convertedVel.push_back(tempVel);
     }
-    if(!noJoints){
+    if(noJoints){
         if(!noAccel){
             m_iVelocityControl->setRefAccelerations(&convertedAccel[0]);
         }
@@ -347,7 +335,6 @@ void ControlBoard_nws_ros2::velocityTopic_callback(const yarp_control_msgs::msg:
 void ControlBoard_nws_ros2::getJointsNamesCallback(const std::shared_ptr<rmw_request_id_t> request_header,
                                                    const std::shared_ptr<yarp_control_msgs::srv::GetJointsNames::Request> request,
                                                    std::shared_ptr<yarp_control_msgs::srv::GetJointsNames::Response> response){
-    std::lock_guard <std::mutex> lg(m_cmdMutex);
     if(!request){
         yCError(CONTROLBOARD_ROS2) << "Invalid request";
         RCLCPP_ERROR(m_node->get_logger(),"Invalid request");
@@ -368,23 +355,13 @@ void ControlBoard_nws_ros2::getJointsNamesCallback(const std::shared_ptr<rmw_req
         return;
     }
 
-    std::string tempName;
+    // Names are cached when the device is attached, no need to query the device
     if(noIndexes){
-        for(size_t i=0; i<m_subdevice_joints; i++){
-            if(!m_iAxisInfo->getAxisName(i,tempName)){
-                yCError(CONTROLBOARD_ROS2) << "Name retrieval failed for joint number"<<i;
-                RCLCPP_ERROR(m_node->get_logger(),"Name retrieval failed for joint number %ld",i);
-
-                response->response = "GET_NAME_ERROR";
-
-                return;
-            }
-            response->names.push_back(tempName);
-        }
+        response->names = m_jointNames;
     }
     else{
         for(const auto &i : request->joint_indexes){
-            if(!m_iAxisInfo->getAxisName(i,tempName)){
+            if(i < 0 || static_cast<size_t>(i) >= m_subdevice_joints){
                 yCError(CONTROLBOARD_ROS2) << "Name retrieval failed for joint number"<<i;
                 RCLCPP_ERROR(m_node->get_logger(),"Name retrieval failed for joint number %d",i);
 
@@ -392,7 +369,7 @@ void ControlBoard_nws_ros2::getJointsNamesCallback(const std::shared_ptr<rmw_req
 
                 return;
             }
-            response->names.push_back(tempName);
+            response->names.push_back(m_jointNames[i]);
         }
     }
 
@@ -403,7 +380,6 @@ void ControlBoard_nws_ros2::getJointsNamesCallback(const std::shared_ptr<rmw_req
 void ControlBoard_nws_ros2::getAvailableModesCallback(const std::shared_ptr<rmw_request_id_t> request_header,
                                                       const std::shared_ptr<yarp_control_msgs::srv::GetAvailableControlModes::Request> request,
                                                       std::shared_ptr<yarp_control_msgs::srv::GetAvailableControlModes::Response> response){
-    std::lock_guard <std::mutex> lg(m_cmdMutex);
     if(!request){
         yCError(CONTROLBOARD_ROS2) << "Invalid request";
         RCLCPP_ERROR(m_node->get_logger(),"Invalid request");
@@ -429,10 +405,6 @@ void ControlBoard_nws_ros2::getAvailableModesCallback(const std::shared_ptr<rmw_
 void ControlBoard_nws_ros2::getControlModesCallback(const std::shared_ptr<rmw_request_id_t> request_header,
                                                     const std::shared_ptr<yarp_control_msgs::srv::GetControlModes::Request> request,
                                                     std::shared_ptr<yarp_control_msgs::srv::GetControlModes::Response> response){
-    std::lock_guard <std::mutex> lg(m_cmdMutex);
-
-    bool noJoints = request->names.size() == 0;
-
     if(!request){
         yCError(CONTROLBOARD_ROS2) << "Invalid request";
         RCLCPP_ERROR(m_node->get_logger(),"Invalid request");
@@ -442,6 +414,8 @@ void ControlBoard_nws_ros2::getControlModesCallback(const std::shared_ptr<rmw_re
         return;
     }
 
+    bool noJoints = request->names.size() == 0;
+
     if(!noJoints){
         if(!namesCheck(request->names)){
             response->response = "NAMES_ERROR";
@@ -456,7 +430,7 @@ void ControlBoard_nws_ros2::getControlModesCallback(const std::shared_ptr<rmw_re
 
     for (size_t i=0; i<forLimit; i++){
 
-        if(!m_iControlMode->getControlMode(noJoints ? i : m_quickJointRef[request->names[i]],tempMode)){
+        if(!m_iControlMode->getControlMode(noJoints ? i : m_quickJointRef.at(request->names[i]),tempMode)){
             yCError(CONTROLBOARD_ROS2) << "Error while retrieving the control mode for joint"<<request->names[i];
             RCLCPP_ERROR(m_node->get_logger(),"Error while retrieving the control mode for joint %s",request->names[i].c_str());
             response->response = "RETRIEVE_ERROR";
@@ -476,10 +450,6 @@ void ControlBoard_nws_ros2::getControlModesCallback(const std::shared_ptr<rmw_re
 void ControlBoard_nws_ros2::setControlModesCallback(const std::shared_ptr<rmw_request_id_t> request_header,
                                                     const std::shared_ptr<yarp_control_msgs::srv::SetControlModes::Request> request,
                                                     std::shared_ptr<yarp_control_msgs::srv::SetControlModes::Response> response){
-    std::lock_guard <std::mutex> lg(m_cmdMutex);
-
-    bool noJoints = request->names.size() == 0;
-
     if(!request){
         yCError(CONTROLBOARD_ROS2) << "Invalid request";
         RCLCPP_ERROR(m_node->get_logger(),"Invalid request");
@@ -489,6 +459,8 @@ void ControlBoard_nws_ros2::setControlModesCallback(const std::shared_ptr<rmw_re
         return;
     }
 
+    bool noJoints = request->names.size() == 0;
+
     if(!messageVectorsCheck("Control mode",request->names,request->modes)){
 
         response->response = "INVALID";
@@ -505,7 +477,7 @@ void ControlBoard_nws_ros2::setControlModesCallback(const std::shared_ptr<rmw_re
 
             return;
         }
-        if(!m_iControlMode->setControlMode(noJoints ? i : m_quickJointRef[request->names[i]],fromStringToCtrlMode.at(request->modes[i]))){
+        if(!m_iControlMode->setControlMode(noJoints ? i : m_quickJointRef.at(request->names[i]),fromStringToCtrlMode.at(request->modes[i]))){
             yCError(CONTROLBOARD_ROS2) << "Error while setting the control mode for joint"<<request->names[i]<<"to"<<request->modes[i];
             RCLCPP_ERROR(m_node->get_logger(),"Error while setting the control mode for joint %s to %s",request->names[i].c_str(),request->modes[i].c_str());
             response->response = "SET_ERROR";
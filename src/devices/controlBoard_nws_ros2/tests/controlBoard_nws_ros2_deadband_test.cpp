@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/WrapperSingle.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/joint_state.hpp>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+using namespace yarp::dev;
+using namespace yarp::os;
+
+namespace {
+struct Received
+{
+    double time;
+    double position0;
+};
+
+// Receives the joint states published by the nws, with their time of arrival
+class JointStateListener
+{
+public:
+    explicit JointStateListener(const std::string& topic)
+    {
+        if (!rclcpp::ok()) {
+            rclcpp::init(0, nullptr);
+        }
+        m_node = std::make_shared<rclcpp::Node>("controlBoard_nws_ros2_deadband_test");
+        m_subscription = m_node->create_subscription<sensor_msgs::msg::JointState>(topic, 100,
+            [this](const sensor_msgs::msg::JointState::SharedPtr msg) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_received.push_back({Time::now(), msg->position.empty() ? 0.0 : msg->position[0]});
+            });
+        m_executor.add_node(m_node);
+    }
+
+    // Spins for the given time, and returns the messages received meanwhile
+    std::vector<Received> spinFor(double duration)
+    {
+        const double end = Time::now() + duration;
+        while (Time::now() < end) {
+            m_executor.spin_some();
+            Time::delay(0.001);
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<Received> received;
+        received.swap(m_received);
+        return received;
+    }
+
+    // Spins until a message is received, and returns its time of arrival
+    double waitMessage(double timeout)
+    {
+        const double end = Time::now() + timeout;
+        while (Time::now() < end) {
+            m_executor.spin_some();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_received.empty()) {
+                const double time = m_received.back().time;
+                m_received.clear();
+                return time;
+            }
+        }
+        return -1;
+    }
+
+private:
+    rclcpp::Node::SharedPtr m_node;
+    rclcpp::Subscription<sensor_msgs::msg::JointState>::SharedPtr m_subscription;
+    rclcpp::executors::SingleThreadedExecutor m_executor;
+    std::mutex m_mutex;
+    std::vector<Received> m_received;
+};
+} // namespace
+
+TEST_CASE("dev::controlBoard_nws_ros2_deadband_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("controlBoard_nws_ros2", "device");
+    YARP_REQUIRE_PLUGIN("fakeMotionControl", "device");
+
+    Network::setLocalMode(true);
+
+    constexpr double keyframePeriod = 1.0;
+    constexpr double deadband = 0.001; // rad
+
+    PolyDriver ddnws;
+    PolyDriver ddfake;
+
+    Property pcfg;
+    pcfg.fromString("(device controlBoard_nws_ros2) (node_name controlboard_deadband_node) (topic_name /controlBoard_nws_ros2_deadband/joint_states) "
+                    "(period 0.01) (deadband 0.001) (keyframe_period 1.0)");
+    REQUIRE(ddnws.open(pcfg));
+
+    Property pcfg_fake;
+    pcfg_fake.put("device", "fakeMotionControl");
+    REQUIRE(ddfake.open(pcfg_fake));
+
+    JointStateListener listener("/controlBoard_nws_ros2_deadband/joint_states");
+
+    yarp::dev::WrapperSingle* ww_nws = nullptr;
+    REQUIRE(ddnws.view(ww_nws));
+    REQUIRE(ww_nws->attach(&ddfake));
+
+    SECTION("Still joints are published only at the keyframe rate, a moving joint immediately")
+    {
+        // The first message is always published, then the joints do not move
+        REQUIRE(listener.waitMessage(2.0) > 0);
+        const double observed = 2.5 * keyframePeriod;
+        std::vector<Received> still = listener.spinFor(observed);
+        // At the period of the nws, without deadband, there would be 250 messages
+        CHECK(still.size() >= 2);
+        CHECK(still.size() <= 3);
+        for (size_t i = 1; i < still.size(); i++) {
+            CHECK(still[i].time - still[i - 1].time >= keyframePeriod * 0.9);
+        }
+
+        // Just after a keyframe, a move beyond the deadband is published within a few periods
+        IControlMode* iMode = nullptr;
+        IPositionDirect* iPosDirect = nullptr;
+        REQUIRE(ddfake.view(iMode));
+        REQUIRE(ddfake.view(iPosDirect));
+        REQUIRE(iMode->setControlMode(0, VOCAB_CM_POSITION_DIRECT));
+        REQUIRE(listener.waitMessage(2.0 * keyframePeriod) > 0);
+        const double commandTime = Time::now();
+        const double target = 10.0; // deg, far beyond the deadband
+        REQUIRE(iPosDirect->setPosition(0, target));
+
+        std::vector<Received> moved = listener.spinFor(0.3 * keyframePeriod);
+        REQUIRE_FALSE(moved.empty());
+        CHECK(moved.front().time - commandTime < 0.3 * keyframePeriod);
+        CHECK(moved.back().position0 == Catch::Approx(target * M_PI / 180.0).margin(deadband));
+    }
+
+    CHECK(ddnws.close());
+    CHECK(ddfake.close());
+
+    Network::setLocalMode(false);
+}
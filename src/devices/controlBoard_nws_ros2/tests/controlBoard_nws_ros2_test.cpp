@@ -4,8 +4,11 @@
  */
 
 #include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/WrapperSingle.h>
+#include <yarp/dev/IMultipleWrapper.h>
+#include <yarp/dev/PolyDriverList.h>
 
 #include <catch2/catch_amalgamated.hpp>
 #include <harness.h>
@@ -39,6 +42,43 @@ TEST_CASE("dev::controlBoard_nws_ros2_test", "[yarp::dev]")
         }
     }
 
+    SECTION("Checking the nws with joint groups")
+    {
+        PolyDriver ddnws;
+
+        ////////"Checking opening nws"
+        {
+            Property pcfg;
+            pcfg.fromString("(device controlBoard_nws_ros2) (node_name controlboard_node) (topic_name /controlBoard_nws_ros2/robot_part) "
+                            "(joint_groups (fast)) "
+                            "(fast (joints (axisName0 axisName1)) (topic_name /controlBoard_nws_ros2/fast) (period 0.005) (qos_reliability best_effort))");
+            REQUIRE(ddnws.open(pcfg));
+        }
+
+        //"Close all polydrivers and check"
+        {
+            CHECK(ddnws.close());
+        }
+
+        ////////"Checking that a group without topic is refused"
+        {
+            Property pcfg;
+            pcfg.fromString("(device controlBoard_nws_ros2) (node_name controlboard_node) (topic_name /controlBoard_nws_ros2/robot_part) "
+                            "(joint_groups (fast)) "
+                            "(fast (joints (axisName0 axisName1)))");
+            CHECK_FALSE(ddnws.open(pcfg));
+        }
+
+        ////////"Checking that a group with an empty topic is refused"
+        {
+            Property pcfg;
+            pcfg.fromString("(device controlBoard_nws_ros2) (node_name controlboard_node) (topic_name /controlBoard_nws_ros2/robot_part) "
+                            "(joint_groups (fast)) "
+                            "(fast (joints (axisName0 axisName1)) (topic_name \"\"))");
+            CHECK_FALSE(ddnws.open(pcfg));
+        }
+    }
+
     SECTION("Checking the nws attached to device")
     {
         PolyDriver ddnws;
@@ -75,5 +115,125 @@ TEST_CASE("dev::controlBoard_nws_ros2_test", "[yarp::dev]")
         }
     }
 
+    SECTION("Checking the nws with deadband attached to device")
+    {
+        PolyDriver ddnws;
+        PolyDriver ddfake;
+        yarp::dev::WrapperSingle* ww_nws = nullptr;
+
+        ////////"Checking opening nws"
+        {
+            Property pcfg;
+            pcfg.put("device", "controlBoard_nws_ros2");
+            pcfg.put("node_name", "controlboard_node");
+            pcfg.put("topic_name","/controlBoard_nws_ros2/robot_part");
+            pcfg.put("deadband", 0.001);
+            pcfg.put("keyframe_period", 0.5);
+            REQUIRE(ddnws.open(pcfg));
+        }
+
+        ////////"Checking opening device"
+        {
+            Property pcfg_fake;
+            pcfg_fake.put("device", "fakeMotionControl");
+            REQUIRE(ddfake.open(pcfg_fake));
+        }
+
+        //attach the nws to the fake device
+        {
+            ddnws.view(ww_nws);
+            bool result_att = ww_nws->attach(&ddfake);
+            REQUIRE(result_att);
+        }
+
+        yarp::os::Time::delay(0.1);
+
+        //"Close all polydrivers and check"
+        {
+            CHECK(ddnws.close());
+            CHECK(ddfake.close());
+        }
+    }
+
+    SECTION("Checking the nws with commands attached again after a detach")
+    {
+        PolyDriver ddnws;
+        PolyDriver ddfake;
+        yarp::dev::WrapperSingle* ww_nws = nullptr;
+
+        ////////"Checking opening nws"
+        {
+            Property pcfg;
+            pcfg.put("device", "controlBoard_nws_ros2");
+            pcfg.put("node_name", "controlboard_node");
+            pcfg.put("topic_name","/controlBoard_nws_ros2/robot_part");
+            pcfg.put("msgs_name","/controlBoard_nws_ros2/commands");
+            REQUIRE(ddnws.open(pcfg));
+        }
+
+        ////////"Checking opening device"
+        {
+            Property pcfg_fake;
+            pcfg_fake.put("device", "fakeMotionControl");
+            REQUIRE(ddfake.open(pcfg_fake));
+        }
+
+        //the spinners are stopped at detach and started again at attach
+        {
+            ddnws.view(ww_nws);
+            REQUIRE(ww_nws);
+            REQUIRE(ww_nws->attach(&ddfake));
+            CHECK(ww_nws->detach());
+            REQUIRE(ww_nws->attach(&ddfake));
+            CHECK(ww_nws->detach());
+        }
+
+        //"Close all polydrivers and check"
+        {
+            CHECK(ddnws.close());
+            CHECK(ddfake.close());
+        }
+    }
+
+    SECTION("Checking the nws attached to a list of devices")
+    {
+        PolyDriver ddnws;
+        PolyDriver ddfake;
+        yarp::dev::IMultipleWrapper* ww_nws = nullptr;
+
+        ////////"Checking opening nws"
+        {
+            Property pcfg;
+            pcfg.put("device", "controlBoard_nws_ros2");
+            pcfg.put("node_name", "controlboard_node");
+            pcfg.put("topic_name","/controlBoard_nws_ros2/robot_part");
+            REQUIRE(ddnws.open(pcfg));
+        }
+
+        ////////"Checking opening device"
+        {
+            Property pcfg_fake;
+            pcfg_fake.put("device", "fakeMotionControl");
+            REQUIRE(ddfake.open(pcfg_fake));
+        }
+
+        //attach the nws to the list of devices
+        {
+            PolyDriverList parts;
+            parts.push(&ddfake, "part");
+            ddnws.view(ww_nws);
+            REQUIRE(ww_nws);
+            CHECK_FALSE(ww_nws->attachAll(PolyDriverList()));
+            REQUIRE(ww_nws->attachAll(parts));
+            CHECK(ww_nws->detachAll());
+        }
+
+        //"Close all polydrivers and check"
+        {
+            CHECK(ddnws.close());
+            CHECK(ddfake.close());
+        }
+    }
+
     Network::setLocalMode(false);
 }
@@ -0,0 +1,238 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include "ControlBoard_replay_ros2.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <chrono>
+#include <cmath>
+#include <Ros2Utils.h>
+
+using namespace yarp::dev;
+
+namespace {
+YARP_LOG_COMPONENT(CONTROLBOARD_REPLAY_ROS2, "yarp.ros2.controlBoard_replay_ros2", yarp::os::Log::TraceType);
+
+constexpr double RAD2DEG = 180.0 / M_PI;
+constexpr double default_first_message_timeout = 5.0;
+} // namespace
+
+bool ControlBoard_replay_ros2::open(yarp::os::Searchable& config)
+{
+    if (!config.check("bag_topic_name")) {
+        yCError(CONTROLBOARD_REPLAY_ROS2) << "missing bag_topic_name parameter";
+        return false;
+    }
+    m_topic_name = config.find("bag_topic_name").asString();
+
+    double firstMessageTimeout = config.check("first_message_timeout", yarp::os::Value(default_first_message_timeout)).asFloat64();
+
+    Ros2BagPlayer::Options options;
+    if (!Ros2BagPlayer::parseOptions(config, options)) {
+        return false;
+    }
+
+    m_player.addTopic(m_topic_name, [this](const rosbag2_storage::SerializedBagMessage& bagMessage) { onJointState(bagMessage); });
+    if (!m_player.open(options)) {
+        return false;
+    }
+
+    // The number of axes must be known before the device is attached to the nws
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_first_message.wait_for(lock, std::chrono::duration<double>(firstMessageTimeout), [this] { return m_data_valid; })) {
+        lock.unlock();
+        yCError(CONTROLBOARD_REPLAY_ROS2) << "No valid message of" << m_topic_name << "was played within" << firstMessageTimeout << "seconds";
+        m_player.close();
+        return false;
+    }
+
+    yCInfo(CONTROLBOARD_REPLAY_ROS2) << "opened with" << m_axes << "axes";
+    return true;
+}
+
+bool ControlBoard_replay_ros2::close()
+{
+    m_player.close();
+    return true;
+}
+
+void ControlBoard_replay_ros2::onJointState(const rosbag2_storage::SerializedBagMessage& bagMessage)
+{
+    sensor_msgs::msg::JointState state;
+    if (!Ros2BagPlayer::deserialize(bagMessage, state)) {
+        yCError(CONTROLBOARD_REPLAY_ROS2) << "Unable to deserialize a message of" << m_topic_name;
+        m_player.consumed();
+        return;
+    }
+
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        m_axes = state.name.size();
+        m_names = state.name;
+        m_positions.assign(m_axes, 0.0);
+        m_velocities.assign(m_axes, 0.0);
+    }
+    if (m_axes == 0 || state.name.size() != m_axes || state.position.size() != m_axes) {
+        yCErrorThrottle(CONTROLBOARD_REPLAY_ROS2, 5.0) << "Skipping a message of" << m_topic_name << "with an unexpected number of joints";
+        m_player.consumed();
+        return;
+    }
+
+    for (size_t i = 0; i < m_axes; i++) {
+        m_positions[i] = state.position[i] * RAD2DEG;
+        m_velocities[i] = (state.velocity.size() == m_axes) ? state.velocity[i] * RAD2DEG : 0.0;
+    }
+    m_timestamp = yarpTimeFromRos2(state.header.stamp) + m_player.stampOffset();
+
+    bool first = !m_data_valid;
+    m_data_valid = true;
+    m_data_fresh = true;
+    if (first) {
+        m_first_message.notify_all();
+    }
+}
+
+bool ControlBoard_replay_ros2::checkAxis(int j) const
+{
+    return j >= 0 && static_cast<size_t>(j) < m_axes;
+}
+
+bool ControlBoard_replay_ros2::getAxes(int* ax)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+    *ax = static_cast<int>(m_axes);
+    return true;
+}
+
+bool ControlBoard_replay_ros2::resetEncoder(int j)
+{
+    yCError(CONTROLBOARD_REPLAY_ROS2) << "resetEncoder is not supported by a recorded joint state";
+    return false;
+}
+
+bool ControlBoard_replay_ros2::resetEncoders()
+{
+    yCError(CONTROLBOARD_REPLAY_ROS2) << "resetEncoders is not supported by a recorded joint state";
+    return false;
+}
+
+bool ControlBoard_replay_ros2::setEncoder(int j, double val)
+{
+    yCError(CONTROLBOARD_REPLAY_ROS2) << "setEncoder is not supported by a recorded joint state";
+    return false;
+}
+
+bool ControlBoard_replay_ros2::setEncoders(const double* vals)
+{
+    yCError(CONTROLBOARD_REPLAY_ROS2) << "setEncoders is not supported by a recorded joint state";
+    return false;
+}
+
+bool ControlBoard_replay_ros2::getEncoder(int j, double* v)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid || !checkAxis(j)) {
+        return false;
+    }
+    *v = m_positions[j];
+    return true;
+}
+
+bool ControlBoard_replay_ros2::getEncoders(double* encs)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+    std::copy(m_positions.begin(), m_positions.end(), encs);
+    return true;
+}
+
+bool ControlBoard_replay_ros2::getEncoderSpeed(int j, double* sp)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid || !checkAxis(j)) {
+        return false;
+    }
+    *sp = m_velocities[j];
+    return true;
+}
+
+bool ControlBoard_replay_ros2::getEncoderSpeeds(double* spds)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+    std::copy(m_velocities.begin(), m_velocities.end(), spds);
+    return true;
+}
+
+bool ControlBoard_replay_ros2::getEncoderAcceleration(int j, double* spds)
+{
+    yCError(CONTROLBOARD_REPLAY_ROS2) << "Accelerations are not recorded in a joint state";
+    return false;
+}
+
+bool ControlBoard_replay_ros2::getEncoderAccelerations(double* accs)
+{
+    yCError(CONTROLBOARD_REPLAY_ROS2) << "Accelerations are not recorded in a joint state";
+    return false;
+}
+
+bool ControlBoard_replay_ros2::getEncodersTimed(double* encs, double* time)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+    std::copy(m_positions.begin(), m_positions.end(), encs);
+    std::fill(time, time + m_axes, m_timestamp);
+
+    if (m_data_fresh) {
+        m_data_fresh = false;
+        m_player.consumed();
+    }
+    return true;
+}
+
+bool ControlBoard_replay_ros2::getEncoderTimed(int j, double* encs, double* time)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid || !checkAxis(j)) {
+        return false;
+    }
+    *encs = m_positions[j];
+    *time = m_timestamp;
+    return true;
+}
+
+bool ControlBoard_replay_ros2::getAxisName(int axis, std::string& name)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid || !checkAxis(axis)) {
+        return false;
+    }
+    name = m_names[axis];
+    return true;
+}
+
+bool ControlBoard_replay_ros2::getJointType(int axis, yarp::dev::JointTypeEnum& type)
+{
+    if (!checkAxis(axis)) {
+        return false;
+    }
+    type = VOCAB_JOINTTYPE_REVOLUTE;
+    return true;
+}
@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_CONTROLBOARD_REPLAY_ROS2_H
+#define YARP_ROS2_CONTROLBOARD_REPLAY_ROS2_H
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IAxisInfo.h>
+#include <yarp/dev/IEncodersTimed.h>
+
+#include <sensor_msgs/msg/joint_state.hpp>
+#include <Ros2BagPlayer.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/**
+ *  @ingroup dev_impl_fake
+ *
+ * \brief `controlBoard_replay_ros2`: A read-only controlboard that replays the JointState messages recorded in a rosbag2 bag.
+ *
+ * It is meant to run the NWS and NWC devices on recorded robot data, in a reproducible way.
+ * The number of axes and their names are taken from the first recorded message, open()
+ * waits for it. All the joints are considered revolute, so positions and velocities are
+ * converted from radians to degrees.
+ *
+ * Parameters required by this device are:
+ * | Parameter name      | SubParameter   | Type    | Units          | Default Value | Required  | Description                                          | Notes |
+ * |:-------------------:|:--------------:|:-------:|:--------------:|:-------------:|:---------:|:----------------------------------------------------:|:-----:|
+ * | bag_uri             |      -         | string  | -              |   -           | Yes       | path of the bag to play                              | |
+ * | bag_topic_name      |      -         | string  | -              |   -           | Yes       | recorded topic of the sensor_msgs/JointState         | |
+ * | time_scale          |      -         | double  | -              |   1.0         | No        | playback speed                                       | |
+ * | as_fast_as_possible |      -         | bool    | -              |   false       | No        | a new state is played after every getEncodersTimed() that returned the previous one | |
+ * | loop                |      -         | bool    | -              |   false       | No        | restart from the beginning at the end of the bag     | |
+ * | first_message_timeout | -            | double  | s              |   5.0         | No        | how long open() waits for the first recorded message | |
+ *
+ * See Ros2BagPlayer for the other playback parameters.
+ *
+ * \code{.unparsed}
+ * yarpdev --device controlBoard_nws_ros2 --subdevice controlBoard_replay_ros2 --bag_uri /data/joints_bag --bag_topic_name /joint_states --node_name joints_node --topic_name /replayed_joint_states
+ * \endcode
+ */
+class ControlBoard_replay_ros2 :
+        public yarp::dev::DeviceDriver,
+        public yarp::dev::IEncodersTimed,
+        public yarp::dev::IAxisInfo
+{
+public:
+    ControlBoard_replay_ros2() = default;
+    ControlBoard_replay_ros2(const ControlBoard_replay_ros2&) = delete;
+    ControlBoard_replay_ros2(ControlBoard_replay_ros2&&) noexcept = delete;
+    ControlBoard_replay_ros2& operator=(const ControlBoard_replay_ros2&) = delete;
+    ControlBoard_replay_ros2& operator=(ControlBoard_replay_ros2&&) noexcept = delete;
+    ~ControlBoard_replay_ros2() override = default;
+
+    // DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    // IEncodersTimed
+    bool getAxes(int* ax) override;
+    bool resetEncoder(int j) override;
+    bool resetEncoders() override;
+    bool setEncoder(int j, double val) override;
+    bool setEncoders(const double* vals) override;
+    bool getEncoder(int j, double* v) override;
+    bool getEncoders(double* encs) override;
+    bool getEncoderSpeed(int j, double* sp) override;
+    bool getEncoderSpeeds(double* spds) override;
+    bool getEncoderAcceleration(int j, double* spds) override;
+    bool getEncoderAccelerations(double* accs) override;
+    bool getEncodersTimed(double* encs, double* time) override;
+    bool getEncoderTimed(int j, double* encs, double* time) override;
+
+    // IAxisInfo
+    bool getAxisName(int axis, std::string& name) override;
+    bool getJointType(int axis, yarp::dev::JointTypeEnum& type) override;
+
+private:
+    void onJointState(const rosbag2_storage::SerializedBagMessage& bagMessage);
+    bool checkAxis(int j) const;
+
+    Ros2BagPlayer m_player;
+    std::string m_topic_name;
+
+    std::mutex m_mutex;
+    std::condition_variable m_first_message;
+    size_t m_axes{0};
+    std::vector<std::string> m_names;
+    std::vector<double> m_positions;
+    std::vector<double> m_velocities;
+    double m_timestamp{0.0};
+    bool m_data_valid{false};
+    bool m_data_fresh{false};
+};
+
+#endif // YARP_ROS2_CONTROLBOARD_REPLAY_ROS2_H
@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
+#include <yarp/dev/IAxisInfo.h>
+#include <yarp/dev/IEncodersTimed.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <sensor_msgs/msg/joint_state.hpp>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+#include <harness_bag.h>
+
+#include <cmath>
+
+using namespace yarp::dev;
+using namespace yarp::os;
+
+namespace {
+constexpr const char* s_topic = "/joint_states";
+constexpr size_t s_samples = 5;
+
+// Records s_samples states of two joints, the recording time of each message is its header stamp
+std::string recordStates()
+{
+    return recordBag("controlBoard_replay_ros2", s_topic, s_samples, [](size_t i, const rclcpp::Time& stamp) {
+        sensor_msgs::msg::JointState state;
+        state.header.stamp = stamp;
+        state.name = {"joint0", "joint1"};
+        state.position = {0.1 * i, -0.2 * i};
+        state.velocity = {1.0, -2.0};
+        return state;
+    });
+}
+
+// Waits for the sample stamped stamp, checks it and releases the next one
+void checkSample(IEncodersTimed* ienc, size_t sample, double stamp)
+{
+    double position = 0;
+    double time = 0;
+    REQUIRE(waitFor([&] { return ienc->getEncoderTimed(0, &position, &time) && time == approxStamp(stamp); }));
+
+    double speeds[2];
+    REQUIRE(ienc->getEncoderSpeeds(speeds));
+    CHECK(speeds[0] == Catch::Approx(1.0 * 180.0 / M_PI));
+    CHECK(speeds[1] == Catch::Approx(-2.0 * 180.0 / M_PI));
+
+    double encs[2];
+    double times[2];
+    REQUIRE(ienc->getEncodersTimed(encs, times));
+    CHECK(encs[0] == Catch::Approx(0.1 * sample * 180.0 / M_PI));
+    CHECK(encs[1] == Catch::Approx(-0.2 * sample * 180.0 / M_PI));
+    CHECK(times[0] == approxStamp(stamp));
+    CHECK(times[1] == approxStamp(stamp));
+}
+} // namespace
+
+TEST_CASE("dev::controlBoard_replay_ros2_playback_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("controlBoard_replay_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    const std::string uri = recordStates();
+
+    SECTION("Playing as fast as possible")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "controlBoard_replay_ros2");
+        pcfg.put("bag_uri", uri);
+        pcfg.put("bag_topic_name", s_topic);
+        pcfg.put("as_fast_as_possible", Value(true));
+        REQUIRE(dd.open(pcfg));
+
+        IEncodersTimed* ienc = nullptr;
+        IAxisInfo* iinfo = nullptr;
+        REQUIRE(dd.view(ienc));
+        REQUIRE(dd.view(iinfo));
+
+        int axes = 0;
+        CHECK(ienc->getAxes(&axes));
+        CHECK(axes == 2);
+        std::string name;
+        CHECK(iinfo->getAxisName(1, name));
+        CHECK(name == "joint1");
+
+        // Every recorded sample is returned once, in order
+        for (size_t i = 0; i < s_samples; i++) {
+            checkSample(ienc, i, stampOf(i));
+        }
+
+        CHECK(dd.close());
+    }
+
+    SECTION("Playing as fast as possible in a loop")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "controlBoard_replay_ros2");
+        pcfg.put("bag_uri", uri);
+        pcfg.put("bag_topic_name", s_topic);
+        pcfg.put("as_fast_as_possible", Value(true));
+        pcfg.put("loop", Value(true));
+        REQUIRE(dd.open(pcfg));
+
+        IEncodersTimed* ienc = nullptr;
+        REQUIRE(dd.view(ienc));
+
+        // The second loop continues the stamps one period after the last sample
+        for (size_t i = 0; i < 2 * s_samples; i++) {
+            checkSample(ienc, i % s_samples, stampOf(i));
+        }
+
+        CHECK(dd.close());
+    }
+
+    SECTION("Playing with the recorded timing")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "controlBoard_replay_ros2");
+        pcfg.put("bag_uri", uri);
+        pcfg.put("bag_topic_name", s_topic);
+        pcfg.put("time_scale", 2.0);
+        REQUIRE(dd.open(pcfg));
+        // open() returns when the first sample is played
+        const double start = Time::now();
+
+        IEncodersTimed* ienc = nullptr;
+        REQUIRE(dd.view(ienc));
+
+        // The samples are played without being read, at twice the recorded speed
+        double position = 0;
+        double time = 0;
+        REQUIRE(waitFor([&] { return ienc->getEncoderTimed(0, &position, &time) && time == approxStamp(stampOf(s_samples - 1)); }));
+        const double elapsed = Time::now() - start;
+        const double expected = (s_samples - 1) * s_periodNs * 1e-9 / 2.0;
+        CHECK(elapsed > expected * 0.5);
+        CHECK(elapsed < expected + 0.5);
+        CHECK(position == Catch::Approx(0.1 * (s_samples - 1) * 180.0 / M_PI));
+
+        CHECK(dd.close());
+    }
+
+    std::filesystem::remove_all(uri);
+
+    Network::setLocalMode(false);
+}
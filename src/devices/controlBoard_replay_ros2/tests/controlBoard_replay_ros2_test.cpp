@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+using namespace yarp::dev;
+using namespace yarp::os;
+
+TEST_CASE("dev::controlBoard_replay_ros2_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("controlBoard_replay_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    SECTION("Checking the device without a bag")
+    {
+        PolyDriver dd;
+
+        ////////"Checking that a bag is required"
+        {
+            Property pcfg;
+            pcfg.put("device", "controlBoard_replay_ros2");
+            pcfg.put("bag_topic_name", "/joint_states");
+            CHECK_FALSE(dd.open(pcfg));
+        }
+
+        ////////"Checking that a missing bag is reported"
+        {
+            Property pcfg;
+            pcfg.put("device", "controlBoard_replay_ros2");
+            pcfg.put("bag_topic_name", "/joint_states");
+            pcfg.put("bag_uri", "controlBoard_replay_ros2_missing_bag");
+            CHECK_FALSE(dd.open(pcfg));
+        }
+    }
+
+    Network::setLocalMode(false);
+}
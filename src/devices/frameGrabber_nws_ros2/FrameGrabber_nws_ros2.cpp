@@ -11,6 +11,7 @@
 
 #include <sensor_msgs/image_encodings.hpp>
 #include <Ros2Utils.h>
+#include <Ros2Tracer.h>
 
 namespace {
 YARP_LOG_COMPONENT(FRAMEGRABBER_NWS_ROS2, "yarp.device.frameGrabber_nws_ros2")
@@ -75,8 +76,16 @@ bool FrameGrabber_nws_ros2::close()
     }
     m_active = false;
 
+    if (m_parameters) {
+        m_parameters->stop();
+    }
     detach();
 
+    if (m_recorder) {
+        m_recorder->close();
+    }
+    Ros2Tracer::flush();
+
     return true;
 }
 
@@ -127,6 +136,11 @@ bool FrameGrabber_nws_ros2::open(yarp::os::Searchable& config)
     }
     m_node = NodeCreator::createNode(m_nodeName);
     publisher_image = m_node->create_publisher<sensor_msgs::msg::Image>(topicName, 10);
+    m_traceChannel = Ros2Tracer::channel(topicName);
+    m_clockDriver = std::make_unique<Ros2ClockDriver>(m_node, [this]() { run(); });
+    if (!m_clockDriver->configure(config) || !m_clockDriver->setPeriod(m_period)) {
+        return false;
+    }
 
 
     // set "cameraInfoTopicName" and open publisher
@@ -142,6 +156,31 @@ bool FrameGrabber_nws_ros2::open(yarp::os::Searchable& config)
     }
     m_frameId = config.find("frame_id").asString();
 
+    Ros2BagRecorder::Options recorderOptions;
+    if (!Ros2BagRecorder::parseOptions(config, recorderOptions)) {
+        return false;
+    }
+    if (!recorderOptions.uri.empty()) {
+        m_recorder = std::make_unique<Ros2BagRecorder>();
+        if (!m_recorder->open(recorderOptions)) {
+            return false;
+        }
+    }
+
+    m_parameters = std::make_unique<Ros2Parameters>(m_node);
+    bool ok = m_parameters->addDouble("period", m_period, [this](double period) {
+        if (period <= 0) {
+            return false;
+        }
+        m_period = period;
+        m_clockDriver->setPeriod(m_period);
+        return PeriodicThread::setPeriod(m_period);
+    });
+    if (!ok || !m_parameters->start()) {
+        yCError(FRAMEGRABBER_NWS_ROS2) << "Unable to initialize the ROS 2 parameters";
+        return false;
+    }
+
     yCInfo(FRAMEGRABBER_NWS_ROS2) << "Running, waiting for attach...";
 
     m_active = true;
@@ -169,12 +208,19 @@ bool FrameGrabber_nws_ros2::attach(yarp::dev::PolyDriver* poly)
         yCWarning(FRAMEGRABBER_NWS_ROS2) << "IRgbVisualParams interface is not available on the device";
     }
 
+    if (m_clockDriver->enabled()) {
+        return threadInit() && m_clockDriver->start();
+    }
     return PeriodicThread::start();
 }
 
 
 bool FrameGrabber_nws_ros2::detach()
 {
+    if (m_clockDriver && m_clockDriver->isRunning()) {
+        m_clockDriver->stop();
+        threadRelease();
+    }
     if (yarp::os::PeriodicThread::isRunning()) {
         yarp::os::PeriodicThread::stop();
     }
@@ -207,28 +253,38 @@ void FrameGrabber_nws_ros2::run()
 //         return;
 //     }
 
-    if (iPreciselyTimed) {
-        m_stamp = iPreciselyTimed->getLastInputStamp();
-    } else {
-        m_stamp.update(yarp::os::Time::now());
-    }
-
     if (iFrameGrabberImage)
     {
         if (iFrameGrabberImage->getImage(*yarpimg))
         {
+            // The stamp of the image just read is available only after getImage()
+            if (iPreciselyTimed) {
+                m_stamp = iPreciselyTimed->getLastInputStamp();
+            } else {
+                m_stamp.update(yarp::os::Time::now());
+            }
+
             sensor_msgs::msg::Image rosimg;
+            rosimg.header.frame_id = m_frameId;
+            rosimg.header.stamp = ros2TimeFromYarp(m_stamp.getTime());
+            Ros2Tracer::traceCapture(m_traceChannel, rosimg.header.stamp);
+            Ros2Tracer::trace(m_traceChannel, Ros2Tracer::NwsRead, rosimg.header.stamp);
+
             rosimg.data.resize(yarpimg->getRawImageSize());
             rosimg.width = yarpimg->width();
             rosimg.height = yarpimg->height();
             rosimg.encoding = yarp2RosPixelCode(yarpimg->getPixelCode());
             rosimg.step = yarpimg->getRowSize();
-            rosimg.header.frame_id = m_frameId;
-    //         rosimg.header.stamp.sec = static_cast<int>(m_stamp.getTime()); // FIXME
-    //         rosimg.header.stamp.nanosec = static_cast<int>(1000000000UL * (m_stamp.getTime() - int(m_stamp.getTime()))); // FIXME
             rosimg.is_bigendian = 0;
             memcpy(rosimg.data.data(), yarpimg->getRawImage(), yarpimg->getRawImageSize());
-            publisher_image->publish(rosimg);
+
+            Ros2Tracer::trace(m_traceChannel, Ros2Tracer::NwsPublish, rosimg.header.stamp);
+            if (m_recorder) {
+                m_recorder->publish(publisher_image, rosimg);
+            } else {
+                publisher_image->publish(rosimg);
+            }
+            Ros2Tracer::trace(m_traceChannel, Ros2Tracer::RmwSent, rosimg.header.stamp);
         }
         else
         {
@@ -244,7 +300,11 @@ void FrameGrabber_nws_ros2::run()
     {
         sensor_msgs::msg::CameraInfo cameraInfo;
         if (setCamInfo(cameraInfo)) {
-            publisher_cameraInfo->publish(cameraInfo);
+            if (m_recorder) {
+                m_recorder->publish(publisher_cameraInfo, cameraInfo);
+            } else {
+                publisher_cameraInfo->publish(cameraInfo);
+            }
         }
     }
     else
@@ -318,8 +378,7 @@ bool FrameGrabber_nws_ros2::setCamInfo(sensor_msgs::msg::CameraInfo& cameraInfo)
     }
 
     cameraInfo.header.frame_id      = m_frameId;
-//     cameraInfo.header.stamp.sec     = static_cast<int>(m_stamp.getTime()); // FIXME
-//     cameraInfo.header.stamp.nanosec = static_cast<int>(1000000000UL * (m_stamp.getTime() - int(m_stamp.getTime()))); // FIXME
+    cameraInfo.header.stamp         = ros2TimeFromYarp(m_stamp.getTime());
     cameraInfo.width                = iRgbVisualParams->getRgbWidth();
     cameraInfo.height               = iRgbVisualParams->getRgbHeight();
     cameraInfo.distortion_model     = distModel;
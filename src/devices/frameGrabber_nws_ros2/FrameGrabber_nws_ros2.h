@@ -23,6 +23,11 @@
 #include <rclcpp/rclcpp.hpp>
 #include <sensor_msgs/msg/image.hpp>
 #include <sensor_msgs/msg/camera_info.hpp>
+#include <Ros2Parameters.h>
+#include <Ros2ClockDriver.h>
+#include <Ros2BagRecorder.h>
+
+#include <memory>
 
 /**
  *  @ingroup dev_impl_nws_ros2 dev_impl_media
@@ -31,6 +36,14 @@
  *
  *  Documentation to be added
  *
+ *  The `period` is also exposed as a ROS 2 parameter of the node, so it can be changed at runtime with `ros2 param set`.
+ *
+ *  With `clock_source` set to `ros` the images are published once per period of the simulated time,
+ *  see Ros2ClockDriver for the `clock_*` parameters.
+ *
+ *  If `record_uri` is set, the published images and camera infos are also recorded in an MCAP bag,
+ *  see Ros2BagRecorder for the `record_*` parameters.
+ *
 */
 class FrameGrabber_nws_ros2 :
         public yarp::dev::DeviceDriver,
@@ -45,6 +58,9 @@ private:
     ImageTopicType::SharedPtr publisher_image;
     CameraInfoTopicType::SharedPtr publisher_cameraInfo;
     rclcpp::Node::SharedPtr m_node;
+    std::unique_ptr<Ros2Parameters> m_parameters;
+    std::unique_ptr<Ros2ClockDriver> m_clockDriver;
+    std::unique_ptr<Ros2BagRecorder> m_recorder;
 
     // Interfaces handled
     yarp::dev::IRgbVisualParams* iRgbVisualParams {nullptr};
@@ -58,6 +74,7 @@ private:
     bool m_active {false};
     yarp::os::Stamp m_stamp;
     std::string m_frameId;
+    uint32_t m_traceChannel {0};
     std::string m_nodeName;
 
     // Options
@@ -7,6 +7,7 @@
 #include <yarp/os/Log.h>
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
 
 using namespace std;
 using namespace yarp::dev;
@@ -19,6 +20,15 @@ namespace {
 YARP_LOG_COMPONENT(FRAMETRANSFORGETNWCROS2, "yarp.device.frameTransformGet_nwc_ros2")
 }
 
+FrameTransformGet_nwc_ros2::FrameTransformGet_nwc_ros2() :
+    PeriodicThread(0.05),
+    m_frames(std::make_shared<const std::vector<std::string>>())
+{
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->frames = m_frames;
+    m_snapshot = std::move(snapshot);
+}
+
 bool FrameTransformGet_nwc_ros2::open(yarp::os::Searchable& config)
 {
     if (!yarp::os::NetworkBase::checkNetwork()) {
@@ -31,9 +41,38 @@ bool FrameTransformGet_nwc_ros2::open(yarp::os::Searchable& config)
     {
         yarp::os::Searchable& general_config = config.findGroup("GENERAL");
         if (general_config.check("refresh_interval"))  {m_refreshInterval = general_config.find("refresh_interval").asFloat64();}
+        if (general_config.check("sweep_period"))  {m_sweepPeriod = general_config.find("sweep_period").asFloat64();}
+        if (general_config.check("frames"))
+        {
+            Bottle* frames = general_config.find("frames").asList();
+            if (!frames)
+            {
+                yCError(FRAMETRANSFORGETNWCROS2) << "frames must be a list of frame ids";
+                return false;
+            }
+            for (size_t i = 0; i < frames->size(); i++)
+            {
+                m_acceptedFrames.insert(frames->get(i).asString());
+            }
+        }
+        if (general_config.check("frame_prefixes"))
+        {
+            Bottle* prefixes = general_config.find("frame_prefixes").asList();
+            if (!prefixes)
+            {
+                yCError(FRAMETRANSFORGETNWCROS2) << "frame_prefixes must be a list of strings";
+                return false;
+            }
+            for (size_t i = 0; i < prefixes->size(); i++)
+            {
+                m_acceptedPrefixes.push_back(prefixes->get(i).asString());
+            }
+        }
+    }
+    if (m_sweepPeriod <= 0)
+    {
+        m_sweepPeriod = m_refreshInterval / 2;
     }
-
-    m_ftContainer.m_timeout = m_refreshInterval;
 
     //ROS2 configuration
     if (config.check("ROS2"))
@@ -64,6 +103,12 @@ bool FrameTransformGet_nwc_ros2::open(yarp::os::Searchable& config)
     m_spinner = new Ros2Spinner(m_node);
     m_spinner->start();
 
+    if (m_sweepPeriod > 0)
+    {
+        setPeriod(m_sweepPeriod);
+        start();
+    }
+
     yCInfo(FRAMETRANSFORGETNWCROS2) << "opened";
 
     return true;
@@ -72,6 +117,10 @@ bool FrameTransformGet_nwc_ros2::open(yarp::os::Searchable& config)
 bool FrameTransformGet_nwc_ros2::close()
 {
     yCInfo(FRAMETRANSFORGETNWCROS2, "closing...");
+    if (isRunning())
+    {
+        stop();
+    }
     delete m_spinner;
     yCInfo(FRAMETRANSFORGETNWCROS2, "closed");
     return true;
@@ -79,54 +128,144 @@ bool FrameTransformGet_nwc_ros2::close()
 
 bool FrameTransformGet_nwc_ros2::getTransforms(std::vector<yarp::math::FrameTransform>& transforms) const
 {
-    std::lock_guard<std::mutex> lock(m_trf_mutex);
-    if(!m_ftContainer.checkAndRemoveExpired())
+    // The snapshot is never modified, the reference keeps it alive while it is copied
+    std::shared_ptr<const Snapshot> snapshot = std::atomic_load(&m_snapshot);
+    const std::vector<std::string>& frames = *snapshot->frames;
+    double now = yarp::os::Time::now();
+    transforms.clear();
+    transforms.reserve(snapshot->transforms.size());
+    for (const auto& stored : snapshot->transforms)
     {
-        yCError(FRAMETRANSFORGETNWCROS2,"Unable to remove expired transforms");
-        return false;
+        if (isExpired(stored, now))
+        {
+            continue;
+        }
+        yarp::math::FrameTransform transform;
+        transform.src_frame_id = frames[stored.src];
+        transform.dst_frame_id = frames[stored.dst];
+        transform.isStatic = stored.isStatic;
+        transform.timestamp = stored.timestamp;
+        transform.translation.tX = stored.translation[0];
+        transform.translation.tY = stored.translation[1];
+        transform.translation.tZ = stored.translation[2];
+        transform.rotation.w() = stored.rotation[0];
+        transform.rotation.x() = stored.rotation[1];
+        transform.rotation.y() = stored.rotation[2];
+        transform.rotation.z() = stored.rotation[3];
+        transforms.push_back(std::move(transform));
+    }
+    return true;
+}
+
+void FrameTransformGet_nwc_ros2::run()
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    double now = yarp::os::Time::now();
+    bool removed = false;
+    for (auto it = m_transforms.begin(); it != m_transforms.end();)
+    {
+        if (isExpired(it->second, now))
+        {
+            it = m_transforms.erase(it);
+            removed = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    if (removed)
+    {
+        publishSnapshot();
+    }
+}
+
+bool FrameTransformGet_nwc_ros2::isExpired(const StoredTransform& transform, double now) const
+{
+    return !transform.isStatic && now - transform.timestamp > m_refreshInterval;
+}
+
+bool FrameTransformGet_nwc_ros2::frameId(const std::string& name, uint32_t& id)
+{
+    auto it = m_frameIds.find(name);
+    if (it != m_frameIds.end())
+    {
+        id = it->second;
+        return true;
     }
-    m_ftContainer.getTransforms(transforms);
+
+    if (!m_acceptedFrames.empty() || !m_acceptedPrefixes.empty())
+    {
+        bool accepted = m_acceptedFrames.count(name) > 0;
+        for (size_t i = 0; !accepted && i < m_acceptedPrefixes.size(); i++)
+        {
+            accepted = name.compare(0, m_acceptedPrefixes[i].size(), m_acceptedPrefixes[i]) == 0;
+        }
+        if (!accepted)
+        {
+            return false;
+        }
+    }
+
+    // The readers may still be using the current table, a new one is published with the next snapshot
+    auto frames = std::make_shared<std::vector<std::string>>(*m_frames);
+    id = static_cast<uint32_t>(frames->size());
+    frames->push_back(name);
+    m_frames = std::move(frames);
+    m_frameIds.emplace(name, id);
     return true;
 }
 
+void FrameTransformGet_nwc_ros2::publishSnapshot()
+{
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->transforms.reserve(m_transforms.size());
+    for (const auto& it : m_transforms)
+    {
+        snapshot->transforms.push_back(it.second);
+    }
+    snapshot->frames = m_frames;
+    std::atomic_store(&m_snapshot, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+}
+
 void FrameTransformGet_nwc_ros2::frameTransformTimedGet_callback(const tf2_msgs::msg::TFMessage::SharedPtr msg)
 {
-    std::lock_guard<std::mutex> lock(m_trf_mutex);
     yCTrace(FRAMETRANSFORGETNWCROS2);
     updateBuffer(msg->transforms,false);
 }
 
 void FrameTransformGet_nwc_ros2::frameTransformStaticGet_callback(const tf2_msgs::msg::TFMessage::SharedPtr msg)
 {
-    std::lock_guard<std::mutex> lock(m_trf_mutex);
     yCTrace(FRAMETRANSFORGETNWCROS2);
     updateBuffer(msg->transforms,true);
 }
 
-void FrameTransformGet_nwc_ros2::ros2TransformToYARP(const geometry_msgs::msg::TransformStamped& input, yarp::math::FrameTransform& output, bool isStatic)
-{
-    output.translation.tX = input.transform.translation.x;
-    output.translation.tY = input.transform.translation.y;
-    output.translation.tZ = input.transform.translation.z;
-
-    output.rotation.w() = input.transform.rotation.w;
-    output.rotation.x() = input.transform.rotation.x;
-    output.rotation.y() = input.transform.rotation.y;
-    output.rotation.z() = input.transform.rotation.z;
-
-    output.timestamp = yarpTimeFromRos2(input.header.stamp);
-    output.src_frame_id = input.header.frame_id;
-    output.dst_frame_id = input.child_frame_id;
-    output.isStatic = isStatic;
-}
-
 bool FrameTransformGet_nwc_ros2::updateBuffer(const std::vector<geometry_msgs::msg::TransformStamped>& transforms, bool areStatic)
 {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    bool changed = false;
     for (auto& it : transforms)
     {
-        yarp::math::FrameTransform tempFT;
-        ros2TransformToYARP(it,tempFT,areStatic);
-        m_ftContainer.setTransform(tempFT);
+        StoredTransform stored;
+        if (!frameId(it.header.frame_id, stored.src) || !frameId(it.child_frame_id, stored.dst))
+        {
+            continue;
+        }
+        stored.isStatic = areStatic;
+        stored.timestamp = yarpTimeFromRos2(it.header.stamp);
+        stored.translation[0] = it.transform.translation.x;
+        stored.translation[1] = it.transform.translation.y;
+        stored.translation[2] = it.transform.translation.z;
+        stored.rotation[0] = it.transform.rotation.w;
+        stored.rotation[1] = it.transform.rotation.x;
+        stored.rotation[2] = it.transform.rotation.y;
+        stored.rotation[3] = it.transform.rotation.z;
+        m_transforms[(static_cast<uint64_t>(stored.src) << 32) | stored.dst] = stored;
+        changed = true;
+    }
+    if (changed)
+    {
+        publishSnapshot();
     }
     return true;
 }
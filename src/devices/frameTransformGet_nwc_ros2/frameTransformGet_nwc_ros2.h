@@ -8,6 +8,7 @@
 
 
 #include <yarp/os/Network.h>
+#include <yarp/os/PeriodicThread.h>
 #include <yarp/dev/IFrameTransformStorage.h>
 #include <yarp/sig/Vector.h>
 #include <Ros2Spinner.h>
@@ -22,8 +23,12 @@
 #include <std_msgs/msg/header.hpp>
 #include <yarp/dev/FrameTransformContainer.h>
 #include <Ros2Utils.h>
+#include <memory>
 #include <mutex>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #define ROS2NODENAME "tfNodeGet"
 #define ROS2TOPICNAME_TF "/tf"
@@ -43,6 +48,9 @@
  * |:--------------:|:--------------------:|:-------:|:--------------:|:---------------------:|:-----------: |:-----------------------------------------------------------------:|
  * | GENERAL        |      -               | group   | -              | -                     | No           |                                                                   |
  * | -              | refresh_interval     | double  | seconds        | 0.1                   | No           | The time interval outside which timed ft will be deleted          |
+ * | -              | sweep_period         | double  | seconds        | refresh_interval / 2  | No           | The period of the thread deleting the expired timed fts           |
+ * | -              | frames               | vector of strings | -    | -                     | No           | The frames to keep, the fts between other frames are discarded    |
+ * | -              | frame_prefixes       | vector of strings | -    | -                     | No           | Keep also the frames starting with one of these prefixes          |
  * | ROS2           |      -               | group   | -              | -                     | No           |                                                                   |
  * | -              | ft_node              | string  | -              | /tfNodeGet            | No           | The name of the ROS2 node                                              |
  * | -              | ft_topic             | string  | -              | /tf                   | No           | The name of the ROS2 topic from which fts will be received        |
@@ -50,6 +58,15 @@
 
  * **N.B.** pay attention to the difference between **tf** and **ft**
  *
+ * The received fts are kept in an immutable snapshot, replaced with an atomic pointer swap by the
+ * subscription callbacks, so getTransforms() never waits for them and never delays them.
+ * The expired fts are skipped by getTransforms() and removed from the snapshot by a background thread.
+ *
+ * If `frames` or `frame_prefixes` are set, only the fts whose parent and child frames both match one of them
+ * are kept: the others are discarded before being converted, so on a busy shared /tf the cost depends on the
+ * frames of interest only. The frame ids of the kept fts are interned, the fts are stored as plain structs
+ * referring to them.
+ *
  * \section FrameTransformGet_nwc_ros2_device_example Example of configuration file using .ini format.
  *
  * \code{.unparsed}
@@ -57,6 +74,8 @@
  * [GENERAL]
  * period 0.05
  * refresh_interval 0.2
+ * frame_prefixes (robot1/)
+ * frames (map)
  * [ROS]
  * ft_topic /tf
  * ft_topic_static /tf_static
@@ -67,9 +86,11 @@
 
 class FrameTransformGet_nwc_ros2 :
     public yarp::dev::DeviceDriver,
+    public yarp::os::PeriodicThread,
     public yarp::dev::IFrameTransformStorageGet
 {
 public:
+    FrameTransformGet_nwc_ros2();
     ~FrameTransformGet_nwc_ros2()=default;
 
     //DeviceDriver
@@ -86,21 +107,53 @@ public:
     void frameTransformTimedGet_callback(const tf2_msgs::msg::TFMessage::SharedPtr msg);
     void frameTransformStaticGet_callback(const tf2_msgs::msg::TFMessage::SharedPtr msg);
 
+    //PeriodicThread, removes the expired transforms
+    void run() override;
+
     //own
-    void ros2TransformToYARP(const geometry_msgs::msg::TransformStamped& input, yarp::math::FrameTransform& output, bool isStatic);
     bool updateBuffer(const std::vector<geometry_msgs::msg::TransformStamped>& transforms, bool areStatic);
-    bool setTransform(const yarp::math::FrameTransform& transform);
 
 private:
-    mutable std::mutex                                                    m_trf_mutex;
+    // A transform with its frames replaced by their index in the frame table
+    struct StoredTransform
+    {
+        uint32_t src;
+        uint32_t dst;
+        bool     isStatic;
+        double   timestamp;
+        double   translation[3];
+        double   rotation[4]; // w, x, y, z
+    };
+
+    struct Snapshot
+    {
+        std::vector<StoredTransform> transforms;
+        // Only replaced, by a larger copy, when a new frame is interned
+        std::shared_ptr<const std::vector<std::string>> frames;
+    };
+
+    bool isExpired(const StoredTransform& transform, double now) const;
+    bool frameId(const std::string& name, uint32_t& id);
+    void publishSnapshot();
+
+    // Held by the writers only: the callbacks and the sweep
+    std::mutex                                                            m_writeMutex;
+    std::map<uint64_t, StoredTransform>                                   m_transforms;
+    std::unordered_map<std::string, uint32_t>                             m_frameIds;
+    std::shared_ptr<const std::vector<std::string>>                       m_frames;
+    // Read and replaced with std::atomic_load/std::atomic_store
+    std::shared_ptr<const Snapshot>                                       m_snapshot;
+    // Frame filter, empty to keep every frame
+    std::unordered_set<std::string>                                       m_acceptedFrames;
+    std::vector<std::string>                                              m_acceptedPrefixes;
     std::string                                                           m_ftNodeName{ROS2NODENAME};
     std::string                                                           m_ftTopic{ROS2TOPICNAME_TF};
     std::string                                                           m_ftTopicStatic{ROS2TOPICNAME_TF_STATIC};
     double                                                                m_refreshInterval{0.1};
+    double                                                                m_sweepPeriod{-1};
     rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr             m_subscriptionFtTimed;
     rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr             m_subscriptionFtStatic;
     rclcpp::Node::SharedPtr                                               m_node;
-    yarp::dev::FrameTransformContainer                                    m_ftContainer;
 };
 
 #endif // YARP_DEV_FRAMETRANSFORMGETNWCROS2_H
@@ -6,13 +6,25 @@
 #include <yarp/os/Network.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/WrapperSingle.h>
+#include <yarp/dev/IFrameTransformStorage.h>
 
 #include <catch2/catch_amalgamated.hpp>
 #include <harness.h>
 
+#include <algorithm>
+#include <sstream>
+
 using namespace yarp::dev;
 using namespace yarp::os;
 
+namespace {
+void addStaticTransform(std::stringstream& callStream, const std::string& parent, const std::string& child, double x)
+{
+    callStream << "{header: {frame_id: '" << parent << "'}, child_frame_id: '" << child << "', ";
+    callStream << "transform: {translation: {x: " << x << "}, rotation: {w: 1.0}}}";
+}
+} // namespace
+
 TEST_CASE("dev::frameTransformGet_nwc_ros2_test", "[yarp::dev]")
 {
     YARP_REQUIRE_PLUGIN("frameTransformGet_nwc_ros2", "device");
@@ -36,5 +48,66 @@ TEST_CASE("dev::frameTransformGet_nwc_ros2_test", "[yarp::dev]")
         }
     }
 
+    SECTION("Checking the nwc with a frame filter")
+    {
+        PolyDriver ddnwc;
+
+        Property pcfg;
+        pcfg.fromString("(device frameTransformGet_nwc_ros2) (GENERAL (frames (map odom)) (frame_prefixes (robot1/)))");
+        REQUIRE(ddnwc.open(pcfg));
+
+        yarp::dev::IFrameTransformStorageGet* iget = nullptr;
+        REQUIRE(ddnwc.view(iget));
+        std::vector<yarp::math::FrameTransform> transforms;
+        CHECK(iget->getTransforms(transforms));
+        CHECK(transforms.empty());
+
+        // Only the transforms whose frames are both accepted, by name or by prefix, are kept
+        std::stringstream callStream;
+        callStream << "ros2 topic pub --once --qos-durability transient_local /tf_static tf2_msgs/msg/TFMessage \"{transforms: [";
+        addStaticTransform(callStream, "map", "odom", 1.0);
+        callStream << ", ";
+        addStaticTransform(callStream, "odom", "robot1/base_link", 2.0);
+        callStream << ", ";
+        addStaticTransform(callStream, "robot1/base_link", "robot1/laser", 3.0);
+        callStream << ", ";
+        addStaticTransform(callStream, "map", "robot2/base_link", 4.0);
+        callStream << ", ";
+        addStaticTransform(callStream, "robot2/base_link", "robot1/laser", 5.0);
+        callStream << ", ";
+        addStaticTransform(callStream, "odom", "robot1", 6.0);
+        callStream << "]}\"";
+        system(callStream.str().c_str());
+
+        REQUIRE(waitFor([&] { return iget->getTransforms(transforms) && !transforms.empty(); }));
+        REQUIRE(transforms.size() == 3);
+        std::sort(transforms.begin(), transforms.end(), [](const yarp::math::FrameTransform& a, const yarp::math::FrameTransform& b) {
+            return a.translation.tX < b.translation.tX;
+        });
+        CHECK(transforms[0].src_frame_id == "map");
+        CHECK(transforms[0].dst_frame_id == "odom");
+        CHECK(transforms[0].translation.tX == Catch::Approx(1.0));
+        CHECK(transforms[1].src_frame_id == "odom");
+        CHECK(transforms[1].dst_frame_id == "robot1/base_link");
+        CHECK(transforms[1].translation.tX == Catch::Approx(2.0));
+        CHECK(transforms[2].src_frame_id == "robot1/base_link");
+        CHECK(transforms[2].dst_frame_id == "robot1/laser");
+        CHECK(transforms[2].translation.tX == Catch::Approx(3.0));
+        for (const auto& transform : transforms) {
+            CHECK(transform.isStatic);
+        }
+
+        CHECK(ddnwc.close());
+    }
+
+    SECTION("Checking the nwc with an invalid frame filter")
+    {
+        PolyDriver ddnwc;
+
+        Property pcfg;
+        pcfg.fromString("(device frameTransformGet_nwc_ros2) (GENERAL (frames map))");
+        CHECK_FALSE(ddnwc.open(pcfg));
+    }
+
     Network::setLocalMode(false);
 }
@@ -0,0 +1,276 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "TransformBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+// Bounds the memory used by the clients asking for many different pairs of frames
+constexpr size_t maxChains = 4096;
+} // namespace
+
+TransformBuffer::TransformBuffer(double cacheTime) :
+        m_cacheTime(cacheTime)
+{
+}
+
+bool TransformBuffer::setTransform(const std::string& parent,
+                                   const std::string& child,
+                                   double stamp,
+                                   const tf2::Transform& transform,
+                                   bool isStatic,
+                                   std::string& error)
+{
+    if (parent.empty() || child.empty()) {
+        error = "The frame ids cannot be empty";
+        return false;
+    }
+    if (parent == child) {
+        error = "The frame " + child + " cannot be the parent of itself";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t parentId = frameId(parent);
+    uint32_t childId = frameId(child);
+
+    if (m_frames[childId].parent != parentId) {
+        // The new parent must not be below the child
+        uint32_t id = parentId;
+        for (size_t steps = 0; id != noParent && steps <= m_frames.size(); steps++) {
+            if (id == childId) {
+                error = "Setting " + parent + " as the parent of " + child + " would create a loop";
+                return false;
+            }
+            id = m_frames[id].parent;
+        }
+        m_frames[childId].parent = parentId;
+        m_frames[childId].history.clear();
+        m_chains.clear();
+    }
+
+    Frame& frame = m_frames[childId];
+    if (frame.isStatic != isStatic) {
+        frame.history.clear();
+        frame.isStatic = isStatic;
+        m_staticGeneration++;
+    }
+
+    Sample sample{stamp, transform};
+    if (isStatic) {
+        // /tf_static is sent again to every new subscriber, the same transforms must not invalidate the products
+        if (frame.history.empty() || !(frame.history.front().transform == transform)) {
+            frame.history.assign(1, sample);
+            m_staticGeneration++;
+        }
+        return true;
+    }
+
+    if (frame.history.empty() || frame.history.back().stamp < stamp) {
+        frame.history.push_back(sample);
+    } else {
+        auto it = std::lower_bound(frame.history.begin(), frame.history.end(), stamp,
+                                   [](const Sample& s, double t) { return s.stamp < t; });
+        if (it != frame.history.end() && it->stamp == stamp) {
+            *it = sample;
+        } else {
+            frame.history.insert(it, sample);
+        }
+    }
+    while (frame.history.front().stamp < frame.history.back().stamp - m_cacheTime) {
+        frame.history.pop_front();
+    }
+    return true;
+}
+
+bool TransformBuffer::lookup(const std::string& target,
+                             const std::string& source,
+                             double time,
+                             tf2::Transform& transform,
+                             double& stamp,
+                             std::string& error)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto targetIt = m_frameIds.find(target);
+    if (targetIt == m_frameIds.end()) {
+        error = "The frame " + target + " does not exist";
+        return false;
+    }
+    auto sourceIt = m_frameIds.find(source);
+    if (sourceIt == m_frameIds.end()) {
+        error = "The frame " + source + " does not exist";
+        return false;
+    }
+
+    Chain& found = chain(targetIt->second, sourceIt->second);
+    if (!found.connected) {
+        error = "The frames " + target + " and " + source + " are not part of the same tree";
+        return false;
+    }
+    if (found.staticGeneration != m_staticGeneration) {
+        precompose(found.fromSource, found.sourceSteps);
+        precompose(found.fromTarget, found.targetSteps);
+        found.staticGeneration = m_staticGeneration;
+    }
+
+    if (time == 0) {
+        time = std::numeric_limits<double>::infinity();
+        latestTime(found.sourceSteps, time);
+        latestTime(found.targetSteps, time);
+        if (std::isinf(time)) {
+            time = 0;
+        }
+    }
+
+    tf2::Transform fromSource;
+    tf2::Transform fromTarget;
+    if (!compose(found.sourceSteps, time, fromSource, error) ||
+        !compose(found.targetSteps, time, fromTarget, error)) {
+        return false;
+    }
+    transform = fromTarget.inverse() * fromSource;
+    stamp = time;
+    return true;
+}
+
+void TransformBuffer::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frames.clear();
+    m_frameIds.clear();
+    m_chains.clear();
+}
+
+size_t TransformBuffer::framesCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_frames.size();
+}
+
+uint64_t TransformBuffer::staticGeneration() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_staticGeneration;
+}
+
+uint32_t TransformBuffer::frameId(const std::string& name)
+{
+    auto it = m_frameIds.find(name);
+    if (it != m_frameIds.end()) {
+        return it->second;
+    }
+    auto id = static_cast<uint32_t>(m_frames.size());
+    m_frames.emplace_back();
+    m_frames.back().name = name;
+    m_frameIds.emplace(name, id);
+    return id;
+}
+
+TransformBuffer::Chain& TransformBuffer::chain(uint32_t target, uint32_t source)
+{
+    uint64_t key = (static_cast<uint64_t>(target) << 32) | source;
+    auto it = m_chains.find(key);
+    if (it != m_chains.end()) {
+        return it->second;
+    }
+    if (m_chains.size() >= maxChains) {
+        m_chains.clear();
+    }
+
+    // The loops are rejected by setTransform(), the walks end at a root
+    std::unordered_map<uint32_t, size_t> sourceAncestors;
+    std::vector<uint32_t> fromSource;
+    for (uint32_t id = source; id != noParent; id = m_frames[id].parent) {
+        sourceAncestors.emplace(id, fromSource.size());
+        fromSource.push_back(id);
+    }
+
+    Chain result;
+    for (uint32_t id = target; id != noParent; id = m_frames[id].parent) {
+        auto common = sourceAncestors.find(id);
+        if (common != sourceAncestors.end()) {
+            fromSource.resize(common->second);
+            result.connected = true;
+            result.fromSource = std::move(fromSource);
+            break;
+        }
+        result.fromTarget.push_back(id);
+    }
+    if (!result.connected) {
+        result.fromTarget.clear();
+    }
+    return m_chains.emplace(key, std::move(result)).first->second;
+}
+
+void TransformBuffer::precompose(const std::vector<uint32_t>& frames, std::vector<Step>& steps) const
+{
+    steps.clear();
+    for (uint32_t id : frames) {
+        const Frame& frame = m_frames[id];
+        if (!frame.isStatic) {
+            steps.push_back(Step{false, id, tf2::Transform()});
+        } else if (!steps.empty() && steps.back().isStatic) {
+            steps.back().product = frame.history.front().transform * steps.back().product;
+        } else {
+            steps.push_back(Step{true, id, frame.history.front().transform});
+        }
+    }
+}
+
+void TransformBuffer::latestTime(const std::vector<Step>& steps, double& time) const
+{
+    for (const auto& step : steps) {
+        if (!step.isStatic) {
+            time = std::min(time, m_frames[step.frame].history.back().stamp);
+        }
+    }
+}
+
+bool TransformBuffer::transformAt(const Frame& frame, double time, tf2::Transform& transform, std::string& error) const
+{
+    const auto& history = frame.history;
+    if (frame.isStatic) {
+        transform = history.front().transform;
+        return true;
+    }
+    if (time < history.front().stamp || time > history.back().stamp) {
+        error = "The transform of " + frame.name + " is available between " + std::to_string(history.front().stamp) +
+                " and " + std::to_string(history.back().stamp) + ", not at " + std::to_string(time);
+        return false;
+    }
+
+    auto after = std::lower_bound(history.begin(), history.end(), time,
+                                  [](const Sample& s, double t) { return s.stamp < t; });
+    if (after->stamp == time) {
+        transform = after->transform;
+        return true;
+    }
+    const Sample& before = *(after - 1);
+    tf2Scalar ratio = (time - before.stamp) / (after->stamp - before.stamp);
+    transform.setOrigin(before.transform.getOrigin().lerp(after->transform.getOrigin(), ratio));
+    transform.setRotation(before.transform.getRotation().slerp(after->transform.getRotation(), ratio));
+    return true;
+}
+
+bool TransformBuffer::compose(const std::vector<Step>& steps, double time, tf2::Transform& transform, std::string& error) const
+{
+    transform.setIdentity();
+    for (const auto& step : steps) {
+        if (step.isStatic) {
+            transform = step.product * transform;
+            continue;
+        }
+        tf2::Transform dynamic;
+        if (!transformAt(m_frames[step.frame], time, dynamic, error)) {
+            return false;
+        }
+        transform = dynamic * transform;
+    }
+    return true;
+}
@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_DEV_FRAMETRANSFORMSERVER_TRANSFORMBUFFER_H
+#define YARP_DEV_FRAMETRANSFORMSERVER_TRANSFORMBUFFER_H
+
+#include <tf2/LinearMath/Transform.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The transforms received on /tf and /tf_static, indexed as a tree of frames.
+ *
+ * Every frame stores the transform from its parent, with a history of `cacheTime` seconds
+ * if it is dynamic. A lookup walks from the two frames up to their common ancestor and
+ * composes the transforms found on the way, interpolating the dynamic ones at the requested
+ * time. The frames walked by a lookup are cached for each pair of frames, and only searched
+ * again after a frame is moved to another parent.
+ *
+ * The consecutive static transforms of a cached chain are also multiplied once and stored,
+ * so a lookup only composes these products with the dynamic transforms of the chain. The
+ * products are computed again only after a static transform changes.
+ */
+class TransformBuffer
+{
+public:
+    explicit TransformBuffer(double cacheTime);
+    TransformBuffer(const TransformBuffer&) = delete;
+    TransformBuffer& operator=(const TransformBuffer&) = delete;
+
+    /**
+     * Stores the transform of `child` in `parent` at time `stamp`.
+     */
+    bool setTransform(const std::string& parent,
+                      const std::string& child,
+                      double stamp,
+                      const tf2::Transform& transform,
+                      bool isStatic,
+                      std::string& error);
+
+    /**
+     * Computes the transform mapping the points expressed in `source` to `target` at time `time`,
+     * or at the latest time available for all the transforms of the chain if `time` is 0.
+     * `stamp` is set to the time of the result, 0 if the chain only contains static transforms.
+     */
+    bool lookup(const std::string& target,
+                const std::string& source,
+                double time,
+                tf2::Transform& transform,
+                double& stamp,
+                std::string& error);
+
+    void clear();
+    size_t framesCount() const;
+
+    /**
+     * Incremented when a static transform changes, the cached products of the chains are
+     * computed again by the next lookup.
+     */
+    uint64_t staticGeneration() const;
+
+private:
+    static constexpr uint32_t noParent = UINT32_MAX;
+
+    struct Sample
+    {
+        double stamp;
+        tf2::Transform transform;
+    };
+
+    struct Frame
+    {
+        std::string name;
+        uint32_t parent{noParent};
+        bool isStatic{false};
+        // Sorted by stamp, a single sample for the static frames
+        std::deque<Sample> history;
+    };
+
+    // A dynamic frame, or the product of consecutive static frames
+    struct Step
+    {
+        bool isStatic;
+        uint32_t frame;
+        tf2::Transform product;
+    };
+
+    // The frames walked from the two ends of a lookup up to the common ancestor, this excluded
+    struct Chain
+    {
+        bool connected{false};
+        std::vector<uint32_t> fromSource;
+        std::vector<uint32_t> fromTarget;
+        // Valid if staticGeneration is the one of the buffer
+        uint64_t staticGeneration{0};
+        std::vector<Step> sourceSteps;
+        std::vector<Step> targetSteps;
+    };
+
+    uint32_t frameId(const std::string& name);
+    Chain& chain(uint32_t target, uint32_t source);
+    void precompose(const std::vector<uint32_t>& frames, std::vector<Step>& steps) const;
+    void latestTime(const std::vector<Step>& steps, double& time) const;
+    bool transformAt(const Frame& frame, double time, tf2::Transform& transform, std::string& error) const;
+    bool compose(const std::vector<Step>& steps, double time, tf2::Transform& transform, std::string& error) const;
+
+    mutable std::mutex m_mutex;
+    double m_cacheTime;
+    std::vector<Frame> m_frames;
+    std::unordered_map<std::string, uint32_t> m_frameIds;
+    // Indexed by (target << 32) | source, cleared when a frame changes parent
+    std::unordered_map<uint64_t, Chain> m_chains;
+    // Incremented when a static transform changes, the products of the chains are computed again
+    uint64_t m_staticGeneration{1};
+};
+
+#endif // YARP_DEV_FRAMETRANSFORMSERVER_TRANSFORMBUFFER_H
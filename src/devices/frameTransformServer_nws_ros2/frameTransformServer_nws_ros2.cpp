@@ -0,0 +1,216 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "frameTransformServer_nws_ros2.h"
+#include <yarp/conf/compiler.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Log.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/dev/GenericVocabs.h>
+#include <tf2/LinearMath/Quaternion.h>
+
+using namespace std;
+using namespace yarp::dev;
+using namespace yarp::os;
+using namespace std::placeholders;
+
+namespace {
+YARP_LOG_COMPONENT(FRAMETRANSFORMSERVERNWSROS2, "yarp.device.frameTransformServer_nws_ros2")
+}
+
+bool FrameTransformServer_nws_ros2::open(yarp::os::Searchable& config)
+{
+    if (!yarp::os::NetworkBase::checkNetwork()) {
+        yCError(FRAMETRANSFORMSERVERNWSROS2,"Error! YARP Network is not initialized");
+        return false;
+    }
+
+    if (config.check("GENERAL"))
+    {
+        yarp::os::Searchable& general_config = config.findGroup("GENERAL");
+        if (general_config.check("cache_time")) {m_cacheTime = general_config.find("cache_time").asFloat64();}
+        if (general_config.check("rpc_port")) {m_rpcPortName = general_config.find("rpc_port").asString();}
+    }
+    if (m_cacheTime <= 0)
+    {
+        yCError(FRAMETRANSFORMSERVERNWSROS2) << "cache_time must be positive";
+        return false;
+    }
+
+    //ROS2 configuration
+    if (config.check("ROS2"))
+    {
+        yCInfo(FRAMETRANSFORMSERVERNWSROS2, "Configuring ROS2 params");
+        Bottle ROS2_config = config.findGroup("ROS2");
+        if(ROS2_config.check("ft_node")) m_ftNodeName = ROS2_config.find("ft_node").asString();
+        if(ROS2_config.check("ft_topic")) m_ftTopic = ROS2_config.find("ft_topic").asString();
+        if(ROS2_config.check("ft_topic_static")) m_ftTopicStatic = ROS2_config.find("ft_topic_static").asString();
+        if(ROS2_config.check("lookup_service")) m_lookupServiceName = ROS2_config.find("lookup_service").asString();
+    }
+    else
+    {
+        //no ROS2 options
+        yCWarning(FRAMETRANSFORMSERVERNWSROS2) << "ROS2 Group not configured";
+    }
+
+    m_buffer = std::make_unique<TransformBuffer>(m_cacheTime);
+
+    if (!m_rpcPortName.empty())
+    {
+        if (!m_rpcPort.open(m_rpcPortName))
+        {
+            yCError(FRAMETRANSFORMSERVERNWSROS2, "Failed to open port %s", m_rpcPortName.c_str());
+            return false;
+        }
+        m_rpcPort.setReader(*this);
+    }
+
+    m_node = NodeCreator::createNode(m_ftNodeName);
+    m_subscriptionFtTimed = m_node->create_subscription<tf2_msgs::msg::TFMessage>(m_ftTopic, 10,
+                                                                                  std::bind(&FrameTransformServer_nws_ros2::frameTransformTimed_callback,
+                                                                                  this, _1));
+
+    rclcpp::QoS qos(10);
+    qos = qos.transient_local(); // Receives the static fts published before the server started
+    m_subscriptionFtStatic = m_node->create_subscription<tf2_msgs::msg::TFMessage>(m_ftTopicStatic, qos,
+                                                                                   std::bind(&FrameTransformServer_nws_ros2::frameTransformStatic_callback,
+                                                                                   this, _1));
+
+    m_lookupService = m_node->create_service<yarp_tf_msgs::srv::LookupTransform>(m_lookupServiceName,
+                                                                                 std::bind(&FrameTransformServer_nws_ros2::lookupTransform_callback,
+                                                                                 this, _1, _2, _3));
+
+    m_spinner = std::make_unique<Ros2Spinner>(m_node);
+    m_spinner->start();
+
+    yCInfo(FRAMETRANSFORMSERVERNWSROS2) << "opened";
+
+    return true;
+}
+
+bool FrameTransformServer_nws_ros2::close()
+{
+    yCInfo(FRAMETRANSFORMSERVERNWSROS2, "closing...");
+    m_spinner.reset();
+    m_rpcPort.close();
+    yCInfo(FRAMETRANSFORMSERVERNWSROS2, "closed");
+    return true;
+}
+
+void FrameTransformServer_nws_ros2::frameTransformTimed_callback(const tf2_msgs::msg::TFMessage::SharedPtr msg)
+{
+    yCTrace(FRAMETRANSFORMSERVERNWSROS2);
+    updateBuffer(msg->transforms, false);
+}
+
+void FrameTransformServer_nws_ros2::frameTransformStatic_callback(const tf2_msgs::msg::TFMessage::SharedPtr msg)
+{
+    yCTrace(FRAMETRANSFORMSERVERNWSROS2);
+    updateBuffer(msg->transforms, true);
+}
+
+void FrameTransformServer_nws_ros2::updateBuffer(const std::vector<geometry_msgs::msg::TransformStamped>& transforms, bool areStatic)
+{
+    for (const auto& it : transforms)
+    {
+        tf2::Quaternion rotation(it.transform.rotation.x, it.transform.rotation.y, it.transform.rotation.z, it.transform.rotation.w);
+        if (rotation.length2() < 1e-12)
+        {
+            yCWarningThrottle(FRAMETRANSFORMSERVERNWSROS2, 5.0) << "Discarding the ft from" << it.header.frame_id << "to" << it.child_frame_id << "with an invalid rotation";
+            continue;
+        }
+        rotation.normalize();
+        tf2::Transform transform(rotation, tf2::Vector3(it.transform.translation.x, it.transform.translation.y, it.transform.translation.z));
+
+        std::string error;
+        if (!m_buffer->setTransform(it.header.frame_id, it.child_frame_id, yarpTimeFromRos2(it.header.stamp), transform, areStatic, error))
+        {
+            yCWarningThrottle(FRAMETRANSFORMSERVERNWSROS2, 5.0) << "Discarding a ft:" << error;
+        }
+    }
+}
+
+void FrameTransformServer_nws_ros2::lookupTransform_callback(const std::shared_ptr<rmw_request_id_t> request_header,
+                                                             const std::shared_ptr<yarp_tf_msgs::srv::LookupTransform::Request> request,
+                                                             std::shared_ptr<yarp_tf_msgs::srv::LookupTransform::Response> response)
+{
+    YARP_UNUSED(request_header);
+
+    tf2::Transform transform;
+    double stamp = 0;
+    double time = (request->time.sec == 0 && request->time.nanosec == 0) ? 0 : yarpTimeFromRos2(request->time);
+    response->valid = m_buffer->lookup(request->target_frame, request->source_frame, time, transform, stamp, response->error);
+    if (!response->valid)
+    {
+        return;
+    }
+
+    response->transform.header.frame_id = request->target_frame;
+    response->transform.header.stamp = ros2TimeFromYarp(stamp);
+    response->transform.child_frame_id = request->source_frame;
+    response->transform.transform.translation.x = transform.getOrigin().x();
+    response->transform.transform.translation.y = transform.getOrigin().y();
+    response->transform.transform.translation.z = transform.getOrigin().z();
+    tf2::Quaternion rotation = transform.getRotation();
+    response->transform.transform.rotation.x = rotation.x();
+    response->transform.transform.rotation.y = rotation.y();
+    response->transform.transform.rotation.z = rotation.z();
+    response->transform.transform.rotation.w = rotation.w();
+}
+
+bool FrameTransformServer_nws_ros2::read(yarp::os::ConnectionReader& connection)
+{
+    yarp::os::Bottle in;
+    yarp::os::Bottle out;
+    if (!in.read(connection))
+    {
+        return false;
+    }
+
+    if (in.get(0).asString() == "lookup" && (in.size() == 3 || in.size() == 4))
+    {
+        tf2::Transform transform;
+        double stamp = 0;
+        std::string error;
+        double time = in.size() == 4 ? in.get(3).asFloat64() : 0;
+        if (m_buffer->lookup(in.get(1).asString(), in.get(2).asString(), time, transform, stamp, error))
+        {
+            out.addVocab32(VOCAB_OK);
+            out.addFloat64(stamp);
+            Bottle& translation = out.addList();
+            translation.addFloat64(transform.getOrigin().x());
+            translation.addFloat64(transform.getOrigin().y());
+            translation.addFloat64(transform.getOrigin().z());
+            tf2::Quaternion q = transform.getRotation();
+            Bottle& rotation = out.addList();
+            rotation.addFloat64(q.w());
+            rotation.addFloat64(q.x());
+            rotation.addFloat64(q.y());
+            rotation.addFloat64(q.z());
+        }
+        else
+        {
+            out.addVocab32(VOCAB_FAILED);
+            out.addString(error);
+        }
+    }
+    else
+    {
+        out.addVocab32(VOCAB_FAILED);
+        out.addString("Usage: lookup <target> <source> [time]");
+    }
+
+    yarp::os::ConnectionWriter *returnToSender = connection.getWriter();
+    if (returnToSender != nullptr)
+    {
+        out.write(*returnToSender);
+    }
+    else
+    {
+        yCError(FRAMETRANSFORMSERVERNWSROS2) << "Invalid return to sender";
+    }
+    return true;
+}
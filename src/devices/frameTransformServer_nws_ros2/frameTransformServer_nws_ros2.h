@@ -0,0 +1,122 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_DEV_FRAMETRANSFORMSERVERNWSROS2_H
+#define YARP_DEV_FRAMETRANSFORMSERVERNWSROS2_H
+
+
+#include <yarp/os/Network.h>
+#include <yarp/os/PortReader.h>
+#include <yarp/os/RpcServer.h>
+#include <yarp/dev/DeviceDriver.h>
+#include <Ros2Spinner.h>
+#include <rclcpp/rclcpp.hpp>
+#include <tf2_msgs/msg/tf_message.hpp>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <yarp_tf_msgs/srv/lookup_transform.hpp>
+#include <Ros2Utils.h>
+
+#include "TransformBuffer.h"
+
+#include <memory>
+#include <string>
+
+#define ROS2NODENAME "tfNodeServer"
+#define ROS2TOPICNAME_TF "/tf"
+#define ROS2TOPICNAME_TF_STATIC "/tf_static"
+#define ROS2SERVICENAME_LOOKUP "/lookupTransform"
+
+
+/**
+ * @ingroup dev_impl_nws_ros2
+ *
+ * @brief `frameTransformServer_nws_ros2`: A ros network wrapper server that keeps the frame transforms received from the ros2 topics in a single buffer, and computes the transform between any two frames on request. See \subpage FrameTransform for additional info.
+ *
+ * \section FrameTransformServer_nws_ros2_device_parameters Parameters
+ *
+ *   Parameters required by this device are:
+ * | Parameter name | SubParameter         | Type    | Units          | Default Value         | Required     | Description                                                       |
+ * |:--------------:|:--------------------:|:-------:|:--------------:|:---------------------:|:-----------: |:-----------------------------------------------------------------:|
+ * | GENERAL        |      -               | group   | -              | -                     | No           |                                                                   |
+ * | -              | cache_time           | double  | seconds        | 10.0                  | No           | How long the timed fts are kept to answer the lookups in the past |
+ * | -              | rpc_port             | string  | -              | -                     | No           | If set, the lookups are also answered on this YARP rpc port       |
+ * | ROS2           |      -               | group   | -              | -                     | No           |                                                                   |
+ * | -              | ft_node              | string  | -              | tfNodeServer          | No           | The name of the ROS2 node                                         |
+ * | -              | ft_topic             | string  | -              | /tf                   | No           | The name of the ROS2 topic from which fts will be received        |
+ * | -              | ft_topic_static      | string  | -              | /tf_static            | No           | The name of the ROS2 topic from which static fts will be received |
+ * | -              | lookup_service       | string  | -              | /lookupTransform      | No           | The name of the yarp_tf_msgs/LookupTransform ROS2 service         |
+ *
+ * **N.B.** pay attention to the difference between **tf** and **ft**
+ *
+ * A client needing a few transforms can call the lookup service instead of subscribing to /tf
+ * and keeping its own buffer: a single server per machine receives the full stream, and any
+ * number of clients share it. The request gives the target and source frames and a time, zero
+ * meaning the latest time available for the whole chain; the timed fts are interpolated at that
+ * time. The frames crossed to go from one frame to the other are cached, and searched again
+ * only when a frame changes parent. The consecutive static fts of a cached chain are multiplied
+ * once, and again only when /tf_static changes, so a lookup through a long chain of static fts
+ * only composes their product with the few timed fts.
+ *
+ * The rpc port answers to `lookup <target> <source> [time]` with
+ * `[ok] <time> (<tx> <ty> <tz>) (<qw> <qx> <qy> <qz>)`, or with `[fail] <error>`.
+ *
+ * \section FrameTransformServer_nws_ros2_device_example Example of configuration file using .ini format.
+ *
+ * \code{.unparsed}
+ * device frameTransformServer_nws_ros2
+ * [GENERAL]
+ * cache_time 5.0
+ * rpc_port /frameTransformServer/rpc
+ * [ROS2]
+ * ft_topic /tf
+ * ft_topic_static /tf_static
+ * lookup_service /lookupTransform
+ * \endcode
+ */
+
+
+class FrameTransformServer_nws_ros2 :
+    public yarp::dev::DeviceDriver,
+    public yarp::os::PortReader
+{
+public:
+    FrameTransformServer_nws_ros2() = default;
+    ~FrameTransformServer_nws_ros2() override = default;
+
+    //DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    //PortReader, the rpc port
+    bool read(yarp::os::ConnectionReader& connection) override;
+
+    //Subscription callbacks
+    void frameTransformTimed_callback(const tf2_msgs::msg::TFMessage::SharedPtr msg);
+    void frameTransformStatic_callback(const tf2_msgs::msg::TFMessage::SharedPtr msg);
+
+    //Service callback
+    void lookupTransform_callback(const std::shared_ptr<rmw_request_id_t> request_header,
+                                  const std::shared_ptr<yarp_tf_msgs::srv::LookupTransform::Request> request,
+                                  std::shared_ptr<yarp_tf_msgs::srv::LookupTransform::Response> response);
+
+private:
+    void updateBuffer(const std::vector<geometry_msgs::msg::TransformStamped>& transforms, bool areStatic);
+
+    std::unique_ptr<TransformBuffer>                                      m_buffer;
+    std::string                                                           m_ftNodeName{ROS2NODENAME};
+    std::string                                                           m_ftTopic{ROS2TOPICNAME_TF};
+    std::string                                                           m_ftTopicStatic{ROS2TOPICNAME_TF_STATIC};
+    std::string                                                           m_lookupServiceName{ROS2SERVICENAME_LOOKUP};
+    std::string                                                           m_rpcPortName;
+    double                                                                m_cacheTime{10.0};
+    yarp::os::RpcServer                                                   m_rpcPort;
+    std::unique_ptr<Ros2Spinner>                                          m_spinner;
+    rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr             m_subscriptionFtTimed;
+    rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr             m_subscriptionFtStatic;
+    rclcpp::Service<yarp_tf_msgs::srv::LookupTransform>::SharedPtr        m_lookupService;
+    rclcpp::Node::SharedPtr                                               m_node;
+};
+
+#endif // YARP_DEV_FRAMETRANSFORMSERVERNWSROS2_H
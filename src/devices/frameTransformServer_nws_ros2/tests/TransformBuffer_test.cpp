@@ -0,0 +1,280 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <TransformBuffer.h>
+
+#include <tf2/LinearMath/Matrix3x3.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+tf2::Transform makeTransform(double x, double y, double z, double yaw)
+{
+    tf2::Quaternion rotation;
+    rotation.setRPY(0, 0, yaw);
+    return tf2::Transform(rotation, tf2::Vector3(x, y, z));
+}
+
+double yawOf(const tf2::Transform& transform)
+{
+    double roll = 0;
+    double pitch = 0;
+    double yaw = 0;
+    tf2::Matrix3x3(transform.getRotation()).getRPY(roll, pitch, yaw);
+    return yaw;
+}
+
+void checkTransform(const tf2::Transform& transform, double x, double y, double z, double yaw)
+{
+    CHECK(transform.getOrigin().x() == Catch::Approx(x).margin(1e-9));
+    CHECK(transform.getOrigin().y() == Catch::Approx(y).margin(1e-9));
+    CHECK(transform.getOrigin().z() == Catch::Approx(z).margin(1e-9));
+    CHECK(yawOf(transform) == Catch::Approx(yaw).margin(1e-9));
+}
+
+void checkSame(const tf2::Transform& transform, const tf2::Transform& expected)
+{
+    checkTransform(transform, expected.getOrigin().x(), expected.getOrigin().y(), expected.getOrigin().z(), yawOf(expected));
+}
+
+// Composes the transforms of the single edges from `frames[0]` down to `frames.back()`
+tf2::Transform edgeByEdge(TransformBuffer& buffer, const std::vector<std::string>& frames, double time)
+{
+    tf2::Transform result;
+    result.setIdentity();
+    for (size_t i = 1; i < frames.size(); i++) {
+        tf2::Transform edge;
+        double stamp = 0;
+        std::string error;
+        REQUIRE(buffer.lookup(frames[i - 1], frames[i], time, edge, stamp, error));
+        result = result * edge;
+    }
+    return result;
+}
+
+// world -> a is static, a -> b is dynamic, b -> c is static, world -> d is static.
+// b is at the origin of a at time 1, and at (0, 2, 0) rotated by 90 degrees at time 3
+void fillTree(TransformBuffer& buffer)
+{
+    std::string error;
+    REQUIRE(buffer.setTransform("world", "a", 0, makeTransform(1, 0, 0, 0), true, error));
+    REQUIRE(buffer.setTransform("a", "b", 1, makeTransform(0, 0, 0, 0), false, error));
+    REQUIRE(buffer.setTransform("a", "b", 3, makeTransform(0, 2, 0, M_PI / 2), false, error));
+    REQUIRE(buffer.setTransform("b", "c", 0, makeTransform(1, 0, 0, 0), true, error));
+    REQUIRE(buffer.setTransform("world", "d", 0, makeTransform(0, 0, 1, 0), true, error));
+}
+} // namespace
+
+TEST_CASE("dev::TransformBuffer_test", "[yarp::dev]")
+{
+    TransformBuffer buffer(10.0);
+    fillTree(buffer);
+    CHECK(buffer.framesCount() == 5);
+
+    tf2::Transform transform;
+    double stamp = -1;
+    std::string error;
+
+    SECTION("A chain of several transforms is composed")
+    {
+        // The origin of c is (1, 0, 0) in b, (0, 3, 0) in a and (1, 3, 0) in world
+        REQUIRE(buffer.lookup("world", "c", 3, transform, stamp, error));
+        checkTransform(transform, 1, 3, 0, M_PI / 2);
+        CHECK(stamp == 3);
+
+        // The inverse lookup gives the inverse transform
+        tf2::Transform inverse;
+        REQUIRE(buffer.lookup("c", "world", 3, inverse, stamp, error));
+        tf2::Transform identity = inverse * transform;
+        checkTransform(identity, 0, 0, 0, 0);
+
+        // The chain from c to d goes through world, their common ancestor
+        REQUIRE(buffer.lookup("d", "c", 3, transform, stamp, error));
+        checkTransform(transform, 1, 3, -1, M_PI / 2);
+
+        // Without a time, the latest time of the dynamic transforms is used
+        REQUIRE(buffer.lookup("world", "c", 0, transform, stamp, error));
+        CHECK(stamp == 3);
+        checkTransform(transform, 1, 3, 0, M_PI / 2);
+
+        // A chain of static transforms has no time
+        REQUIRE(buffer.lookup("a", "d", 0, transform, stamp, error));
+        CHECK(stamp == 0);
+        checkTransform(transform, -1, 0, 1, 0);
+    }
+
+    SECTION("The transform of a frame to itself is the identity")
+    {
+        REQUIRE(buffer.lookup("c", "c", 0, transform, stamp, error));
+        checkTransform(transform, 0, 0, 0, 0);
+        CHECK(stamp == 0);
+
+        REQUIRE(buffer.lookup("b", "b", 2, transform, stamp, error));
+        checkTransform(transform, 0, 0, 0, 0);
+        CHECK(stamp == 2);
+    }
+
+    SECTION("The dynamic transforms are interpolated")
+    {
+        // Halfway, b is at (0, 1, 0) rotated by 45 degrees
+        REQUIRE(buffer.lookup("a", "b", 2, transform, stamp, error));
+        checkTransform(transform, 0, 1, 0, M_PI / 4);
+        CHECK(stamp == 2);
+
+        REQUIRE(buffer.lookup("world", "c", 2, transform, stamp, error));
+        checkTransform(transform, 1 + M_SQRT1_2, 1 + M_SQRT1_2, 0, M_PI / 4);
+
+        // A sample inserted between the others is used instead
+        REQUIRE(buffer.setTransform("a", "b", 2, makeTransform(0, 0, 0, 0), false, error));
+        REQUIRE(buffer.lookup("a", "b", 2.5, transform, stamp, error));
+        checkTransform(transform, 0, 1, 0, M_PI / 4);
+    }
+
+    SECTION("The times out of the history are rejected")
+    {
+        CHECK_FALSE(buffer.lookup("world", "c", 0.5, transform, stamp, error));
+        CHECK_FALSE(error.empty());
+        error.clear();
+        CHECK_FALSE(buffer.lookup("world", "c", 3.5, transform, stamp, error));
+        CHECK_FALSE(error.empty());
+
+        // The static transforms are valid at any time
+        CHECK(buffer.lookup("world", "d", 100, transform, stamp, error));
+
+        // The samples older than the cache time are dropped
+        REQUIRE(buffer.setTransform("a", "b", 12, makeTransform(0, 2, 0, M_PI / 2), false, error));
+        CHECK_FALSE(buffer.lookup("a", "b", 1.5, transform, stamp, error));
+        CHECK(buffer.lookup("a", "b", 3, transform, stamp, error));
+    }
+
+    SECTION("The loops are rejected")
+    {
+        CHECK_FALSE(buffer.setTransform("c", "world", 0, makeTransform(0, 0, 0, 0), true, error));
+        CHECK(error.find("loop") != std::string::npos);
+        CHECK_FALSE(buffer.setTransform("b", "a", 3, makeTransform(0, 0, 0, 0), false, error));
+        CHECK_FALSE(buffer.setTransform("c", "c", 0, makeTransform(0, 0, 0, 0), true, error));
+        CHECK_FALSE(buffer.setTransform("", "c", 0, makeTransform(0, 0, 0, 0), true, error));
+
+        // The tree is unchanged
+        REQUIRE(buffer.lookup("world", "c", 3, transform, stamp, error));
+        checkTransform(transform, 1, 3, 0, M_PI / 2);
+    }
+
+    SECTION("A frame is moved to another parent")
+    {
+        REQUIRE(buffer.lookup("world", "d", 3, transform, stamp, error));
+        checkTransform(transform, 0, 0, 1, 0);
+
+        // The cached chain of the pair is searched again
+        REQUIRE(buffer.setTransform("c", "d", 0, makeTransform(0, 0, 1, 0), true, error));
+        REQUIRE(buffer.lookup("world", "d", 3, transform, stamp, error));
+        checkTransform(transform, 1, 3, 1, M_PI / 2);
+        CHECK(stamp == 3);
+
+        // The history of a moved dynamic frame is dropped, and its children follow it
+        REQUIRE(buffer.setTransform("world", "b", 4, makeTransform(1, 0, 0, 0), false, error));
+        CHECK_FALSE(buffer.lookup("a", "b", 3, transform, stamp, error));
+        REQUIRE(buffer.lookup("a", "b", 4, transform, stamp, error));
+        checkTransform(transform, 0, 0, 0, 0);
+        REQUIRE(buffer.lookup("world", "c", 4, transform, stamp, error));
+        checkTransform(transform, 2, 0, 0, 0);
+    }
+
+    SECTION("The frames of different trees are not connected")
+    {
+        REQUIRE(buffer.setTransform("other", "e", 0, makeTransform(0, 0, 0, 0), true, error));
+        CHECK_FALSE(buffer.lookup("world", "e", 0, transform, stamp, error));
+        CHECK_FALSE(buffer.lookup("world", "missing", 0, transform, stamp, error));
+        CHECK(error.find("missing") != std::string::npos);
+
+        buffer.clear();
+        CHECK(buffer.framesCount() == 0);
+        CHECK_FALSE(buffer.lookup("world", "c", 0, transform, stamp, error));
+    }
+}
+
+TEST_CASE("dev::TransformBuffer_precompose_test", "[yarp::dev]")
+{
+    // Two static transforms, a dynamic one and two static transforms again from root to s4,
+    // two static transforms from root to t2
+    TransformBuffer buffer(10.0);
+    std::string error;
+    REQUIRE(buffer.setTransform("root", "s1", 0, makeTransform(1, 0, 0, M_PI / 6), true, error));
+    REQUIRE(buffer.setTransform("s1", "s2", 0, makeTransform(0, 1, 0, M_PI / 4), true, error));
+    REQUIRE(buffer.setTransform("s2", "m", 0, makeTransform(0, 0, 0, 0), false, error));
+    REQUIRE(buffer.setTransform("s2", "m", 2, makeTransform(2, 0, 0, M_PI / 3), false, error));
+    REQUIRE(buffer.setTransform("m", "s3", 0, makeTransform(0, 0, 1, -M_PI / 9), true, error));
+    REQUIRE(buffer.setTransform("s3", "s4", 0, makeTransform(2, 0, 0, 0), true, error));
+    REQUIRE(buffer.setTransform("root", "t1", 0, makeTransform(0, -1, 0, M_PI / 2), true, error));
+    REQUIRE(buffer.setTransform("t1", "t2", 0, makeTransform(0.5, 0, 0, -M_PI / 4), true, error));
+    const std::vector<std::string> toSource{"root", "s1", "s2", "m", "s3", "s4"};
+    const std::vector<std::string> toTarget{"root", "t1", "t2"};
+
+    tf2::Transform transform;
+    double stamp = 0;
+
+    SECTION("A chain of static and dynamic transforms is composed edge by edge")
+    {
+        for (double time : {0.0, 0.5, 1.0, 2.0}) {
+            REQUIRE(buffer.lookup("t2", "s4", time, transform, stamp, error));
+            checkSame(transform, edgeByEdge(buffer, toTarget, time).inverse() * edgeByEdge(buffer, toSource, time));
+        }
+
+        // Halfway, m is at (1, 0, 0) rotated by 30 degrees in s2
+        REQUIRE(buffer.lookup("root", "s4", 1, transform, stamp, error));
+        checkSame(transform, makeTransform(1, 0, 0, M_PI / 6) * makeTransform(0, 1, 0, M_PI / 4) *
+                             makeTransform(1, 0, 0, M_PI / 6) * makeTransform(0, 0, 1, -M_PI / 9) *
+                             makeTransform(2, 0, 0, 0));
+    }
+
+    SECTION("The same static transforms sent again keep the products")
+    {
+        REQUIRE(buffer.lookup("t2", "s4", 1, transform, stamp, error));
+        const tf2::Transform before = transform;
+        const uint64_t generation = buffer.staticGeneration();
+
+        // /tf_static is sent again to every new subscriber
+        REQUIRE(buffer.setTransform("root", "s1", 0, makeTransform(1, 0, 0, M_PI / 6), true, error));
+        REQUIRE(buffer.setTransform("s3", "s4", 5, makeTransform(2, 0, 0, 0), true, error));
+        CHECK(buffer.staticGeneration() == generation);
+
+        // The dynamic transforms do not change the products either
+        REQUIRE(buffer.setTransform("s2", "m", 3, makeTransform(2, 0, 0, M_PI / 3), false, error));
+        CHECK(buffer.staticGeneration() == generation);
+
+        REQUIRE(buffer.lookup("t2", "s4", 1, transform, stamp, error));
+        checkSame(transform, before);
+    }
+
+    SECTION("A changed static transform invalidates the products")
+    {
+        REQUIRE(buffer.lookup("t2", "s4", 1, transform, stamp, error));
+        const tf2::Transform before = transform;
+        const uint64_t generation = buffer.staticGeneration();
+
+        REQUIRE(buffer.setTransform("s3", "s4", 0, makeTransform(3, 0, 0, 0), true, error));
+        CHECK(buffer.staticGeneration() > generation);
+        REQUIRE(buffer.lookup("t2", "s4", 1, transform, stamp, error));
+        checkSame(transform, edgeByEdge(buffer, toTarget, 1).inverse() * edgeByEdge(buffer, toSource, 1));
+        // s4 moved by 1 along the x axis of s3
+        checkSame(transform, before * makeTransform(1, 0, 0, 0));
+
+        // A static frame becoming dynamic also changes the products
+        const uint64_t changed = buffer.staticGeneration();
+        REQUIRE(buffer.setTransform("root", "t1", 1, makeTransform(0, 0, 0, 0), false, error));
+        CHECK(buffer.staticGeneration() > changed);
+        REQUIRE(buffer.lookup("t2", "s4", 1, transform, stamp, error));
+        checkSame(transform, edgeByEdge(buffer, toTarget, 1).inverse() * edgeByEdge(buffer, toSource, 1));
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/RpcClient.h>
+#include <yarp/dev/GenericVocabs.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+using namespace yarp::dev;
+using namespace yarp::os;
+
+TEST_CASE("dev::frameTransformServer_nws_ros2_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("frameTransformServer_nws_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    SECTION("Checking the nws alone")
+    {
+        PolyDriver ddnws;
+
+        ////////"Checking opening nws"
+        {
+            Property pcfg;
+            pcfg.put("device", "frameTransformServer_nws_ros2");
+            REQUIRE(ddnws.open(pcfg));
+        }
+
+        //"Close all polydrivers and check"
+        {
+            CHECK(ddnws.close());
+        }
+    }
+
+    SECTION("Checking the rpc port")
+    {
+        PolyDriver ddnws;
+
+        Property pcfg;
+        pcfg.fromString("(device frameTransformServer_nws_ros2) (GENERAL (cache_time 2.0) (rpc_port /frameTransformServer_test/rpc))");
+        REQUIRE(ddnws.open(pcfg));
+
+        RpcClient client;
+        REQUIRE(client.open("/frameTransformServer_test/client"));
+        REQUIRE(Network::connect("/frameTransformServer_test/client", "/frameTransformServer_test/rpc"));
+
+        Bottle cmd;
+        Bottle reply;
+        cmd.fromString("lookup map base_link");
+        REQUIRE(client.write(cmd, reply));
+        CHECK(reply.get(0).asVocab32() == VOCAB_FAILED);
+
+        cmd.fromString("transform map");
+        reply.clear();
+        REQUIRE(client.write(cmd, reply));
+        CHECK(reply.get(0).asVocab32() == VOCAB_FAILED);
+
+        client.close();
+        CHECK(ddnws.close());
+    }
+
+    SECTION("Checking an invalid cache time")
+    {
+        PolyDriver ddnws;
+
+        Property pcfg;
+        pcfg.fromString("(device frameTransformServer_nws_ros2) (GENERAL (cache_time 0))");
+        CHECK_FALSE(ddnws.open(pcfg));
+    }
+
+    Network::setLocalMode(false);
+}
@@ -0,0 +1,318 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include "Localization2D_nwc_ros2.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <cmath>
+#include <OdometryConversion.h>
+#include <Ros2Utils.h>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::dev::Nav2D;
+
+YARP_LOG_COMPONENT(LOCALIZATION2D_NWC_ROS2, "yarp.ros2.localization2D_nwc_ros2", yarp::os::Log::TraceType);
+
+namespace {
+constexpr double RAD2DEG = 180.0 / M_PI;
+constexpr double DEG2RAD = M_PI / 180.0;
+
+// The indexes of x, y and yaw in the 6x6 covariance of ROS2
+constexpr size_t covIndexes[3] = {0, 1, 5};
+
+// The default covariance of the initial pose, the same of rviz
+constexpr double defaultInitialCov[3] = {0.25, 0.25, 0.06853891945200942};
+
+double yawFromQuaternion(const geometry_msgs::msg::Quaternion& q)
+{
+    return std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+}
+
+bool checkTopicName(const std::string& name, const char* param)
+{
+    if (name.c_str()[0] != '/') {
+        yCError(LOCALIZATION2D_NWC_ROS2) << "Missing '/' in" << param << "parameter";
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+bool Localization2D_nwc_ros2::open(yarp::os::Searchable& config)
+{
+    // node_name check
+    if (!config.check("node_name")) {
+        yCError(LOCALIZATION2D_NWC_ROS2) << "missing node_name parameter";
+        return false;
+    }
+    m_node_name = config.find("node_name").asString();
+
+    // topic_name check
+    if (!config.check("topic_name")) {
+        yCError(LOCALIZATION2D_NWC_ROS2) << "missing topic_name parameter";
+        return false;
+    }
+    m_topic_name = config.find("topic_name").asString();
+    if (!checkTopicName(m_topic_name, "topic_name")) {
+        return false;
+    }
+
+    if (config.check("odometry_topic")) {
+        m_odometryTopic = config.find("odometry_topic").asString();
+        if (!checkTopicName(m_odometryTopic, "odometry_topic")) {
+            return false;
+        }
+    }
+    if (config.check("initial_pose_topic")) {
+        m_initialPoseTopic = config.find("initial_pose_topic").asString();
+        if (!checkTopicName(m_initialPoseTopic, "initial_pose_topic")) {
+            return false;
+        }
+    }
+    if (config.check("map_name")) {
+        m_mapName = config.find("map_name").asString();
+    }
+    if (config.check("map_frame")) {
+        m_mapFrame = config.find("map_frame").asString();
+    }
+    m_historyLength = config.check("history_length", Value(1.0)).asFloat64();
+    if (m_historyLength <= 0) {
+        yCError(LOCALIZATION2D_NWC_ROS2) << "history_length must be positive";
+        return false;
+    }
+
+    m_node = NodeCreator::createNode(m_node_name);
+    m_poseSubscriber = std::make_unique<Ros2Subscriber<Localization2D_nwc_ros2, geometry_msgs::msg::PoseWithCovarianceStamped>>(m_node, this);
+    m_poseSubscriber->subscribe_to_topic(m_topic_name);
+    if (!m_odometryTopic.empty()) {
+        m_odometrySubscriber = std::make_unique<Ros2Subscriber<Localization2D_nwc_ros2, nav_msgs::msg::Odometry>>(m_node, this);
+        m_odometrySubscriber->subscribe_to_topic(m_odometryTopic);
+        m_history = std::make_unique<OdometryHistory>(m_historyLength);
+    }
+    m_initialPosePublisher = m_node->create_publisher<geometry_msgs::msg::PoseWithCovarianceStamped>(m_initialPoseTopic, rclcpp::QoS(10));
+
+    m_spinner = std::make_unique<Ros2Spinner>(m_node);
+    m_spinner->start();
+
+    yCInfo(LOCALIZATION2D_NWC_ROS2) << "opened";
+
+    return true;
+}
+
+bool Localization2D_nwc_ros2::close()
+{
+    yCInfo(LOCALIZATION2D_NWC_ROS2, "closing...");
+    m_spinner.reset();
+    yCInfo(LOCALIZATION2D_NWC_ROS2, "closed");
+    return true;
+}
+
+void Localization2D_nwc_ros2::callback(geometry_msgs::msg::PoseWithCovarianceStamped::SharedPtr msg, std::string topic)
+{
+    YARP_UNUSED(topic);
+    yCTrace(LOCALIZATION2D_NWC_ROS2, "callback PoseWithCovarianceStamped");
+
+    PoseSample sample;
+    sample.pose.x = msg->pose.pose.position.x;
+    sample.pose.y = msg->pose.pose.position.y;
+    sample.pose.theta = yawFromQuaternion(msg->pose.pose.orientation);
+    for (size_t r = 0; r < 3; r++) {
+        for (size_t c = 0; c < 3; c++) {
+            sample.covariance[r * 3 + c] = msg->pose.covariance[covIndexes[r] * 6 + covIndexes[c]];
+        }
+    }
+
+    // The correction is computed before the pose is stored, so that a reader never moves a
+    // new pose by an old correction. The pose is estimated from the sensors at the time of its
+    // stamp, so it is compared to the odometry at that time, not to the one received meanwhile.
+    OdometrySample odom;
+    if (m_odometrySubscriber && getOdometryAt(yarpTimeFromRos2(msg->header.stamp), odom)) {
+        Pose2D correction;
+        correction.theta = sample.pose.theta - odom.theta * DEG2RAD;
+        const double cosTheta = std::cos(correction.theta);
+        const double sinTheta = std::sin(correction.theta);
+        correction.x = sample.pose.x - (cosTheta * odom.x - sinTheta * odom.y);
+        correction.y = sample.pose.y - (sinTheta * odom.x + cosTheta * odom.y);
+        m_correction.store(correction);
+    }
+    m_pose.store(sample);
+}
+
+void Localization2D_nwc_ros2::callback(nav_msgs::msg::Odometry::SharedPtr msg, std::string topic)
+{
+    YARP_UNUSED(topic);
+    yCTrace(LOCALIZATION2D_NWC_ROS2, "callback Odometry");
+
+    const OdometrySample sample = odometrySampleFromRos2(*msg);
+    m_odometry.store(sample);
+
+    std::lock_guard<std::mutex> lock(m_historyMutex);
+    m_history->add(sample);
+}
+
+bool Localization2D_nwc_ros2::getOdometryAt(double time, OdometrySample& sample)
+{
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        if (m_history->get(time, sample, error)) {
+            return true;
+        }
+    }
+    // A pose newer than the odometry is compared to the latest one, which is the closest
+    if (!m_odometry.load(sample)) {
+        return false;
+    }
+    if (time < sample.timestamp) {
+        yCWarningThrottle(LOCALIZATION2D_NWC_ROS2, 5.0) << "The pose is older than the odometry history, it is compared to the latest odometry:" << error;
+    }
+    return true;
+}
+
+bool Localization2D_nwc_ros2::getCurrentPose(Pose2D& pose, PoseSample* sample)
+{
+    PoseSample latest;
+    if (!m_pose.load(latest)) {
+        yCErrorThrottle(LOCALIZATION2D_NWC_ROS2, 5.0) << "No pose received yet";
+        return false;
+    }
+    if (sample) {
+        *sample = latest;
+    }
+
+    Pose2D correction;
+    OdometrySample odom;
+    if (m_correction.load(correction) && m_odometry.load(odom)) {
+        const double cosTheta = std::cos(correction.theta);
+        const double sinTheta = std::sin(correction.theta);
+        pose.x = correction.x + cosTheta * odom.x - sinTheta * odom.y;
+        pose.y = correction.y + sinTheta * odom.x + cosTheta * odom.y;
+        pose.theta = std::remainder(correction.theta + odom.theta * DEG2RAD, 2.0 * M_PI);
+    } else {
+        pose = latest.pose;
+    }
+    return true;
+}
+
+bool Localization2D_nwc_ros2::getLocalizationStatus(LocalizationStatusEnum& status)
+{
+    status = m_pose.empty() ? LocalizationStatusEnum::localization_status_not_yet_localized
+                            : LocalizationStatusEnum::localization_status_localized_ok;
+    return true;
+}
+
+bool Localization2D_nwc_ros2::getEstimatedPoses(std::vector<Map2DLocation>& poses)
+{
+    // Only the most likely pose is published
+    poses.clear();
+    Map2DLocation loc;
+    if (!getCurrentPosition(loc)) {
+        return false;
+    }
+    poses.push_back(loc);
+    return true;
+}
+
+bool Localization2D_nwc_ros2::getCurrentPosition(Map2DLocation& loc)
+{
+    Pose2D pose;
+    if (!getCurrentPose(pose, nullptr)) {
+        return false;
+    }
+    loc = Map2DLocation(m_mapName, pose.x, pose.y, pose.theta * RAD2DEG);
+    return true;
+}
+
+bool Localization2D_nwc_ros2::getCurrentPosition(Map2DLocation& loc, yarp::sig::Matrix& cov)
+{
+    Pose2D pose;
+    PoseSample sample;
+    if (!getCurrentPose(pose, &sample)) {
+        return false;
+    }
+    loc = Map2DLocation(m_mapName, pose.x, pose.y, pose.theta * RAD2DEG);
+    cov.resize(3, 3);
+    for (size_t r = 0; r < 3; r++) {
+        for (size_t c = 0; c < 3; c++) {
+            cov[r][c] = sample.covariance[r * 3 + c];
+        }
+    }
+    return true;
+}
+
+bool Localization2D_nwc_ros2::getEstimatedOdometry(OdometryData& odom)
+{
+    OdometrySample sample;
+    if (!m_odometrySubscriber) {
+        yCError(LOCALIZATION2D_NWC_ROS2) << "getEstimatedOdometry requires the odometry_topic parameter";
+        return false;
+    }
+    if (!m_odometry.load(sample)) {
+        yCErrorThrottle(LOCALIZATION2D_NWC_ROS2, 5.0) << "No odometry received yet";
+        return false;
+    }
+    toOdometryData(sample, odom);
+    return true;
+}
+
+bool Localization2D_nwc_ros2::setInitialPose(const Map2DLocation& loc)
+{
+    yarp::sig::Matrix cov(3, 3);
+    cov.zero();
+    for (size_t i = 0; i < 3; i++) {
+        cov[i][i] = defaultInitialCov[i];
+    }
+    return setInitialPose(loc, cov);
+}
+
+bool Localization2D_nwc_ros2::setInitialPose(const Map2DLocation& loc, const yarp::sig::Matrix& cov)
+{
+    if (cov.rows() != 3 || cov.cols() != 3) {
+        yCError(LOCALIZATION2D_NWC_ROS2) << "The covariance must be a 3x3 matrix";
+        return false;
+    }
+    if (loc.map_id != m_mapName) {
+        yCError(LOCALIZATION2D_NWC_ROS2) << "The initial pose is on map" << loc.map_id << ", but the localization runs on map" << m_mapName;
+        return false;
+    }
+
+    geometry_msgs::msg::PoseWithCovarianceStamped msg;
+    msg.header.frame_id = m_mapFrame;
+    msg.header.stamp = m_node->get_clock()->now();
+    msg.pose.pose.position.x = loc.x;
+    msg.pose.pose.position.y = loc.y;
+    msg.pose.pose.position.z = 0;
+    msg.pose.pose.orientation.x = 0;
+    msg.pose.pose.orientation.y = 0;
+    msg.pose.pose.orientation.z = std::sin(loc.theta * DEG2RAD / 2.0);
+    msg.pose.pose.orientation.w = std::cos(loc.theta * DEG2RAD / 2.0);
+    msg.pose.covariance.fill(0);
+    for (size_t r = 0; r < 3; r++) {
+        for (size_t c = 0; c < 3; c++) {
+            msg.pose.covariance[covIndexes[r] * 6 + covIndexes[c]] = cov[r][c];
+        }
+    }
+    m_initialPosePublisher->publish(msg);
+    return true;
+}
+
+bool Localization2D_nwc_ros2::startLocalizationService()
+{
+    yCError(LOCALIZATION2D_NWC_ROS2) << "startLocalizationService is not supported, the localization runs in ROS2";
+    return false;
+}
+
+bool Localization2D_nwc_ros2::stopLocalizationService()
+{
+    yCError(LOCALIZATION2D_NWC_ROS2) << "stopLocalizationService is not supported, the localization runs in ROS2";
+    return false;
+}
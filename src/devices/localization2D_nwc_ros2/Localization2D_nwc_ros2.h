@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_LOCALIZATION2D_NWC_ROS2_H
+#define YARP_ROS2_LOCALIZATION2D_NWC_ROS2_H
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/ILocalization2D.h>
+#include <yarp/dev/OdometryData.h>
+#include <yarp/sig/Matrix.h>
+#include <OdometryHistory.h>
+#include <Ros2Spinner.h>
+#include <Ros2Subscriber.h>
+#include <SeqLock.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <geometry_msgs/msg/pose_with_covariance_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ *  @ingroup dev_impl_nwc_ros2 dev_impl_navigation
+ *
+ * \brief `Localization2D_nwc_ros2`: A network client that receives the pose of a mobile base estimated by a ROS2 localization (e.g. AMCL), and exposes it as ILocalization2D
+ *
+ * | Parameter name     | SubParameter   | Type    | Units          | Default Value    | Required | Description                                                        | Notes |
+ * |:------------------:|:--------------:|:-------:|:--------------:|:----------------:|:--------:|:------------------------------------------------------------------:|:-----:|
+ * | node_name          |      -         | string  | -              |   -              | Yes      | The name of the ROS node opened by this device                     | |
+ * | topic_name         |      -         | string  | -              |   -              | Yes      | The geometry_msgs/PoseWithCovarianceStamped topic of the pose      | MUST start with a '/' character, e.g. /amcl_pose |
+ * | odometry_topic     |      -         | string  | -              |   -              | No       | The nav_msgs/Odometry topic of the base                            | MUST start with a '/' character |
+ * | initial_pose_topic |      -         | string  | -              | /initialpose     | No       | The topic where setInitialPose() publishes the pose                | MUST start with a '/' character |
+ * | map_name           |      -         | string  | -              | map              | No       | The map_id of the returned locations                               | |
+ * | map_frame          |      -         | string  | -              | map              | No       | The frame_id of the initial pose                                   | |
+ * | history_length     |      -         | double  | s              | 1.0              | No       | How long the odometry is kept to pair it with the poses            | Only with odometry_topic |
+ *
+ * A localization like AMCL publishes the pose only when it is updated, and meanwhile provides
+ * the pose through the transform from the map frame to the odometry frame. When odometry_topic
+ * is set, the device reproduces that transform: every pose received is compared to the odometry
+ * at the time of the pose, interpolated between the odometry received in the last history_length
+ * seconds, and the current position is the latest odometry moved by this correction, so it
+ * follows the base between the updates of the pose. If the time of the pose is not in the
+ * history, the pose is compared to the latest odometry. Without odometry_topic, the current
+ * position is the latest pose received and getEstimatedOdometry() fails.
+ *
+ * The latest pose, odometry and correction are kept in SeqLocks, so the getters never take a
+ * lock and never delay the reception of the messages.
+ *
+ * The covariance is the 3x3 block of x, y and yaw of the ROS2 covariance, in m^2 and rad^2.
+ * The localization runs in ROS2, so startLocalizationService() and stopLocalizationService()
+ * are not supported.
+ */
+class Localization2D_nwc_ros2 :
+        public yarp::dev::DeviceDriver,
+        public yarp::dev::Nav2D::ILocalization2D
+{
+public:
+    Localization2D_nwc_ros2() = default;
+    Localization2D_nwc_ros2(const Localization2D_nwc_ros2&) = delete;
+    Localization2D_nwc_ros2(Localization2D_nwc_ros2&&) noexcept = delete;
+    Localization2D_nwc_ros2& operator=(const Localization2D_nwc_ros2&) = delete;
+    Localization2D_nwc_ros2& operator=(Localization2D_nwc_ros2&&) noexcept = delete;
+    ~Localization2D_nwc_ros2() override = default;
+
+    // DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    // ROS2 Topic Callbacks
+    void callback(geometry_msgs::msg::PoseWithCovarianceStamped::SharedPtr msg, std::string topic);
+    void callback(nav_msgs::msg::Odometry::SharedPtr msg, std::string topic);
+
+    // ILocalization2D
+    bool getLocalizationStatus(yarp::dev::Nav2D::LocalizationStatusEnum& status) override;
+    bool getEstimatedPoses(std::vector<yarp::dev::Nav2D::Map2DLocation>& poses) override;
+    bool getCurrentPosition(yarp::dev::Nav2D::Map2DLocation& loc) override;
+    bool getCurrentPosition(yarp::dev::Nav2D::Map2DLocation& loc, yarp::sig::Matrix& cov) override;
+    bool getEstimatedOdometry(yarp::dev::OdometryData& odom) override;
+    bool setInitialPose(const yarp::dev::Nav2D::Map2DLocation& loc) override;
+    bool setInitialPose(const yarp::dev::Nav2D::Map2DLocation& loc, const yarp::sig::Matrix& cov) override;
+    bool startLocalizationService() override;
+    bool stopLocalizationService() override;
+
+private:
+    // A planar pose, in meters and radians
+    struct Pose2D
+    {
+        double x;
+        double y;
+        double theta;
+    };
+
+    struct PoseSample
+    {
+        Pose2D pose;
+        // x, y and yaw, row major
+        double covariance[9];
+    };
+
+    bool getCurrentPose(Pose2D& pose, PoseSample* sample);
+    bool getOdometryAt(double time, OdometrySample& sample);
+
+    std::string m_node_name;
+    std::string m_topic_name;
+    std::string m_odometryTopic;
+    std::string m_initialPoseTopic{"/initialpose"};
+    std::string m_mapName{"map"};
+    std::string m_mapFrame{"map"};
+    rclcpp::Node::SharedPtr m_node;
+    std::unique_ptr<Ros2Subscriber<Localization2D_nwc_ros2, geometry_msgs::msg::PoseWithCovarianceStamped>> m_poseSubscriber;
+    std::unique_ptr<Ros2Subscriber<Localization2D_nwc_ros2, nav_msgs::msg::Odometry>> m_odometrySubscriber;
+    rclcpp::Publisher<geometry_msgs::msg::PoseWithCovarianceStamped>::SharedPtr m_initialPosePublisher;
+    std::unique_ptr<Ros2Spinner> m_spinner;
+
+    // Written by the callbacks only
+    SeqLock<PoseSample> m_pose;
+    SeqLock<OdometrySample> m_odometry;
+    // From the odometry frame to the map frame, computed when a pose is received
+    SeqLock<Pose2D> m_correction;
+
+    double m_historyLength{1.0};
+    std::mutex m_historyMutex;
+    std::unique_ptr<OdometryHistory> m_history;
+};
+
+#endif // YARP_ROS2_LOCALIZATION2D_NWC_ROS2_H
@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/dev/ILocalization2D.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <string>
+
+using namespace yarp::dev;
+using namespace yarp::dev::Nav2D;
+using namespace yarp::os;
+
+namespace {
+// Publishes the odometry of a base at (x, 0) looking along x
+void publishOdometry(int sec, double x)
+{
+    const std::string cmd = "ros2 topic pub --once /localization2D_nwc_odom nav_msgs/msg/Odometry \"{header: {stamp: {sec: " + std::to_string(sec) + "}, "
+                            "frame_id: 'odom'}, child_frame_id: 'base_link', pose: {pose: {position: {x: " + std::to_string(x) + "}, orientation: {w: 1.0}}}, "
+                            "twist: {twist: {linear: {x: 1.0}}}}\"";
+    system(cmd.c_str());
+}
+} // namespace
+
+TEST_CASE("dev::localization2D_nwc_ros2_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("localization2D_nwc_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    SECTION("Checking the nwc alone")
+    {
+        PolyDriver ddnwc;
+
+        ////////"Checking opening nwc"
+        {
+            Property pcfg;
+            pcfg.put("device", "localization2D_nwc_ros2");
+            pcfg.put("node_name", "localization2D_nwc");
+            pcfg.put("topic_name", "/localization2D_nwc_pose");
+            REQUIRE(ddnwc.open(pcfg));
+        }
+
+        //"Close all polydrivers and check"
+        {
+            CHECK(ddnwc.close());
+        }
+    }
+
+    SECTION("Checking the nwc before receiving the pose")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device localization2D_nwc_ros2) (node_name localization2D_nwc) (topic_name /localization2D_nwc_pose) "
+                        "(odometry_topic /localization2D_nwc_odom) (initial_pose_topic /localization2D_nwc_initialpose) (map_name test_map)");
+        REQUIRE(ddnwc.open(pcfg));
+
+        ILocalization2D* iloc = nullptr;
+        REQUIRE(ddnwc.view(iloc));
+
+        LocalizationStatusEnum status = LocalizationStatusEnum::localization_status_localized_ok;
+        CHECK(iloc->getLocalizationStatus(status));
+        CHECK(status == LocalizationStatusEnum::localization_status_not_yet_localized);
+
+        Map2DLocation loc;
+        std::vector<Map2DLocation> poses;
+        OdometryData odom;
+        CHECK_FALSE(iloc->getCurrentPosition(loc));
+        CHECK_FALSE(iloc->getEstimatedPoses(poses));
+        CHECK_FALSE(iloc->getEstimatedOdometry(odom));
+        CHECK_FALSE(iloc->startLocalizationService());
+        CHECK_FALSE(iloc->stopLocalizationService());
+
+        CHECK(iloc->setInitialPose(Map2DLocation("test_map", 1.0, 2.0, 90.0)));
+        CHECK_FALSE(iloc->setInitialPose(Map2DLocation("other_map", 1.0, 2.0, 90.0)));
+        yarp::sig::Matrix cov(2, 2);
+        CHECK_FALSE(iloc->setInitialPose(Map2DLocation("test_map", 1.0, 2.0, 90.0), cov));
+
+        CHECK(ddnwc.close());
+    }
+
+    SECTION("Checking the nwc receiving the pose and the odometry")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device localization2D_nwc_ros2) (node_name localization2D_nwc) (topic_name /localization2D_nwc_pose) "
+                        "(odometry_topic /localization2D_nwc_odom) (map_name test_map) (history_length 5.0)");
+        REQUIRE(ddnwc.open(pcfg));
+
+        ILocalization2D* iloc = nullptr;
+        REQUIRE(ddnwc.view(iloc));
+
+        // The base moves along x by 1 m/s in the odometry frame
+        publishOdometry(10, 0.0);
+        publishOdometry(11, 1.0);
+        OdometryData odom;
+        REQUIRE(waitFor([&] { return iloc->getEstimatedOdometry(odom) && odom.odom_x > 0.5; }));
+        CHECK(odom.odom_x == Catch::Approx(1.0).epsilon(0).margin(1e-9));
+        CHECK(odom.odom_theta == Catch::Approx(0.0).epsilon(0).margin(1e-9));
+        CHECK(odom.base_vel_x == Catch::Approx(1.0).epsilon(0).margin(1e-9));
+        CHECK(odom.odom_vel_x == Catch::Approx(1.0).epsilon(0).margin(1e-9));
+
+        // At 10.5 s, when the odometry was at (0.5, 0), the base was at (5, 5) in the map, turned by 90 degrees
+        system("ros2 topic pub --once /localization2D_nwc_pose geometry_msgs/msg/PoseWithCovarianceStamped \"{header: {stamp: {sec: 10, nanosec: 500000000}, "
+               "frame_id: 'map'}, pose: {pose: {position: {x: 5.0, y: 5.0}, orientation: {z: 0.7071067811865476, w: 0.7071067811865476}}, "
+               "covariance: [0.1, 0.0, 0.0, 0.0, 0.0, 0.05, 0.0, 0.2, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, "
+               "0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.05, 0.0, 0.0, 0.0, 0.0, 0.3]}}\"");
+
+        Map2DLocation loc;
+        yarp::sig::Matrix cov;
+        REQUIRE(waitFor([&] { return iloc->getCurrentPosition(loc, cov); }));
+        LocalizationStatusEnum status = LocalizationStatusEnum::localization_status_not_yet_localized;
+        CHECK(iloc->getLocalizationStatus(status));
+        CHECK(status == LocalizationStatusEnum::localization_status_localized_ok);
+
+        // The odometry moved by 0.5 m since the pose, that is along y in the map
+        CHECK(loc.map_id == "test_map");
+        CHECK(loc.x == Catch::Approx(5.0).epsilon(0).margin(1e-6));
+        CHECK(loc.y == Catch::Approx(5.5).epsilon(0).margin(1e-6));
+        CHECK(loc.theta == Catch::Approx(90.0).epsilon(0).margin(1e-6));
+        REQUIRE(cov.rows() == 3);
+        REQUIRE(cov.cols() == 3);
+        CHECK(cov[0][0] == Catch::Approx(0.1));
+        CHECK(cov[1][1] == Catch::Approx(0.2));
+        CHECK(cov[2][2] == Catch::Approx(0.3));
+        CHECK(cov[0][2] == Catch::Approx(0.05));
+        CHECK(cov[2][0] == Catch::Approx(0.05));
+
+        // The position follows the odometry until the next pose
+        publishOdometry(12, 2.0);
+        REQUIRE(waitFor([&] { return iloc->getCurrentPosition(loc) && loc.y > 6.0; }));
+        CHECK(loc.x == Catch::Approx(5.0).epsilon(0).margin(1e-6));
+        CHECK(loc.y == Catch::Approx(6.5).epsilon(0).margin(1e-6));
+        CHECK(loc.theta == Catch::Approx(90.0).epsilon(0).margin(1e-6));
+
+        std::vector<Map2DLocation> poses;
+        CHECK(iloc->getEstimatedPoses(poses));
+        REQUIRE(poses.size() == 1);
+        CHECK(poses[0].y == Catch::Approx(6.5).epsilon(0).margin(1e-6));
+
+        CHECK(ddnwc.close());
+    }
+
+    SECTION("Checking invalid parameters")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device localization2D_nwc_ros2) (node_name localization2D_nwc) (topic_name /localization2D_nwc_pose) (odometry_topic odom)");
+        CHECK_FALSE(ddnwc.open(pcfg));
+
+        PolyDriver ddhistory;
+        Property phistory;
+        phistory.fromString("(device localization2D_nwc_ros2) (node_name localization2D_nwc) (topic_name /localization2D_nwc_pose) "
+                            "(odometry_topic /localization2D_nwc_odom) (history_length 0.0)");
+        CHECK_FALSE(ddhistory.open(phistory));
+    }
+
+    Network::setLocalMode(false);
+}
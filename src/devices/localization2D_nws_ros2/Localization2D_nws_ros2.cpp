@@ -49,6 +49,10 @@ bool Localization2D_nws_ros2::attach(yarp::dev::PolyDriver* poly)
 
 bool Localization2D_nws_ros2::detach()
 {
+    if (m_clockDriver)
+    {
+        m_clockDriver->stop();
+    }
     if (PeriodicThread::isRunning())
     {
         PeriodicThread::stop();
@@ -101,8 +105,8 @@ void Localization2D_nws_ros2::run()
             yCWarning(LOCALIZATION2D_NWS_ROS2, "The system is not properly localized!");
         }
 
-        if (1) publish_odometry_on_ROS_topic();
-        if (1) publish_odometry_on_TF_topic();
+        if (m_publishOdom) publish_odometry_on_ROS_topic();
+        if (m_publishTf) publish_odometry_on_TF_topic();
     }
 }
 
@@ -145,6 +149,8 @@ bool Localization2D_nws_ros2::open(yarp::os::Searchable &config)
         return false;
     }
     m_period   = config.check("period", yarp::os::Value(0.010), "Period of the thread").asFloat64();
+    m_publishOdom = config.check("publish_odom", yarp::os::Value(true), "Publish the odometry topic").asBool();
+    m_publishTf   = config.check("publish_tf", yarp::os::Value(true), "Publish the odometry transform on /tf").asBool();
 
     //create the topics
     const std::string m_odom_topic ="/odom";
@@ -155,16 +161,53 @@ bool Localization2D_nws_ros2::open(yarp::os::Searchable &config)
     m_publisher_tf   = m_node->create_publisher<tf2_msgs::msg::TFMessage>(m_tf_topic, 10);
     yCInfo(LOCALIZATION2D_NWS_ROS2, "Opened topics: %s, %s", m_odom_topic.c_str(), m_tf_topic.c_str());
 
+    m_clockDriver = std::make_unique<Ros2ClockDriver>(m_node, [this]() { run(); });
+    if (!m_clockDriver->configure(config))
+    {
+        return false;
+    }
+
+    m_parameters = std::make_unique<Ros2Parameters>(m_node);
+    bool ok = m_parameters->addDouble("period", m_period, [this](double period) {
+        if (period <= 0) {
+            return false;
+        }
+        m_period = period;
+        m_clockDriver->setPeriod(m_period);
+        return setPeriod(m_period);
+    });
+    ok &= m_parameters->addBool("publish_odom", m_publishOdom, [this](bool enable) {
+        m_publishOdom = enable;
+        return true;
+    });
+    ok &= m_parameters->addBool("publish_tf", m_publishTf, [this](bool enable) {
+        m_publishTf = enable;
+        return true;
+    });
+    if (!ok || !m_parameters->start()) {
+        yCError(LOCALIZATION2D_NWS_ROS2) << "Unable to initialize the ROS 2 parameters";
+        return false;
+    }
+
     yCInfo(LOCALIZATION2D_NWS_ROS2) << "Waiting for device to attach";
 
     //start the publishig thread
     setPeriod(m_period);
+    m_clockDriver->setPeriod(m_period);
+    if (m_clockDriver->enabled())
+    {
+        return m_clockDriver->start();
+    }
     start();
     return true;
 }
 
 bool Localization2D_nws_ros2::close()
 {
+    if (m_parameters)
+    {
+        m_parameters->stop();
+    }
     detach();
     return true;
 }
@@ -176,7 +219,7 @@ void Localization2D_nws_ros2::publish_odometry_on_TF_topic()
     geometry_msgs::msg::TransformStamped tsData;
     tsData.child_frame_id = m_child_frame_id;
     tsData.header.frame_id = m_parent_frame_id;
-    tsData.header.stamp = m_node->get_clock()->now();   //@@@@@@@@@@@ CHECK HERE: simulation time?
+    tsData.header.stamp = m_node->get_clock()->now(); // simulated time with clock_source ros
     double halfYaw = m_current_odometry.odom_theta / 180.0 * M_PI * 0.5;
     double cosYaw = cos(halfYaw);
     double sinYaw = sin(halfYaw);
@@ -205,7 +248,7 @@ void Localization2D_nws_ros2::publish_odometry_on_ROS_topic()
     nav_msgs::msg::Odometry rosData;
 
     rosData.header.frame_id = m_fixed_frame;
-    rosData.header.stamp = m_node->get_clock()->now();   //@@@@@@@@@@@ CHECK HERE: simulation time?
+    rosData.header.stamp = m_node->get_clock()->now(); // simulated time with clock_source ros
     rosData.child_frame_id = m_robot_frame;
 
     rosData.pose.pose.position.x = m_current_odometry.odom_x;
@@ -16,7 +16,11 @@
 #include <tf2_msgs/msg/tf_message.hpp>
 #include <nav_msgs/msg/odometry.hpp>
 #include <yarp/math/Math.h>
+#include <Ros2Parameters.h>
+#include <Ros2ClockDriver.h>
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 /**
@@ -26,6 +30,12 @@
  *
  *  Documentation to be added
  *
+ *  `period`, `publish_odom` and `publish_tf` are declared as ROS 2 parameters of the node
+ *  and can be changed at runtime with `ros2 param set`.
+ *
+ *  With `clock_source` set to `ros` the device publishes once per period of the simulated time,
+ *  see Ros2ClockDriver for the `clock_*` parameters.
+ *
  */
 class Localization2D_nws_ros2 :
         public yarp::dev::DeviceDriver,
@@ -60,6 +70,8 @@ private:
     rclcpp::Node::SharedPtr m_node;
     rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr   m_publisher_odom;
     rclcpp::Publisher<tf2_msgs::msg::TFMessage>::SharedPtr  m_publisher_tf;
+    std::unique_ptr<Ros2Parameters> m_parameters;
+    std::unique_ptr<Ros2ClockDriver> m_clockDriver;
     bool m_isDeviceOwned = false;
 
     std::string m_nodeName;
@@ -71,6 +83,8 @@ private:
 
     double                                  m_stats_time_last;
     double                                  m_period;
+    std::atomic<bool>                       m_publishOdom{true};
+    std::atomic<bool>                       m_publishTf{true};
     yarp::os::Stamp                         m_loc_stamp;
     yarp::os::Stamp                         m_odom_stamp;
 
@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Map2DCompression.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <cstring>
+
+namespace {
+YARP_LOG_COMPONENT(MAP2D_COMPRESSION, "yarp.ros2.Map2DCompression")
+}
+
+void map2DEncodeRle(const int8_t* cells, size_t count, std::vector<uint8_t>& out)
+{
+    out.clear();
+    size_t i = 0;
+    while (i < count) {
+        int8_t value = cells[i];
+        size_t run = 1;
+        while (i + run < count && cells[i + run] == value) {
+            run++;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+        size_t length = run;
+        do {
+            uint8_t byte = length & 0x7F;
+            length >>= 7;
+            out.push_back(length ? (byte | 0x80) : byte);
+        } while (length);
+        i += run;
+    }
+}
+
+bool map2DDecodeRle(const uint8_t* data, size_t size, int8_t* cells, size_t count)
+{
+    size_t pos = 0;
+    size_t decoded = 0;
+    while (pos < size) {
+        int8_t value = static_cast<int8_t>(data[pos++]);
+        uint64_t run = 0;
+        unsigned int shift = 0;
+        while (true) {
+            if (pos >= size || shift > 63) {
+                return false;
+            }
+            uint8_t byte = data[pos++];
+            run |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            shift += 7;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        if (run > count - decoded) {
+            return false;
+        }
+        std::memset(cells + decoded, value, run);
+        decoded += run;
+    }
+    return decoded == count;
+}
+
+bool map2DDecompress(const map2d_nws_ros2_msgs::msg::CompressedOccupancyGrid& in, nav_msgs::msg::OccupancyGrid& out)
+{
+    if (in.encoding != "rle") {
+        yCError(MAP2D_COMPRESSION) << "Unsupported map encoding" << in.encoding;
+        return false;
+    }
+    out.header = in.header;
+    out.info = in.info;
+    out.data.resize(static_cast<size_t>(in.info.width) * in.info.height);
+    if (!map2DDecodeRle(in.data.data(), in.data.size(), out.data.data(), out.data.size())) {
+        yCError(MAP2D_COMPRESSION) << "Malformed compressed map";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_DEV_MAP2D_COMPRESSION_H
+#define YARP_DEV_MAP2D_COMPRESSION_H
+
+#include <nav_msgs/msg/occupancy_grid.hpp>
+#include <map2d_nws_ros2_msgs/msg/compressed_occupancy_grid.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Run length encoding of the cells of a map, as described in CompressedOccupancyGrid.msg.
+ * Occupancy grids are mostly made of long runs of unknown or free cells, so they usually
+ * shrink by two orders of magnitude.
+ */
+void map2DEncodeRle(const int8_t* cells, size_t count, std::vector<uint8_t>& out);
+
+/**
+ * Decodes exactly `count` cells, returns false if the data is malformed or has a different size.
+ */
+bool map2DDecodeRle(const uint8_t* data, size_t size, int8_t* cells, size_t count);
+
+/**
+ * Decodes a map received from the GetCompressedMapByName service or from the compressed map topic.
+ */
+bool map2DDecompress(const map2d_nws_ros2_msgs::msg::CompressedOccupancyGrid& in, nav_msgs::msg::OccupancyGrid& out);
+
+#endif // YARP_DEV_MAP2D_COMPRESSION_H
@@ -0,0 +1,241 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Map2DSharedMemory.h"
+
+#include <yarp/conf/compiler.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+YARP_LOG_COMPONENT(MAP2D_SHARED_MEMORY, "yarp.ros2.Map2DSharedMemory")
+
+constexpr char magic[8] = {'Y', 'M', 'A', 'P', '2', 'D', 0, 0};
+constexpr uint32_t layout = 1;
+constexpr size_t versionsKept = 2;
+
+// The data starts on a cache line
+constexpr uint64_t dataOffset = (sizeof(Map2DSharedMemoryHeader) + 63) / 64 * 64;
+
+std::string sanitize(const std::string& name)
+{
+    std::string out = name;
+    for (auto& c : out) {
+        if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-') {
+            c = '_';
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+Map2DSharedMemoryWriter::Map2DSharedMemoryWriter(const std::string& prefix) :
+        m_prefix("/" + sanitize(prefix))
+{
+}
+
+Map2DSharedMemoryWriter::~Map2DSharedMemoryWriter()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& map : m_segments) {
+        for (auto& segment : map.second) {
+            release(segment);
+        }
+    }
+    m_segments.clear();
+}
+
+bool Map2DSharedMemoryWriter::supported()
+{
+#if defined(_WIN32)
+    return false;
+#else
+    return true;
+#endif
+}
+
+#if defined(_WIN32)
+
+bool Map2DSharedMemoryWriter::write(const std::string& mapName,
+                                    const Map2DSharedMemoryHeader& header,
+                                    const std::function<void(int8_t*)>& fill,
+                                    Handle& handle)
+{
+    YARP_UNUSED(mapName);
+    YARP_UNUSED(header);
+    YARP_UNUSED(fill);
+    YARP_UNUSED(handle);
+    yCError(MAP2D_SHARED_MEMORY) << "Shared memory maps are not supported on this platform";
+    return false;
+}
+
+void Map2DSharedMemoryWriter::release(Segment& segment)
+{
+    YARP_UNUSED(segment);
+}
+
+Map2DSharedMemoryReader::~Map2DSharedMemoryReader() = default;
+
+bool Map2DSharedMemoryReader::open(const std::string& name, uint64_t version)
+{
+    YARP_UNUSED(name);
+    YARP_UNUSED(version);
+    yCError(MAP2D_SHARED_MEMORY) << "Shared memory maps are not supported on this platform";
+    return false;
+}
+
+void Map2DSharedMemoryReader::close()
+{
+}
+
+#else
+
+bool Map2DSharedMemoryWriter::write(const std::string& mapName,
+                                    const Map2DSharedMemoryHeader& header,
+                                    const std::function<void(int8_t*)>& fill,
+                                    Handle& handle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Segment segment;
+    segment.handle.version = m_lastVersion + 1;
+    segment.handle.name = m_prefix + "." + sanitize(mapName) + "." + std::to_string(segment.handle.version);
+    segment.handle.data_offset = dataOffset;
+    uint64_t dataSize = static_cast<uint64_t>(header.width) * header.height;
+    segment.handle.size = dataOffset + dataSize;
+
+    // Read-only for everybody else, the permissions are not checked for the creator
+    int fd = shm_open(segment.handle.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0444);
+    if (fd < 0 && errno == EEXIST) {
+        // Left behind by a previous run that did not close
+        shm_unlink(segment.handle.name.c_str());
+        fd = shm_open(segment.handle.name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0444);
+    }
+    if (fd < 0) {
+        yCError(MAP2D_SHARED_MEMORY) << "Unable to create" << segment.handle.name << ":" << strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(segment.handle.size)) != 0) {
+        yCError(MAP2D_SHARED_MEMORY) << "Unable to resize" << segment.handle.name << ":" << strerror(errno);
+        ::close(fd);
+        shm_unlink(segment.handle.name.c_str());
+        return false;
+    }
+    segment.address = mmap(nullptr, segment.handle.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (segment.address == MAP_FAILED) {
+        yCError(MAP2D_SHARED_MEMORY) << "Unable to map" << segment.handle.name << ":" << strerror(errno);
+        segment.address = nullptr;
+        shm_unlink(segment.handle.name.c_str());
+        return false;
+    }
+
+    auto* out = static_cast<Map2DSharedMemoryHeader*>(segment.address);
+    *out = header;
+    std::memcpy(out->magic, magic, sizeof(magic));
+    out->layout = layout;
+    out->reserved = 0;
+    out->version = segment.handle.version;
+    out->data_offset = dataOffset;
+    out->data_size = dataSize;
+    fill(static_cast<int8_t*>(segment.address) + dataOffset);
+    mprotect(segment.address, segment.handle.size, PROT_READ);
+
+    auto& versions = m_segments[mapName];
+    m_lastVersion = segment.handle.version;
+    versions.push_back(segment);
+    while (versions.size() > versionsKept) {
+        release(versions.front());
+        versions.pop_front();
+    }
+    handle = segment.handle;
+    return true;
+}
+
+void Map2DSharedMemoryWriter::release(Segment& segment)
+{
+    if (segment.address) {
+        munmap(segment.address, segment.handle.size);
+        segment.address = nullptr;
+    }
+    // The clients that mapped the segment keep their mapping
+    shm_unlink(segment.handle.name.c_str());
+}
+
+Map2DSharedMemoryReader::~Map2DSharedMemoryReader()
+{
+    close();
+}
+
+bool Map2DSharedMemoryReader::open(const std::string& name, uint64_t version)
+{
+    close();
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        yCError(MAP2D_SHARED_MEMORY) << "Unable to open" << name << ":" << strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Map2DSharedMemoryHeader)) {
+        yCError(MAP2D_SHARED_MEMORY) << name << "is not a map segment";
+        ::close(fd);
+        return false;
+    }
+    void* address = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        yCError(MAP2D_SHARED_MEMORY) << "Unable to map" << name << ":" << strerror(errno);
+        return false;
+    }
+    m_address = address;
+    m_size = static_cast<size_t>(st.st_size);
+
+    const auto* h = header();
+    if (std::memcmp(h->magic, magic, sizeof(magic)) != 0 || h->layout != layout ||
+        h->data_offset + h->data_size > m_size ||
+        h->data_size != static_cast<uint64_t>(h->width) * h->height) {
+        yCError(MAP2D_SHARED_MEMORY) << name << "is not a map segment";
+        close();
+        return false;
+    }
+    if (h->version != version) {
+        yCError(MAP2D_SHARED_MEMORY) << name << "has version" << h->version << "instead of" << version;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void Map2DSharedMemoryReader::close()
+{
+    if (m_address) {
+        munmap(const_cast<void*>(m_address), m_size);
+        m_address = nullptr;
+        m_size = 0;
+    }
+}
+
+#endif
+
+const int8_t* Map2DSharedMemoryReader::data() const
+{
+    if (!m_address) {
+        return nullptr;
+    }
+    return static_cast<const int8_t*>(m_address) + header()->data_offset;
+}
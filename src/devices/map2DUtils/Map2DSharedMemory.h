@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_DEV_MAP2D_SHARED_MEMORY_H
+#define YARP_DEV_MAP2D_SHARED_MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * Layout of the beginning of a map segment, followed by the occupancy data at `data_offset`.
+ * The origin angle is in radians.
+ */
+struct Map2DSharedMemoryHeader
+{
+    char     magic[8];
+    uint32_t layout;
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved;
+    uint64_t version;
+    uint64_t data_offset;
+    uint64_t data_size;
+    double   resolution;
+    double   origin_x;
+    double   origin_y;
+    double   origin_theta;
+};
+
+/**
+ * Writes the maps to read-only POSIX shared memory segments named `<prefix>.<map>.<version>`.
+ *
+ * A segment is never modified after it is written: when the content of a map changes a new
+ * version is written to a new segment, and only the last two versions of each map are kept,
+ * so that a client that has just received the previous handle can still open it.
+ * Shared memory is not supported on Windows, write() always fails there.
+ */
+class Map2DSharedMemoryWriter
+{
+public:
+    struct Handle
+    {
+        std::string name;
+        uint64_t version{0};
+        uint64_t size{0};
+        uint64_t data_offset{0};
+    };
+
+    explicit Map2DSharedMemoryWriter(const std::string& prefix);
+    Map2DSharedMemoryWriter(const Map2DSharedMemoryWriter&) = delete;
+    Map2DSharedMemoryWriter& operator=(const Map2DSharedMemoryWriter&) = delete;
+    ~Map2DSharedMemoryWriter();
+
+    static bool supported();
+
+    /**
+     * Writes a new version of a map. `header` gives the size and the metadata of the map,
+     * `fill` writes the `width * height` cells. The caller checks that the map changed, as
+     * it knows the map before it is converted.
+     */
+    bool write(const std::string& mapName,
+               const Map2DSharedMemoryHeader& header,
+               const std::function<void(int8_t*)>& fill,
+               Handle& handle);
+
+private:
+    struct Segment
+    {
+        Handle handle;
+        void* address{nullptr};
+    };
+
+    void release(Segment& segment);
+
+    std::string m_prefix;
+    std::mutex m_mutex;
+    uint64_t m_lastVersion{0};
+    std::map<std::string, std::deque<Segment>> m_segments;
+};
+
+/**
+ * Maps a segment written by Map2DSharedMemoryWriter, for the clients.
+ */
+class Map2DSharedMemoryReader
+{
+public:
+    Map2DSharedMemoryReader() = default;
+    Map2DSharedMemoryReader(const Map2DSharedMemoryReader&) = delete;
+    Map2DSharedMemoryReader& operator=(const Map2DSharedMemoryReader&) = delete;
+    ~Map2DSharedMemoryReader();
+
+    /**
+     * Maps the segment, checking that it is a map segment of the expected version.
+     */
+    bool open(const std::string& name, uint64_t version);
+    void close();
+
+    const Map2DSharedMemoryHeader* header() const
+    {
+        return static_cast<const Map2DSharedMemoryHeader*>(m_address);
+    }
+    const int8_t* data() const;
+
+private:
+    const void* m_address{nullptr};
+    size_t m_size{0};
+};
+
+#endif // YARP_DEV_MAP2D_SHARED_MEMORY_H
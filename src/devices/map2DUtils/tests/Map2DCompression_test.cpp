@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <Map2DCompression.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <vector>
+
+namespace {
+// A map made of the given runs of cells
+std::vector<int8_t> makeCells(const std::vector<std::pair<int8_t, size_t>>& runs)
+{
+    std::vector<int8_t> cells;
+    for (const auto& run : runs) {
+        cells.insert(cells.end(), run.second, run.first);
+    }
+    return cells;
+}
+
+std::vector<int8_t> roundTrip(const std::vector<int8_t>& cells, std::vector<uint8_t>& encoded)
+{
+    map2DEncodeRle(cells.data(), cells.size(), encoded);
+    std::vector<int8_t> decoded(cells.size(), 42);
+    CHECK(map2DDecodeRle(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+    return decoded;
+}
+} // namespace
+
+TEST_CASE("dev::Map2DCompression_test", "[yarp::dev]")
+{
+    SECTION("Short runs")
+    {
+        std::vector<int8_t> cells = makeCells({{-1, 3}, {0, 1}, {100, 2}, {0, 1}});
+        std::vector<uint8_t> encoded;
+        CHECK(roundTrip(cells, encoded) == cells);
+        // A value and a single byte length per run
+        CHECK(encoded == std::vector<uint8_t>{0xFF, 3, 0, 1, 100, 2, 0, 1});
+    }
+
+    SECTION("Runs longer than 127 cells have a multi-byte length")
+    {
+        std::vector<uint8_t> encoded;
+
+        std::vector<int8_t> cells = makeCells({{-1, 127}});
+        CHECK(roundTrip(cells, encoded) == cells);
+        CHECK(encoded == std::vector<uint8_t>{0xFF, 0x7F});
+
+        cells = makeCells({{-1, 128}});
+        CHECK(roundTrip(cells, encoded) == cells);
+        CHECK(encoded == std::vector<uint8_t>{0xFF, 0x80, 0x01});
+
+        cells = makeCells({{0, 300}, {100, 16384}, {-1, 5}});
+        CHECK(roundTrip(cells, encoded) == cells);
+        // 300 = 0b10 0101100, 16384 = 0b1 0000000 0000000
+        CHECK(encoded == std::vector<uint8_t>{0, 0xAC, 0x02, 100, 0x80, 0x80, 0x01, 0xFF, 5});
+    }
+
+    SECTION("An empty map")
+    {
+        std::vector<uint8_t> encoded{1, 2, 3};
+        map2DEncodeRle(nullptr, 0, encoded);
+        CHECK(encoded.empty());
+        CHECK(map2DDecodeRle(encoded.data(), 0, nullptr, 0));
+    }
+
+    SECTION("Malformed data is rejected")
+    {
+        std::vector<int8_t> cells = makeCells({{0, 300}, {100, 2}});
+        std::vector<uint8_t> encoded;
+        map2DEncodeRle(cells.data(), cells.size(), encoded);
+        std::vector<int8_t> decoded(cells.size());
+
+        // Truncated in the middle of a multi-byte length, or without the length of the last run
+        CHECK_FALSE(map2DDecodeRle(encoded.data(), 2, decoded.data(), decoded.size()));
+        CHECK_FALSE(map2DDecodeRle(encoded.data(), encoded.size() - 1, decoded.data(), decoded.size()));
+        // Fewer cells than expected
+        CHECK_FALSE(map2DDecodeRle(encoded.data(), 3, decoded.data(), decoded.size()));
+
+        // More cells than expected, nothing is written beyond the cells
+        std::vector<int8_t> small(cells.size() - 1 + 4, 42);
+        CHECK_FALSE(map2DDecodeRle(encoded.data(), encoded.size(), small.data(), cells.size() - 1));
+        for (size_t i = cells.size() - 1; i < small.size(); i++) {
+            CHECK(small[i] == 42);
+        }
+
+        // A length longer than 64 bits
+        std::vector<uint8_t> endless{0};
+        endless.insert(endless.end(), 10, 0xFF);
+        endless.push_back(0x01);
+        CHECK_FALSE(map2DDecodeRle(endless.data(), endless.size(), decoded.data(), decoded.size()));
+    }
+
+    SECTION("Decompressing a map")
+    {
+        std::vector<int8_t> cells = makeCells({{-1, 200}, {0, 100}});
+        map2d_nws_ros2_msgs::msg::CompressedOccupancyGrid in;
+        in.header.frame_id = "map";
+        in.info.width = 30;
+        in.info.height = 10;
+        in.info.resolution = 0.05F;
+        in.encoding = "rle";
+        map2DEncodeRle(cells.data(), cells.size(), in.data);
+
+        nav_msgs::msg::OccupancyGrid out;
+        REQUIRE(map2DDecompress(in, out));
+        CHECK(out.header.frame_id == "map");
+        CHECK(out.info.width == 30);
+        CHECK(out.info.height == 10);
+        CHECK(out.info.resolution == 0.05F);
+        CHECK(out.data == cells);
+
+        // The cells must match the size of the map
+        in.info.height = 11;
+        CHECK_FALSE(map2DDecompress(in, out));
+        in.info.height = 10;
+
+        in.encoding = "zstd";
+        CHECK_FALSE(map2DDecompress(in, out));
+    }
+}
@@ -0,0 +1,172 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <Map2DSharedMemory.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+Map2DSharedMemoryHeader makeHeader(uint32_t width, uint32_t height)
+{
+    Map2DSharedMemoryHeader header{};
+    header.width = width;
+    header.height = height;
+    header.resolution = 0.05;
+    header.origin_x = -1.0;
+    header.origin_y = 2.0;
+    header.origin_theta = 0.5;
+    return header;
+}
+
+// Fills the cells with first, first + 1, ...
+std::function<void(int8_t*)> fillFrom(uint32_t size, int8_t first)
+{
+    return [size, first](int8_t* data) {
+        for (uint32_t i = 0; i < size; i++) {
+            data[i] = static_cast<int8_t>(first + i);
+        }
+    };
+}
+
+#if !defined(_WIN32)
+bool segmentExists(const std::string& name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    close(fd);
+    return true;
+}
+#endif
+} // namespace
+
+TEST_CASE("dev::Map2DSharedMemory_test", "[yarp::dev]")
+{
+#if defined(_WIN32)
+    CHECK_FALSE(Map2DSharedMemoryWriter::supported());
+    YARP_SKIP_TEST("Shared memory maps are not supported on this platform");
+#else
+    REQUIRE(Map2DSharedMemoryWriter::supported());
+
+    SECTION("A written map is read back")
+    {
+        Map2DSharedMemoryWriter writer("map2DSharedMemory_test");
+        Map2DSharedMemoryWriter::Handle handle;
+        REQUIRE(writer.write("test map", makeHeader(3, 2), fillFrom(6, 10), handle));
+        CHECK(handle.version == 1);
+        // The name of the map is sanitized
+        CHECK(handle.name == "/map2DSharedMemory_test.test_map.1");
+        CHECK(handle.data_offset % 64 == 0);
+        CHECK(handle.size == handle.data_offset + 6);
+
+        Map2DSharedMemoryReader reader;
+        REQUIRE(reader.open(handle.name, handle.version));
+        const Map2DSharedMemoryHeader* header = reader.header();
+        REQUIRE(header != nullptr);
+        CHECK(header->version == 1);
+        CHECK(header->width == 3);
+        CHECK(header->height == 2);
+        CHECK(header->data_offset == handle.data_offset);
+        CHECK(header->data_size == 6);
+        CHECK(header->resolution == 0.05);
+        CHECK(header->origin_x == -1.0);
+        CHECK(header->origin_y == 2.0);
+        CHECK(header->origin_theta == 0.5);
+        const int8_t* data = reader.data();
+        REQUIRE(data != nullptr);
+        for (int i = 0; i < 6; i++) {
+            CHECK(data[i] == 10 + i);
+        }
+
+        // The version must match the one of the handle
+        Map2DSharedMemoryReader other;
+        CHECK_FALSE(other.open(handle.name, handle.version + 1));
+        CHECK(other.data() == nullptr);
+        CHECK_FALSE(other.open("/map2DSharedMemory_test.missing.1", 1));
+
+        reader.close();
+        CHECK(reader.data() == nullptr);
+    }
+
+    SECTION("Only the last two versions of a map are kept")
+    {
+        Map2DSharedMemoryWriter::Handle first;
+        Map2DSharedMemoryWriter::Handle second;
+        Map2DSharedMemoryWriter::Handle third;
+        Map2DSharedMemoryWriter::Handle otherMap;
+        Map2DSharedMemoryReader firstReader;
+        {
+            Map2DSharedMemoryWriter writer("map2DSharedMemory_test");
+            REQUIRE(writer.write("map", makeHeader(2, 2), fillFrom(4, 0), first));
+            REQUIRE(firstReader.open(first.name, first.version));
+
+            REQUIRE(writer.write("map", makeHeader(2, 2), fillFrom(4, 20), second));
+            REQUIRE(writer.write("other", makeHeader(1, 1), fillFrom(1, 0), otherMap));
+            REQUIRE(writer.write("map", makeHeader(4, 1), fillFrom(4, 40), third));
+            // The versions increase across the maps of a writer
+            CHECK(second.version == first.version + 1);
+            CHECK(otherMap.version == second.version + 1);
+            CHECK(third.version == otherMap.version + 1);
+
+            CHECK_FALSE(segmentExists(first.name));
+            CHECK(segmentExists(second.name));
+            CHECK(segmentExists(third.name));
+            CHECK(segmentExists(otherMap.name));
+
+            // A client that mapped an unlinked version keeps reading it
+            CHECK(firstReader.header()->version == first.version);
+            CHECK(firstReader.data()[3] == 3);
+
+            Map2DSharedMemoryReader thirdReader;
+            REQUIRE(thirdReader.open(third.name, third.version));
+            CHECK(thirdReader.header()->width == 4);
+            CHECK(thirdReader.header()->height == 1);
+            CHECK(thirdReader.data()[0] == 40);
+        }
+
+        // The writer unlinks its segments when it is destroyed
+        CHECK_FALSE(segmentExists(second.name));
+        CHECK_FALSE(segmentExists(third.name));
+        CHECK_FALSE(segmentExists(otherMap.name));
+        CHECK(firstReader.data()[0] == 0);
+    }
+
+    SECTION("The segments are read-only")
+    {
+        Map2DSharedMemoryWriter writer("map2DSharedMemory_test");
+        Map2DSharedMemoryWriter::Handle handle;
+        REQUIRE(writer.write("map", makeHeader(2, 2), fillFrom(4, 0), handle));
+
+        int fd = shm_open(handle.name.c_str(), O_RDONLY, 0);
+        REQUIRE(fd >= 0);
+        struct stat st;
+        REQUIRE(fstat(fd, &st) == 0);
+        close(fd);
+        CHECK((st.st_mode & 0777) == 0444);
+
+        // The permissions are not checked for root
+        if (geteuid() != 0) {
+            CHECK(shm_open(handle.name.c_str(), O_RDWR, 0) < 0);
+            CHECK(errno == EACCES);
+        }
+
+        // The reader maps the segment read-only, a writable mapping is refused
+        fd = shm_open(handle.name.c_str(), O_RDONLY, 0);
+        REQUIRE(fd >= 0);
+        CHECK(mmap(nullptr, handle.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) == MAP_FAILED);
+        close(fd);
+    }
+#endif
+}
@@ -0,0 +1,407 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include "Map2D_nwc_ros2.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/sig/Image.h>
+
+#include <cmath>
+#include <cstring>
+#include <Ros2Utils.h>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::dev::Nav2D;
+
+YARP_LOG_COMPONENT(MAP2D_NWC_ROS2, "yarp.ros2.map2D_nwc_ros2", yarp::os::Log::TraceType);
+
+namespace {
+constexpr double RAD2DEG = 180.0 / M_PI;
+
+bool sameTime(const builtin_interfaces::msg::Time& a, const builtin_interfaces::msg::Time& b)
+{
+    return a.sec == b.sec && a.nanosec == b.nanosec;
+}
+} // namespace
+
+bool Map2D_nwc_ros2::MapVersion::operator==(const MapVersion& other) const
+{
+    return sameTime(stamp, other.stamp) && sameTime(loadTime, other.loadTime) && width == other.width && height == other.height;
+}
+
+bool Map2D_nwc_ros2::open(yarp::os::Searchable& config)
+{
+    // node_name check
+    if (!config.check("node_name")) {
+        yCError(MAP2D_NWC_ROS2) << "missing node_name parameter";
+        return false;
+    }
+    m_node_name = config.find("node_name").asString();
+
+    // topic_name check
+    if (!config.check("topic_name")) {
+        yCError(MAP2D_NWC_ROS2) << "missing topic_name parameter";
+        return false;
+    }
+    m_topic_name = config.find("topic_name").asString();
+    if (m_topic_name.c_str()[0] != '/') {
+        yCError(MAP2D_NWC_ROS2) << "Missing '/' in topic_name parameter";
+        return false;
+    }
+
+    if (config.check("map_name")) {
+        m_mapName = config.find("map_name").asString();
+    }
+    m_freeThresh = config.check("free_thresh", Value(0.25)).asFloat64();
+    m_occupiedThresh = config.check("occupied_thresh", Value(0.65)).asFloat64();
+    if (m_freeThresh < 0 || m_occupiedThresh > 1 || m_freeThresh >= m_occupiedThresh) {
+        yCError(MAP2D_NWC_ROS2) << "free_thresh and occupied_thresh must be in [0, 1], with free_thresh < occupied_thresh";
+        return false;
+    }
+
+    // The occupancy is a probability in percent, or -1 (255 as an unsigned byte) if unknown
+    for (size_t value = 0; value < 256; value++) {
+        if (value > 100) {
+            m_flagsTable[value] = MapGrid2D::MAP_CELL_UNKNOWN;
+        } else if (value >= m_occupiedThresh * 100) {
+            m_flagsTable[value] = MapGrid2D::MAP_CELL_WALL;
+        } else if (value <= m_freeThresh * 100) {
+            m_flagsTable[value] = MapGrid2D::MAP_CELL_FREE;
+        } else {
+            m_flagsTable[value] = MapGrid2D::MAP_CELL_UNKNOWN;
+        }
+    }
+
+    m_node = NodeCreator::createNode(m_node_name);
+    rclcpp::QoS qos(1);
+    qos = qos.transient_local(); // Receives the map latched by the map server before the device opened
+    m_subscription = m_node->create_subscription<nav_msgs::msg::OccupancyGrid>(m_topic_name, qos,
+                        [this](const nav_msgs::msg::OccupancyGrid::SharedPtr msg) {
+                            callback(msg);
+                        });
+
+    m_spinner = std::make_unique<Ros2Spinner>(m_node);
+    m_spinner->start();
+
+    yCInfo(MAP2D_NWC_ROS2) << "opened";
+
+    return true;
+}
+
+bool Map2D_nwc_ros2::close()
+{
+    yCInfo(MAP2D_NWC_ROS2, "closing...");
+    m_spinner.reset();
+    yCInfo(MAP2D_NWC_ROS2, "closed");
+    return true;
+}
+
+void Map2D_nwc_ros2::callback(nav_msgs::msg::OccupancyGrid::SharedPtr msg)
+{
+    yCTrace(MAP2D_NWC_ROS2, "callback OccupancyGrid");
+
+    MapVersion version;
+    version.stamp = msg->header.stamp;
+    version.loadTime = msg->info.map_load_time;
+    version.width = msg->info.width;
+    version.height = msg->info.height;
+    if (m_versionValid && version == m_version) {
+        yCTrace(MAP2D_NWC_ROS2, "The map did not change");
+        return;
+    }
+
+    auto map = std::make_shared<MapGrid2D>();
+    if (!convertMap(*msg, *map)) {
+        return;
+    }
+    m_version = version;
+    m_versionValid = true;
+
+    std::lock_guard<std::mutex> lock(m_mapMutex);
+    m_map = std::move(map);
+}
+
+bool Map2D_nwc_ros2::convertMap(const nav_msgs::msg::OccupancyGrid& msg, MapGrid2D& map) const
+{
+    const size_t width = msg.info.width;
+    const size_t height = msg.info.height;
+    if (msg.data.size() != width * height) {
+        yCError(MAP2D_NWC_ROS2) << "Received a map of" << width << "x" << height << "cells, but with" << msg.data.size() << "values";
+        return false;
+    }
+
+    const auto& q = msg.info.origin.orientation;
+    const double yaw = std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+    map.setMapName(m_mapName);
+    map.setSize_in_cells(width, height);
+    map.setResolution(msg.info.resolution);
+    map.setOrigin(msg.info.origin.position.x, msg.info.origin.position.y, yaw * RAD2DEG);
+
+    // ROS2 stores the bottom row first, the cells are copied as they are since -1 (unknown)
+    // is 255 as an unsigned byte, the unknown occupancy of MapGrid2D
+    yarp::sig::ImageOf<yarp::sig::PixelMono> occupancy;
+    occupancy.resize(width, height);
+    const auto* data = reinterpret_cast<const unsigned char*>(msg.data.data());
+    for (size_t row = 0; row < height; row++) {
+        std::memcpy(occupancy.getRow(height - 1 - row), data + row * width, width);
+    }
+    if (!map.setOccupancyGrid(occupancy)) {
+        yCError(MAP2D_NWC_ROS2) << "Failed to set the occupancy of the map";
+        return false;
+    }
+
+    XYCell cell;
+    for (cell.y = 0; cell.y < height; cell.y++) {
+        const unsigned char* rowData = occupancy.getRow(cell.y);
+        for (cell.x = 0; cell.x < width; cell.x++) {
+            map.setMapFlag(cell, m_flagsTable[rowData[cell.x]]);
+        }
+    }
+    return true;
+}
+
+bool Map2D_nwc_ros2::notSupported(const char* method) const
+{
+    yCError(MAP2D_NWC_ROS2) << method << "is not supported, the maps are provided by the ROS2 map server";
+    return false;
+}
+
+bool Map2D_nwc_ros2::get_map(std::string map_name, MapGrid2D& map)
+{
+    if (map_name != m_mapName) {
+        yCError(MAP2D_NWC_ROS2) << "Map" << map_name << "not found";
+        return false;
+    }
+    std::shared_ptr<const MapGrid2D> cached;
+    {
+        std::lock_guard<std::mutex> lock(m_mapMutex);
+        cached = m_map;
+    }
+    if (!cached) {
+        yCErrorThrottle(MAP2D_NWC_ROS2, 5.0) << "No map received yet";
+        return false;
+    }
+    map = *cached;
+    return true;
+}
+
+bool Map2D_nwc_ros2::get_map_names(std::vector<std::string>& map_names)
+{
+    map_names.clear();
+    std::lock_guard<std::mutex> lock(m_mapMutex);
+    if (m_map) {
+        map_names.push_back(m_mapName);
+    }
+    return true;
+}
+
+bool Map2D_nwc_ros2::getLocationsList(std::vector<std::string>& locations)
+{
+    locations.clear();
+    return true;
+}
+
+bool Map2D_nwc_ros2::getAreasList(std::vector<std::string>& areas)
+{
+    areas.clear();
+    return true;
+}
+
+bool Map2D_nwc_ros2::getPathsList(std::vector<std::string>& paths)
+{
+    paths.clear();
+    return true;
+}
+
+bool Map2D_nwc_ros2::getAllLocations(std::vector<Map2DLocation>& locations)
+{
+    locations.clear();
+    return true;
+}
+
+bool Map2D_nwc_ros2::getAllAreas(std::vector<Map2DArea>& areas)
+{
+    areas.clear();
+    return true;
+}
+
+bool Map2D_nwc_ros2::getAllPaths(std::vector<Map2DPath>& paths)
+{
+    paths.clear();
+    return true;
+}
+
+bool Map2D_nwc_ros2::getLocation(std::string location_name, Map2DLocation& loc)
+{
+    YARP_UNUSED(loc);
+    yCError(MAP2D_NWC_ROS2) << "Location" << location_name << "not found";
+    return false;
+}
+
+bool Map2D_nwc_ros2::getArea(std::string area_name, Map2DArea& area)
+{
+    YARP_UNUSED(area);
+    yCError(MAP2D_NWC_ROS2) << "Area" << area_name << "not found";
+    return false;
+}
+
+bool Map2D_nwc_ros2::getPath(std::string path_name, Map2DPath& path)
+{
+    YARP_UNUSED(path);
+    yCError(MAP2D_NWC_ROS2) << "Path" << path_name << "not found";
+    return false;
+}
+
+bool Map2D_nwc_ros2::clearAllMaps()
+{
+    return notSupported("clearAllMaps");
+}
+
+bool Map2D_nwc_ros2::store_map(const MapGrid2D& map)
+{
+    YARP_UNUSED(map);
+    return notSupported("store_map");
+}
+
+bool Map2D_nwc_ros2::remove_map(std::string map_name)
+{
+    YARP_UNUSED(map_name);
+    return notSupported("remove_map");
+}
+
+bool Map2D_nwc_ros2::storeLocation(std::string location_name, Map2DLocation loc)
+{
+    YARP_UNUSED(location_name);
+    YARP_UNUSED(loc);
+    return notSupported("storeLocation");
+}
+
+bool Map2D_nwc_ros2::storeArea(std::string area_name, Map2DArea area)
+{
+    YARP_UNUSED(area_name);
+    YARP_UNUSED(area);
+    return notSupported("storeArea");
+}
+
+bool Map2D_nwc_ros2::storePath(std::string path_name, Map2DPath path)
+{
+    YARP_UNUSED(path_name);
+    YARP_UNUSED(path);
+    return notSupported("storePath");
+}
+
+bool Map2D_nwc_ros2::renameLocation(std::string original_name, std::string new_name)
+{
+    YARP_UNUSED(original_name);
+    YARP_UNUSED(new_name);
+    return notSupported("renameLocation");
+}
+
+bool Map2D_nwc_ros2::deleteLocation(std::string location_name)
+{
+    YARP_UNUSED(location_name);
+    return notSupported("deleteLocation");
+}
+
+bool Map2D_nwc_ros2::deletePath(std::string path_name)
+{
+    YARP_UNUSED(path_name);
+    return notSupported("deletePath");
+}
+
+bool Map2D_nwc_ros2::renameArea(std::string original_name, std::string new_name)
+{
+    YARP_UNUSED(original_name);
+    YARP_UNUSED(new_name);
+    return notSupported("renameArea");
+}
+
+bool Map2D_nwc_ros2::deleteArea(std::string area_name)
+{
+    YARP_UNUSED(area_name);
+    return notSupported("deleteArea");
+}
+
+bool Map2D_nwc_ros2::renamePath(std::string original_name, std::string new_name)
+{
+    YARP_UNUSED(original_name);
+    YARP_UNUSED(new_name);
+    return notSupported("renamePath");
+}
+
+bool Map2D_nwc_ros2::clearAllLocations()
+{
+    return notSupported("clearAllLocations");
+}
+
+bool Map2D_nwc_ros2::clearAllAreas()
+{
+    return notSupported("clearAllAreas");
+}
+
+bool Map2D_nwc_ros2::clearAllPaths()
+{
+    return notSupported("clearAllPaths");
+}
+
+bool Map2D_nwc_ros2::clearAllMapsTemporaryFlags()
+{
+    return notSupported("clearAllMapsTemporaryFlags");
+}
+
+bool Map2D_nwc_ros2::clearMapTemporaryFlags(std::string map_name)
+{
+    YARP_UNUSED(map_name);
+    return notSupported("clearMapTemporaryFlags");
+}
+
+bool Map2D_nwc_ros2::saveMapsCollection(std::string maps_collection_file)
+{
+    YARP_UNUSED(maps_collection_file);
+    return notSupported("saveMapsCollection");
+}
+
+bool Map2D_nwc_ros2::loadMapsCollection(std::string maps_collection_file)
+{
+    YARP_UNUSED(maps_collection_file);
+    return notSupported("loadMapsCollection");
+}
+
+bool Map2D_nwc_ros2::saveLocationsAndExtras(std::string locations_collection_file)
+{
+    YARP_UNUSED(locations_collection_file);
+    return notSupported("saveLocationsAndExtras");
+}
+
+bool Map2D_nwc_ros2::loadLocationsAndExtras(std::string locations_collection_file)
+{
+    YARP_UNUSED(locations_collection_file);
+    return notSupported("loadLocationsAndExtras");
+}
+
+bool Map2D_nwc_ros2::saveMapToDisk(std::string map_name, std::string file_name)
+{
+    YARP_UNUSED(map_name);
+    YARP_UNUSED(file_name);
+    return notSupported("saveMapToDisk");
+}
+
+bool Map2D_nwc_ros2::loadMapFromDisk(std::string file_name)
+{
+    YARP_UNUSED(file_name);
+    return notSupported("loadMapFromDisk");
+}
+
+bool Map2D_nwc_ros2::enableMapsCompression(bool enable)
+{
+    YARP_UNUSED(enable);
+    return notSupported("enableMapsCompression");
+}
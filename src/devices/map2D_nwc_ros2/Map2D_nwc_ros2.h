@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_MAP2D_NWC_ROS2_H
+#define YARP_ROS2_MAP2D_NWC_ROS2_H
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IMap2D.h>
+#include <yarp/dev/MapGrid2D.h>
+#include <yarp/dev/Map2DLocation.h>
+#include <yarp/dev/Map2DArea.h>
+#include <yarp/dev/Map2DPath.h>
+#include <Ros2Spinner.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <nav_msgs/msg/occupancy_grid.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ *  @ingroup dev_impl_nwc_ros2 dev_impl_navigation
+ *
+ * \brief `Map2D_nwc_ros2`: A network client that receives the map published by a ROS2 map server on a topic of type nav_msgs::OccupancyGrid, and exposes it as IMap2D
+ *
+ * | Parameter name | SubParameter   | Type    | Units          | Default Value    | Required | Description                                                        | Notes |
+ * |:--------------:|:--------------:|:-------:|:--------------:|:----------------:|:--------:|:------------------------------------------------------------------:|:-----:|
+ * | node_name      |      -         | string  | -              |   -              | Yes      | The name of the ROS node opened by this device                     | |
+ * | topic_name     |      -         | string  | -              |   -              | Yes      | The nav_msgs/OccupancyGrid topic of the map                        | MUST start with a '/' character, e.g. /map |
+ * | map_name       |      -         | string  | -              | map              | No       | The name of the map in IMap2D                                      | |
+ * | free_thresh    |      -         | double  | -              | 0.25             | No       | Cells with a lower or equal occupancy probability are free         | The same of the yaml files of the ROS2 map server |
+ * | occupied_thresh|      -         | double  | -              | 0.65             | No       | Cells with a greater or equal occupancy probability are walls      | The cells in between are unknown |
+ *
+ * The map is received with a transient local QoS, so the map latched by the map server is
+ * received also when the device opens after it.
+ *
+ * The map is converted to a MapGrid2D only once per version, when it is received: the rows are
+ * copied in bulk to the occupancy grid, flipped since ROS2 stores the bottom row first, and the
+ * flags of the cells are computed by a lookup table. A map received again with the same stamp,
+ * load time and size is not converted again. get_map() copies the cached map and takes the lock
+ * only to get a reference to it, so it never waits for a conversion.
+ *
+ * A ROS2 map server has no locations, areas or paths and its maps cannot be changed by the
+ * clients, so the methods to store, remove and save them are not supported, and the lists
+ * of locations, areas and paths are empty.
+ */
+class Map2D_nwc_ros2 :
+        public yarp::dev::DeviceDriver,
+        public yarp::dev::Nav2D::IMap2D
+{
+public:
+    Map2D_nwc_ros2() = default;
+    Map2D_nwc_ros2(const Map2D_nwc_ros2&) = delete;
+    Map2D_nwc_ros2(Map2D_nwc_ros2&&) noexcept = delete;
+    Map2D_nwc_ros2& operator=(const Map2D_nwc_ros2&) = delete;
+    Map2D_nwc_ros2& operator=(Map2D_nwc_ros2&&) noexcept = delete;
+    ~Map2D_nwc_ros2() override = default;
+
+    // DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    // ROS2 Topic Callback
+    void callback(nav_msgs::msg::OccupancyGrid::SharedPtr msg);
+
+    // IMap2D
+    bool clearAllMaps() override;
+    bool store_map(const yarp::dev::Nav2D::MapGrid2D& map) override;
+    bool get_map(std::string map_name, yarp::dev::Nav2D::MapGrid2D& map) override;
+    bool get_map_names(std::vector<std::string>& map_names) override;
+    bool remove_map(std::string map_name) override;
+    bool storeLocation(std::string location_name, yarp::dev::Nav2D::Map2DLocation loc) override;
+    bool storeArea(std::string area_name, yarp::dev::Nav2D::Map2DArea area) override;
+    bool storePath(std::string path_name, yarp::dev::Nav2D::Map2DPath path) override;
+    bool getLocation(std::string location_name, yarp::dev::Nav2D::Map2DLocation& loc) override;
+    bool getArea(std::string area_name, yarp::dev::Nav2D::Map2DArea& area) override;
+    bool getPath(std::string path_name, yarp::dev::Nav2D::Map2DPath& path) override;
+    bool getLocationsList(std::vector<std::string>& locations) override;
+    bool getAreasList(std::vector<std::string>& areas) override;
+    bool getPathsList(std::vector<std::string>& paths) override;
+    bool getAllLocations(std::vector<yarp::dev::Nav2D::Map2DLocation>& locations) override;
+    bool getAllAreas(std::vector<yarp::dev::Nav2D::Map2DArea>& areas) override;
+    bool getAllPaths(std::vector<yarp::dev::Nav2D::Map2DPath>& paths) override;
+    bool renameLocation(std::string original_name, std::string new_name) override;
+    bool deleteLocation(std::string location_name) override;
+    bool deletePath(std::string path_name) override;
+    bool renameArea(std::string original_name, std::string new_name) override;
+    bool deleteArea(std::string area_name) override;
+    bool renamePath(std::string original_name, std::string new_name) override;
+    bool clearAllLocations() override;
+    bool clearAllAreas() override;
+    bool clearAllPaths() override;
+    bool clearAllMapsTemporaryFlags() override;
+    bool clearMapTemporaryFlags(std::string map_name) override;
+    bool saveMapsCollection(std::string maps_collection_file) override;
+    bool loadMapsCollection(std::string maps_collection_file) override;
+    bool saveLocationsAndExtras(std::string locations_collection_file) override;
+    bool loadLocationsAndExtras(std::string locations_collection_file) override;
+    bool saveMapToDisk(std::string map_name, std::string file_name) override;
+    bool loadMapFromDisk(std::string file_name) override;
+    bool enableMapsCompression(bool enable) override;
+
+private:
+    // What identifies a version of the map
+    struct MapVersion
+    {
+        builtin_interfaces::msg::Time stamp;
+        builtin_interfaces::msg::Time loadTime;
+        uint32_t width{0};
+        uint32_t height{0};
+
+        bool operator==(const MapVersion& other) const;
+    };
+
+    bool convertMap(const nav_msgs::msg::OccupancyGrid& msg, yarp::dev::Nav2D::MapGrid2D& map) const;
+    bool notSupported(const char* method) const;
+
+    std::string m_node_name;
+    std::string m_topic_name;
+    std::string m_mapName{"map"};
+    double m_freeThresh{0.25};
+    double m_occupiedThresh{0.65};
+    rclcpp::Node::SharedPtr m_node;
+    rclcpp::Subscription<nav_msgs::msg::OccupancyGrid>::SharedPtr m_subscription;
+    std::unique_ptr<Ros2Spinner> m_spinner;
+
+    // The flag of every value of the occupancy, indexed by the value as an unsigned byte
+    yarp::dev::Nav2D::MapGrid2D::map_flags m_flagsTable[256];
+
+    // Written by the callback only
+    MapVersion m_version;
+    bool m_versionValid{false};
+
+    // The cached map is never modified, a new version replaces it
+    std::mutex m_mapMutex;
+    std::shared_ptr<const yarp::dev::Nav2D::MapGrid2D> m_map;
+};
+
+#endif // YARP_ROS2_MAP2D_NWC_ROS2_H
@@ -0,0 +1,205 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
+#include <yarp/dev/IMap2D.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/sig/Image.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <string>
+#include <vector>
+
+using namespace yarp::dev;
+using namespace yarp::dev::Nav2D;
+using namespace yarp::os;
+
+namespace {
+// Publishes a map of 4x2 cells of 0.5 m, at (1, -2) and turned by 90 degrees, latched like the map server does
+void publishMap(int sec, const std::string& data)
+{
+    const std::string cmd = "ros2 topic pub --once --qos-durability transient_local /map2D_nwc_map nav_msgs/msg/OccupancyGrid \"{header: {stamp: {sec: " + std::to_string(sec) + "}, "
+                            "frame_id: 'map'}, info: {map_load_time: {sec: 5}, resolution: 0.5, width: 4, height: 2, origin: {position: {x: 1.0, y: -2.0}, "
+                            "orientation: {z: 0.7071067811865476, w: 0.7071067811865476}}}, data: " + data + "}\"";
+    system(cmd.c_str());
+}
+
+// The bottom row first, as ROS2 stores it
+constexpr const char* mapData = "[0, 25, 26, -1, 64, 65, 100, 50]";
+
+// The occupancy of the map, the top row first
+std::vector<unsigned char> occupancyOf(const MapGrid2D& map)
+{
+    yarp::sig::ImageOf<yarp::sig::PixelMono> occupancy;
+    REQUIRE(map.getOccupancyGrid(occupancy));
+    std::vector<unsigned char> cells;
+    for (size_t y = 0; y < occupancy.height(); y++) {
+        for (size_t x = 0; x < occupancy.width(); x++) {
+            cells.push_back(occupancy.pixel(x, y));
+        }
+    }
+    return cells;
+}
+
+std::vector<MapGrid2D::map_flags> flagsOf(const MapGrid2D& map)
+{
+    std::vector<MapGrid2D::map_flags> flags;
+    XYCell cell;
+    for (cell.y = 0; cell.y < map.height(); cell.y++) {
+        for (cell.x = 0; cell.x < map.width(); cell.x++) {
+            MapGrid2D::map_flags flag = MapGrid2D::MAP_CELL_KEEP_OUT;
+            CHECK(map.getMapFlag(cell, flag));
+            flags.push_back(flag);
+        }
+    }
+    return flags;
+}
+} // namespace
+
+TEST_CASE("dev::map2D_nwc_ros2_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("map2D_nwc_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    SECTION("Checking the nwc alone")
+    {
+        PolyDriver ddnwc;
+
+        ////////"Checking opening nwc"
+        {
+            Property pcfg;
+            pcfg.put("device", "map2D_nwc_ros2");
+            pcfg.put("node_name", "map2D_nwc");
+            pcfg.put("topic_name", "/map2D_nwc_map");
+            REQUIRE(ddnwc.open(pcfg));
+        }
+
+        //"Close all polydrivers and check"
+        {
+            CHECK(ddnwc.close());
+        }
+    }
+
+    SECTION("Checking the nwc before receiving the map")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device map2D_nwc_ros2) (node_name map2D_nwc) (topic_name /map2D_nwc_map) (map_name test_map)");
+        REQUIRE(ddnwc.open(pcfg));
+
+        IMap2D* imap = nullptr;
+        REQUIRE(ddnwc.view(imap));
+
+        std::vector<std::string> names;
+        CHECK(imap->get_map_names(names));
+        CHECK(names.empty());
+        CHECK(imap->getLocationsList(names));
+        CHECK(names.empty());
+
+        MapGrid2D map;
+        CHECK_FALSE(imap->get_map("test_map", map));
+        CHECK_FALSE(imap->get_map("other_map", map));
+        CHECK_FALSE(imap->store_map(map));
+        CHECK_FALSE(imap->storeLocation("loc", Map2DLocation("test_map", 1.0, 2.0, 90.0)));
+
+        CHECK(ddnwc.close());
+    }
+
+    SECTION("Checking the nwc receiving the map")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device map2D_nwc_ros2) (node_name map2D_nwc) (topic_name /map2D_nwc_map) (map_name test_map)");
+        REQUIRE(ddnwc.open(pcfg));
+
+        IMap2D* imap = nullptr;
+        REQUIRE(ddnwc.view(imap));
+
+        publishMap(10, mapData);
+        MapGrid2D map;
+        REQUIRE(waitFor([&] { return imap->get_map("test_map", map); }));
+
+        std::vector<std::string> names;
+        CHECK(imap->get_map_names(names));
+        REQUIRE(names.size() == 1);
+        CHECK(names[0] == "test_map");
+
+        CHECK(map.getMapName() == "test_map");
+        CHECK(map.width() == 4);
+        CHECK(map.height() == 2);
+        double resolution = 0;
+        map.getResolution(resolution);
+        CHECK(resolution == 0.5);
+        double x = 0;
+        double y = 0;
+        double theta = 0;
+        map.getOrigin(x, y, theta);
+        CHECK(x == Catch::Approx(1.0).epsilon(0).margin(1e-9));
+        CHECK(y == Catch::Approx(-2.0).epsilon(0).margin(1e-9));
+        CHECK(theta == Catch::Approx(90.0).epsilon(0).margin(1e-6));
+
+        // The rows are flipped, and -1 is 255 as an unsigned byte, the unknown occupancy
+        const std::vector<unsigned char> expectedOccupancy{64, 65, 100, 50, 0, 25, 26, 255};
+        CHECK(occupancyOf(map) == expectedOccupancy);
+
+        // Free up to 25%, walls from 65%
+        const std::vector<MapGrid2D::map_flags> expectedFlags{
+            MapGrid2D::MAP_CELL_UNKNOWN, MapGrid2D::MAP_CELL_WALL, MapGrid2D::MAP_CELL_WALL, MapGrid2D::MAP_CELL_UNKNOWN,
+            MapGrid2D::MAP_CELL_FREE, MapGrid2D::MAP_CELL_FREE, MapGrid2D::MAP_CELL_UNKNOWN, MapGrid2D::MAP_CELL_UNKNOWN};
+        CHECK(flagsOf(map) == expectedFlags);
+
+        // The same version of the map is not converted again
+        publishMap(10, "[100, 100, 100, 100, 100, 100, 100, 100]");
+        Time::delay(1.0);
+        CHECK(imap->get_map("test_map", map));
+        CHECK(occupancyOf(map) == expectedOccupancy);
+
+        // A new version replaces it
+        publishMap(11, "[100, 100, 100, 100, 100, 100, 100, 100]");
+        REQUIRE(waitFor([&] { return imap->get_map("test_map", map) && occupancyOf(map)[4] == 100; }));
+        CHECK(occupancyOf(map) == std::vector<unsigned char>(8, 100));
+        CHECK(flagsOf(map) == std::vector<MapGrid2D::map_flags>(8, MapGrid2D::MAP_CELL_WALL));
+
+        CHECK(ddnwc.close());
+    }
+
+    SECTION("Checking the thresholds of the nwc")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device map2D_nwc_ros2) (node_name map2D_nwc) (topic_name /map2D_nwc_map) (map_name test_map) "
+                        "(free_thresh 0.5) (occupied_thresh 0.9)");
+        REQUIRE(ddnwc.open(pcfg));
+
+        IMap2D* imap = nullptr;
+        REQUIRE(ddnwc.view(imap));
+
+        publishMap(10, mapData);
+        MapGrid2D map;
+        REQUIRE(waitFor([&] { return imap->get_map("test_map", map); }));
+
+        // Free up to 50%, walls from 90%
+        const std::vector<MapGrid2D::map_flags> expectedFlags{
+            MapGrid2D::MAP_CELL_UNKNOWN, MapGrid2D::MAP_CELL_UNKNOWN, MapGrid2D::MAP_CELL_WALL, MapGrid2D::MAP_CELL_FREE,
+            MapGrid2D::MAP_CELL_FREE, MapGrid2D::MAP_CELL_FREE, MapGrid2D::MAP_CELL_FREE, MapGrid2D::MAP_CELL_UNKNOWN};
+        CHECK(flagsOf(map) == expectedFlags);
+
+        CHECK(ddnwc.close());
+    }
+
+    SECTION("Checking invalid parameters")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device map2D_nwc_ros2) (node_name map2D_nwc) (topic_name /map2D_nwc_map) (free_thresh 0.7) (occupied_thresh 0.6)");
+        CHECK_FALSE(ddnwc.open(pcfg));
+    }
+
+    Network::setLocalMode(false);
+}
@@ -23,6 +23,7 @@
 #include <cstdlib>
 #include <fstream>
 #include <Ros2Utils.h>
+#include <Map2DCompression.h>
 #include <rclcpp/qos.hpp>
 
 using namespace yarp::sig;
@@ -96,8 +97,20 @@ bool Map2D_nws_ros2::open(yarp::os::Searchable &config)
     //ROS2 configuration
     if(config.check("getmap")) m_getMapName = config.find("getmap").asString();
     if(config.check("getmapbyname")) m_getMapByNameName = config.find("getmapbyname").asString();
+    if(config.check("getcompressedmapbyname")) m_getCompressedMapByNameName = config.find("getcompressedmapbyname").asString();
     if(config.check("roscmdparser")) m_rosCmdParserName = config.find("roscmdparser").asString();
     if(config.check("markers_pub")) m_markersName = config.find("markers_pub").asString();
+    if(config.check("workers")) m_workersNumber = static_cast<size_t>(config.find("workers").asInt32());
+    if(m_workersNumber == 0){
+        yCError(MAP2D_NWS_ROS2) << "workers must be at least 1";
+        return false;
+    }
+    if(config.check("shm_maps")) m_shmMaps = config.find("shm_maps").asBool();
+    if(config.check("getmaphandlebyname")) m_getMapHandleByNameName = config.find("getmaphandlebyname").asString();
+    if(m_shmMaps && !Map2DSharedMemoryWriter::supported()){
+        yCError(MAP2D_NWS_ROS2) << "shm_maps is not supported on this platform";
+        return false;
+    }
     if (!config.check("node_name")) {
         yCWarning(MAP2D_NWS_ROS2) << "Missing node_name parameter. Using:" << m_name;
         m_nodeName = m_name;
@@ -126,33 +139,52 @@ bool Map2D_nws_ros2::open(yarp::os::Searchable &config)
     qos.avoid_ros_namespace_conventions = true;
     m_ros2Service_getMap = m_node->create_service<nav_msgs::srv::GetMap>(m_getMapName,
                                                                                        std::bind(&Map2D_nws_ros2::getMapCallback,this,_1,_2,_3),qos );
+    // The response is sent by a worker once the map is converted, see answerGetMapByName()
     m_ros2Service_getMapByName = m_node->create_service<map2d_nws_ros2_msgs::srv::GetMapByName>(m_getMapByNameName,
-                                                                                                              std::bind(&Map2D_nws_ros2::getMapByNameCallback,this,_1,_2,_3));
+                                                                                                [this](const std::shared_ptr<rmw_request_id_t> request_header,
+                                                                                                       const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapByName::Request> request) {
+                                                                                                    getMapByNameCallback(request_header, request);
+                                                                                                });
     m_ros2Service_rosCmdParser = m_node->create_service<test_msgs::srv::BasicTypes>(m_rosCmdParserName,
                                                                                                   std::bind(&Map2D_nws_ros2::rosCmdParserCallback,this,_1,_2,_3));
+    if (m_shmMaps)
+    {
+        m_shmWriter = std::make_unique<Map2DSharedMemoryWriter>("yarp_map2d_" + m_name);
+        m_ros2Service_getMapHandleByName = m_node->create_service<map2d_nws_ros2_msgs::srv::GetMapHandleByName>(m_getMapHandleByNameName,
+                                                                                                            [this](const std::shared_ptr<rmw_request_id_t> request_header,
+                                                                                                                   const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapHandleByName::Request> request) {
+                                                                                                                getMapHandleByNameCallback(request_header, request);
+                                                                                                            });
+    }
+    m_ros2Service_getCompressedMapByName = m_node->create_service<map2d_nws_ros2_msgs::srv::GetCompressedMapByName>(m_getCompressedMapByNameName,
+                                                                                                                    [this](const std::shared_ptr<rmw_request_id_t> request_header,
+                                                                                                                           const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetCompressedMapByName::Request> request) {
+                                                                                                                        getCompressedMapByNameCallback(request_header, request);
+                                                                                                                    });
+    m_ros2Publisher_map = m_node->create_publisher<nav_msgs::msg::OccupancyGrid>(m_getMapByNameName+"/pub", 10);
+    m_ros2Publisher_compressedMap = m_node->create_publisher<map2d_nws_ros2_msgs::msg::CompressedOccupancyGrid>(m_getCompressedMapByNameName+"/pub", 10);
+
+    m_workers = std::make_unique<Ros2WorkerPool>(m_workersNumber);
 
     yCInfo(MAP2D_NWS_ROS2) << "Waiting for device to attach";
-    start();
+    m_spinner = std::make_unique<Ros2Spinner>(m_node);
+    m_spinner->start();
 
     return true;
 }
 
-
-void Map2D_nws_ros2::run()
-{
-
-//    if(!m_spinned)  //This is just a temporary solution.
-//    {
-//        rclcpp::spin(m_node);
-//        m_spinned = true;
-//    }
-}
-
 bool Map2D_nws_ros2::close()
 {
     yCTrace(MAP2D_NWS_ROS2, "Close");
+    // The workers must not answer through a service that is going away
+    if (m_workers) {
+        m_workers->stop();
+    }
+    m_spinner.reset();
     m_rpcPort.close();
-    rclcpp::shutdown();
+    // Unlinks the segments, the clients that mapped them keep their mapping
+    m_shmWriter.reset();
+    m_sharedMaps.clear();
     return true;
 }
 
@@ -216,6 +248,12 @@ bool Map2D_nws_ros2::updateVizMarkers()
 
     std::vector<std::string> locations;
     int count = 1;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_iMap2D)
+    {
+        yCError(MAP2D_NWS_ROS2) << "No map server attached";
+        return false;
+    }
     m_iMap2D->getLocationsList(locations);
     for (auto it : locations)
     {
@@ -291,69 +329,201 @@ void Map2D_nws_ros2::rosCmdParserCallback(const std::shared_ptr<rmw_request_id_t
     }
 }
 
-//void Map2D_nws_ros2::prepareMapMsg(MapGrid2D inputMap, nav_msgs::msg::OccupancyGrid &outputMsg)
 void Map2D_nws_ros2::getMapByNameCallback(const std::shared_ptr<rmw_request_id_t> request_header,
-                                          const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapByName::Request> request,
-                                          std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapByName::Response> response)
+                                          const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapByName::Request> request)
 {
-    if (!m_ros2Publisher_map)
+    if (!m_workers->post([this, request_header, request]() { answerGetMapByName(request_header, request); }))
     {
-        m_ros2Publisher_map = m_node->create_publisher<nav_msgs::msg::OccupancyGrid>(m_getMapByNameName+"/pub", 10);
+        yCWarning(MAP2D_NWS_ROS2) << "Closing, the request for map" << request->name << "is dropped";
     }
-    nav_msgs::msg::OccupancyGrid mapToGo;
-    nav_msgs::msg::MapMetaData metaToGo;
-    mapToGo.header.frame_id = "map";
+}
+
+void Map2D_nws_ros2::answerGetMapByName(const std::shared_ptr<rmw_request_id_t> request_header,
+                                        const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapByName::Request> request)
+{
+    map2d_nws_ros2_msgs::srv::GetMapByName::Response response;
+    MapGrid2D theMap;
+    if (!getMapCopy(request->name, theMap))
+    {
+        response.map.header.frame_id = "invalid_frame";
+        m_ros2Service_getMapByName->send_response(*request_header, response);
+        return;
+    }
+
+    response.map.header.frame_id = "map";
+    convertMapInfo(theMap, response.map.info);
+    response.map.header.stamp = response.map.info.map_load_time;
+    response.map.data.resize(theMap.width()*theMap.height());
+    convertMapData(theMap, response.map.data.data());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_currentMapName = request->name;
+    }
+
+    m_ros2Publisher_map->publish(response.map);
+    m_ros2Service_getMapByName->send_response(*request_header, response);
+}
+
+void Map2D_nws_ros2::getMapHandleByNameCallback(const std::shared_ptr<rmw_request_id_t> request_header,
+                                                const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapHandleByName::Request> request)
+{
+    if (!m_workers->post([this, request_header, request]() { answerGetMapHandleByName(request_header, request); }))
+    {
+        yCWarning(MAP2D_NWS_ROS2) << "Closing, the request for map" << request->name << "is dropped";
+    }
+}
+
+void Map2D_nws_ros2::answerGetMapHandleByName(const std::shared_ptr<rmw_request_id_t> request_header,
+                                              const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapHandleByName::Request> request)
+{
+    map2d_nws_ros2_msgs::srv::GetMapHandleByName::Response response;
+    response.valid = false;
+    MapGrid2D theMap;
+    if (!getMapCopy(request->name, theMap))
+    {
+        m_ros2Service_getMapHandleByName->send_response(*request_header, response);
+        return;
+    }
+
+    convertMapInfo(theMap, response.info);
+
+    Map2DSharedMemoryWriter::Handle handle;
+    bool written = false;
+    {
+        // An unchanged map keeps its segment, without creating and filling a new one
+        std::lock_guard<std::mutex> lock(m_sharedMapsMutex);
+        auto it = m_sharedMaps.find(request->name);
+        if (it != m_sharedMaps.end() && it->second.map.isIdenticalTo(theMap))
+        {
+            handle = it->second.handle;
+            written = true;
+        }
+        else
+        {
+            Map2DSharedMemoryHeader header{};
+            header.width = theMap.width();
+            header.height = theMap.height();
+            header.resolution = response.info.resolution;
+            double t = 0;
+            theMap.getOrigin(header.origin_x, header.origin_y, t);
+            header.origin_theta = t * M_PI / 180.0;
+
+            written = m_shmWriter->write(request->name, header, [&theMap](int8_t* data) { convertMapData(theMap, data); }, handle);
+            if (written)
+            {
+                m_sharedMaps[request->name] = SharedMap{std::move(theMap), handle};
+            }
+        }
+    }
+    if (written)
+    {
+        response.valid = true;
+        response.shm_name = handle.name;
+        response.version = handle.version;
+        response.size = handle.size;
+        response.data_offset = handle.data_offset;
+        response.frame_id = "map";
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_currentMapName = request->name;
+    }
+    m_ros2Service_getMapHandleByName->send_response(*request_header, response);
+}
+
+void Map2D_nws_ros2::getCompressedMapByNameCallback(const std::shared_ptr<rmw_request_id_t> request_header,
+                                                    const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetCompressedMapByName::Request> request)
+{
+    if (!m_workers->post([this, request_header, request]() { answerGetCompressedMapByName(request_header, request); }))
+    {
+        yCWarning(MAP2D_NWS_ROS2) << "Closing, the request for map" << request->name << "is dropped";
+    }
+}
+
+void Map2D_nws_ros2::answerGetCompressedMapByName(const std::shared_ptr<rmw_request_id_t> request_header,
+                                                  const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetCompressedMapByName::Request> request)
+{
+    map2d_nws_ros2_msgs::srv::GetCompressedMapByName::Response response;
     MapGrid2D theMap;
-    if(!m_iMap2D->get_map(request->name,theMap))
+    if (!getMapCopy(request->name, theMap))
     {
-        mapToGo.header.frame_id = "invalid_frame";
-        response->map = mapToGo;
+        response.map.header.frame_id = "invalid_frame";
+        m_ros2Service_getCompressedMapByName->send_response(*request_header, response);
         return;
     }
-    mapToGo.info.map_load_time = m_node->get_clock()->now();
-    mapToGo.header.stamp = m_node->get_clock()->now();
-    mapToGo.info.height = theMap.height();
-    mapToGo.info.width = theMap.width();
+
+    // The cells are needed anyway to know if the map changed, the encoding is what is saved
+    nav_msgs::msg::MapMetaData info;
+    convertMapInfo(theMap, info);
+    std::vector<int8_t> cells(theMap.width()*theMap.height());
+    convertMapData(theMap, cells.data());
+
+    {
+        std::lock_guard<std::mutex> lock(m_compressedMapsMutex);
+        auto& cached = m_compressedMaps[request->name];
+        info.map_load_time = cached.msg.info.map_load_time;
+        if (cached.msg.encoding.empty() || cached.msg.info != info || cached.cells != cells)
+        {
+            convertMapInfo(theMap, cached.msg.info);
+            cached.msg.header.frame_id = "map";
+            cached.msg.header.stamp = cached.msg.info.map_load_time;
+            cached.msg.encoding = "rle";
+            cached.msg.version = ++m_compressedMapsVersion;
+            map2DEncodeRle(cells.data(), cells.size(), cached.msg.data);
+            cached.cells = std::move(cells);
+            yCDebug(MAP2D_NWS_ROS2) << "Map" << request->name << "compressed from" << cached.cells.size() << "to" << cached.msg.data.size() << "bytes";
+        }
+        response.map = cached.msg;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_currentMapName = request->name;
+    }
+
+    m_ros2Publisher_compressedMap->publish(response.map);
+    m_ros2Service_getCompressedMapByName->send_response(*request_header, response);
+}
+
+bool Map2D_nws_ros2::getMapCopy(const std::string& name, MapGrid2D& theMap)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_iMap2D && m_iMap2D->get_map(name, theMap);
+}
+
+//void Map2D_nws_ros2::prepareMapMsg(MapGrid2D inputMap, nav_msgs::msg::OccupancyGrid &outputMsg)
+void Map2D_nws_ros2::convertMapInfo(const MapGrid2D& theMap, nav_msgs::msg::MapMetaData& info)
+{
+    info.map_load_time = m_node->get_clock()->now();
+    info.height = theMap.height();
+    info.width = theMap.width();
 
     double DEG2RAD = M_PI/180.0;
     double tmp=0;
     theMap.getResolution(tmp);
-    mapToGo.info.resolution=tmp;
+    info.resolution=tmp;
     double x, y, t;
     theMap.getOrigin(x,y,t);
-    mapToGo.info.origin.position.x=x;
-    mapToGo.info.origin.position.y=y;
+    info.origin.position.x=x;
+    info.origin.position.y=y;
     yarp::math::Quaternion q;
     yarp::sig::Vector v(4);
     v[0]=0; v[1]=0; v[2]=1; v[3]=t*DEG2RAD;
     q.fromAxisAngle(v);
-    mapToGo.info.origin.orientation.x = q.x();
-    mapToGo.info.origin.orientation.y = q.y();
-    mapToGo.info.origin.orientation.z = q.z();
-    mapToGo.info.origin.orientation.w = q.w();
-    mapToGo.data.resize(theMap.width()*theMap.height());
-    int index=0;
+    info.origin.orientation.x = q.x();
+    info.origin.orientation.y = q.y();
+    info.origin.orientation.z = q.z();
+    info.origin.orientation.w = q.w();
+}
+
+void Map2D_nws_ros2::convertMapData(const MapGrid2D& theMap, int8_t* data)
+{
+    double tmp=0;
+    size_t index=0;
     yarp::dev::Nav2D::XYCell cell;
     for (cell.y=theMap.height(); cell.y-- > 0;)
     {
       for (cell.x=0; cell.x<theMap.width(); cell.x++)
       {
         theMap.getOccupancyData(cell,tmp);
-        mapToGo.data[index++]=(int)tmp;
+        data[index++]=(int8_t)tmp;
       }
     }
-
-    response->map = mapToGo;
-    m_currentMapName = request->name;
-
-    metaToGo.map_load_time = mapToGo.info.map_load_time;
-    metaToGo.height = theMap.height();
-    metaToGo.width = theMap.width();
-    metaToGo.origin = mapToGo.info.origin;
-    metaToGo.resolution = mapToGo.info.resolution;
-
-    if (m_ros2Publisher_map)
-    {
-        m_ros2Publisher_map->publish(mapToGo);
-    }
 }
@@ -7,9 +7,11 @@
 #define YARP_DEV_MAP2D_NWS_ROS2_H
 
 #include <vector>
+#include <map>
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <memory>
 #include <mutex>
 
 #include <yarp/os/Network.h>
@@ -45,6 +47,14 @@
 
 //Custom ros2 interfaces
 #include <map2d_nws_ros2_msgs/srv/get_map_by_name.hpp>
+#include <map2d_nws_ros2_msgs/srv/get_map_handle_by_name.hpp>
+#include <map2d_nws_ros2_msgs/srv/get_compressed_map_by_name.hpp>
+#include <map2d_nws_ros2_msgs/msg/compressed_occupancy_grid.hpp>
+
+#include <Ros2Spinner.h>
+#include <Ros2WorkerPool.h>
+
+#include <Map2DSharedMemory.h>
 
 
 /**
@@ -60,16 +70,35 @@
  * | name           |      -        | string  | -       | map2D_nws_ros         | No          | Device name prefix                                            |                                                                                                 |
  * | getmap         |      -        | string  | -       | getMap                | No          | The "GetMap" ROS service name                                 |               For the moment being the service always responds with an empty map                |
  * | getmapbyname   |      -        | string  | -       | getMapByName          | No          | The "GetMapByName" ROS2  custom service name                  | The map returned by this service is also available via publisher named "getmapbyname value"/pub |
+ * | getcompressedmapbyname | -     | string  | -       | getCompressedMapByName | No         | The "GetCompressedMapByName" ROS2 custom service name         | The map returned by this service is also available via publisher named "getcompressedmapbyname value"/pub |
  * | roscmdparser   |      -        | string  | -       | rosCmdParser          | No          | The "BasicTypes" ROS service name                             |             This is used to send commands to the nws via ros2 BasicTypes service                |
  * | markers_pub    |      -        | string  | -       | locationServerMarkers | No          | The visual markers array publisher name                       |                                                                                                 |
  * | node_name      |      -        | string  | -       |         -             | No          | The ROS2 node name. If absent, the device name will be used   |                                                                                                 |
+ * | workers        |      -        | int     | -       |         2             | No          | Number of threads converting the maps requested by name       | The other services are served directly by the executor of the node                              |
+ * | shm_maps       |      -        | bool    | -       |       false           | No          | Serve the maps also through POSIX shared memory               | Not available on Windows. See the notes below                                                   |
+ * | getmaphandlebyname |   -       | string  | -       | getMapHandleByName    | No          | The "GetMapHandleByName" ROS2 custom service name             | Only created when shm_maps is true                                                              |
 
  * \section Notes:
  * Integration with ROS2 map server is currently under development.
+ *
+ * The services are spun by the device. The conversion of a map requested by name can take long,
+ * so it runs on a pool of worker threads which answer the request when the map is ready,
+ * meanwhile the other services keep being served.
+ *
+ * Transferring a large map through a service response copies it several times. When shm_maps is
+ * enabled, the clients running on the same host can call the "GetMapHandleByName" service instead:
+ * the map is written once to a read-only shared memory segment, and the response only contains
+ * its name, version and metadata. The segment can then be mapped in constant time with
+ * Map2DSharedMemoryReader, or directly with shm_open() and mmap(). A segment is never modified,
+ * a map that changed is written to a new segment with a new version.
+ *
+ * Remote clients can use the "GetCompressedMapByName" service, which returns the map with its cells
+ * run length encoded (see CompressedOccupancyGrid.msg) and decoded by map2DDecompress(). The
+ * compressed map is cached and only encoded again when the map changes.
+ * Map2DSharedMemoryReader and map2DDecompress() are in the Map2DUtils library, for the clients.
  */
 
 class Map2D_nws_ros2 :
-        public yarp::os::Thread,
         public yarp::dev::DeviceDriver,
         public yarp::os::PortReader,
         public yarp::dev::WrapperSingle
@@ -93,16 +122,27 @@ public:
                         const std::shared_ptr<nav_msgs::srv::GetMap::Request> request,
                         std::shared_ptr<nav_msgs::srv::GetMap::Response> response);
     void getMapByNameCallback(const std::shared_ptr<rmw_request_id_t> request_header,
-                              const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapByName::Request> request,
-                              std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapByName::Response> response);
+                              const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapByName::Request> request);
     void rosCmdParserCallback(const std::shared_ptr<rmw_request_id_t> request_header,
                          const std::shared_ptr<test_msgs::srv::BasicTypes::Request> request,
                          std::shared_ptr<test_msgs::srv::BasicTypes::Response> response);
+    void getCompressedMapByNameCallback(const std::shared_ptr<rmw_request_id_t> request_header,
+                                        const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetCompressedMapByName::Request> request);
+    void getMapHandleByNameCallback(const std::shared_ptr<rmw_request_id_t> request_header,
+                                    const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapHandleByName::Request> request);
     bool updateVizMarkers();
 
-    void run() override;
-
 private:
+    bool getMapCopy(const std::string& name, yarp::dev::Nav2D::MapGrid2D& theMap);
+    void answerGetCompressedMapByName(const std::shared_ptr<rmw_request_id_t> request_header,
+                                      const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetCompressedMapByName::Request> request);
+    void answerGetMapHandleByName(const std::shared_ptr<rmw_request_id_t> request_header,
+                                  const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapHandleByName::Request> request);
+    void convertMapInfo(const yarp::dev::Nav2D::MapGrid2D& theMap, nav_msgs::msg::MapMetaData& info);
+    static void convertMapData(const yarp::dev::Nav2D::MapGrid2D& theMap, int8_t* data);
+    void answerGetMapByName(const std::shared_ptr<rmw_request_id_t> request_header,
+                            const std::shared_ptr<map2d_nws_ros2_msgs::srv::GetMapByName::Request> request);
+
     //drivers and interfaces
     yarp::dev::Nav2D::IMap2D*    m_iMap2D = nullptr;
     yarp::dev::PolyDriver        m_drv;
@@ -113,10 +153,13 @@ private:
     std::string                  m_rosCmdParserName{"rosCmdParser"};
     std::string                  m_getMapName{"getMap"};
     std::string                  m_getMapByNameName{"getMapByName"};
+    std::string                  m_getMapHandleByNameName{"getMapHandleByName"};
+    std::string                  m_getCompressedMapByNameName{"getCompressedMapByName"};
     std::string                  m_markersName{"locationServerMarkers"};
     std::string                  m_currentMapName{"none"};
     std::string                  m_nodeName;
-    bool                         m_spinned{false};
+    size_t                       m_workersNumber{2};
+    bool                         m_shmMaps{false};
 
     yarp::os::RpcServer                                                    m_rpcPort;
     rclcpp::Node::SharedPtr                                                m_node;
@@ -125,6 +168,31 @@ private:
     rclcpp::Service<nav_msgs::srv::GetMap>::SharedPtr                      m_ros2Service_getMap{nullptr};
     rclcpp::Service<map2d_nws_ros2_msgs::srv::GetMapByName>::SharedPtr     m_ros2Service_getMapByName{nullptr};
     rclcpp::Service<test_msgs::srv::BasicTypes>::SharedPtr                 m_ros2Service_rosCmdParser{nullptr};
+    rclcpp::Service<map2d_nws_ros2_msgs::srv::GetMapHandleByName>::SharedPtr m_ros2Service_getMapHandleByName{nullptr};
+    rclcpp::Service<map2d_nws_ros2_msgs::srv::GetCompressedMapByName>::SharedPtr m_ros2Service_getCompressedMapByName{nullptr};
+    rclcpp::Publisher<map2d_nws_ros2_msgs::msg::CompressedOccupancyGrid>::SharedPtr m_ros2Publisher_compressedMap{nullptr};
+    std::unique_ptr<Ros2Spinner>                                           m_spinner;
+    std::unique_ptr<Ros2WorkerPool>                                        m_workers;
+    std::unique_ptr<Map2DSharedMemoryWriter>                               m_shmWriter;
+
+    // The last map written to shared memory under every name, with its segment
+    struct SharedMap
+    {
+        yarp::dev::Nav2D::MapGrid2D map;
+        Map2DSharedMemoryWriter::Handle handle;
+    };
+    std::mutex                                                             m_sharedMapsMutex;
+    std::map<std::string, SharedMap>                                       m_sharedMaps;
+
+    // The last compressed version of every map, with the cells it was encoded from
+    struct CompressedMap
+    {
+        std::vector<int8_t> cells;
+        map2d_nws_ros2_msgs::msg::CompressedOccupancyGrid msg;
+    };
+    std::mutex                                                             m_compressedMapsMutex;
+    std::map<std::string, CompressedMap>                                   m_compressedMaps;
+    uint64_t                                                               m_compressedMapsVersion{0};
 };
 
 
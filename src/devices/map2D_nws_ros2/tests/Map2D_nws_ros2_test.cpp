@@ -45,5 +45,18 @@ TEST_CASE("dev::Map2D_nws_ros2_test", "[yarp::dev]")
         }
     }
 
+#if !defined(_WIN32)
+    SECTION("Checking map2D_nws_ros2 device with shared memory maps")
+    {
+        PolyDriver ddmapserver;
+
+        Property pmapserver_cfg;
+        pmapserver_cfg.put("device", "map2D_nws_ros2");
+        pmapserver_cfg.put("shm_maps", true);
+        REQUIRE(ddmapserver.open(pmapserver_cfg));
+        CHECK(ddmapserver.close());
+    }
+#endif
+
     Network::setLocalMode(false);
 }
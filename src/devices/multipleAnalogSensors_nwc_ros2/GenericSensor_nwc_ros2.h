@@ -10,10 +10,14 @@
 #include <yarp/dev/DeviceDriver.h>
 #include <yarp/dev/IMultipleWrapper.h>
 #include <yarp/dev/MultipleAnalogSensorsInterfaces.h>
+#include <yarp/os/Bottle.h>
 #include <yarp/os/Log.h>
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/LogStream.h>
+#include <limits>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #include <rclcpp/rclcpp.hpp>
 #include <Ros2Utils.h>
@@ -39,6 +43,11 @@ YARP_DECLARE_LOG_COMPONENT(GENERICSENSOR_NWC_ROS2)
  * | topic_name     |      -         | string  | -              |   -              | Yes                         | The name of the ROS topic opened by this device.                  | MUST start with a '/' character |
  * | node_name      |      -         | string  | -              |   -              | Yes                         | The name of the ROS node opened by this device                    | Autogenerated by default        |
  * | sensor_name    |      -         | string  | -              |   -              | Yes                         | The name of the sensor the data are coming from                   |                                 |
+ * | topic_names    |      -         | list of strings | -      |   -              | No                          | The topics of several sensors of the same type, one per sensor    | Replaces topic_name             |
+ * | sensor_names   |      -         | list of strings | -      |   -              | No                          | The names of the sensors of topic_names, in the same order        | Replaces sensor_name            |
+ *
+ * With topic_names a single node subscribes to all the topics, and the sensor index of the YARP
+ * interfaces is the position of the topic in the list.
  */
 
 template <class ROS_MSG>
@@ -48,19 +57,31 @@ class GenericSensor_nwc_ros2 :
 protected:
     double        m_periodInS{0.01};
     double        m_timestamp;
-    std::string   m_subscriptionName;
+    std::vector<std::string> m_subscriptionNames;
     std::string   m_rosNodeName;
     std::string   m_framename;
-    std::string   m_sensorName;
+    std::vector<std::string> m_sensorNames;
     Ros2Spinner*  m_spinner{nullptr};
     const size_t  m_sens_index = 0;
     mutable std::mutex      m_dataMutex;
     yarp::dev::MAS_status   m_internalStatus;
     rclcpp::Node::SharedPtr m_node;
-    typename rclcpp::Subscription<ROS_MSG>::SharedPtr m_subscription;
+    std::vector<typename rclcpp::Subscription<ROS_MSG>::SharedPtr> m_subscriptions;
+
+    // Subscription callback of the topic of the sensor sens_index. To be implemented for each derived device
+    virtual void subscription_callback(size_t sens_index, const std::shared_ptr<ROS_MSG> msg)=0;
+
+    // The number of sensors the derived device can expose
+    virtual size_t maxSensors() const
+    {
+        return std::numeric_limits<size_t>::max();
+    }
 
-    // Subscription callback. To be implemented for each derived device
-    virtual void subscription_callback(const std::shared_ptr<ROS_MSG> msg)=0;
+    // Called when the sensors are known, before subscribing to their topics
+    virtual bool configureSensors()
+    {
+        return true;
+    }
 
 public:
     GenericSensor_nwc_ros2();
@@ -75,7 +96,6 @@ template <class ROS_MSG>
 GenericSensor_nwc_ros2<ROS_MSG>::GenericSensor_nwc_ros2()
 {
     m_node = nullptr;
-    m_subscription=nullptr;
     m_timestamp=0;
 }
 
@@ -85,9 +105,29 @@ GenericSensor_nwc_ros2<ROS_MSG>::~GenericSensor_nwc_ros2() = default;
 template <class ROS_MSG>
 bool GenericSensor_nwc_ros2<ROS_MSG>::open(yarp::os::Searchable & config)
 {
-    if (!config.check("topic_name")) {
-        yCError(GENERICSENSOR_NWC_ROS2, "Missing topic_name parameter, exiting.");
-        return false;
+    if (config.check("topic_names")) {
+        yarp::os::Bottle* topics = config.find("topic_names").asList();
+        yarp::os::Bottle* sensors = config.find("sensor_names").asList();
+        if (!topics || !sensors || topics->size() == 0 || topics->size() != sensors->size()) {
+            yCError(GENERICSENSOR_NWC_ROS2) << "topic_names and sensor_names must be two lists of the same, non zero, size";
+            return false;
+        }
+        for (size_t i = 0; i < topics->size(); i++) {
+            m_subscriptionNames.push_back(topics->get(i).asString());
+            m_sensorNames.push_back(sensors->get(i).asString());
+        }
+    } else {
+        if (!config.check("topic_name")) {
+            yCError(GENERICSENSOR_NWC_ROS2, "Missing topic_name parameter, exiting.");
+            return false;
+        }
+
+        if (!config.check("sensor_name")) {
+            yCError(GENERICSENSOR_NWC_ROS2, "Missing sensor_name parameter, exiting.");
+            return false;
+        }
+        m_subscriptionNames.push_back(config.find("topic_name").asString());
+        m_sensorNames.push_back(config.find("sensor_name").asString());
     }
 
     if (!config.check("node_name"))
@@ -96,38 +136,45 @@ bool GenericSensor_nwc_ros2<ROS_MSG>::open(yarp::os::Searchable & config)
         return false;
     }
 
-    if (!config.check("sensor_name")) {
-        yCError(GENERICSENSOR_NWC_ROS2, "Missing sensor_name parameter, exiting.");
-        return false;
-    }
-
     m_rosNodeName = config.find("node_name").asString();
     if (m_rosNodeName.c_str()[0] == '/') {
         yCError(GENERICSENSOR_NWC_ROS2) << "node name cannot begin with /";
         return false;
     }
 
-    m_subscriptionName = config.find("topic_name").asString();
-    if (m_subscriptionName.c_str()[0] != '/') {
-        yCError(GENERICSENSOR_NWC_ROS2) << "Missing '/' in topic_name parameter";
+    for (const auto& topic : m_subscriptionNames) {
+        if (topic.c_str()[0] != '/') {
+            yCError(GENERICSENSOR_NWC_ROS2) << "Missing '/' in topic name" << topic;
+            return false;
+        }
+    }
+
+    if (m_subscriptionNames.size() > maxSensors()) {
+        yCError(GENERICSENSOR_NWC_ROS2) << "This device supports at most" << maxSensors() << "sensors";
         return false;
     }
 
-    m_sensorName = config.find("sensor_name").asString();
+    if (!configureSensors()) {
+        return false;
+    }
 
     m_node = NodeCreator::createNode(m_rosNodeName);
-    m_subscription = m_node->create_subscription<ROS_MSG>(m_subscriptionName, rclcpp::QoS(10),
-                                                          std::bind(&GenericSensor_nwc_ros2<ROS_MSG>::subscription_callback,
-                                                          this, std::placeholders::_1));
 
     if (m_node == nullptr) {
         yCError(GENERICSENSOR_NWC_ROS2) << "Opening " << m_rosNodeName << " Node creation failed, check your yarp-ROS network configuration\n";
         return false;
     }
 
-    if (m_subscription == nullptr) {
-        yCError(GENERICSENSOR_NWC_ROS2) << "Opening " << m_subscriptionName << " Topic failed, check your yarp-ROS network configuration\n";
-        return false;
+    for (size_t i = 0; i < m_subscriptionNames.size(); i++) {
+        auto subscription = m_node->create_subscription<ROS_MSG>(m_subscriptionNames[i], rclcpp::QoS(10),
+                                                                 [this, i](const std::shared_ptr<ROS_MSG> msg) {
+                                                                     this->subscription_callback(i, msg);
+                                                                 });
+        if (subscription == nullptr) {
+            yCError(GENERICSENSOR_NWC_ROS2) << "Opening " << m_subscriptionNames[i] << " Topic failed, check your yarp-ROS network configuration\n";
+            return false;
+        }
+        m_subscriptions.push_back(subscription);
     }
 
     m_internalStatus = yarp::dev::MAS_status::MAS_WAITING_FOR_FIRST_READ;
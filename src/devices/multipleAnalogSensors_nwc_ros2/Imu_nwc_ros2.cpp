@@ -17,8 +17,9 @@
 
 YARP_LOG_COMPONENT(GENERICSENSOR_NWC_ROS2, "yarp.device.imu_nwc_ros2")
 
-void Imu_nwc_ros2::subscription_callback(const std::shared_ptr<sensor_msgs::msg::Imu> msg)
+void Imu_nwc_ros2::subscription_callback(size_t sens_index, const std::shared_ptr<sensor_msgs::msg::Imu> msg)
 {
+    YARP_UNUSED(sens_index);
     std::lock_guard<std::mutex> dataGuard(m_dataMutex);
     if(m_internalStatus == yarp::dev::MAS_status::MAS_WAITING_FOR_FIRST_READ) { m_internalStatus = yarp::dev::MAS_status::MAS_OK; }
     m_currentData = *msg;
@@ -50,7 +51,7 @@ bool Imu_nwc_ros2::getThreeAxisLinearAccelerometerMeasure(size_t sens_index, yar
 bool Imu_nwc_ros2::getThreeAxisLinearAccelerometerName(size_t sens_index, std::string &name) const
 {
     YARP_UNUSED(sens_index);
-    name = m_sensorName;
+    name = m_sensorNames[0];
 
     return true;
 }
@@ -107,7 +108,7 @@ bool Imu_nwc_ros2::getThreeAxisGyroscopeMeasure(size_t sens_index, yarp::sig::Ve
 bool Imu_nwc_ros2::getThreeAxisGyroscopeName(size_t sens_index, std::string &name) const
 {
     YARP_UNUSED(sens_index);
-    name = m_sensorName;
+    name = m_sensorNames[0];
 
     return true;
 }
@@ -173,7 +174,7 @@ bool Imu_nwc_ros2::getOrientationSensorMeasureAsRollPitchYaw(size_t sens_index,
 bool Imu_nwc_ros2::getOrientationSensorName(size_t sens_index, std::string &name) const
 {
     YARP_UNUSED(sens_index);
-    name = m_sensorName;
+    name = m_sensorNames[0];
 
     return true;
 }
@@ -42,7 +42,11 @@ public:
     using GenericSensor_nwc_ros2<sensor_msgs::msg::Imu>::close;
 
 protected:
-    void subscription_callback(const std::shared_ptr<sensor_msgs::msg::Imu> msg) override;
+    void subscription_callback(size_t sens_index, const std::shared_ptr<sensor_msgs::msg::Imu> msg) override;
+    size_t maxSensors() const override
+    {
+        return 1;
+    }
 public:
     /* IThreeAxisLinearAccelerometers methods */
     size_t getNrOfThreeAxisLinearAccelerometers() const override;
@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "WrenchStamped_nwc_ros2.h"
+
+YARP_LOG_COMPONENT(GENERICSENSOR_NWC_ROS2, "yarp.device.wrenchStamped_nwc_ros2")
+
+bool WrenchStamped_nwc_ros2::configureSensors()
+{
+    m_samples = std::make_unique<SeqLock<Sample>[]>(m_sensorNames.size());
+    m_frameNames.assign(m_sensorNames.size(), "");
+    return true;
+}
+
+void WrenchStamped_nwc_ros2::subscription_callback(size_t sens_index, const std::shared_ptr<geometry_msgs::msg::WrenchStamped> msg)
+{
+    Sample sample;
+    sample.wrench[0] = msg->wrench.force.x;
+    sample.wrench[1] = msg->wrench.force.y;
+    sample.wrench[2] = msg->wrench.force.z;
+    sample.wrench[3] = msg->wrench.torque.x;
+    sample.wrench[4] = msg->wrench.torque.y;
+    sample.wrench[5] = msg->wrench.torque.z;
+    sample.timestamp = yarpTimeFromRos2(msg->header.stamp);
+
+    // Only the callbacks write the frame names, so reading them here needs no lock.
+    // The frame is set before the sample, so it is known once the sensor is ready
+    if (m_frameNames[sens_index] != msg->header.frame_id) {
+        std::lock_guard<std::mutex> dataGuard(m_dataMutex);
+        m_frameNames[sens_index] = msg->header.frame_id;
+    }
+    m_samples[sens_index].store(sample);
+}
+
+bool WrenchStamped_nwc_ros2::checkIndex(size_t sens_index) const
+{
+    if (sens_index >= m_sensorNames.size()) {
+        yCError(GENERICSENSOR_NWC_ROS2) << "Sensor index" << sens_index << "out of range, there are" << m_sensorNames.size() << "sensors";
+        return false;
+    }
+    return true;
+}
+
+// ISixAxisForceTorqueSensors ----------------------------------------------------------------------------------------------------- START //
+size_t WrenchStamped_nwc_ros2::getNrOfSixAxisForceTorqueSensors() const
+{
+    return m_sensorNames.size();
+}
+
+yarp::dev::MAS_status WrenchStamped_nwc_ros2::getSixAxisForceTorqueSensorStatus(size_t sens_index) const
+{
+    if (!checkIndex(sens_index)) {
+        return yarp::dev::MAS_status::MAS_ERROR;
+    }
+    if (m_samples[sens_index].empty()) {
+        return yarp::dev::MAS_status::MAS_WAITING_FOR_FIRST_READ;
+    }
+    return yarp::dev::MAS_status::MAS_OK;
+}
+
+bool WrenchStamped_nwc_ros2::getSixAxisForceTorqueSensorName(size_t sens_index, std::string &name) const
+{
+    if (!checkIndex(sens_index)) {
+        return false;
+    }
+    name = m_sensorNames[sens_index];
+
+    return true;
+}
+
+bool WrenchStamped_nwc_ros2::getSixAxisForceTorqueSensorFrameName(size_t sens_index, std::string &frameName) const
+{
+    if (!checkIndex(sens_index)) {
+        return false;
+    }
+    if (m_samples[sens_index].empty()) {
+        yCError(GENERICSENSOR_NWC_ROS2) << "No data received yet";
+        return false;
+    }
+    std::lock_guard<std::mutex> dataGuard(m_dataMutex);
+    frameName = m_frameNames[sens_index];
+
+    return true;
+}
+
+bool WrenchStamped_nwc_ros2::getSixAxisForceTorqueSensorMeasure(size_t sens_index, yarp::sig::Vector& out, double& timestamp) const
+{
+    if (!checkIndex(sens_index)) {
+        return false;
+    }
+    Sample sample;
+    if (!m_samples[sens_index].load(sample)) {
+        yCError(GENERICSENSOR_NWC_ROS2) << "No data received yet";
+        return false;
+    }
+    out.resize(6);
+    for (size_t i = 0; i < 6; i++) {
+        out[i] = sample.wrench[i];
+    }
+    timestamp = sample.timestamp;
+
+    return true;
+}
+// ISixAxisForceTorqueSensors ------------------------------------------------------------------------------------------------------- END //
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_DEV_WRENCHSTAMPED_NWC_ROS2_H
+#define YARP_DEV_WRENCHSTAMPED_NWC_ROS2_H
+
+#include "GenericSensor_nwc_ros2.h"
+#include <SeqLock.h>
+#include <geometry_msgs/msg/wrench_stamped.hpp>
+
+#include <memory>
+
+/**
+ * @ingroup dev_impl_wrapper
+ *
+ * \brief `WrenchStamped_nwc_ros2`: This device subscribes to ROS topics of type geometry_msgs::WrenchStamped and exposes them as six axis force torque sensors.
+ *
+ * | YARP device name |
+ * |:-----------------:|
+ * | `WrenchStamped_nwc_ros2` |
+ *
+ * The parameters accepted by this device are:
+ * | Parameter name | SubParameter   | Type    | Units          | Default Value    | Required                    | Description                                                       | Notes |
+ * |:--------------:|:--------------:|:-------:|:--------------:|:----------------:|:--------------------------: |:-----------------------------------------------------------------:|:-----:|
+ * | topic_name     |      -         | string  | -              |   -              | Yes, or topic_names         | The name of the ROS topic opened by this device.                  | MUST start with a '/' character |
+ * | node_name      |      -         | string  | -              |   -              | Yes                         | The name of the ROS node opened by this device                    | Autogenerated by default |
+ * | sensor_name    |      -         | string  | -              |   -              | Yes, or sensor_names        | The name of the sensor the data are coming from                   |  |
+ * | topic_names    |      -         | list of strings | -      |   -              | No                          | The topics of all the force torque sensors, one per sensor        | Replaces topic_name |
+ * | sensor_names   |      -         | list of strings | -      |   -              | No                          | The names of the sensors of topic_names, in the same order        | Replaces sensor_name |
+ *
+ * The latest measure of every sensor is kept in a SeqLock, so reading a measure never takes a
+ * lock and never delays the reception of the messages.
+ */
+class WrenchStamped_nwc_ros2 : public GenericSensor_nwc_ros2<geometry_msgs::msg::WrenchStamped>,
+                               public yarp::dev::ISixAxisForceTorqueSensors
+{
+private:
+    struct Sample
+    {
+        double wrench[6];
+        double timestamp;
+    };
+
+    // One for each sensor, written by the subscription callbacks
+    std::unique_ptr<SeqLock<Sample>[]> m_samples;
+    // Guarded by m_dataMutex
+    std::vector<std::string> m_frameNames;
+
+    bool checkIndex(size_t sens_index) const;
+
+public:
+    using GenericSensor_nwc_ros2<geometry_msgs::msg::WrenchStamped>::GenericSensor_nwc_ros2;
+
+    using GenericSensor_nwc_ros2<geometry_msgs::msg::WrenchStamped>::open;
+    using GenericSensor_nwc_ros2<geometry_msgs::msg::WrenchStamped>::close;
+
+protected:
+    void subscription_callback(size_t sens_index, const std::shared_ptr<geometry_msgs::msg::WrenchStamped> msg) override;
+    bool configureSensors() override;
+
+public:
+    /* ISixAxisForceTorqueSensors methods */
+    size_t getNrOfSixAxisForceTorqueSensors() const override;
+    yarp::dev::MAS_status getSixAxisForceTorqueSensorStatus(size_t sens_index) const override;
+    bool getSixAxisForceTorqueSensorName(size_t sens_index, std::string &name) const override;
+    bool getSixAxisForceTorqueSensorFrameName(size_t sens_index, std::string &frameName) const override;
+    bool getSixAxisForceTorqueSensorMeasure(size_t sens_index, yarp::sig::Vector& out, double& timestamp) const override;
+};
+
+#endif // YARP_DEV_WRENCHSTAMPED_NWC_ROS2_H
@@ -29,6 +29,7 @@ TEST_CASE("dev::MultipleAnalogSensors_nwc_ros2_test", "[yarp::dev]")
 {
     YARP_REQUIRE_PLUGIN("fakeIMU", "device");
     YARP_REQUIRE_PLUGIN("imu_nws_ros2", "device");
+    YARP_REQUIRE_PLUGIN("wrenchStamped_nwc_ros2", "device");
 
 //#if defined(DISABLE_FAILING_TESTS)
 //    YARP_SKIP_TEST("Skipping failing tests")
@@ -180,5 +181,58 @@ TEST_CASE("dev::MultipleAnalogSensors_nwc_ros2_test", "[yarp::dev]")
         nwc.close();
     }
 
+    SECTION("Test the wrench nwc with several topics")
+    {
+        yarp::dev::ISixAxisForceTorqueSensors* iTestFT;
+        yarp::dev::PolyDriver nwc;
+
+        yarp::os::Property pNwc;
+        pNwc.fromString("(device wrenchStamped_nwc_ros2) (node_name wrench_node) (topic_names (/l_arm_ft /r_arm_ft)) (sensor_names (l_arm_ft r_arm_ft))");
+        REQUIRE(nwc.open(pNwc)); // wrench nwc open reported successful
+
+        REQUIRE(nwc.view(iTestFT)); // ISixAxisForceTorqueSensors view reported successul
+        REQUIRE(iTestFT->getNrOfSixAxisForceTorqueSensors() == 2);
+        std::string gotSensName;
+        REQUIRE(iTestFT->getSixAxisForceTorqueSensorName(1, gotSensName));
+        REQUIRE(gotSensName == "r_arm_ft");
+        REQUIRE_FALSE(iTestFT->getSixAxisForceTorqueSensorName(2, gotSensName));
+
+        std::stringstream callStream;
+        callStream << "ros2 topic pub --once /r_arm_ft geometry_msgs/msg/WrenchStamped \"{header: {stamp: {sec: 10, nanosec: 500000000}, ";
+        callStream << "frame_id: 'r_arm_ft_frame'}, wrench: {force: {x: 1.0, y: 2.0, z: 3.0}, torque: {x: 4.0, y: 5.0, z: 6.0}}}\"";
+        system(callStream.str().c_str());
+
+        while(iTestFT->getSixAxisForceTorqueSensorStatus(1) != yarp::dev::MAS_status::MAS_OK)
+        {
+            std::this_thread::sleep_for(250ms);
+        }
+        CHECK(iTestFT->getSixAxisForceTorqueSensorStatus(0) == yarp::dev::MAS_status::MAS_WAITING_FOR_FIRST_READ);
+
+        yarp::sig::Vector wrench;
+        double timeStamp;
+        std::string gotFrameName;
+        REQUIRE(iTestFT->getSixAxisForceTorqueSensorFrameName(1, gotFrameName));
+        REQUIRE(gotFrameName == "r_arm_ft_frame");
+        REQUIRE(iTestFT->getSixAxisForceTorqueSensorMeasure(1, wrench, timeStamp));
+        REQUIRE(wrench.size() == 6);
+        for (size_t i = 0; i < 6; i++) {
+            REQUIRE(wrench[i] == Catch::Approx(i + 1.0));
+        }
+        REQUIRE(timeStamp == Catch::Approx(10.5));
+        REQUIRE_FALSE(iTestFT->getSixAxisForceTorqueSensorMeasure(0, wrench, timeStamp));
+
+        // Close devices
+        nwc.close();
+    }
+
+    SECTION("Test mismatched topic and sensor names")
+    {
+        yarp::dev::PolyDriver nwc;
+
+        yarp::os::Property pNwc;
+        pNwc.fromString("(device wrenchStamped_nwc_ros2) (node_name wrench_node) (topic_names (/l_arm_ft /r_arm_ft)) (sensor_names (l_arm_ft))");
+        REQUIRE_FALSE(nwc.open(pNwc)); // each topic needs a sensor name
+    }
+
     yarp::os::Network::setLocalMode(false);
 }
@@ -10,12 +10,25 @@
 #include <yarp/dev/DeviceDriver.h>
 #include <yarp/dev/IMultipleWrapper.h>
 #include <yarp/dev/MultipleAnalogSensorsInterfaces.h>
+#include <yarp/os/Bottle.h>
 #include <yarp/os/Log.h>
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/LogStream.h>
 
 #include <rclcpp/rclcpp.hpp>
 #include <Ros2Utils.h>
+#include <Ros2Parameters.h>
+#include <Ros2ClockDriver.h>
+#include <yarp_sensor_msgs/msg/sensor_batch.hpp>
+
+#include "SensorSampleBatcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 
 
 // The log component is defined in each device, with a specialized name
@@ -34,9 +47,24 @@ YARP_DECLARE_LOG_COMPONENT(GENERICSENSOR_NWS_ROS2)
  * The parameters accepted by this device are:
  * | Parameter name | SubParameter   | Type    | Units          | Default Value    | Required                    | Description                                                       | Notes |
  * |:--------------:|:--------------:|:-------:|:--------------:|:----------------:|:--------------------------: |:-----------------------------------------------------------------:|:-----:|
- * | topic_name     |      -         | string  | -              |   -              | Yes                         | The name of the ROS topic opened by this device.                  | MUST start with a '/' character |
+ * | topic_name     |      -         | string  | -              |   -              | Yes, or topic_names         | The name of the ROS topic opened by this device.                  | MUST start with a '/' character |
+ * | topic_names    |      -         | list of strings | -      |   -              | No                          | One topic per sensor, the i-th topic publishes the i-th sensor    | Replaces topic_name |
  * | node_name      |      -         | string  | -              |   -              | Yes                         | The name of the ROS node opened by this device                    | Autogenerated by default |
- * | period         |      -         | double  | s              |   -              | Yes                         | Refresh period of the broadcasted values in seconds               |  |
+ * | period         |      -         | double  | s              |   -              | Yes                         | Refresh period of the broadcasted values in seconds               | Also exposed as the `period` ROS 2 parameter of the node |
+ * | clock_source   |      -         | string  | -              |   system         | No                          | Clock the publishing cycle runs on                                | `system` or `ros`, see Ros2ClockDriver |
+ * | clock_topic    |      -         | string  | -              |   /clock         | No                          | Clock topic used when clock_source is `ros`                       | |
+ * | batch          |      -         | bool    | -              |   false          | No                          | Publish batches of samples instead of the latest sample           | See below |
+ * | batch_topic    |      -         | string  | -              | topic_name/batch | No                          | The topic of the yarp_sensor_msgs/SensorBatch messages            | Only with batch |
+ * | batch_sample_period | -         | double  | s              |   0.001          | No                          | Sampling period of the sensor                                     | Only with batch, should be at most the period of the sensor |
+ * | batch_capacity |      -         | int     | -              | 4 * period / batch_sample_period, at least 16 | No | Samples kept between two batches                          | Only with batch |
+ *
+ * With `batch` the sensor is sampled every batch_sample_period seconds by a separate thread into a
+ * ring buffer, and every `period` seconds the samples stored meanwhile are published together in a
+ * yarp_sensor_msgs/SensorBatch message, in place of the message of the sensor. A sample is stored
+ * only if its timestamp changed, so the batch holds every sample of the sensor as long as
+ * batch_sample_period is not longer than the period of the sensor; the samples that do not fit in
+ * the buffer are counted in the `dropped` field of the next batch. The batch mode publishes a
+ * single sensor, so it cannot be used with more than one topic.
  */
 
 template <class ROS_MSG>
@@ -48,15 +76,29 @@ class GenericSensor_nws_ros2 :
 protected:
     double            m_periodInS{0.01};
     std::string       m_publisherName;
+    std::vector<std::string> m_publisherNames;
     std::string       m_rosNodeName;
     rclcpp::Node::SharedPtr m_node;
+    std::unique_ptr<Ros2Parameters> m_parameters;
+    std::unique_ptr<Ros2ClockDriver> m_clockDriver;
     typename rclcpp::Publisher<ROS_MSG>::SharedPtr m_publisher;
+    std::vector<typename rclcpp::Publisher<ROS_MSG>::SharedPtr> m_publishers;
     yarp::dev::PolyDriver* m_poly;
     double                 m_timestamp;
     std::string            m_framename;
     const size_t           m_sens_index = 0;
     yarp::dev::PolyDriver  m_subdevicedriver;
 
+    // Batching
+    bool m_batch{false};
+    std::string m_batchTopic;
+    double m_batchSamplePeriod{0.001};
+    size_t m_batchCapacity{0};
+    rclcpp::Publisher<yarp_sensor_msgs::msg::SensorBatch>::SharedPtr m_batchPublisher;
+    std::unique_ptr<SensorSampleBatcher> m_batcher;
+    yarp_sensor_msgs::msg::SensorBatch m_batchMsg;
+    std::vector<double> m_batchStamps;
+
 public:
     GenericSensor_nws_ros2();
     virtual ~GenericSensor_nws_ros2();
@@ -75,6 +117,31 @@ public:
 
 protected:
     virtual bool viewInterfaces() = 0;
+
+    // The number of sensors the derived device can publish, one per topic
+    virtual size_t maxSensors() const
+    {
+        return std::numeric_limits<size_t>::max();
+    }
+
+    // Reads the parameters of the derived device, once the node and the publishers are created
+    virtual bool configureSensors(yarp::os::Searchable& config)
+    {
+        YARP_UNUSED(config);
+        return true;
+    }
+
+    // Publishes the latest sample of the sensor
+    virtual void publishSample() = 0;
+
+    // The names of the values of a sample in batch mode
+    virtual std::vector<std::string> sampleChannels() const = 0;
+
+    // Reads a sample in batch mode, called by the sampling thread
+    virtual bool readSample(double* values, double& timestamp) = 0;
+
+private:
+    void publishBatch();
 };
 
 template <class ROS_MSG>
@@ -93,11 +160,27 @@ GenericSensor_nws_ros2<ROS_MSG>::~GenericSensor_nws_ros2() = default;
 template <class ROS_MSG>
 bool GenericSensor_nws_ros2<ROS_MSG>::open(yarp::os::Searchable & config)
 {
-    if (!config.check("topic_name")) {
+    if (config.check("topic_names")) {
+        yarp::os::Bottle* topics = config.find("topic_names").asList();
+        if (!topics || topics->size() == 0) {
+            yCError(GENERICSENSOR_NWS_ROS2, "`topic_names` must be a non empty list of topics, exiting.");
+            return false;
+        }
+        for (size_t i = 0; i < topics->size(); i++) {
+            m_publisherNames.push_back(topics->get(i).asString());
+        }
+    } else if (config.check("topic_name")) {
+        m_publisherNames.push_back(config.find("topic_name").asString());
+    } else {
         yCError(GENERICSENSOR_NWS_ROS2, "Missing `topic_name` parameter, exiting.");
         return false;
     }
 
+    if (m_publisherNames.size() > maxSensors()) {
+        yCError(GENERICSENSOR_NWS_ROS2) << "This device publishes at most" << maxSensors() << "sensors";
+        return false;
+    }
+
     if (!config.check("period")) {
         yCError(GENERICSENSOR_NWS_ROS2, "Missing `period` parameter, exiting.");
         return false;
@@ -127,23 +210,86 @@ bool GenericSensor_nws_ros2<ROS_MSG>::open(yarp::os::Searchable & config)
         return false;
     }
 
-    m_publisherName = config.find("topic_name").asString();
-
-    if (m_publisherName.c_str()[0] != '/') {
-        yCError(GENERICSENSOR_NWS_ROS2) << "Missing '/' in topic_name parameter";
-        return false;
+    for (const auto& topic : m_publisherNames) {
+        if (topic.c_str()[0] != '/') {
+            yCError(GENERICSENSOR_NWS_ROS2) << "Missing '/' in topic name" << topic;
+            return false;
+        }
+    }
+    m_publisherName = m_publisherNames[0];
+
+    m_batch = config.check("batch", yarp::os::Value(false)).asBool();
+    if (m_batch) {
+        if (m_publisherNames.size() > 1) {
+            yCError(GENERICSENSOR_NWS_ROS2) << "batch publishes a single sensor, it cannot be used with more than one topic";
+            return false;
+        }
+        m_batchTopic = config.check("batch_topic", yarp::os::Value(m_publisherName + "/batch")).asString();
+        if (m_batchTopic.c_str()[0] != '/') {
+            yCError(GENERICSENSOR_NWS_ROS2) << "Missing '/' in batch_topic parameter";
+            return false;
+        }
+        m_batchSamplePeriod = config.check("batch_sample_period", yarp::os::Value(0.001)).asFloat64();
+        if (m_batchSamplePeriod <= 0 || m_batchSamplePeriod > m_periodInS) {
+            yCError(GENERICSENSOR_NWS_ROS2) << "batch_sample_period must be positive and not longer than period";
+            return false;
+        }
+        int defaultCapacity = std::max(16, 4 * static_cast<int>(std::ceil(m_periodInS / m_batchSamplePeriod)));
+        int capacity = config.check("batch_capacity", yarp::os::Value(defaultCapacity)).asInt32();
+        if (capacity <= 0) {
+            yCError(GENERICSENSOR_NWS_ROS2) << "batch_capacity must be positive";
+            return false;
+        }
+        m_batchCapacity = static_cast<size_t>(capacity);
     }
 
     m_node = NodeCreator::createNode(m_rosNodeName); // add a ROS node
-    m_publisher = m_node->create_publisher<ROS_MSG>(m_publisherName,rclcpp::QoS(10));
 
     if (m_node == nullptr) {
         yCError(GENERICSENSOR_NWS_ROS2) << "Opening " << m_rosNodeName << " Node, check your yarp-ROS network configuration\n";
         return false;
     }
 
-    if (m_publisher == nullptr) {
-        yCError(GENERICSENSOR_NWS_ROS2) << "Opening " << m_publisherName << " Topic, check your yarp-ROS network configuration\n";
+    if (m_batch) {
+        m_batchPublisher = m_node->create_publisher<yarp_sensor_msgs::msg::SensorBatch>(m_batchTopic, rclcpp::QoS(10));
+        if (m_batchPublisher == nullptr) {
+            yCError(GENERICSENSOR_NWS_ROS2) << "Opening " << m_batchTopic << " Topic, check your yarp-ROS network configuration\n";
+            return false;
+        }
+    } else {
+        for (const auto& topic : m_publisherNames) {
+            auto publisher = m_node->create_publisher<ROS_MSG>(topic, rclcpp::QoS(10));
+            if (publisher == nullptr) {
+                yCError(GENERICSENSOR_NWS_ROS2) << "Opening " << topic << " Topic, check your yarp-ROS network configuration\n";
+                return false;
+            }
+            m_publishers.push_back(publisher);
+        }
+        m_publisher = m_publishers[0];
+    }
+
+    m_clockDriver = std::make_unique<Ros2ClockDriver>(m_node, [this]() { this->run(); });
+    if (!m_clockDriver->configure(config)) {
+        return false;
+    }
+
+    m_parameters = std::make_unique<Ros2Parameters>(m_node);
+    bool ok = m_parameters->addDouble("period", m_periodInS, [this](double period) {
+        if (period <= 0) {
+            return false;
+        }
+        m_periodInS = period;
+        m_clockDriver->setPeriod(m_periodInS);
+        return this->setPeriod(m_periodInS);
+    });
+    if (!ok) {
+        yCError(GENERICSENSOR_NWS_ROS2) << "Unable to initialize the ROS 2 parameters";
+        return false;
+    }
+    if (!configureSensors(config)) {
+        return false;
+    }
+    if (!m_parameters->start()) {
         return false;
     }
 
@@ -155,6 +301,9 @@ bool GenericSensor_nws_ros2<ROS_MSG>::open(yarp::os::Searchable & config)
 template <class ROS_MSG>
 bool GenericSensor_nws_ros2<ROS_MSG>::close()
 {
+    if (m_parameters) {
+        m_parameters->stop();
+    }
     return this->detachAll();
 }
 
@@ -189,9 +338,30 @@ bool GenericSensor_nws_ros2<ROS_MSG>::attachAll(const yarp::dev::PolyDriverList
     // View all the interfaces
     bool ok = viewInterfaces();
 
+    if (ok && m_batch) {
+        m_batchMsg.header.frame_id = m_framename;
+        m_batchMsg.channels = sampleChannels();
+        m_batcher = std::make_unique<SensorSampleBatcher>(m_batchMsg.channels.size(),
+                                                          m_batchCapacity,
+                                                          m_batchSamplePeriod,
+                                                          [this](double* values, double& timestamp) {
+                                                              return this->readSample(values, timestamp);
+                                                          });
+        // Sized for a full buffer, so that publishing a batch never allocates
+        m_batchStamps.reserve(m_batchCapacity);
+        m_batchMsg.stamps.reserve(m_batchCapacity);
+        m_batchMsg.data.reserve(m_batchCapacity * m_batchMsg.channels.size());
+        ok &= m_batcher->start();
+    }
+
     // Set rate period
     ok &= this->setPeriod(m_periodInS);
-    ok &= this->start();
+    ok &= m_clockDriver->setPeriod(m_periodInS);
+    if (m_clockDriver->enabled()) {
+        ok &= m_clockDriver->start();
+    } else {
+        ok &= this->start();
+    }
 
     return ok;
 }
@@ -200,15 +370,50 @@ template <class ROS_MSG>
 bool GenericSensor_nws_ros2<ROS_MSG>::detachAll()
 {
     // Stop the thread on detach
+    if (m_clockDriver) {
+        m_clockDriver->stop();
+    }
     if (this->isRunning()) {
         this->stop();
     }
+    if (m_batcher) {
+        m_batcher->stop();
+        m_batcher.reset();
+    }
     return true;
 }
 
 template <class ROS_MSG>
 void GenericSensor_nws_ros2<ROS_MSG>::run()
 {
+    if (m_batcher) {
+        publishBatch();
+    } else {
+        publishSample();
+    }
+}
+
+template <class ROS_MSG>
+void GenericSensor_nws_ros2<ROS_MSG>::publishBatch()
+{
+    m_batchStamps.clear();
+    m_batchMsg.data.clear();
+    m_batchMsg.dropped = m_batcher->drain(m_batchStamps, m_batchMsg.data);
+    if (m_batchStamps.empty() && m_batchMsg.dropped == 0) {
+        return;
+    }
+    if (m_batchMsg.dropped > 0) {
+        yCWarningThrottle(GENERICSENSOR_NWS_ROS2, 5.0) << m_batchMsg.dropped << "samples dropped, increase batch_capacity or decrease period";
+    }
+
+    m_batchMsg.stamps.resize(m_batchStamps.size());
+    for (size_t i = 0; i < m_batchStamps.size(); i++) {
+        m_batchMsg.stamps[i] = ros2TimeFromYarp(m_batchStamps[i]);
+    }
+    if (!m_batchMsg.stamps.empty()) {
+        m_batchMsg.header.stamp = m_batchMsg.stamps.back();
+    }
+    m_batchPublisher->publish(m_batchMsg);
 }
 
 template <class ROS_MSG>
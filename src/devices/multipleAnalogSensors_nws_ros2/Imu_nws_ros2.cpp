@@ -46,7 +46,7 @@ bool Imu_nws_ros2::viewInterfaces()
     return ok;
 }
 
-void Imu_nws_ros2::run()
+void Imu_nws_ros2::publishSample()
 {
     if (m_publisher)
     {
@@ -75,3 +75,28 @@ void Imu_nws_ros2::run()
         m_publisher->publish(imu_ros_data);
     }
 }
+
+std::vector<std::string> Imu_nws_ros2::sampleChannels() const
+{
+    return {"angular_velocity.x", "angular_velocity.y", "angular_velocity.z",
+            "linear_acceleration.x", "linear_acceleration.y", "linear_acceleration.z",
+            "orientation.roll", "orientation.pitch", "orientation.yaw"};
+}
+
+bool Imu_nws_ros2::readSample(double* values, double& timestamp)
+{
+    // The sample takes the timestamp of the gyroscope, which is usually the fastest of the three
+    double accTimestamp = 0;
+    double rpyTimestamp = 0;
+    if (!m_iThreeAxisGyroscopes->getThreeAxisGyroscopeMeasure(m_sens_index, m_sampleGyro, timestamp) ||
+        !m_iThreeAxisLinearAccelerometers->getThreeAxisLinearAccelerometerMeasure(m_sens_index, m_sampleAcc, accTimestamp) ||
+        !m_iOrientationSensors->getOrientationSensorMeasureAsRollPitchYaw(m_sens_index, m_sampleRpy, rpyTimestamp)) {
+        return false;
+    }
+    for (size_t i = 0; i < 3; i++) {
+        values[i] = m_sampleGyro[i] * M_PI / 180.0;
+        values[3 + i] = m_sampleAcc[i];
+        values[6 + i] = m_sampleRpy[i] * M_PI / 180.0;
+    }
+    return true;
+}
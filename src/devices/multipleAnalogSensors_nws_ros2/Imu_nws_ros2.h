@@ -33,6 +33,11 @@ class Imu_nws_ros2 : public GenericSensor_nws_ros2<sensor_msgs::msg::Imu>
     yarp::dev::IOrientationSensors*            m_iOrientationSensors{ nullptr };
     yarp::dev::IThreeAxisMagnetometers*        m_iThreeAxisMagnetometers{ nullptr };
 
+    // Used by the sampling thread in batch mode
+    yarp::sig::Vector m_sampleGyro = yarp::sig::Vector(3);
+    yarp::sig::Vector m_sampleAcc = yarp::sig::Vector(3);
+    yarp::sig::Vector m_sampleRpy = yarp::sig::Vector(3);
+
 public:
     using GenericSensor_nws_ros2<sensor_msgs::msg::Imu>::GenericSensor_nws_ros2;
 
@@ -41,11 +46,15 @@ public:
     using GenericSensor_nws_ros2<sensor_msgs::msg::Imu>::attachAll;
     using GenericSensor_nws_ros2<sensor_msgs::msg::Imu>::detachAll;
 
-    /* PeriodicRateThread methods */
-    void run() override;
-
 protected:
     bool viewInterfaces() override;
+    size_t maxSensors() const override
+    {
+        return 1;
+    }
+    void publishSample() override;
+    std::vector<std::string> sampleChannels() const override;
+    bool readSample(double* values, double& timestamp) override;
 };
 
 #endif // YARP_DEV_IMU_NWS_ROS2_H
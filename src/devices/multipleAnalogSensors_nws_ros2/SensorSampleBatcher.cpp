@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "SensorSampleBatcher.h"
+
+#include <algorithm>
+#include <utility>
+
+SensorSampleBatcher::SensorSampleBatcher(size_t channels, size_t capacity, double samplePeriod, ReadFunction read) :
+        PeriodicThread(samplePeriod),
+        m_channels(channels),
+        m_capacity(capacity),
+        m_read(std::move(read)),
+        m_stamps(capacity),
+        m_values(capacity * channels),
+        m_sample(channels)
+{
+}
+
+void SensorSampleBatcher::run()
+{
+    double stamp = 0;
+    if (!m_read(m_sample.data(), stamp) || stamp == m_lastStamp) {
+        return;
+    }
+    m_lastStamp = stamp;
+
+    uint64_t written = m_writeCount.load(std::memory_order_relaxed);
+    if (written - m_readCount.load(std::memory_order_acquire) >= m_capacity) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    size_t slot = written % m_capacity;
+    m_stamps[slot] = stamp;
+    std::copy(m_sample.begin(), m_sample.end(), m_values.begin() + slot * m_channels);
+    // Publishes the slot to the reader
+    m_writeCount.store(written + 1, std::memory_order_release);
+}
+
+uint32_t SensorSampleBatcher::drain(std::vector<double>& stamps, std::vector<double>& data)
+{
+    uint64_t read = m_readCount.load(std::memory_order_relaxed);
+    uint64_t written = m_writeCount.load(std::memory_order_acquire);
+    for (; read != written; read++) {
+        size_t slot = read % m_capacity;
+        stamps.push_back(m_stamps[slot]);
+        data.insert(data.end(), m_values.begin() + slot * m_channels, m_values.begin() + (slot + 1) * m_channels);
+    }
+    // Gives the slots back to the writer
+    m_readCount.store(read, std::memory_order_release);
+    return m_dropped.exchange(0, std::memory_order_relaxed);
+}
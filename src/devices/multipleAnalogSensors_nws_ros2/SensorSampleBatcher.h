@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_DEV_SENSORSAMPLEBATCHER_H
+#define YARP_DEV_SENSORSAMPLEBATCHER_H
+
+#include <yarp/os/PeriodicThread.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Samples a sensor at its own rate into a ring buffer, so that the samples can be published in batches.
+ *
+ * The thread reads a sample every `samplePeriod` seconds and stores it only if its timestamp changed,
+ * so sampling faster than the sensor does not store the same sample twice. The ring buffer has a single
+ * writer (the sampling thread) and a single reader (the publishing thread): neither waits for the other.
+ * When the buffer is full the new samples are dropped and counted.
+ */
+class SensorSampleBatcher : public yarp::os::PeriodicThread
+{
+public:
+    /**
+     * `read` fills the `channels` values of a sample and its timestamp, and returns false if the sensor failed.
+     */
+    using ReadFunction = std::function<bool(double* values, double& timestamp)>;
+
+    SensorSampleBatcher(size_t channels, size_t capacity, double samplePeriod, ReadFunction read);
+
+    /**
+     * Appends the samples stored since the previous call to `stamps` and `data`, and returns the number of
+     * samples dropped meanwhile. Must be called by one thread only.
+     */
+    uint32_t drain(std::vector<double>& stamps, std::vector<double>& data);
+
+    // PeriodicThread
+    void run() override;
+
+private:
+    const size_t m_channels;
+    const size_t m_capacity;
+    ReadFunction m_read;
+
+    std::vector<double> m_stamps;
+    std::vector<double> m_values;
+    std::vector<double> m_sample;
+    double m_lastStamp{-1};
+
+    // Incremented by the writer and by the reader, the slot is the index modulo the capacity
+    std::atomic<uint64_t> m_writeCount{0};
+    std::atomic<uint64_t> m_readCount{0};
+    std::atomic<uint32_t> m_dropped{0};
+};
+
+#endif // YARP_DEV_SENSORSAMPLEBATCHER_H
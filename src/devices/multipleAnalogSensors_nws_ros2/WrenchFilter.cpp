@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include "WrenchFilter.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <cmath>
+
+namespace {
+YARP_LOG_COMPONENT(WRENCHFILTER, "yarp.device.WrenchStamped_nws_ros2.filter")
+} // namespace
+
+bool WrenchFilter::configure(yarp::os::Searchable& config)
+{
+    m_removeBias = config.check("remove_bias", yarp::os::Value(false)).asBool();
+    int biasSamples = config.check("bias_samples", yarp::os::Value(100)).asInt32();
+    if (biasSamples <= 0) {
+        yCError(WRENCHFILTER) << "bias_samples must be positive";
+        return false;
+    }
+    m_biasSamples = static_cast<size_t>(biasSamples);
+    m_cutoff = config.check("lowpass_cutoff", yarp::os::Value(0.0)).asFloat64();
+    if (m_cutoff < 0) {
+        yCError(WRENCHFILTER) << "lowpass_cutoff cannot be negative";
+        return false;
+    }
+    return true;
+}
+
+void WrenchFilter::reset(size_t sensors)
+{
+    m_states.assign(sensors, State());
+}
+
+void WrenchFilter::recomputeBias()
+{
+    for (auto& state : m_states) {
+        state.biasCount = 0;
+        for (size_t i = 0; i < 6; i++) {
+            state.sum[i] = 0;
+        }
+        state.initialized = false;
+    }
+}
+
+bool WrenchFilter::update(size_t sensor, const double* wrench, double timestamp, double* filtered)
+{
+    State& state = m_states[sensor];
+    if (m_removeBias && state.biasCount < m_biasSamples) {
+        for (size_t i = 0; i < 6; i++) {
+            state.sum[i] += wrench[i];
+        }
+        state.biasCount++;
+        if (state.biasCount < m_biasSamples) {
+            return false;
+        }
+        for (size_t i = 0; i < 6; i++) {
+            state.bias[i] = state.sum[i] / static_cast<double>(m_biasSamples);
+        }
+    }
+
+    if (!state.initialized || m_cutoff <= 0) {
+        for (size_t i = 0; i < 6; i++) {
+            state.output[i] = wrench[i] - state.bias[i];
+        }
+        state.initialized = true;
+    } else {
+        double elapsed = timestamp - state.lastTimestamp;
+        double alpha = elapsed > 0 ? 1.0 - std::exp(-2.0 * M_PI * m_cutoff * elapsed) : 0.0;
+        for (size_t i = 0; i < 6; i++) {
+            state.output[i] += alpha * (wrench[i] - state.bias[i] - state.output[i]);
+        }
+    }
+    state.lastTimestamp = timestamp;
+
+    for (size_t i = 0; i < 6; i++) {
+        filtered[i] = state.output[i];
+    }
+    return true;
+}
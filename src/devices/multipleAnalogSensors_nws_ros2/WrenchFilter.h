@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_DEV_WRENCHFILTER_H
+#define YARP_DEV_WRENCHFILTER_H
+
+#include <yarp/os/Searchable.h>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Removes the bias of force torque measures and filters them with a first order low-pass filter.
+ *
+ * The filter reads the parameters
+ * | Parameter name  | Type    | Units | Default | Description |
+ * |:---------------:|:-------:|:-----:|:-------:|:------------|
+ * | remove_bias     | bool    | -     | false   | Subtract the mean of the first bias_samples samples of every sensor |
+ * | bias_samples    | int     | -     | 100     | The samples averaged to estimate the bias |
+ * | lowpass_cutoff  | double  | Hz    | 0       | Cutoff frequency of the low-pass filter, 0 disables it |
+ *
+ * The filter is meant to be updated with every new sample of the sensor: the coefficient of the
+ * low-pass filter is computed from the time elapsed since the previous sample, so the cutoff
+ * frequency does not depend on the sampling period.
+ */
+class WrenchFilter
+{
+public:
+    bool configure(yarp::os::Searchable& config);
+
+    bool enabled() const
+    {
+        return m_removeBias || m_cutoff > 0;
+    }
+
+    void reset(size_t sensors);
+
+    // Estimates the bias again, starting from the next sample
+    void recomputeBias();
+
+    // Filters a new sample of a sensor, returns false while its bias is being estimated
+    bool update(size_t sensor, const double* wrench, double timestamp, double* filtered);
+
+private:
+    struct State
+    {
+        double bias[6]{0, 0, 0, 0, 0, 0};
+        double sum[6]{0, 0, 0, 0, 0, 0};
+        size_t biasCount{0};
+        double output[6]{0, 0, 0, 0, 0, 0};
+        double lastTimestamp{0};
+        bool initialized{false};
+    };
+
+    bool m_removeBias{false};
+    size_t m_biasSamples{100};
+    double m_cutoff{0};
+    std::vector<State> m_states;
+};
+
+#endif // YARP_DEV_WRENCHFILTER_H
@@ -5,31 +5,152 @@
 
 #include "WrenchStamped_nws_ros2.h"
 
+#include <algorithm>
+
 YARP_LOG_COMPONENT(GENERICSENSOR_NWS_ROS2, "yarp.device.WrenchStamped_nws_ros2")
 
+bool WrenchStamped_nws_ros2::configureSensors(yarp::os::Searchable& config)
+{
+    if (!m_filter.configure(config)) {
+        return false;
+    }
+    // In batch mode the filter runs in the sampling thread of the batches
+    m_filtering = m_filter.enabled() && !m_batch;
+    if (!m_filter.enabled()) {
+        return true;
+    }
+    m_filterSamplePeriod = config.check("filter_sample_period", yarp::os::Value(0.001)).asFloat64();
+    if (m_filterSamplePeriod <= 0 || m_filterSamplePeriod > m_periodInS) {
+        yCError(GENERICSENSOR_NWS_ROS2) << "filter_sample_period must be positive and not longer than period";
+        return false;
+    }
+    return m_parameters->addBool("recompute_bias", false, [this](bool recompute) {
+        if (recompute) {
+            m_recomputeBias = true;
+        }
+        return true;
+    });
+}
+
 bool WrenchStamped_nws_ros2::viewInterfaces()
 {
     // View all the interfaces
-    bool ok = m_poly->view(m_iFTsens);
-    m_iFTsens->getSixAxisForceTorqueSensorFrameName(m_sens_index, m_framename);
+    if (!m_poly->view(m_iFTsens) || !m_iFTsens) {
+        yCError(GENERICSENSOR_NWS_ROS2) << "ISixAxisForceTorqueSensors interface is not available";
+        return false;
+    }
+
+    // The batch mode publishes the first sensor only
+    const size_t sensors = m_batch ? 1 : m_publishers.size();
+    if (m_iFTsens->getNrOfSixAxisForceTorqueSensors() < sensors) {
+        yCError(GENERICSENSOR_NWS_ROS2) << "The device has" << m_iFTsens->getNrOfSixAxisForceTorqueSensors() << "sensors, but" << sensors << "topics are configured";
+        return false;
+    }
+
+    m_messages.resize(sensors);
+    for (size_t i = 0; i < sensors; i++) {
+        m_iFTsens->getSixAxisForceTorqueSensorFrameName(i, m_messages[i].header.frame_id);
+    }
+    m_framename = m_messages[0].header.frame_id;
+
+    m_filter.reset(sensors);
+    m_lastSampleTimestamps.assign(sensors, -1);
+    std::lock_guard<std::mutex> lock(m_filteredMutex);
+    m_filtered.assign(sensors, FilteredSample{{0, 0, 0, 0, 0, 0}, 0, false});
+    return true;
+}
+
+bool WrenchStamped_nws_ros2::attachAll(const yarp::dev::PolyDriverList& p)
+{
+    bool ok = GenericSensor_nws_ros2<geometry_msgs::msg::WrenchStamped>::attachAll(p);
+    if (ok && m_filtering) {
+        m_sampler = std::make_unique<Sampler>(*this, m_filterSamplePeriod);
+        ok = m_sampler->start();
+    }
     return ok;
 }
 
-void WrenchStamped_nws_ros2::run()
+bool WrenchStamped_nws_ros2::detachAll()
+{
+    if (m_sampler) {
+        m_sampler->stop();
+        m_sampler.reset();
+    }
+    return GenericSensor_nws_ros2<geometry_msgs::msg::WrenchStamped>::detachAll();
+}
+
+bool WrenchStamped_nws_ros2::filterSample(size_t sens_index, double* filtered, double& timestamp)
+{
+    if (!m_iFTsens->getSixAxisForceTorqueSensorMeasure(sens_index, m_sampleWrench, timestamp)) {
+        return false;
+    }
+    // The filter is updated once per sample of the sensor
+    if (timestamp == m_lastSampleTimestamps[sens_index]) {
+        return false;
+    }
+    m_lastSampleTimestamps[sens_index] = timestamp;
+    return m_filter.update(sens_index, m_sampleWrench.data(), timestamp, filtered);
+}
+
+void WrenchStamped_nws_ros2::sampleAll()
+{
+    if (m_recomputeBias.exchange(false)) {
+        m_filter.recomputeBias();
+    }
+    for (size_t i = 0; i < m_messages.size(); i++) {
+        FilteredSample sample;
+        if (!filterSample(i, sample.wrench, sample.timestamp)) {
+            continue;
+        }
+        sample.valid = true;
+        std::lock_guard<std::mutex> lock(m_filteredMutex);
+        m_filtered[i] = sample;
+    }
+}
+
+void WrenchStamped_nws_ros2::publishSample()
+{
+    for (size_t i = 0; i < m_messages.size(); i++) {
+        double timestamp = 0;
+        if (m_filtering) {
+            std::lock_guard<std::mutex> lock(m_filteredMutex);
+            if (!m_filtered[i].valid) {
+                continue;
+            }
+            std::copy(m_filtered[i].wrench, m_filtered[i].wrench + 6, m_wrench.begin());
+            timestamp = m_filtered[i].timestamp;
+        } else if (!m_iFTsens->getSixAxisForceTorqueSensorMeasure(i, m_wrench, timestamp)) {
+            continue;
+        }
+
+        geometry_msgs::msg::WrenchStamped& wrench_ros_data = m_messages[i];
+        wrench_ros_data.header.stamp = ros2TimeFromYarp(timestamp);
+        wrench_ros_data.wrench.force.x = m_wrench[0];
+        wrench_ros_data.wrench.force.y = m_wrench[1];
+        wrench_ros_data.wrench.force.z = m_wrench[2];
+        wrench_ros_data.wrench.torque.x = m_wrench[3];
+        wrench_ros_data.wrench.torque.y = m_wrench[4];
+        wrench_ros_data.wrench.torque.z = m_wrench[5];
+        m_publishers[i]->publish(wrench_ros_data);
+    }
+}
+
+std::vector<std::string> WrenchStamped_nws_ros2::sampleChannels() const
 {
-    if (m_publisher)
-    {
-        yarp::sig::Vector vecwrench(6);
-        geometry_msgs::msg::WrenchStamped wrench_ros_data;
-        m_iFTsens->getSixAxisForceTorqueSensorMeasure(m_sens_index, vecwrench, m_timestamp);
-        wrench_ros_data.header.frame_id = m_framename;
-        wrench_ros_data.header.stamp = ros2TimeFromYarp(m_timestamp);
-        wrench_ros_data.wrench.force.x = vecwrench[0];
-        wrench_ros_data.wrench.force.y = vecwrench[1];
-        wrench_ros_data.wrench.force.z = vecwrench[2];
-        wrench_ros_data.wrench.torque.x = vecwrench[4];
-        wrench_ros_data.wrench.torque.y = vecwrench[5];
-        wrench_ros_data.wrench.torque.z = vecwrench[6];
-        m_publisher->publish(wrench_ros_data);
+    return {"force.x", "force.y", "force.z", "torque.x", "torque.y", "torque.z"};
+}
+
+bool WrenchStamped_nws_ros2::readSample(double* values, double& timestamp)
+{
+    if (!m_filter.enabled()) {
+        if (!m_iFTsens->getSixAxisForceTorqueSensorMeasure(m_sens_index, m_sampleWrench, timestamp)) {
+            return false;
+        }
+        std::copy(m_sampleWrench.begin(), m_sampleWrench.end(), values);
+        return true;
+    }
+    if (m_recomputeBias.exchange(false)) {
+        m_filter.recomputeBias();
     }
+    return filterSample(m_sens_index, values, timestamp);
 }
@@ -7,8 +7,12 @@
 #define YARP_DEV_WRENCHSTAMPED_NWS_ROS2_H
 
 #include "GenericSensor_nws_ros2.h"
+#include "WrenchFilter.h"
 #include <geometry_msgs/msg/wrench_stamped.hpp>
 
+#include <atomic>
+#include <mutex>
+
     /**
  * @ingroup dev_impl_wrapper
  *
@@ -21,28 +25,87 @@
  * The parameters accepted by this device are:
  * | Parameter name | SubParameter   | Type    | Units          | Default Value    | Required                    | Description                                                       | Notes |
  * |:--------------:|:--------------:|:-------:|:--------------:|:----------------:|:--------------------------: |:-----------------------------------------------------------------:|:-----:|
- * | topic_name     |      -         | string  | -              |   -              | Yes                         | The name of the ROS topic opened by this device.                  | MUST start with a '/' character |
+ * | topic_name     |      -         | string  | -              |   -              | Yes, or topic_names         | The name of the ROS topic opened by this device.                  | MUST start with a '/' character |
+ * | topic_names    |      -         | list of strings | -      |   -              | No                          | One topic per sensor, the i-th topic publishes the i-th sensor    | Replaces topic_name |
  * | node_name      |      -         | string  | -              |   -              | Yes                          | The name of the ROS node opened by this device                    | Autogenerated by default |
  * | period         |      -         | double  | s              |   -              | Yes                         | Refresh period of the broadcasted values in seconds               |  |
+ * | remove_bias    |      -         | bool    | -              |   false          | No                          | Subtract the mean of the first bias_samples samples               | See WrenchFilter |
+ * | bias_samples   |      -         | int     | -              |   100            | No                          | The samples averaged to estimate the bias                         | |
+ * | lowpass_cutoff |      -         | double  | Hz             |   0              | No                          | Cutoff frequency of the low-pass filter, 0 disables it            | |
+ * | filter_sample_period | -        | double  | s              |   0.001          | No                          | Sampling period of the filter                                     | Without batch, should be at most the period of the sensor |
+ *
+ * When the bias removal or the low-pass filter are enabled, a separate thread samples all the
+ * sensors every filter_sample_period seconds and updates the filter with every new sample, and the
+ * publishing thread publishes the latest filtered measures every `period` seconds. In batch mode
+ * the filter runs in the sampling thread of the batches instead, so the batches hold the filtered
+ * samples. Setting the `recompute_bias` ROS 2 parameter to true estimates the bias again.
  */
 class WrenchStamped_nws_ros2 : public GenericSensor_nws_ros2<geometry_msgs::msg::WrenchStamped>
 {
     // Interface of the wrapped device
     yarp::dev::ISixAxisForceTorqueSensors* m_iFTsens{ nullptr };
 
+    // Samples all the sensors at the rate of the filter
+    class Sampler : public yarp::os::PeriodicThread
+    {
+        WrenchStamped_nws_ros2& m_owner;
+
+    public:
+        Sampler(WrenchStamped_nws_ros2& owner, double period) :
+                PeriodicThread(period),
+                m_owner(owner)
+        {
+        }
+
+        void run() override
+        {
+            m_owner.sampleAll();
+        }
+    };
+
+    struct FilteredSample
+    {
+        double wrench[6];
+        double timestamp;
+        bool valid;
+    };
+
+    // Used by the publishing thread, one message per sensor
+    std::vector<geometry_msgs::msg::WrenchStamped> m_messages;
+    yarp::sig::Vector m_wrench = yarp::sig::Vector(6);
+
+    // Used by the sampling thread
+    WrenchFilter m_filter;
+    bool m_filtering{false};
+    double m_filterSamplePeriod{0.001};
+    std::unique_ptr<Sampler> m_sampler;
+    yarp::sig::Vector m_sampleWrench = yarp::sig::Vector(6);
+    std::vector<double> m_lastSampleTimestamps;
+    std::atomic<bool> m_recomputeBias{false};
+
+    // Written by the sampling thread and read by the publishing thread
+    std::mutex m_filteredMutex;
+    std::vector<FilteredSample> m_filtered;
+
+    bool filterSample(size_t sens_index, double* filtered, double& timestamp);
+    void sampleAll();
+
 public:
     using GenericSensor_nws_ros2<geometry_msgs::msg::WrenchStamped>::GenericSensor_nws_ros2;
 
     using GenericSensor_nws_ros2<geometry_msgs::msg::WrenchStamped>::open;
     using GenericSensor_nws_ros2<geometry_msgs::msg::WrenchStamped>::close;
-    using GenericSensor_nws_ros2<geometry_msgs::msg::WrenchStamped>::attachAll;
-    using GenericSensor_nws_ros2<geometry_msgs::msg::WrenchStamped>::detachAll;
 
-    /* PeriodicRateThread methods */
-    void run() override;
+    /* IMultipleWrapper methods */
+    bool attachAll(const yarp::dev::PolyDriverList& p) override;
+    bool detachAll() override;
 
 protected:
     bool viewInterfaces() override;
+    bool configureSensors(yarp::os::Searchable& config) override;
+    void publishSample() override;
+    std::vector<std::string> sampleChannels() const override;
+    bool readSample(double* values, double& timestamp) override;
 };
 
 #endif
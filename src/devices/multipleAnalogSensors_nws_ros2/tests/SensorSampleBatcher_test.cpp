@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <SensorSampleBatcher.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <utility>
+#include <vector>
+
+namespace {
+struct Reading
+{
+    bool valid;
+    double stamp;
+};
+
+// Returns the scripted readings one per call, a reading of two channels is (stamp, -stamp)
+class ScriptedSensor
+{
+public:
+    explicit ScriptedSensor(std::vector<Reading> script) :
+            m_script(std::move(script))
+    {
+    }
+
+    SensorSampleBatcher::ReadFunction readFunction()
+    {
+        return [this](double* values, double& timestamp) {
+            REQUIRE(m_next < m_script.size());
+            const Reading& reading = m_script[m_next++];
+            values[0] = reading.stamp;
+            values[1] = -reading.stamp;
+            timestamp = reading.stamp;
+            return reading.valid;
+        };
+    }
+
+    size_t remaining() const
+    {
+        return m_script.size() - m_next;
+    }
+
+private:
+    std::vector<Reading> m_script;
+    size_t m_next{0};
+};
+
+void runAll(SensorSampleBatcher& batcher, const ScriptedSensor& sensor)
+{
+    while (sensor.remaining() > 0) {
+        batcher.run();
+    }
+}
+
+void checkSamples(const std::vector<double>& stamps, const std::vector<double>& data, const std::vector<double>& expected)
+{
+    REQUIRE(stamps.size() == expected.size());
+    REQUIRE(data.size() == 2 * expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        CHECK(stamps[i] == expected[i]);
+        CHECK(data[2 * i] == expected[i]);
+        CHECK(data[2 * i + 1] == -expected[i]);
+    }
+}
+} // namespace
+
+TEST_CASE("dev::SensorSampleBatcher_test", "[yarp::dev]")
+{
+    std::vector<double> stamps;
+    std::vector<double> data;
+
+    SECTION("The samples are drained in order")
+    {
+        ScriptedSensor sensor({{true, 1.0}, {true, 2.0}, {true, 3.0}});
+        SensorSampleBatcher batcher(2, 8, 0.01, sensor.readFunction());
+        runAll(batcher, sensor);
+        CHECK(batcher.drain(stamps, data) == 0);
+        checkSamples(stamps, data, {1.0, 2.0, 3.0});
+
+        // Nothing is drained twice
+        CHECK(batcher.drain(stamps, data) == 0);
+        CHECK(stamps.size() == 3);
+
+        // The samples are appended to the ones already in the vectors
+        ScriptedSensor more({{true, 4.0}});
+        SensorSampleBatcher other(2, 8, 0.01, more.readFunction());
+        runAll(other, more);
+        CHECK(other.drain(stamps, data) == 0);
+        checkSamples(stamps, data, {1.0, 2.0, 3.0, 4.0});
+    }
+
+    SECTION("The samples with the timestamp of the previous one are not stored again")
+    {
+        ScriptedSensor sensor({{true, 1.0}, {true, 1.0}, {true, 1.0}, {true, 2.0}, {true, 2.0}, {true, 3.0}});
+        SensorSampleBatcher batcher(2, 8, 0.01, sensor.readFunction());
+        runAll(batcher, sensor);
+        CHECK(batcher.drain(stamps, data) == 0);
+        checkSamples(stamps, data, {1.0, 2.0, 3.0});
+    }
+
+    SECTION("The failed readings are skipped")
+    {
+        // A failed reading does not count as the previous timestamp either
+        ScriptedSensor sensor({{true, 1.0}, {false, 2.0}, {true, 2.0}, {false, 3.0}});
+        SensorSampleBatcher batcher(2, 8, 0.01, sensor.readFunction());
+        runAll(batcher, sensor);
+        CHECK(batcher.drain(stamps, data) == 0);
+        checkSamples(stamps, data, {1.0, 2.0});
+    }
+
+    SECTION("The samples are dropped and counted when the buffer is full")
+    {
+        ScriptedSensor sensor({{true, 1.0}, {true, 2.0}, {true, 3.0}, {true, 4.0}, {true, 5.0},
+                               {true, 6.0}, {true, 7.0}, {true, 8.0}, {true, 9.0}});
+        SensorSampleBatcher batcher(2, 3, 0.01, sensor.readFunction());
+        for (int i = 0; i < 5; i++) {
+            batcher.run();
+        }
+        // The oldest samples are kept
+        CHECK(batcher.drain(stamps, data) == 2);
+        checkSamples(stamps, data, {1.0, 2.0, 3.0});
+
+        // The counter is reset by each drain, and the drained slots are reused
+        stamps.clear();
+        data.clear();
+        batcher.run();
+        batcher.run();
+        CHECK(batcher.drain(stamps, data) == 0);
+        checkSamples(stamps, data, {6.0, 7.0});
+
+        // The buffer wraps around
+        stamps.clear();
+        data.clear();
+        runAll(batcher, sensor);
+        CHECK(batcher.drain(stamps, data) == 0);
+        checkSamples(stamps, data, {8.0, 9.0});
+    }
+}
@@ -0,0 +1,168 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Property.h>
+
+#include <WrenchFilter.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <cmath>
+
+namespace {
+WrenchFilter configured(const std::string& config, size_t sensors)
+{
+    yarp::os::Property pcfg;
+    pcfg.fromString(config);
+    WrenchFilter filter;
+    REQUIRE(filter.configure(pcfg));
+    filter.reset(sensors);
+    return filter;
+}
+
+// A wrench whose channel i is value + i
+void fill(double value, double* wrench)
+{
+    for (size_t i = 0; i < 6; i++) {
+        wrench[i] = value + i;
+    }
+}
+
+void checkAll(const double* filtered, double expected)
+{
+    for (size_t i = 0; i < 6; i++) {
+        CHECK(filtered[i] == Catch::Approx(expected).margin(1e-12));
+    }
+}
+} // namespace
+
+TEST_CASE("dev::WrenchFilter_test", "[yarp::dev]")
+{
+    double wrench[6];
+    double filtered[6];
+
+    SECTION("The filter is disabled by default")
+    {
+        WrenchFilter filter = configured("", 1);
+        CHECK_FALSE(filter.enabled());
+
+        // The samples are passed through
+        fill(3.0, wrench);
+        REQUIRE(filter.update(0, wrench, 1.0, filtered));
+        for (size_t i = 0; i < 6; i++) {
+            CHECK(filtered[i] == wrench[i]);
+        }
+    }
+
+    SECTION("The bias is the mean of the first samples")
+    {
+        WrenchFilter filter = configured("(remove_bias true) (bias_samples 4)", 2);
+        CHECK(filter.enabled());
+
+        // Nothing is returned while the bias is estimated, the bias of channel i is 1.5 + i
+        for (int k = 0; k < 3; k++) {
+            fill(k, wrench);
+            CHECK_FALSE(filter.update(0, wrench, 0.1 * k, filtered));
+        }
+        fill(3.0, wrench);
+        REQUIRE(filter.update(0, wrench, 0.3, filtered));
+        checkAll(filtered, 1.5);
+
+        fill(10.0, wrench);
+        REQUIRE(filter.update(0, wrench, 0.4, filtered));
+        checkAll(filtered, 8.5);
+
+        // The bias of every sensor is estimated on its own samples
+        CHECK_FALSE(filter.update(1, wrench, 0.4, filtered));
+    }
+
+    SECTION("The low-pass filter follows a step with its time constant")
+    {
+        constexpr double cutoff = 1.0;
+        constexpr double dt = 0.01;
+        WrenchFilter filter = configured("(lowpass_cutoff 1.0)", 1);
+        CHECK(filter.enabled());
+
+        // The first sample initializes the output
+        fill(0.0, wrench);
+        REQUIRE(filter.update(0, wrench, 0.0, filtered));
+        CHECK(filtered[0] == 0.0);
+        CHECK(filtered[5] == 5.0);
+
+        // A unit step on every channel
+        const double step[6] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+        double time = 0;
+        for (int k = 1; k <= 100; k++) {
+            time = k * dt;
+            REQUIRE(filter.update(0, step, time, filtered));
+            const double expected = 1.0 - std::exp(-2.0 * M_PI * cutoff * time);
+            CHECK(filtered[0] == Catch::Approx(expected).margin(1e-9));
+        }
+        // Channel 5 goes from 5 to 1 with the same time constant
+        CHECK(filtered[5] == Catch::Approx(1.0 + 4.0 * std::exp(-2.0 * M_PI * cutoff * time)).margin(1e-9));
+
+        // A repeated timestamp does not move the output
+        const double before = filtered[0];
+        REQUIRE(filter.update(0, wrench, time, filtered));
+        CHECK(filtered[0] == before);
+    }
+
+    SECTION("The low-pass filter does not depend on the sampling period")
+    {
+        WrenchFilter slow = configured("(lowpass_cutoff 5.0)", 1);
+        WrenchFilter fast = configured("(lowpass_cutoff 5.0)", 1);
+        fill(0.0, wrench);
+        REQUIRE(slow.update(0, wrench, 0.0, filtered));
+        REQUIRE(fast.update(0, wrench, 0.0, filtered));
+
+        fill(1.0, wrench);
+        double slowFiltered[6];
+        REQUIRE(slow.update(0, wrench, 0.02, slowFiltered));
+        REQUIRE(fast.update(0, wrench, 0.01, filtered));
+        REQUIRE(fast.update(0, wrench, 0.02, filtered));
+        for (size_t i = 0; i < 6; i++) {
+            CHECK(filtered[i] == Catch::Approx(slowFiltered[i]).margin(1e-12));
+        }
+    }
+
+    SECTION("The bias is estimated again on request")
+    {
+        WrenchFilter filter = configured("(remove_bias true) (bias_samples 2) (lowpass_cutoff 1.0)", 1);
+        fill(1.0, wrench);
+        CHECK_FALSE(filter.update(0, wrench, 0.0, filtered));
+        REQUIRE(filter.update(0, wrench, 0.1, filtered));
+        checkAll(filtered, 0.0);
+
+        // The sensor is now loaded by 4
+        fill(5.0, wrench);
+        REQUIRE(filter.update(0, wrench, 0.2, filtered));
+        CHECK(filtered[0] > 0.0);
+        CHECK(filtered[0] < 4.0);
+
+        filter.recomputeBias();
+        CHECK_FALSE(filter.update(0, wrench, 0.3, filtered));
+        fill(7.0, wrench);
+        // The bias is now 6 + i, and the output of the low-pass filter starts again from the sample
+        REQUIRE(filter.update(0, wrench, 0.4, filtered));
+        checkAll(filtered, 1.0);
+    }
+
+    SECTION("The invalid parameters are rejected")
+    {
+        for (const char* config : {"(remove_bias true) (bias_samples 0)",
+                                   "(lowpass_cutoff -1.0)"}) {
+            INFO(config);
+            yarp::os::Property pcfg;
+            pcfg.fromString(config);
+            WrenchFilter filter;
+            CHECK_FALSE(filter.configure(pcfg));
+        }
+    }
+}
@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IMultipleWrapper.h>
+#include <yarp/dev/MultipleAnalogSensorsInterfaces.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/PolyDriverList.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <geometry_msgs/msg/wrench_stamped.hpp>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <mutex>
+#include <vector>
+
+using namespace yarp::dev;
+using namespace yarp::os;
+
+namespace {
+// A force torque sensor measuring (1 2 3 4 5 6), every read is a new sample unless the timestamp is fixed
+class FakeForceTorque :
+        public DeviceDriver,
+        public ISixAxisForceTorqueSensors
+{
+public:
+    explicit FakeForceTorque(double fixedTimestamp = 0) :
+            m_fixedTimestamp(fixedTimestamp)
+    {
+    }
+
+    size_t getNrOfSixAxisForceTorqueSensors() const override
+    {
+        return 1;
+    }
+
+    MAS_status getSixAxisForceTorqueSensorStatus(size_t sens_index) const override
+    {
+        return sens_index == 0 ? MAS_OK : MAS_UNKNOWN;
+    }
+
+    bool getSixAxisForceTorqueSensorName(size_t sens_index, std::string& name) const override
+    {
+        name = "ft";
+        return sens_index == 0;
+    }
+
+    bool getSixAxisForceTorqueSensorFrameName(size_t sens_index, std::string& frameName) const override
+    {
+        frameName = "ft_frame";
+        return sens_index == 0;
+    }
+
+    bool getSixAxisForceTorqueSensorMeasure(size_t sens_index, yarp::sig::Vector& out, double& timestamp) const override
+    {
+        if (sens_index != 0) {
+            return false;
+        }
+        out.resize(6);
+        for (size_t i = 0; i < 6; i++) {
+            out[i] = i + 1.0;
+        }
+        timestamp = m_fixedTimestamp > 0 ? m_fixedTimestamp : Time::now();
+        return true;
+    }
+
+private:
+    double m_fixedTimestamp;
+};
+
+// Receives the wrenches published by the nws
+class WrenchListener
+{
+public:
+    explicit WrenchListener(const std::string& topic)
+    {
+        if (!rclcpp::ok()) {
+            rclcpp::init(0, nullptr);
+        }
+        m_node = std::make_shared<rclcpp::Node>("wrenchStamped_nws_ros2_test");
+        m_subscription = m_node->create_subscription<geometry_msgs::msg::WrenchStamped>(topic, 100,
+            [this](const geometry_msgs::msg::WrenchStamped::SharedPtr msg) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_received.push_back(*msg);
+            });
+        m_executor.add_node(m_node);
+    }
+
+    // Spins until a message is received
+    bool waitMessage(double timeout, geometry_msgs::msg::WrenchStamped& message)
+    {
+        const double end = Time::now() + timeout;
+        while (Time::now() < end) {
+            m_executor.spin_some();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_received.empty()) {
+                message = m_received.back();
+                m_received.clear();
+                return true;
+            }
+            Time::delay(0.001);
+        }
+        return false;
+    }
+
+private:
+    rclcpp::Node::SharedPtr m_node;
+    rclcpp::Subscription<geometry_msgs::msg::WrenchStamped>::SharedPtr m_subscription;
+    rclcpp::executors::SingleThreadedExecutor m_executor;
+    std::mutex m_mutex;
+    std::vector<geometry_msgs::msg::WrenchStamped> m_received;
+};
+} // namespace
+
+TEST_CASE("dev::WrenchStamped_nws_ros2_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("wrenchStamped_nws_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    constexpr const char* topic = "/wrenchStamped_nws_ros2_test/wrench";
+
+    SECTION("The force and the torque are published from the measure of the device")
+    {
+        PolyDriver wrapper;
+        Property pWrapper;
+        pWrapper.fromString("(device wrenchStamped_nws_ros2) (node_name wrench_test_node) (topic_name /wrenchStamped_nws_ros2_test/wrench) (period 0.01)");
+        REQUIRE(wrapper.open(pWrapper));
+
+        FakeForceTorque fake(10.5);
+        PolyDriver sensor;
+        REQUIRE(sensor.give(&fake, false));
+
+        WrenchListener listener(topic);
+
+        IMultipleWrapper* iwrap = nullptr;
+        REQUIRE(wrapper.view(iwrap));
+        PolyDriverList pdList;
+        pdList.push(&sensor, "ft");
+        REQUIRE(iwrap->attachAll(pdList));
+
+        geometry_msgs::msg::WrenchStamped message;
+        REQUIRE(listener.waitMessage(5.0, message));
+        CHECK(message.header.frame_id == "ft_frame");
+        CHECK(message.header.stamp.sec == 10);
+        CHECK(message.header.stamp.nanosec == 500000000);
+        CHECK(message.wrench.force.x == 1.0);
+        CHECK(message.wrench.force.y == 2.0);
+        CHECK(message.wrench.force.z == 3.0);
+        // The torque is made of the elements 3 to 5 of the measure
+        CHECK(message.wrench.torque.x == 4.0);
+        CHECK(message.wrench.torque.y == 5.0);
+        CHECK(message.wrench.torque.z == 6.0);
+
+        iwrap->detachAll();
+        wrapper.close();
+        sensor.close();
+    }
+
+    SECTION("The bias of the device is removed")
+    {
+        PolyDriver wrapper;
+        Property pWrapper;
+        pWrapper.fromString("(device wrenchStamped_nws_ros2) (node_name wrench_test_node) (topic_name /wrenchStamped_nws_ros2_test/wrench) (period 0.01) "
+                            "(remove_bias true) (bias_samples 5)");
+        REQUIRE(wrapper.open(pWrapper));
+
+        FakeForceTorque fake;
+        PolyDriver sensor;
+        REQUIRE(sensor.give(&fake, false));
+
+        WrenchListener listener(topic);
+
+        IMultipleWrapper* iwrap = nullptr;
+        REQUIRE(wrapper.view(iwrap));
+        PolyDriverList pdList;
+        pdList.push(&sensor, "ft");
+        REQUIRE(iwrap->attachAll(pdList));
+
+        // The measure never changes, so it is all bias
+        geometry_msgs::msg::WrenchStamped message;
+        REQUIRE(listener.waitMessage(5.0, message));
+        CHECK(message.header.frame_id == "ft_frame");
+        CHECK(message.wrench.force.x == Catch::Approx(0.0).margin(1e-9));
+        CHECK(message.wrench.force.z == Catch::Approx(0.0).margin(1e-9));
+        CHECK(message.wrench.torque.x == Catch::Approx(0.0).margin(1e-9));
+        CHECK(message.wrench.torque.z == Catch::Approx(0.0).margin(1e-9));
+
+        iwrap->detachAll();
+        wrapper.close();
+        sensor.close();
+    }
+
+    Network::setLocalMode(false);
+}
@@ -86,5 +86,78 @@ TEST_CASE("dev::MultipleAnalogSensors_nws_ros2_test", "[yarp::dev]")
         imuSensor.close();
     }
 
+    SECTION("Test the batch mode on a single IMU")
+    {
+        PolyDriver imuSensor;
+        PolyDriver wrapper;
+
+        Property p;
+        p.put("device", "fakeIMU");
+        REQUIRE(imuSensor.open(p)); // sensor open reported successful
+
+        Property pWrapper;
+        pWrapper.put("device", "imu_nws_ros2");
+        pWrapper.put("node_name", "imu_batch_node");
+        pWrapper.put("topic_name", "/imu_topic");
+        pWrapper.put("period", 0.02);
+        pWrapper.put("batch", true);
+        pWrapper.put("batch_sample_period", 0.002);
+        REQUIRE(wrapper.open(pWrapper)); // batch parameters accepted
+
+        yarp::dev::IMultipleWrapper *iwrap = nullptr;
+        REQUIRE(wrapper.view(iwrap));
+
+        PolyDriverList pdList;
+        pdList.push(&imuSensor, "pdlist_key");
+        REQUIRE(iwrap->attachAll(pdList)); // sampling and publishing threads started
+        yarp::os::Time::delay(0.1);
+
+        // Close devices
+        iwrap->detachAll();
+        wrapper.close();
+        imuSensor.close();
+    }
+
+    SECTION("Test an invalid batch sample period")
+    {
+        PolyDriver wrapper;
+
+        Property pWrapper;
+        pWrapper.put("device", "imu_nws_ros2");
+        pWrapper.put("node_name", "imu_batch_node");
+        pWrapper.put("topic_name", "/imu_topic");
+        pWrapper.put("period", 0.01);
+        pWrapper.put("batch", true);
+        pWrapper.put("batch_sample_period", 0.1);
+        REQUIRE_FALSE(wrapper.open(pWrapper)); // the sampling cannot be slower than the publishing
+    }
+
+    SECTION("Test the wrench nws with several topics and the filter")
+    {
+        PolyDriver wrapper;
+
+        Property pWrapper;
+        pWrapper.fromString("(device wrenchStamped_nws_ros2) (node_name wrench_node) (topic_names (/l_arm_ft /r_arm_ft)) "
+                            "(period 0.01) (remove_bias true) (bias_samples 50) (lowpass_cutoff 30.0)");
+        REQUIRE(wrapper.open(pWrapper)); // one publisher per sensor, filter parameters accepted
+
+        // Close devices
+        wrapper.close();
+    }
+
+    SECTION("Test invalid filter and topic parameters")
+    {
+        PolyDriver wrapper;
+
+        Property pWrapper;
+        pWrapper.fromString("(device wrenchStamped_nws_ros2) (node_name wrench_node) (topic_name /wrench_topic) "
+                            "(period 0.01) (lowpass_cutoff 30.0) (filter_sample_period 0.1)");
+        REQUIRE_FALSE(wrapper.open(pWrapper)); // the filter cannot sample slower than the publishing
+
+        Property pImu;
+        pImu.fromString("(device imu_nws_ros2) (node_name imu_node) (topic_names (/imu1 /imu2)) (period 0.01)");
+        REQUIRE_FALSE(wrapper.open(pImu)); // the imu publishes a single sensor
+    }
+
     Network::setLocalMode(false);
 }
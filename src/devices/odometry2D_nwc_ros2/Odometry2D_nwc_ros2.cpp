@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Odometry2D_nwc_ros2.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/dev/GenericVocabs.h>
+
+#include <OdometryConversion.h>
+#include <Ros2Utils.h>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+
+YARP_LOG_COMPONENT(ODOMETRY2D_NWC_ROS2, "yarp.ros2.odometry2D_nwc_ros2", yarp::os::Log::TraceType);
+
+bool Odometry2D_nwc_ros2::open(yarp::os::Searchable& config)
+{
+    // node_name check
+    if (!config.check("node_name")) {
+        yCError(ODOMETRY2D_NWC_ROS2) << "missing node_name parameter";
+        return false;
+    }
+    m_node_name = config.find("node_name").asString();
+
+    // topic_name check
+    if (!config.check("topic_name")) {
+        yCError(ODOMETRY2D_NWC_ROS2) << "missing topic_name parameter";
+        return false;
+    }
+    m_topic_name = config.find("topic_name").asString();
+    if (m_topic_name.c_str()[0] != '/') {
+        yCError(ODOMETRY2D_NWC_ROS2) << "Missing '/' in topic_name parameter";
+        return false;
+    }
+
+    m_historyLength = config.check("history_length", Value(1.0)).asFloat64();
+    if (m_historyLength < 0) {
+        yCError(ODOMETRY2D_NWC_ROS2) << "history_length cannot be negative";
+        return false;
+    }
+    if (m_historyLength > 0) {
+        m_history = std::make_unique<OdometryHistory>(m_historyLength);
+    }
+
+    if (config.check("rpc_port")) {
+        m_rpcPortName = config.find("rpc_port").asString();
+        if (!m_rpcPort.open(m_rpcPortName)) {
+            yCError(ODOMETRY2D_NWC_ROS2, "Failed to open port %s", m_rpcPortName.c_str());
+            return false;
+        }
+        m_rpcPort.setReader(*this);
+    }
+
+    m_node = NodeCreator::createNode(m_node_name);
+    m_subscriber = std::make_unique<Ros2Subscriber<Odometry2D_nwc_ros2, nav_msgs::msg::Odometry>>(m_node, this);
+    m_subscriber->subscribe_to_topic(m_topic_name);
+
+    m_spinner = std::make_unique<Ros2Spinner>(m_node);
+    m_spinner->start();
+
+    yCInfo(ODOMETRY2D_NWC_ROS2) << "opened";
+
+    return true;
+}
+
+bool Odometry2D_nwc_ros2::close()
+{
+    yCInfo(ODOMETRY2D_NWC_ROS2, "closing...");
+    // Deleting the spinner stops it
+    m_spinner.reset();
+    m_rpcPort.close();
+    yCInfo(ODOMETRY2D_NWC_ROS2, "closed");
+    return true;
+}
+
+void Odometry2D_nwc_ros2::callback(nav_msgs::msg::Odometry::SharedPtr msg, std::string topic)
+{
+    YARP_UNUSED(topic);
+    yCTrace(ODOMETRY2D_NWC_ROS2, "callback Odometry");
+
+    const OdometrySample sample = odometrySampleFromRos2(*msg);
+    m_latest.store(sample);
+
+    if (m_history) {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        m_history->add(sample);
+    }
+}
+
+bool Odometry2D_nwc_ros2::getOdometry(yarp::dev::OdometryData& odom, double* timestamp)
+{
+    OdometrySample sample;
+    if (!m_latest.load(sample)) {
+        yCErrorThrottle(ODOMETRY2D_NWC_ROS2, 5.0) << "No odometry received yet";
+        return false;
+    }
+    toOdometryData(sample, odom);
+    if (timestamp) {
+        *timestamp = sample.timestamp;
+    }
+    return true;
+}
+
+bool Odometry2D_nwc_ros2::resetOdometry()
+{
+    yCError(ODOMETRY2D_NWC_ROS2) << "resetOdometry is not supported, the odometry is computed by the publisher";
+    return false;
+}
+
+bool Odometry2D_nwc_ros2::getOdometryAt(double time, yarp::dev::OdometryData& odom, std::string& error)
+{
+    if (!m_history) {
+        error = "The history is disabled";
+        return false;
+    }
+    OdometrySample sample;
+    {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        if (!m_history->get(time, sample, error)) {
+            return false;
+        }
+    }
+    toOdometryData(sample, odom);
+    return true;
+}
+
+bool Odometry2D_nwc_ros2::read(yarp::os::ConnectionReader& connection)
+{
+    Bottle in;
+    Bottle out;
+    if (!in.read(connection)) {
+        return false;
+    }
+
+    if (in.get(0).asString() == "get_odometry_at" && in.size() == 2) {
+        OdometryData odom;
+        std::string error;
+        double time = in.get(1).asFloat64();
+        if (getOdometryAt(time, odom, error)) {
+            out.addVocab32(VOCAB_OK);
+            out.addFloat64(time);
+            out.addFloat64(odom.odom_x);
+            out.addFloat64(odom.odom_y);
+            out.addFloat64(odom.odom_theta);
+            out.addFloat64(odom.base_vel_x);
+            out.addFloat64(odom.base_vel_y);
+            out.addFloat64(odom.base_vel_theta);
+            out.addFloat64(odom.odom_vel_x);
+            out.addFloat64(odom.odom_vel_y);
+            out.addFloat64(odom.odom_vel_theta);
+        } else {
+            out.addVocab32(VOCAB_FAILED);
+            out.addString(error);
+        }
+    } else {
+        out.addVocab32(VOCAB_FAILED);
+        out.addString("Usage: get_odometry_at <time>");
+    }
+
+    yarp::os::ConnectionWriter* returnToSender = connection.getWriter();
+    if (returnToSender != nullptr) {
+        out.write(*returnToSender);
+    }
+    return true;
+}
@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ODOMETRY2D_NWC_ROS2_H
+#define YARP_ROS2_ODOMETRY2D_NWC_ROS2_H
+
+#include <yarp/os/PortReader.h>
+#include <yarp/os/RpcServer.h>
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IOdometry2D.h>
+#include <yarp/dev/OdometryData.h>
+#include <OdometryHistory.h>
+#include <Ros2Spinner.h>
+#include <Ros2Subscriber.h>
+#include <SeqLock.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <nav_msgs/msg/odometry.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ *  @ingroup dev_impl_nwc_ros2 dev_impl_navigation
+ *
+ * \brief `Odometry2D_nwc_ros2`: A network client that receives the odometry of a mobile base from a ROS2 topic of type nav_msgs::Odometry, and exposes it as IOdometry2D
+ *
+ * | Parameter name | SubParameter   | Type    | Units          | Default Value    | Required                    | Description                                                       | Notes |
+ * |:--------------:|:--------------:|:-------:|:--------------:|:----------------:|:--------------------------: |:-----------------------------------------------------------------:|:-----:|
+ * | node_name      |      -         | string  | -              |   -              | Yes                         | The name of the ROS node opened by this device                    | |
+ * | topic_name     |      -         | string  | -              |   -              | Yes                         | The nav_msgs/Odometry topic                                       | MUST start with a '/' character |
+ * | history_length |      -         | double  | s              |   1.0            | No                          | How long the odometry is kept to answer the queries in the past   | 0 disables the history |
+ * | rpc_port       |      -         | string  | -              |   -              | No                          | If set, the queries in the past are answered on this YARP rpc port | |
+ *
+ * Each message is converted once, when it is received: the orientation to the yaw in degrees,
+ * the angular velocity to deg/s and the velocity of the base to the odometry frame. The latest
+ * odometry is kept in a SeqLock, so getOdometry() never takes a lock and never delays the
+ * reception of the messages.
+ *
+ * The odometry at a past time is interpolated between the samples of the history, by
+ * getOdometryAt() or by the rpc port, which answers to `get_odometry_at <time>` with
+ * `[ok] <time> <x> <y> <theta> <base_vel_x> <base_vel_y> <base_vel_theta> <odom_vel_x> <odom_vel_y> <odom_vel_theta>`,
+ * or with `[fail] <error>`.
+ * The odometry is computed by the publisher, so resetOdometry() is not supported.
+ */
+class Odometry2D_nwc_ros2 :
+        public yarp::dev::DeviceDriver,
+        public yarp::dev::Nav2D::IOdometry2D,
+        public yarp::os::PortReader
+{
+public:
+    Odometry2D_nwc_ros2() = default;
+    Odometry2D_nwc_ros2(const Odometry2D_nwc_ros2&) = delete;
+    Odometry2D_nwc_ros2(Odometry2D_nwc_ros2&&) noexcept = delete;
+    Odometry2D_nwc_ros2& operator=(const Odometry2D_nwc_ros2&) = delete;
+    Odometry2D_nwc_ros2& operator=(Odometry2D_nwc_ros2&&) noexcept = delete;
+    ~Odometry2D_nwc_ros2() override = default;
+
+    // DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    // ROS2 Topic Callback
+    void callback(nav_msgs::msg::Odometry::SharedPtr msg, std::string topic);
+
+    // IOdometry2D
+    bool getOdometry(yarp::dev::OdometryData& odom, double* timestamp = nullptr) override;
+    bool resetOdometry() override;
+
+    // The odometry at a past time, interpolated between the samples of the history
+    bool getOdometryAt(double time, yarp::dev::OdometryData& odom, std::string& error);
+
+    // PortReader, the rpc port
+    bool read(yarp::os::ConnectionReader& connection) override;
+
+private:
+    std::string m_topic_name;
+    std::string m_node_name;
+    std::string m_rpcPortName;
+    rclcpp::Node::SharedPtr m_node;
+    std::unique_ptr<Ros2Subscriber<Odometry2D_nwc_ros2, nav_msgs::msg::Odometry>> m_subscriber;
+    std::unique_ptr<Ros2Spinner> m_spinner;
+    yarp::os::RpcServer m_rpcPort;
+
+    // Written by the callback only
+    SeqLock<OdometrySample> m_latest;
+
+    double m_historyLength{1.0};
+    std::mutex m_historyMutex;
+    std::unique_ptr<OdometryHistory> m_history;
+};
+
+#endif // YARP_ROS2_ODOMETRY2D_NWC_ROS2_H
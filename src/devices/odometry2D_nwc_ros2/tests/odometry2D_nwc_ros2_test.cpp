@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/RpcClient.h>
+#include <yarp/dev/GenericVocabs.h>
+#include <yarp/dev/IOdometry2D.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <cmath>
+
+using namespace yarp::dev;
+using namespace yarp::os;
+
+TEST_CASE("dev::odometry2D_nwc_ros2_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("odometry2D_nwc_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    SECTION("Checking the nwc alone")
+    {
+        PolyDriver ddnwc;
+
+        ////////"Checking opening nwc"
+        {
+            Property pcfg;
+            pcfg.put("device", "odometry2D_nwc_ros2");
+            pcfg.put("node_name", "odometry2D_nwc");
+            pcfg.put("topic_name", "/odometry2D_nwc_topic");
+            REQUIRE(ddnwc.open(pcfg));
+        }
+
+        //"Close all polydrivers and check"
+        {
+            CHECK(ddnwc.close());
+        }
+    }
+
+    SECTION("Checking the nwc before receiving the odometry")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device odometry2D_nwc_ros2) (node_name odometry2D_nwc) (topic_name /odometry2D_nwc_topic) "
+                        "(history_length 2.0) (rpc_port /odometry2D_nwc_test/rpc)");
+        REQUIRE(ddnwc.open(pcfg));
+
+        Nav2D::IOdometry2D* iodom = nullptr;
+        REQUIRE(ddnwc.view(iodom));
+        OdometryData odom;
+        double timestamp = 0;
+        CHECK_FALSE(iodom->getOdometry(odom, &timestamp));
+        CHECK_FALSE(iodom->resetOdometry());
+
+        RpcClient client;
+        REQUIRE(client.open("/odometry2D_nwc_test/client"));
+        REQUIRE(Network::connect("/odometry2D_nwc_test/client", "/odometry2D_nwc_test/rpc"));
+        Bottle cmd;
+        Bottle reply;
+        cmd.fromString("get_odometry_at 10.0");
+        REQUIRE(client.write(cmd, reply));
+        CHECK(reply.get(0).asVocab32() == VOCAB_FAILED);
+        client.close();
+
+        CHECK(ddnwc.close());
+    }
+
+    SECTION("Checking the nwc receiving the odometry")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device odometry2D_nwc_ros2) (node_name odometry2D_nwc) (topic_name /odometry2D_nwc_topic) "
+                        "(history_length 2.0) (rpc_port /odometry2D_nwc_test/rpc)");
+        REQUIRE(ddnwc.open(pcfg));
+
+        Nav2D::IOdometry2D* iodom = nullptr;
+        REQUIRE(ddnwc.view(iodom));
+
+        // The base at (1, 2) turned by 90 degrees, moving forward and to its left while turning by 0.5 rad/s
+        system("ros2 topic pub --once /odometry2D_nwc_topic nav_msgs/msg/Odometry \"{header: {stamp: {sec: 10, nanosec: 500000000}, frame_id: 'odom'}, "
+               "child_frame_id: 'base_link', pose: {pose: {position: {x: 1.0, y: 2.0}, orientation: {z: 0.7071067811865476, w: 0.7071067811865476}}}, "
+               "twist: {twist: {linear: {x: 1.0, y: 0.5}, angular: {z: 0.5}}}}\"");
+
+        OdometryData odom;
+        double timestamp = 0;
+        REQUIRE(waitFor([&] { return iodom->getOdometry(odom, &timestamp); }));
+        CHECK(timestamp == Catch::Approx(10.5).epsilon(0).margin(1e-9));
+        CHECK(odom.odom_x == Catch::Approx(1.0).epsilon(0).margin(1e-9));
+        CHECK(odom.odom_y == Catch::Approx(2.0).epsilon(0).margin(1e-9));
+        // The yaw of the quaternion, in degrees
+        CHECK(odom.odom_theta == Catch::Approx(90.0).epsilon(0).margin(1e-6));
+        // The velocity of the base is kept in its frame, the angular one in deg/s
+        CHECK(odom.base_vel_x == Catch::Approx(1.0).epsilon(0).margin(1e-9));
+        CHECK(odom.base_vel_y == Catch::Approx(0.5).epsilon(0).margin(1e-9));
+        CHECK(odom.base_vel_theta == Catch::Approx(0.5 * 180.0 / M_PI).epsilon(0).margin(1e-9));
+        // In the odometry frame, forward is +y and left is -x
+        CHECK(odom.odom_vel_x == Catch::Approx(-0.5).epsilon(0).margin(1e-9));
+        CHECK(odom.odom_vel_y == Catch::Approx(1.0).epsilon(0).margin(1e-9));
+        CHECK(odom.odom_vel_theta == Catch::Approx(odom.base_vel_theta).epsilon(0).margin(1e-9));
+
+        // One second later the base is at (3, 2), turned by 180 degrees
+        system("ros2 topic pub --once /odometry2D_nwc_topic nav_msgs/msg/Odometry \"{header: {stamp: {sec: 11, nanosec: 500000000}, frame_id: 'odom'}, "
+               "child_frame_id: 'base_link', pose: {pose: {position: {x: 3.0, y: 2.0}, orientation: {z: 1.0, w: 0.0}}}, "
+               "twist: {twist: {linear: {x: 1.0, y: 0.5}, angular: {z: 0.5}}}}\"");
+        REQUIRE(waitFor([&] { return iodom->getOdometry(odom, &timestamp) && timestamp > 11.0; }));
+        CHECK(odom.odom_theta == Catch::Approx(180.0).epsilon(0).margin(1e-6));
+        CHECK(odom.odom_vel_x == Catch::Approx(-1.0).epsilon(0).margin(1e-9));
+        CHECK(odom.odom_vel_y == Catch::Approx(-0.5).epsilon(0).margin(1e-9));
+
+        // The odometry in between is interpolated
+        RpcClient client;
+        REQUIRE(client.open("/odometry2D_nwc_test/client"));
+        REQUIRE(Network::connect("/odometry2D_nwc_test/client", "/odometry2D_nwc_test/rpc"));
+        Bottle cmd;
+        Bottle reply;
+        cmd.fromString("get_odometry_at 11.0");
+        REQUIRE(client.write(cmd, reply));
+        REQUIRE(reply.get(0).asVocab32() == VOCAB_OK);
+        CHECK(reply.get(2).asFloat64() == Catch::Approx(2.0).epsilon(0).margin(1e-9));
+        CHECK(reply.get(3).asFloat64() == Catch::Approx(2.0).epsilon(0).margin(1e-9));
+        CHECK(reply.get(4).asFloat64() == Catch::Approx(135.0).epsilon(0).margin(1e-6));
+        client.close();
+
+        CHECK(ddnwc.close());
+    }
+
+    SECTION("Checking invalid parameters")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.fromString("(device odometry2D_nwc_ros2) (node_name odometry2D_nwc) (topic_name /odometry2D_nwc_topic) (history_length -1.0)");
+        CHECK_FALSE(ddnwc.open(pcfg));
+    }
+
+    Network::setLocalMode(false);
+}
@@ -43,12 +43,21 @@ bool Odometry2D_nws_ros2::attach(yarp::dev::PolyDriver* driver)
 
     yCInfo(ODOMETRY2D_NWS_ROS2, "Attach complete");
     PeriodicThread::setPeriod(m_period);
+    m_clockDriver->setPeriod(m_period);
+    if (m_clockDriver->enabled()) {
+        return threadInit() && m_clockDriver->start();
+    }
     return PeriodicThread::start();
 }
 
 
 bool Odometry2D_nws_ros2::detach()
 {
+    if (m_clockDriver && m_clockDriver->isRunning())
+    {
+        m_clockDriver->stop();
+        threadRelease();
+    }
     if (PeriodicThread::isRunning())
     {
         PeriodicThread::stop();
@@ -103,6 +112,14 @@ bool Odometry2D_nws_ros2::open(yarp::os::Searchable &config)
     }
     m_baseFrame = config.find("base_frame").asString();
 
+    if (config.check("publish_tf")) {
+        m_publishTf = config.find("publish_tf").asBool();
+    }
+
+    if (config.check("use_sim_time")) {
+        m_useSimTime = config.find("use_sim_time").asBool();
+    }
+
     rclcpp::NodeOptions node_options;
     node_options.allow_undeclared_parameters(true);
     node_options.automatically_declare_parameters_from_overrides(true);
@@ -112,13 +129,39 @@ bool Odometry2D_nws_ros2::open(yarp::os::Searchable &config)
         return false;
     }
 
-    rclcpp::Parameter simTime( "use_sim_time", rclcpp::ParameterValue( true ) );
-    m_node->set_parameter( simTime );
+    // This device has always stamped its messages with the simulated time, whatever the clock source
+    if (m_useSimTime) {
+        m_node->set_parameter(rclcpp::Parameter("use_sim_time", true));
+    }
+
+    // Switches the node to use_sim_time when the clock source is the simulation
+    m_clockDriver = std::make_unique<Ros2ClockDriver>(m_node, [this]() { run(); });
+    if (!m_clockDriver->configure(config)) {
+        return false;
+    }
     const std::string m_tf_topic ="/tf";
     m_publisher_tf   = m_node->create_publisher<tf2_msgs::msg::TFMessage>(m_tf_topic, 10);
 
     m_ros2Publisher_odometry = m_node->create_publisher<nav_msgs::msg::Odometry>(m_topicName, 10);
 
+    m_parameters = std::make_unique<Ros2Parameters>(m_node);
+    bool ok = m_parameters->addDouble("period", m_period, [this](double period) {
+        if (period <= 0) {
+            return false;
+        }
+        m_period = period;
+        m_clockDriver->setPeriod(m_period);
+        return PeriodicThread::setPeriod(m_period);
+    });
+    ok &= m_parameters->addBool("publish_tf", m_publishTf, [this](bool enable) {
+        m_publishTf = enable;
+        return true;
+    });
+    if (!ok || !m_parameters->start()) {
+        yCError(ODOMETRY2D_NWS_ROS2) << "Unable to initialize the ROS 2 parameters";
+        return false;
+    }
+
     yCInfo(ODOMETRY2D_NWS_ROS2) << "Waiting for device to attach";
     return true;
 }
@@ -204,7 +247,9 @@ void Odometry2D_nws_ros2::run()
 
         m_ros2Publisher_odometry->publish(odometryMsg);
 
-        m_publisher_tf->publish(rosData);
+        if (m_publishTf) {
+            m_publisher_tf->publish(rosData);
+        }
 
 
     } else{
@@ -215,6 +260,9 @@ void Odometry2D_nws_ros2::run()
 bool Odometry2D_nws_ros2::close()
 {
     yCTrace(ODOMETRY2D_NWS_ROS2);
+    if (m_parameters) {
+        m_parameters->stop();
+    }
     if (PeriodicThread::isRunning())
     {
         PeriodicThread::stop();
@@ -14,6 +14,11 @@
 #include <yarp/dev/DeviceDriver.h>
 #include <yarp/dev/WrapperSingle.h>
 #include <tf2_msgs/msg/tf_message.hpp>
+#include <Ros2Parameters.h>
+#include <Ros2ClockDriver.h>
+
+#include <atomic>
+#include <memory>
 
 #ifndef _USE_MATH_DEFINES
 #define _USE_MATH_DEFINES
@@ -37,6 +42,17 @@
  * | topic_name          |      -                  | string  | -              |   -           | Yes                            | name of the topic where the device must publish the data| must begin with an initial '/'     |
  * | odom_frame          |      -                  | string  | -              |   -           | Yes                            | name of the reference frame for odometry                |      |
  * | base_frame          |      -                  | string  | -              |   -           | Yes                            | name of the base frame for odometry                     |      |
+ * | publish_tf          |      -                  | bool    | -              |   true        | No                             | publish the odom->base transform on /tf                 |      |
+ * | clock_source        |      -                  | string  | -              |   system      | No                             | clock the publishing cycle runs on                      | `system` or `ros`, see Ros2ClockDriver |
+ * | clock_topic         |      -                  | string  | -              |   /clock      | No                             | clock topic used when clock_source is `ros`             |      |
+ * | use_sim_time        |      -                  | bool    | -              |   true        | No                             | stamp the messages with the simulated time of /clock    | always true when clock_source is `ros` |
+ *
+ * Unlike the other nws, this device stamps its messages with the simulated time by default, also
+ * when the publishing cycle runs on the system clock. Set use_sim_time to false to use the wall clock
+ * without a simulation.
+ *
+ * `period` and `publish_tf` are also declared as ROS 2 parameters of the node, so they can be
+ * changed at runtime with `ros2 param set` or overridden from the ROS 2 command line.
  *
  * Example of configuration file using .ini format.
  *
@@ -113,6 +129,7 @@ private:
     std::string m_nodeName;
     std::string m_odomFrame;
     std::string m_baseFrame;
+    bool m_useSimTime{true};
 
     // stamp count for timestamp
     yarp::os::Stamp m_timeStamp;
@@ -120,10 +137,15 @@ private:
     // period for thread
     double m_period{DEFAULT_THREAD_PERIOD};
 
+    // output toggles
+    std::atomic<bool> m_publishTf{true};
+
     //ros2 node
     rclcpp::Node::SharedPtr m_node;
     rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr   m_ros2Publisher_odometry;
     rclcpp::Publisher<tf2_msgs::msg::TFMessage>::SharedPtr  m_publisher_tf;
+    std::unique_ptr<Ros2Parameters> m_parameters;
+    std::unique_ptr<Ros2ClockDriver> m_clockDriver;
 
     //interfaces
     yarp::dev::PolyDriver m_driver;
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include "Odometry2D_replay_ros2.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <cmath>
+#include <Ros2Utils.h>
+
+using namespace yarp::dev;
+
+namespace {
+YARP_LOG_COMPONENT(ODOMETRY2D_REPLAY_ROS2, "yarp.ros2.odometry2D_replay_ros2", yarp::os::Log::TraceType);
+
+constexpr double RAD2DEG = 180.0 / M_PI;
+} // namespace
+
+bool Odometry2D_replay_ros2::open(yarp::os::Searchable& config)
+{
+    if (!config.check("bag_topic_name")) {
+        yCError(ODOMETRY2D_REPLAY_ROS2) << "missing bag_topic_name parameter";
+        return false;
+    }
+    m_topic_name = config.find("bag_topic_name").asString();
+
+    Ros2BagPlayer::Options options;
+    if (!Ros2BagPlayer::parseOptions(config, options)) {
+        return false;
+    }
+
+    m_player.addTopic(m_topic_name, [this](const rosbag2_storage::SerializedBagMessage& bagMessage) { onOdometry(bagMessage); });
+    if (!m_player.open(options)) {
+        return false;
+    }
+
+    yCInfo(ODOMETRY2D_REPLAY_ROS2) << "opened";
+    return true;
+}
+
+bool Odometry2D_replay_ros2::close()
+{
+    m_player.close();
+    return true;
+}
+
+void Odometry2D_replay_ros2::onOdometry(const rosbag2_storage::SerializedBagMessage& bagMessage)
+{
+    nav_msgs::msg::Odometry msg;
+    if (!Ros2BagPlayer::deserialize(bagMessage, msg)) {
+        yCError(ODOMETRY2D_REPLAY_ROS2) << "Unable to deserialize a message of" << m_topic_name;
+        m_player.consumed();
+        return;
+    }
+
+    const auto& q = msg.pose.pose.orientation;
+    double yaw = atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+
+    // The recorded twist is expressed in the child (base) frame
+    const auto& twist = msg.twist.twist;
+    double cosYaw = cos(yaw);
+    double sinYaw = sin(yaw);
+
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    m_odometry.odom_x = msg.pose.pose.position.x;
+    m_odometry.odom_y = msg.pose.pose.position.y;
+    m_odometry.odom_theta = yaw * RAD2DEG;
+    m_odometry.base_vel_x = twist.linear.x;
+    m_odometry.base_vel_y = twist.linear.y;
+    m_odometry.base_vel_theta = twist.angular.z * RAD2DEG;
+    m_odometry.odom_vel_x = cosYaw * twist.linear.x - sinYaw * twist.linear.y;
+    m_odometry.odom_vel_y = sinYaw * twist.linear.x + cosYaw * twist.linear.y;
+    m_odometry.odom_vel_theta = m_odometry.base_vel_theta;
+    m_timestamp = yarpTimeFromRos2(msg.header.stamp) + m_player.stampOffset();
+    m_data_valid = true;
+    m_data_fresh = true;
+}
+
+bool Odometry2D_replay_ros2::getOdometry(yarp::dev::OdometryData& odom, double* timestamp)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+
+    odom = m_odometry;
+    if (timestamp) {
+        *timestamp = m_timestamp;
+    }
+
+    if (m_data_fresh) {
+        m_data_fresh = false;
+        m_player.consumed();
+    }
+    return true;
+}
+
+bool Odometry2D_replay_ros2::resetOdometry()
+{
+    yCError(ODOMETRY2D_REPLAY_ROS2) << "resetOdometry is not supported by a recorded odometry";
+    return false;
+}
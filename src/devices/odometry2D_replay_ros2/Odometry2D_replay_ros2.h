@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ODOMETRY2D_REPLAY_ROS2_H
+#define YARP_ROS2_ODOMETRY2D_REPLAY_ROS2_H
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IOdometry2D.h>
+
+#include <nav_msgs/msg/odometry.hpp>
+#include <Ros2BagPlayer.h>
+
+#include <mutex>
+
+/**
+ *  @ingroup dev_impl_fake dev_impl_navigation
+ *
+ * \brief `odometry2D_replay_ros2`: A 2D odometry that replays the Odometry messages recorded in a rosbag2 bag.
+ *
+ * It is meant to run the NWS and NWC devices on recorded robot data, in a reproducible way.
+ * The recorded pose is projected on the plane, the orientation is the yaw of the recorded quaternion.
+ *
+ * Parameters required by this device are:
+ * | Parameter name      | SubParameter   | Type    | Units          | Default Value | Required  | Description                                        | Notes |
+ * |:-------------------:|:--------------:|:-------:|:--------------:|:-------------:|:---------:|:--------------------------------------------------:|:-----:|
+ * | bag_uri             |      -         | string  | -              |   -           | Yes       | path of the bag to play                            | |
+ * | bag_topic_name      |      -         | string  | -              |   -           | Yes       | recorded topic of the nav_msgs/Odometry            | |
+ * | time_scale          |      -         | double  | -              |   1.0         | No        | playback speed                                     | |
+ * | as_fast_as_possible |      -         | bool    | -              |   false       | No        | a new odometry is played after every getOdometry() that returned the previous one | |
+ * | loop                |      -         | bool    | -              |   false       | No        | restart from the beginning at the end of the bag   | |
+ *
+ * See Ros2BagPlayer for the other playback parameters.
+ *
+ * \code{.unparsed}
+ * yarpdev --device odometry2D_nws_ros2 --subdevice odometry2D_replay_ros2 --bag_uri /data/base_bag --bag_topic_name /odom --node_name odom_node --topic_name /replayed_odom
+ * \endcode
+ */
+class Odometry2D_replay_ros2 :
+        public yarp::dev::DeviceDriver,
+        public yarp::dev::Nav2D::IOdometry2D
+{
+public:
+    Odometry2D_replay_ros2() = default;
+    Odometry2D_replay_ros2(const Odometry2D_replay_ros2&) = delete;
+    Odometry2D_replay_ros2(Odometry2D_replay_ros2&&) noexcept = delete;
+    Odometry2D_replay_ros2& operator=(const Odometry2D_replay_ros2&) = delete;
+    Odometry2D_replay_ros2& operator=(Odometry2D_replay_ros2&&) noexcept = delete;
+    ~Odometry2D_replay_ros2() override = default;
+
+    // DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    // IOdometry2D
+    bool getOdometry(yarp::dev::OdometryData& odom, double* timestamp = nullptr) override;
+    bool resetOdometry() override;
+
+private:
+    void onOdometry(const rosbag2_storage::SerializedBagMessage& bagMessage);
+
+    Ros2BagPlayer m_player;
+    std::string m_topic_name;
+
+    std::mutex m_mutex;
+    yarp::dev::OdometryData m_odometry;
+    double m_timestamp{0.0};
+    bool m_data_valid{false};
+    bool m_data_fresh{false};
+};
+
+#endif // YARP_ROS2_ODOMETRY2D_REPLAY_ROS2_H
@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
+#include <yarp/dev/IOdometry2D.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <nav_msgs/msg/odometry.hpp>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+#include <harness_bag.h>
+
+#include <cmath>
+
+using namespace yarp::dev;
+using namespace yarp::dev::Nav2D;
+using namespace yarp::os;
+
+namespace {
+constexpr const char* s_topic = "/odom";
+constexpr size_t s_samples = 5;
+constexpr double s_yawStep = 20.0; // deg
+
+// Records s_samples odometries of a base turning while moving forward and sideways,
+// the recording time of each message is its header stamp
+std::string recordOdometries()
+{
+    return recordBag("odometry2D_replay_ros2", s_topic, s_samples, [](size_t i, const rclcpp::Time& stamp) {
+        const double yaw = s_yawStep * i * M_PI / 180.0;
+        nav_msgs::msg::Odometry odom;
+        odom.header.stamp = stamp;
+        odom.pose.pose.position.x = 1.0 * i;
+        odom.pose.pose.position.y = 2.0 * i;
+        odom.pose.pose.orientation.z = sin(yaw / 2);
+        odom.pose.pose.orientation.w = cos(yaw / 2);
+        odom.twist.twist.linear.x = 1.0;
+        odom.twist.twist.linear.y = 0.5;
+        odom.twist.twist.angular.z = 0.1;
+        return odom;
+    });
+}
+
+// Waits for the odometry stamped stamp, which also releases the next one, and checks it
+void checkSample(IOdometry2D* iodom, size_t sample, double stamp)
+{
+    OdometryData odom;
+    double timestamp = 0;
+    REQUIRE(waitFor([&] { return iodom->getOdometry(odom, &timestamp) && timestamp == approxStamp(stamp); }));
+
+    const double yaw = s_yawStep * sample;
+    CHECK(odom.odom_x == Catch::Approx(1.0 * sample));
+    CHECK(odom.odom_y == Catch::Approx(2.0 * sample));
+    CHECK(odom.odom_theta == Catch::Approx(yaw).margin(1e-9));
+    CHECK(odom.base_vel_x == Catch::Approx(1.0));
+    CHECK(odom.base_vel_y == Catch::Approx(0.5));
+    CHECK(odom.base_vel_theta == Catch::Approx(0.1 * 180.0 / M_PI));
+    // The recorded twist is rotated from the base frame to the odometry frame
+    const double c = cos(yaw * M_PI / 180.0);
+    const double s = sin(yaw * M_PI / 180.0);
+    CHECK(odom.odom_vel_x == Catch::Approx(c * 1.0 - s * 0.5));
+    CHECK(odom.odom_vel_y == Catch::Approx(s * 1.0 + c * 0.5));
+    CHECK(odom.odom_vel_theta == Catch::Approx(0.1 * 180.0 / M_PI));
+}
+} // namespace
+
+TEST_CASE("dev::odometry2D_replay_ros2_playback_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("odometry2D_replay_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    const std::string uri = recordOdometries();
+
+    SECTION("Playing as fast as possible")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "odometry2D_replay_ros2");
+        pcfg.put("bag_uri", uri);
+        pcfg.put("bag_topic_name", s_topic);
+        pcfg.put("as_fast_as_possible", Value(true));
+        REQUIRE(dd.open(pcfg));
+
+        IOdometry2D* iodom = nullptr;
+        REQUIRE(dd.view(iodom));
+
+        // Every recorded odometry is returned once, in order
+        for (size_t i = 0; i < s_samples; i++) {
+            checkSample(iodom, i, stampOf(i));
+        }
+
+        CHECK(dd.close());
+    }
+
+    SECTION("Playing as fast as possible in a loop")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "odometry2D_replay_ros2");
+        pcfg.put("bag_uri", uri);
+        pcfg.put("bag_topic_name", s_topic);
+        pcfg.put("as_fast_as_possible", Value(true));
+        pcfg.put("loop", Value(true));
+        REQUIRE(dd.open(pcfg));
+
+        IOdometry2D* iodom = nullptr;
+        REQUIRE(dd.view(iodom));
+
+        // The second loop continues the stamps one period after the last odometry
+        for (size_t i = 0; i < 2 * s_samples; i++) {
+            checkSample(iodom, i % s_samples, stampOf(i));
+        }
+
+        CHECK(dd.close());
+    }
+
+    SECTION("Playing with the recorded timing")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "odometry2D_replay_ros2");
+        pcfg.put("bag_uri", uri);
+        pcfg.put("bag_topic_name", s_topic);
+        pcfg.put("time_scale", 0.5);
+        REQUIRE(dd.open(pcfg));
+        const double start = Time::now();
+
+        IOdometry2D* iodom = nullptr;
+        REQUIRE(dd.view(iodom));
+
+        // At half the recorded speed, the last odometry is played after twice the recorded duration
+        OdometryData odom;
+        double timestamp = 0;
+        REQUIRE(waitFor([&] { return iodom->getOdometry(odom, &timestamp) && timestamp == approxStamp(stampOf(s_samples - 1)); }, 3.0));
+        const double elapsed = Time::now() - start;
+        const double expected = (s_samples - 1) * s_periodNs * 1e-9 * 2.0;
+        CHECK(elapsed > expected * 0.5);
+        CHECK(elapsed < expected + 0.5);
+        CHECK(odom.odom_x == Catch::Approx(1.0 * (s_samples - 1)));
+
+        CHECK(dd.close());
+    }
+
+    std::filesystem::remove_all(uri);
+
+    Network::setLocalMode(false);
+}
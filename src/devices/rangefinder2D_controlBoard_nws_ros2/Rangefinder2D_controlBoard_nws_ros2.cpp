@@ -79,6 +79,10 @@ bool Rangefinder2D_controlBoard_nws_ros2::attach(yarp::dev::PolyDriver* driver)
 
 bool Rangefinder2D_controlBoard_nws_ros2::detach()
 {
+    if (m_clockDriver)
+    {
+        m_clockDriver->stop();
+    }
     if (PeriodicThread::isRunning())
     {
         PeriodicThread::stop();
@@ -128,7 +132,7 @@ void Rangefinder2D_controlBoard_nws_ros2::run()
             rosData.range_min = m_minDistance;
             rosData.range_max = m_maxDistance;
             rosData.ranges.resize(ranges_size);
-            rosData.intensities.resize(ranges_size);
+            // The intensities are left empty, IRangefinder2D does not provide them
 
             for (int i = 0; i < ranges_size; i++)
             {
@@ -137,12 +141,10 @@ void Rangefinder2D_controlBoard_nws_ros2::run()
                 if (std::isnan(ranges[i]))
                 {
                    rosData.ranges[i] = std::numeric_limits<double>::infinity();
-                   rosData.intensities[i] = 0.0;
                 }
                 else
                 {
                    rosData.ranges[i] = ranges[i];
-                   rosData.intensities[i] = 0.0;
                 }
             }
             m_publisher_laser->publish(rosData);
@@ -244,20 +246,47 @@ bool Rangefinder2D_controlBoard_nws_ros2::open(yarp::os::Searchable &config)
 
     //create the topic
     m_node = NodeCreator::createNode(m_node_name);
+    m_clockDriver = std::make_unique<Ros2ClockDriver>(m_node, [this]() { run(); });
+    if (!m_clockDriver->configure(config))
+    {
+        return false;
+    }
     m_publisher_laser = m_node->create_publisher<sensor_msgs::msg::LaserScan>(m_topic, 10);
     m_publisher_joint = m_node->create_publisher<sensor_msgs::msg::JointState>(m_topic_cb, 10);
     yCInfo(RANGEFINDER2D_NWS_ROS2, "Opened topic: %s", m_topic.c_str());
 
+    m_parameters = std::make_unique<Ros2Parameters>(m_node);
+    bool ok = m_parameters->addDouble("period", m_period, [this](double period) {
+        if (period <= 0) {
+            return false;
+        }
+        m_period = period;
+        m_clockDriver->setPeriod(m_period);
+        return setPeriod(m_period);
+    });
+    if (!ok || !m_parameters->start()) {
+        yCError(RANGEFINDER2D_NWS_ROS2) << "Unable to initialize the ROS 2 parameters";
+        return false;
+    }
+
     yCWarning(RANGEFINDER2D_NWS_ROS2) << "Waiting for device to attach";
 
     //start the publishing thread
     setPeriod(m_period);
+    m_clockDriver->setPeriod(m_period);
+    if (m_clockDriver->enabled())
+    {
+        return m_clockDriver->start();
+    }
     start();
     return true;
 }
 
 bool Rangefinder2D_controlBoard_nws_ros2::close()
 {
+    if (m_parameters) {
+        m_parameters->stop();
+    }
     detach();
     return true;
 }
@@ -21,7 +21,10 @@
 
 #include <sensor_msgs/msg/laser_scan.hpp>
 #include <sensor_msgs/msg/joint_state.hpp>
+#include <Ros2Parameters.h>
+#include <Ros2ClockDriver.h>
 
+#include <memory>
 #include <mutex>
 
 /**
@@ -32,6 +35,9 @@
  * This device was developed for testing purposes only with fake/simulated controllers.
  * No documentation is provided for this device. Please do not use it on a real robot.
  *
+ *  With `clock_source` set to `ros` the device publishes once per period of the simulated time,
+ *  see Ros2ClockDriver for the `clock_*` parameters.
+ *
  */
 class Rangefinder2D_controlBoard_nws_ros2 :
         public yarp::dev::DeviceDriver,
@@ -75,6 +81,8 @@ private:
     rclcpp::Node::SharedPtr m_node;
     rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr m_publisher_laser;
     rclcpp::Publisher<sensor_msgs::msg::JointState>::SharedPtr m_publisher_joint;
+    std::unique_ptr<Ros2Parameters> m_parameters;
+    std::unique_ptr<Ros2ClockDriver> m_clockDriver;
     bool m_isDeviceReady = false;
     yarp::sig::Vector m_times;
 
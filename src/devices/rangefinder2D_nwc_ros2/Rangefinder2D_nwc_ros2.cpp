@@ -25,6 +25,10 @@ using namespace yarp::dev;
 
 YARP_LOG_COMPONENT(RANGEFINDER2D_NWC_ROS2, "yarp.ros2.rangefinder2D_nwc_ros2", yarp::os::Log::TraceType);
 
+namespace {
+constexpr double RAD2DEG = 180.0 / M_PI;
+}
+
 
 Rangefinder2D_nwc_ros2::Rangefinder2D_nwc_ros2()
 {
@@ -75,51 +79,55 @@ void Rangefinder2D_nwc_ros2::callback(sensor_msgs::msg::LaserScan::SharedPtr msg
     yCTrace(RANGEFINDER2D_NWC_ROS2, "callback LaserScan");
     std::lock_guard<std::mutex> data_guard(m_mutex);
 
-    if (m_data_valid==false)
-    {
-        m_minAngle = msg->angle_min;
-        m_maxAngle = msg->angle_max;
-        m_minDistance = msg->range_min;
-        m_maxDistance = msg->range_max;
-        m_resolution = msg->angle_increment;
-        m_data.resize(msg->ranges.size());
-        m_data_valid = true;
-    }
-    if (msg->ranges.size() == m_data.size())
+    // The ROS angles are in radians, the ones of IRangefinder2D in degrees
+    m_angleMinRad = msg->angle_min;
+    m_angleIncrementRad = msg->angle_increment;
+    m_minAngle = msg->angle_min * RAD2DEG;
+    m_maxAngle = msg->angle_max * RAD2DEG;
+    m_minDistance = msg->range_min;
+    m_maxDistance = msg->range_max;
+    m_resolution = msg->angle_increment * RAD2DEG;
+    m_scanTime = msg->scan_time;
+    if (m_data_valid && msg->ranges.size() != m_data.size())
     {
-        for (size_t i=0; i<m_data.size(); i++)
-        {
-            m_data[i] = msg->ranges[i];
-        }
+        yCWarning(RANGEFINDER2D_NWC_ROS2) << "The scan size changed from" << m_data.size() << "to" << msg->ranges.size();
     }
-    else
+    m_data.resize(msg->ranges.size());
+    for (size_t i=0; i<m_data.size(); i++)
     {
-        yCError(RANGEFINDER2D_NWC_ROS2, "Data vector changed its size?");
+        m_data[i] = msg->ranges[i];
     }
-    m_timestamp = (msg->header.stamp.sec + (msg->header.stamp.nanosec / 1000000000));
+    m_timestamp = yarpTimeFromRos2(msg->header.stamp);
+    m_data_valid = true;
 }
 
 bool Rangefinder2D_nwc_ros2::getLaserMeasurement(std::vector<yarp::dev::LaserMeasurementData> &data, double* timestamp)
 {
-    if (!m_data_valid) {return false;}
     std::lock_guard<std::mutex> data_guard(m_mutex);
-    *timestamp = m_timestamp;
+    if (!m_data_valid) {return false;}
+    data.resize(m_data.size());
+    for (size_t i=0; i<m_data.size(); i++)
+    {
+        data[i].set_polar(m_data[i], m_angleMinRad + i * m_angleIncrementRad);
+    }
+    if (timestamp) {*timestamp = m_timestamp;}
     return true;
 }
 
 bool Rangefinder2D_nwc_ros2::getRawData(yarp::sig::Vector &data, double* timestamp)
 {
-    if (!m_data_valid) {return false;}
     std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {return false;}
     data = m_data;
-    *timestamp = m_timestamp;
+    if (timestamp) {*timestamp = m_timestamp;}
     return true;
 }
 
 bool Rangefinder2D_nwc_ros2::getDeviceStatus(Device_status& status)
 {
-    if (!m_data_valid) {return false;}
     std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {return false;}
+    status = DEVICE_OK_IN_USE;
     return true;
 }
 
@@ -175,8 +183,9 @@ bool Rangefinder2D_nwc_ros2::setHorizontalResolution(double step)
 
 bool Rangefinder2D_nwc_ros2::getScanRate(double& rate)
 {
-    if (!m_data_valid) {return false;}
     std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid || m_scanTime <= 0) {return false;}
+    rate = 1.0 / m_scanTime;
     return true;
 }
 
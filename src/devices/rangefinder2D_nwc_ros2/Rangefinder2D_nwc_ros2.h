@@ -76,6 +76,9 @@ private:
     double m_minAngle, m_maxAngle;
     double m_minDistance, m_maxDistance;
     double m_resolution;
+    double m_angleMinRad = 0;
+    double m_angleIncrementRad = 0;
+    double m_scanTime = 0;
     double m_period;
     double m_timestamp;
     yarp::sig::Vector m_data;
@@ -3,13 +3,20 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
 #include <yarp/os/Network.h>
 #include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/IRangefinder2D.h>
 #include <yarp/dev/WrapperSingle.h>
 
 #include <catch2/catch_amalgamated.hpp>
 #include <harness.h>
 
+#include <cmath>
+
 using namespace yarp::dev;
 using namespace yarp::os;
 
@@ -37,5 +44,82 @@ TEST_CASE("dev::rangefinder2D_nwc_ros2_test", "[yarp::dev]")
             CHECK(ddnwc.close());
         }
     }
+
+    SECTION("Checking the nwc before receiving a scan")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.put("device", "rangefinder2D_nwc_ros2");
+        pcfg.put("node_name", "rangefinder2D_nwc");
+        pcfg.put("topic_name","/rangefinder2D_nwc_topic");
+        REQUIRE(ddnwc.open(pcfg));
+
+        yarp::dev::IRangefinder2D* irf = nullptr;
+        REQUIRE(ddnwc.view(irf));
+        std::vector<yarp::dev::LaserMeasurementData> measurements;
+        double timestamp = 0;
+        CHECK_FALSE(irf->getLaserMeasurement(measurements, &timestamp));
+        CHECK_FALSE(irf->getLaserMeasurement(measurements));
+
+        CHECK(ddnwc.close());
+    }
+
+    SECTION("Checking the nwc receiving a scan")
+    {
+        PolyDriver ddnwc;
+        Property pcfg;
+        pcfg.put("device", "rangefinder2D_nwc_ros2");
+        pcfg.put("node_name", "rangefinder2D_nwc");
+        pcfg.put("topic_name","/rangefinder2D_nwc_topic");
+        REQUIRE(ddnwc.open(pcfg));
+
+        yarp::dev::IRangefinder2D* irf = nullptr;
+        REQUIRE(ddnwc.view(irf));
+
+        // Three beams at -0.5, 0 and 0.5 rad
+        system("ros2 topic pub --once /rangefinder2D_nwc_topic sensor_msgs/msg/LaserScan \"{header: {stamp: {sec: 10, nanosec: 500000000}, "
+               "frame_id: 'laser'}, angle_min: -0.5, angle_max: 0.5, angle_increment: 0.5, scan_time: 0.1, range_min: 0.1, range_max: 10.0, "
+               "ranges: [1.0, 2.0, 3.0]}\"");
+
+        std::vector<yarp::dev::LaserMeasurementData> measurements;
+        double timestamp = 0;
+        REQUIRE(waitFor([&] { return irf->getLaserMeasurement(measurements, &timestamp); }));
+        // The nanoseconds are kept
+        CHECK(timestamp == Catch::Approx(10.5).epsilon(0).margin(1e-9));
+        REQUIRE(measurements.size() == 3);
+        for (size_t i = 0; i < measurements.size(); i++) {
+            double rho = 0;
+            double theta = 0;
+            measurements[i].get_polar(rho, theta);
+            CHECK(rho == Catch::Approx(1.0 + i));
+            CHECK(theta == Catch::Approx(-0.5 + 0.5 * i).margin(1e-6));
+        }
+
+        yarp::sig::Vector ranges;
+        CHECK(irf->getRawData(ranges, &timestamp));
+        REQUIRE(ranges.size() == 3);
+        CHECK(ranges[2] == Catch::Approx(3.0));
+
+        // The angles of IRangefinder2D are in degrees
+        double min = 0;
+        double max = 0;
+        CHECK(irf->getScanLimits(min, max));
+        CHECK(min == Catch::Approx(-0.5 * 180.0 / M_PI));
+        CHECK(max == Catch::Approx(0.5 * 180.0 / M_PI));
+        double step = 0;
+        CHECK(irf->getHorizontalResolution(step));
+        CHECK(step == Catch::Approx(0.5 * 180.0 / M_PI));
+        CHECK(irf->getDistanceRange(min, max));
+        CHECK(min == Catch::Approx(0.1));
+        CHECK(max == Catch::Approx(10.0));
+        double rate = 0;
+        CHECK(irf->getScanRate(rate));
+        CHECK(rate == Catch::Approx(10.0));
+        IRangefinder2D::Device_status status;
+        CHECK(irf->getDeviceStatus(status));
+        CHECK(status == IRangefinder2D::DEVICE_OK_IN_USE);
+
+        CHECK(ddnwc.close());
+    }
     Network::setLocalMode(false);
 }
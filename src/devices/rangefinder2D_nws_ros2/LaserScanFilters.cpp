@@ -0,0 +1,244 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include "LaserScanFilters.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+YARP_LOG_COMPONENT(LASERSCANFILTERS, "yarp.ros2.rangefinder2D_nws_ros2.filters")
+
+constexpr float removed = std::numeric_limits<float>::infinity();
+
+// The angle from `from` to `to`, counterclockwise, in [0, 2pi)
+double sector(double from, double to)
+{
+    double angle = std::fmod(to - from, 2 * M_PI);
+    return angle < 0 ? angle + 2 * M_PI : angle;
+}
+} // namespace
+
+bool LaserScanFilters::configure(yarp::os::Searchable& config)
+{
+    m_chain.clear();
+    m_masks.clear();
+    m_hasGeometry = false;
+
+    if (!config.check("filters")) {
+        return true;
+    }
+    yarp::os::Bottle* filters = config.find("filters").asList();
+    if (!filters) {
+        yCError(LASERSCANFILTERS) << "filters must be a list of filter names";
+        return false;
+    }
+    for (size_t i = 0; i < filters->size(); i++) {
+        std::string name = filters->get(i).asString();
+        if (name == "range") {
+            m_chain.push_back(Filter::Range);
+        } else if (name == "angular_mask") {
+            m_chain.push_back(Filter::AngularMask);
+        } else if (name == "median") {
+            m_chain.push_back(Filter::Median);
+        } else if (name == "shadow") {
+            m_chain.push_back(Filter::Shadow);
+        } else {
+            yCError(LASERSCANFILTERS) << "Unknown filter" << name << ", must be one of range, angular_mask, median, shadow";
+            return false;
+        }
+    }
+
+    if (config.check("filter_range_min")) {
+        m_rangeMin = static_cast<float>(config.find("filter_range_min").asFloat64());
+    }
+    if (config.check("filter_range_max")) {
+        m_rangeMax = static_cast<float>(config.find("filter_range_max").asFloat64());
+    }
+    if (m_rangeMin < 0 || m_rangeMax <= m_rangeMin) {
+        yCError(LASERSCANFILTERS) << "filter_range_min and filter_range_max must satisfy 0 <= min < max";
+        return false;
+    }
+
+    if (config.check("filter_angular_mask")) {
+        yarp::os::Bottle* masks = config.find("filter_angular_mask").asList();
+        if (!masks) {
+            yCError(LASERSCANFILTERS) << "filter_angular_mask must be a list of (min max) sectors";
+            return false;
+        }
+        for (size_t i = 0; i < masks->size(); i++) {
+            yarp::os::Bottle* mask = masks->get(i).asList();
+            if (!mask || mask->size() != 2) {
+                yCError(LASERSCANFILTERS) << "filter_angular_mask must be a list of (min max) sectors";
+                return false;
+            }
+            m_masks.emplace_back(mask->get(0).asFloat64() * M_PI / 180.0, mask->get(1).asFloat64() * M_PI / 180.0);
+        }
+    }
+    if (std::find(m_chain.begin(), m_chain.end(), Filter::AngularMask) != m_chain.end() && m_masks.empty()) {
+        yCError(LASERSCANFILTERS) << "The angular_mask filter requires filter_angular_mask";
+        return false;
+    }
+
+    if (config.check("filter_median_window")) {
+        int window = config.find("filter_median_window").asInt32();
+        if (window < 3 || window % 2 == 0) {
+            yCError(LASERSCANFILTERS) << "filter_median_window must be an odd number greater than 1";
+            return false;
+        }
+        m_medianWindow = static_cast<size_t>(window);
+    }
+
+    m_shadowMinAngle = config.check("filter_shadow_min_angle", yarp::os::Value(10.0)).asFloat64() * M_PI / 180.0;
+    if (m_shadowMinAngle <= 0 || m_shadowMinAngle >= M_PI / 2) {
+        yCError(LASERSCANFILTERS) << "filter_shadow_min_angle must be between 0 and 90 degrees";
+        return false;
+    }
+    if (config.check("filter_shadow_neighbors")) {
+        int neighbors = config.find("filter_shadow_neighbors").asInt32();
+        if (neighbors < 1) {
+            yCError(LASERSCANFILTERS) << "filter_shadow_neighbors must be positive";
+            return false;
+        }
+        m_shadowNeighbors = static_cast<size_t>(neighbors);
+    }
+
+    m_window.reserve(m_medianWindow);
+    return true;
+}
+
+void LaserScanFilters::apply(double angleMin, double angleIncrement, std::vector<float>& ranges)
+{
+    if (m_chain.empty()) {
+        return;
+    }
+    if (!m_hasGeometry || angleMin != m_angleMin || angleIncrement != m_angleIncrement || ranges.size() != m_count) {
+        updateGeometry(angleMin, angleIncrement, ranges.size());
+    }
+
+    for (auto filter : m_chain) {
+        switch (filter) {
+        case Filter::Range:
+            applyRange(ranges);
+            break;
+        case Filter::AngularMask:
+            applyAngularMask(ranges);
+            break;
+        case Filter::Median:
+            applyMedian(ranges);
+            break;
+        case Filter::Shadow:
+            applyShadow(ranges);
+            break;
+        }
+    }
+}
+
+void LaserScanFilters::updateGeometry(double angleMin, double angleIncrement, size_t count)
+{
+    m_hasGeometry = true;
+    m_angleMin = angleMin;
+    m_angleIncrement = angleIncrement;
+    m_count = count;
+
+    m_maskedIndexes.clear();
+    bool inside = false;
+    for (size_t i = 0; i < count; i++) {
+        double angle = angleMin + i * angleIncrement;
+        bool masked = false;
+        for (const auto& mask : m_masks) {
+            masked = masked || sector(mask.first, angle) <= sector(mask.first, mask.second);
+        }
+        if (masked && !inside) {
+            m_maskedIndexes.emplace_back(i, count);
+        } else if (!masked && inside) {
+            m_maskedIndexes.back().second = i;
+        }
+        inside = masked;
+    }
+
+    m_shadowSin.resize(m_shadowNeighbors + 1);
+    m_shadowCos.resize(m_shadowNeighbors + 1);
+    for (size_t k = 1; k <= m_shadowNeighbors; k++) {
+        m_shadowSin[k] = static_cast<float>(std::sin(k * angleIncrement));
+        m_shadowCos[k] = static_cast<float>(std::cos(k * angleIncrement));
+    }
+
+    m_input.resize(count);
+    m_shadowed.resize(count);
+}
+
+void LaserScanFilters::applyRange(std::vector<float>& ranges) const
+{
+    // Branchless, so that it is vectorized
+    const float min = m_rangeMin;
+    const float max = m_rangeMax;
+    float* data = ranges.data();
+    const size_t size = ranges.size();
+    for (size_t i = 0; i < size; i++) {
+        data[i] = (data[i] < min || data[i] > max) ? removed : data[i];
+    }
+}
+
+void LaserScanFilters::applyAngularMask(std::vector<float>& ranges) const
+{
+    for (const auto& masked : m_maskedIndexes) {
+        std::fill(ranges.begin() + masked.first, ranges.begin() + masked.second, removed);
+    }
+}
+
+void LaserScanFilters::applyMedian(std::vector<float>& ranges)
+{
+    std::copy(ranges.begin(), ranges.end(), m_input.begin());
+    const size_t half = m_medianWindow / 2;
+    const size_t size = ranges.size();
+    for (size_t i = 0; i < size; i++) {
+        // The window is shorter at the ends of the scan
+        size_t first = i < half ? 0 : i - half;
+        size_t last = std::min(size, i + half + 1);
+        m_window.assign(m_input.begin() + first, m_input.begin() + last);
+        auto middle = m_window.begin() + m_window.size() / 2;
+        std::nth_element(m_window.begin(), middle, m_window.end());
+        ranges[i] = *middle;
+    }
+}
+
+void LaserScanFilters::applyShadow(std::vector<float>& ranges)
+{
+    // The angle between the beam and the line joining two readings is close to 0 or to pi when
+    // the readings are on a surface seen edge-on, or are veiling points between two objects
+    const float tanMin = static_cast<float>(std::tan(m_shadowMinAngle));
+    const size_t size = ranges.size();
+    std::fill(m_shadowed.begin(), m_shadowed.end(), 0);
+    for (size_t i = 0; i < size; i++) {
+        const float r1 = ranges[i];
+        if (!std::isfinite(r1)) {
+            continue;
+        }
+        for (size_t k = 1; k <= m_shadowNeighbors && i + k < size; k++) {
+            const float r2 = ranges[i + k];
+            if (!std::isfinite(r2)) {
+                continue;
+            }
+            const float perpendicular = r2 * m_shadowSin[k];
+            const float along = r1 - r2 * m_shadowCos[k];
+            // |atan2(perpendicular, along)| < min or > pi - min
+            if (std::fabs(perpendicular) < tanMin * std::fabs(along)) {
+                m_shadowed[r1 > r2 ? i : i + k] = 1;
+            }
+        }
+    }
+    for (size_t i = 0; i < size; i++) {
+        ranges[i] = m_shadowed[i] ? removed : ranges[i];
+    }
+}
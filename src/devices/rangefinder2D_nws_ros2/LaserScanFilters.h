@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_LASERSCANFILTERS_H
+#define YARP_ROS2_LASERSCANFILTERS_H
+
+#include <yarp/os/Searchable.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * A chain of filters applied in place to the ranges of a scan before it is published.
+ *
+ * The filters read the parameters
+ * | Parameter name          | Type             | Units   | Default | Description |
+ * |:-----------------------:|:----------------:|:-------:|:-------:|:------------|
+ * | filters                 | list of strings  | -       | -       | The filters to apply, in order, among `range`, `angular_mask`, `median` and `shadow`. No filter if absent |
+ * | filter_range_min        | double           | m       | 0       | `range`: the readings closer than this are removed |
+ * | filter_range_max        | double           | m       | inf     | `range`: the readings farther than this are removed |
+ * | filter_angular_mask     | list of lists    | deg     | -       | `angular_mask`: the `(min max)` angular sectors whose readings are removed, e.g. the ones hitting the robot body |
+ * | filter_median_window    | int              | -       | 3       | `median`: the odd number of consecutive readings the median is computed on |
+ * | filter_shadow_min_angle | double           | deg     | 10      | `shadow`: the readings on a surface seen at a smaller angle than this are removed |
+ * | filter_shadow_neighbors | int              | -       | 1       | `shadow`: how many following readings each reading is compared with |
+ *
+ * The removed readings are set to +inf, as the missing ones. Everything depending only on the
+ * geometry of the scan (the indexes of the masked sectors, the trigonometry of the shadow filter)
+ * is computed when the first scan is received, and again only if the geometry changes. The
+ * buffers used by the filters are allocated once, so filtering a scan does not allocate memory.
+ */
+class LaserScanFilters
+{
+public:
+    bool configure(yarp::os::Searchable& config);
+
+    bool empty() const
+    {
+        return m_chain.empty();
+    }
+
+    /**
+     * Filters the ranges of a scan starting at `angleMin` with a reading every `angleIncrement` radians.
+     */
+    void apply(double angleMin, double angleIncrement, std::vector<float>& ranges);
+
+private:
+    enum class Filter
+    {
+        Range,
+        AngularMask,
+        Median,
+        Shadow
+    };
+
+    void updateGeometry(double angleMin, double angleIncrement, size_t count);
+    void applyRange(std::vector<float>& ranges) const;
+    void applyAngularMask(std::vector<float>& ranges) const;
+    void applyMedian(std::vector<float>& ranges);
+    void applyShadow(std::vector<float>& ranges);
+
+    std::vector<Filter> m_chain;
+    float m_rangeMin{0};
+    float m_rangeMax{std::numeric_limits<float>::infinity()};
+    std::vector<std::pair<double, double>> m_masks; // radians
+    size_t m_medianWindow{3};
+    double m_shadowMinAngle{0};                     // radians
+    size_t m_shadowNeighbors{1};
+
+    // Depending on the geometry of the scan
+    bool m_hasGeometry{false};
+    double m_angleMin{0};
+    double m_angleIncrement{0};
+    size_t m_count{0};
+    std::vector<std::pair<size_t, size_t>> m_maskedIndexes; // [first, last)
+    std::vector<float> m_shadowSin;
+    std::vector<float> m_shadowCos;
+
+    // Work buffers
+    std::vector<float> m_input;
+    std::vector<float> m_window;
+    std::vector<uint8_t> m_shadowed;
+};
+
+#endif // YARP_ROS2_LASERSCANFILTERS_H
@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "LaserScanToPointCloud.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <sensor_msgs/msg/point_field.hpp>
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+YARP_LOG_COMPONENT(LASERSCANTOPOINTCLOUD, "yarp.ros2.rangefinder2D_nws_ros2.pointcloud")
+
+constexpr uint32_t pointStep = 3 * sizeof(float);
+} // namespace
+
+bool LaserScanToPointCloud::configure(yarp::os::Searchable& config, const std::string& laserFrameId)
+{
+    m_hasGeometry = false;
+    m_topic = config.check("pointcloud_topic", yarp::os::Value("")).asString();
+    m_frameId = config.check("pointcloud_frame_id", yarp::os::Value(laserFrameId)).asString();
+    if (!enabled()) {
+        return true;
+    }
+    if (m_frameId.empty()) {
+        yCError(LASERSCANTOPOINTCLOUD) << "pointcloud_frame_id cannot be empty";
+        return false;
+    }
+
+    if (config.check("pointcloud_transform")) {
+        yarp::os::Bottle* pose = config.find("pointcloud_transform").asList();
+        if (!pose || pose->size() != 6) {
+            yCError(LASERSCANTOPOINTCLOUD) << "pointcloud_transform must be a list of 6 values: x y z roll pitch yaw";
+            return false;
+        }
+        for (size_t i = 0; i < 3; i++) {
+            m_translation[i] = pose->get(i).asFloat64();
+        }
+        double cr = std::cos(pose->get(3).asFloat64());
+        double sr = std::sin(pose->get(3).asFloat64());
+        double cp = std::cos(pose->get(4).asFloat64());
+        double sp = std::sin(pose->get(4).asFloat64());
+        double cy = std::cos(pose->get(5).asFloat64());
+        double sy = std::sin(pose->get(5).asFloat64());
+        // Rz(yaw) * Ry(pitch) * Rx(roll)
+        double rotation[3][3] = {{cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr},
+                                 {sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr},
+                                 {-sp, cp * sr, cp * cr}};
+        std::memcpy(m_rotation, rotation, sizeof(m_rotation));
+    }
+    return true;
+}
+
+void LaserScanToPointCloud::updateGeometry(float angleMin, float angleIncrement, size_t count)
+{
+    m_hasGeometry = true;
+    m_angleMin = angleMin;
+    m_angleIncrement = angleIncrement;
+    m_directions.resize(3 * count);
+    for (size_t i = 0; i < count; i++) {
+        double angle = static_cast<double>(angleMin) + i * static_cast<double>(angleIncrement);
+        double c = std::cos(angle);
+        double s = std::sin(angle);
+        for (size_t j = 0; j < 3; j++) {
+            m_directions[3 * i + j] = static_cast<float>(m_rotation[j][0] * c + m_rotation[j][1] * s);
+        }
+    }
+}
+
+void LaserScanToPointCloud::convert(const sensor_msgs::msg::LaserScan& scan, sensor_msgs::msg::PointCloud2& cloud)
+{
+    const size_t count = scan.ranges.size();
+    if (!m_hasGeometry || scan.angle_min != m_angleMin || scan.angle_increment != m_angleIncrement || 3 * count != m_directions.size()) {
+        updateGeometry(scan.angle_min, scan.angle_increment, count);
+    }
+
+    cloud.header.stamp = scan.header.stamp;
+    cloud.header.frame_id = m_frameId;
+    if (cloud.fields.empty()) {
+        const char* names[3] = {"x", "y", "z"};
+        for (uint32_t i = 0; i < 3; i++) {
+            sensor_msgs::msg::PointField field;
+            field.name = names[i];
+            field.offset = i * sizeof(float);
+            field.datatype = sensor_msgs::msg::PointField::FLOAT32;
+            field.count = 1;
+            cloud.fields.push_back(field);
+        }
+        cloud.height = 1;
+        cloud.point_step = pointStep;
+        cloud.is_bigendian = false;
+        cloud.is_dense = true;
+    }
+
+    // Shrinking the buffer keeps its capacity, it is only reallocated if the cloud grows
+    cloud.data.resize(count * pointStep);
+    uint8_t* out = cloud.data.data();
+    const float tx = static_cast<float>(m_translation[0]);
+    const float ty = static_cast<float>(m_translation[1]);
+    const float tz = static_cast<float>(m_translation[2]);
+    const float* direction = m_directions.data();
+    size_t valid = 0;
+    for (size_t i = 0; i < count; i++, direction += 3) {
+        const float range = scan.ranges[i];
+        if (!std::isfinite(range) || range < scan.range_min || range > scan.range_max) {
+            continue;
+        }
+        const float point[3] = {tx + range * direction[0], ty + range * direction[1], tz + range * direction[2]};
+        std::memcpy(out + valid * pointStep, point, pointStep);
+        valid++;
+    }
+    cloud.data.resize(valid * pointStep);
+    cloud.width = static_cast<uint32_t>(valid);
+    cloud.row_step = cloud.width * pointStep;
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_LASERSCANTOPOINTCLOUD_H
+#define YARP_ROS2_LASERSCANTOPOINTCLOUD_H
+
+#include <yarp/os/Searchable.h>
+
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+ * Converts the scans to point clouds.
+ *
+ * The conversion reads the parameters
+ * | Parameter name        | Type             | Units    | Default        | Description |
+ * |:---------------------:|:----------------:|:--------:|:--------------:|:------------|
+ * | pointcloud_topic      | string           | -        | -              | The topic of the sensor_msgs/PointCloud2 messages. No cloud is published if absent |
+ * | pointcloud_frame_id   | string           | -        | frame_id       | The frame of the points |
+ * | pointcloud_transform  | list of doubles  | m, rad   | (0 0 0 0 0 0)  | `(x y z roll pitch yaw)`, the pose of the laser in pointcloud_frame_id |
+ *
+ * The direction of every beam, already rotated to the frame of the points, is computed when
+ * the first scan is received and again only if the geometry of the scan changes, so the
+ * conversion of a reading only costs a multiplication and an addition per coordinate.
+ * The readings that are not finite or are outside the range limits of the scan are skipped,
+ * the cloud is dense and its buffer is only reallocated if the cloud grows.
+ */
+class LaserScanToPointCloud
+{
+public:
+    bool configure(yarp::os::Searchable& config, const std::string& laserFrameId);
+
+    bool enabled() const
+    {
+        return !m_topic.empty();
+    }
+
+    const std::string& topic() const
+    {
+        return m_topic;
+    }
+
+    void convert(const sensor_msgs::msg::LaserScan& scan, sensor_msgs::msg::PointCloud2& cloud);
+
+private:
+    void updateGeometry(float angleMin, float angleIncrement, size_t count);
+
+    std::string m_topic;
+    std::string m_frameId;
+    double m_translation[3]{0, 0, 0};
+    double m_rotation[3][3]{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+
+    // Depending on the geometry of the scan
+    bool m_hasGeometry{false};
+    float m_angleMin{0};
+    float m_angleIncrement{0};
+    // The direction of the beams in the frame of the points, x y z for every beam
+    std::vector<float> m_directions;
+};
+
+#endif // YARP_ROS2_LASERSCANTOPOINTCLOUD_H
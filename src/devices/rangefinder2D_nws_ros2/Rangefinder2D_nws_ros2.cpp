@@ -69,6 +69,10 @@ bool Rangefinder2D_nws_ros2::attach(yarp::dev::PolyDriver* driver)
 
 bool Rangefinder2D_nws_ros2::detach()
 {
+    if (m_clockDriver)
+    {
+        m_clockDriver->stop();
+    }
     if (PeriodicThread::isRunning())
     {
         PeriodicThread::stop();
@@ -94,7 +98,8 @@ void Rangefinder2D_nws_ros2::run()
         {
             int ranges_size = ranges.size();
 
-            sensor_msgs::msg::LaserScan rosData;
+            // The message is kept between the cycles, the buffers are only reallocated if the scan size changes
+            sensor_msgs::msg::LaserScan& rosData = m_scan;
 
             if (!std::isnan(synchronized_timestamp))
             {
@@ -117,7 +122,8 @@ void Rangefinder2D_nws_ros2::run()
             rosData.range_min = m_minDistance;
             rosData.range_max = m_maxDistance;
             rosData.ranges.resize(ranges_size);
-            rosData.intensities.resize(ranges_size);
+            // IRangefinder2D does not provide the intensities, an empty array means they are not available
+            rosData.intensities.clear();
 
             for (int i = 0; i < ranges_size; i++)
             {
@@ -126,15 +132,48 @@ void Rangefinder2D_nws_ros2::run()
                 if (std::isnan(ranges[i]))
                 {
                    rosData.ranges[i] = std::numeric_limits<double>::infinity();
-                   rosData.intensities[i] = 0.0;
                 }
                 else
                 {
                    rosData.ranges[i] = ranges[i];
-                   rosData.intensities[i] = 0.0;
                 }
             }
-            m_publisher->publish(rosData);
+            m_filters.apply(rosData.angle_min, rosData.angle_increment, rosData.ranges);
+            if (m_publishScan)
+            {
+                if (m_recorder)
+                {
+                    m_recorder->publish(m_publisher, rosData);
+                }
+                else
+                {
+                    m_publisher->publish(rosData);
+                }
+            }
+            if (m_multiEchoPublisher)
+            {
+                fillMultiEcho(rosData);
+                if (m_recorder)
+                {
+                    m_recorder->publish(m_multiEchoPublisher, m_multiEcho);
+                }
+                else
+                {
+                    m_multiEchoPublisher->publish(m_multiEcho);
+                }
+            }
+            if (m_pointCloud.enabled())
+            {
+                m_pointCloud.convert(rosData, m_cloud);
+                if (m_recorder)
+                {
+                    m_recorder->publish(m_cloudPublisher, m_cloud);
+                }
+                else
+                {
+                    m_cloudPublisher->publish(m_cloud);
+                }
+            }
         }
         else
         {
@@ -143,6 +182,27 @@ void Rangefinder2D_nws_ros2::run()
     }
 }
 
+void Rangefinder2D_nws_ros2::fillMultiEcho(const sensor_msgs::msg::LaserScan& scan)
+{
+    m_multiEcho.header = scan.header;
+    m_multiEcho.angle_min = scan.angle_min;
+    m_multiEcho.angle_max = scan.angle_max;
+    m_multiEcho.angle_increment = scan.angle_increment;
+    m_multiEcho.time_increment = scan.time_increment;
+    m_multiEcho.scan_time = scan.scan_time;
+    m_multiEcho.range_min = scan.range_min;
+    m_multiEcho.range_max = scan.range_max;
+    // IRangefinder2D provides a single echo per beam. The echo arrays are kept between the cycles,
+    // so after the first scan filling them does not allocate memory
+    m_multiEcho.ranges.resize(scan.ranges.size());
+    for (size_t i = 0; i < scan.ranges.size(); i++)
+    {
+        m_multiEcho.ranges[i].echoes.resize(1);
+        m_multiEcho.ranges[i].echoes[0] = scan.ranges[i];
+    }
+    m_multiEcho.intensities.clear();
+}
+
 bool Rangefinder2D_nws_ros2::open(yarp::os::Searchable &config)
 {
     //wrapper params
@@ -150,25 +210,97 @@ bool Rangefinder2D_nws_ros2::open(yarp::os::Searchable &config)
     m_frame_id = config.check("frame_id",  yarp::os::Value("laser_frame"), "Name of the frameId").asString();
     m_node_name = config.check("node_name",  yarp::os::Value("laser_node"), "Name of the node").asString();
     m_period   = config.check("period", yarp::os::Value(0.010), "Period of the thread").asFloat64();
+    m_publishScan = config.check("publish_scan", yarp::os::Value(true), "Publish the LaserScan messages").asBool();
+    if (!m_filters.configure(config)) {
+        return false;
+    }
+    if (!m_pointCloud.configure(config, m_frame_id)) {
+        return false;
+    }
+    m_multiEchoTopic = config.check("multiecho_topic", yarp::os::Value(""), "Name of the ROS2 topic of the MultiEchoLaserScan messages").asString();
+    if (!m_publishScan && !m_pointCloud.enabled() && m_multiEchoTopic.empty()) {
+        yCError(RANGEFINDER2D_NWS_ROS2) << "publish_scan is false and neither pointcloud_topic nor multiecho_topic are set, nothing would be published";
+        return false;
+    }
+
+    Ros2BagRecorder::Options recorderOptions;
+    if (!Ros2BagRecorder::parseOptions(config, recorderOptions)) {
+        return false;
+    }
+    if (!recorderOptions.uri.empty()) {
+        m_recorder = std::make_unique<Ros2BagRecorder>();
+        if (!m_recorder->open(recorderOptions)) {
+            return false;
+        }
+    }
 
     //create the topic
     m_node = NodeCreator::createNode(m_node_name);
-    m_publisher = m_node->create_publisher<sensor_msgs::msg::LaserScan>(m_topic, 10);
-    yCInfo(RANGEFINDER2D_NWS_ROS2, "Opened topic: %s", m_topic.c_str());
+    m_clockDriver = std::make_unique<Ros2ClockDriver>(m_node, [this]() { run(); });
+    if (!m_clockDriver->configure(config))
+    {
+        return false;
+    }
+    if (m_publishScan)
+    {
+        m_publisher = m_node->create_publisher<sensor_msgs::msg::LaserScan>(m_topic, 10);
+        yCInfo(RANGEFINDER2D_NWS_ROS2, "Opened topic: %s", m_topic.c_str());
+    }
+    if (!m_multiEchoTopic.empty())
+    {
+        m_multiEchoPublisher = m_node->create_publisher<sensor_msgs::msg::MultiEchoLaserScan>(m_multiEchoTopic, 10);
+        yCInfo(RANGEFINDER2D_NWS_ROS2, "Opened topic: %s", m_multiEchoTopic.c_str());
+    }
+    if (m_pointCloud.enabled())
+    {
+        m_cloudPublisher = m_node->create_publisher<sensor_msgs::msg::PointCloud2>(m_pointCloud.topic(), 10);
+        yCInfo(RANGEFINDER2D_NWS_ROS2, "Opened topic: %s", m_pointCloud.topic().c_str());
+    }
+
+    m_parameters = std::make_unique<Ros2Parameters>(m_node);
+    bool ok = m_parameters->addDouble("period", m_period, [this](double period) {
+        if (period <= 0) {
+            return false;
+        }
+        m_period = period;
+        m_clockDriver->setPeriod(m_period);
+        return setPeriod(m_period);
+    });
+    if (!ok || !m_parameters->start()) {
+        yCError(RANGEFINDER2D_NWS_ROS2) << "Unable to initialize the ROS 2 parameters";
+        return false;
+    }
 
     yCInfo(RANGEFINDER2D_NWS_ROS2, "Waiting for device to attach");
 
     //start the publishig thread
     setPeriod(m_period);
+    m_clockDriver->setPeriod(m_period);
+    if (m_clockDriver->enabled())
+    {
+        return m_clockDriver->start();
+    }
     start();
     return true;
 }
 
 bool Rangefinder2D_nws_ros2::close()
 {
+    if (m_parameters)
+    {
+        m_parameters->stop();
+    }
+    if (m_clockDriver)
+    {
+        m_clockDriver->stop();
+    }
     if (PeriodicThread::isRunning())
     {
         PeriodicThread::stop();
     }
+    if (m_recorder)
+    {
+        m_recorder->close();
+    }
     return true;
 }
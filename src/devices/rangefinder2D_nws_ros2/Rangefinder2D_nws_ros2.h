@@ -14,7 +14,16 @@
 #include <rclcpp/rclcpp.hpp>
 #include <std_msgs/msg/string.hpp>
 #include <sensor_msgs/msg/laser_scan.hpp>
+#include <sensor_msgs/msg/multi_echo_laser_scan.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <Ros2Parameters.h>
+#include <Ros2ClockDriver.h>
+#include <Ros2BagRecorder.h>
 
+#include "LaserScanFilters.h"
+#include "LaserScanToPointCloud.h"
+
+#include <memory>
 #include <mutex>
 
 /**
@@ -24,6 +33,30 @@
  *
  *  Documentation to be added
  *
+ *  The `period` of the thread is also exposed as a ROS 2 parameter of the node and
+ *  can be changed at runtime with `ros2 param set`.
+ *
+ *  With `clock_source` set to `ros` the device publishes once per period of the simulated time,
+ *  see Ros2ClockDriver for the `clock_*` parameters.
+ *
+ *  If `record_uri` is set, the published scans are also recorded in an MCAP bag,
+ *  see Ros2BagRecorder for the `record_*` parameters.
+ *
+ *  The ranges can be filtered before being published (range clipping, masking of angular sectors,
+ *  median and shadow filters), instead of running a separate filtering node that receives and
+ *  sends every scan again. See LaserScanFilters for the `filters` and `filter_*` parameters, e.g.
+ *  `filters (range angular_mask shadow)` with `filter_angular_mask ((170 190))`.
+ *
+ *  The filtered scan can also be published as a sensor_msgs/PointCloud2, in the laser frame or in
+ *  another frame, so that the consumers needing points do not convert every scan themselves.
+ *  See LaserScanToPointCloud for the `pointcloud_*` parameters. With `publish_scan` set to false
+ *  (default true) only the point cloud is published.
+ *
+ *  If `multiecho_topic` is set, the filtered scan is also published as a sensor_msgs/MultiEchoLaserScan,
+ *  for the consumers that only accept this message. IRangefinder2D provides a single echo per beam and
+ *  no intensities: the `intensities` arrays of the messages are left empty, as the ROS convention for
+ *  a sensor without intensities, instead of being filled with zeros.
+ *
  */
 class Rangefinder2D_nws_ros2 :
         public yarp::dev::DeviceDriver,
@@ -50,10 +83,24 @@ public:
     void run() override;
 
 private:
+    void fillMultiEcho(const sensor_msgs::msg::LaserScan& scan);
+
     yarp::dev::PolyDriver m_driver;
     yarp::dev::IRangefinder2D *m_iDevice =nullptr;
     rclcpp::Node::SharedPtr m_node;
     rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr m_publisher;
+    std::unique_ptr<Ros2Parameters> m_parameters;
+    std::unique_ptr<Ros2ClockDriver> m_clockDriver;
+    std::unique_ptr<Ros2BagRecorder> m_recorder;
+    sensor_msgs::msg::LaserScan m_scan;
+    LaserScanFilters m_filters;
+    rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_cloudPublisher;
+    sensor_msgs::msg::PointCloud2 m_cloud;
+    LaserScanToPointCloud m_pointCloud;
+    bool m_publishScan{true};
+    rclcpp::Publisher<sensor_msgs::msg::MultiEchoLaserScan>::SharedPtr m_multiEchoPublisher;
+    sensor_msgs::msg::MultiEchoLaserScan m_multiEcho;
+    std::string m_multiEchoTopic;
     bool m_isDeviceOwned = false;
 
     double m_minAngle, m_maxAngle;
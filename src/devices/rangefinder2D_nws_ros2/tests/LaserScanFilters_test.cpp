@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Property.h>
+
+#include <LaserScanFilters.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+constexpr float removed = std::numeric_limits<float>::infinity();
+constexpr double degree = M_PI / 180.0;
+
+LaserScanFilters configured(const std::string& config)
+{
+    yarp::os::Property pcfg;
+    pcfg.fromString(config);
+    LaserScanFilters filters;
+    REQUIRE(filters.configure(pcfg));
+    return filters;
+}
+
+void checkRanges(const std::vector<float>& ranges, const std::vector<float>& expected)
+{
+    REQUIRE(ranges.size() == expected.size());
+    for (size_t i = 0; i < ranges.size(); i++) {
+        INFO("reading " << i);
+        if (std::isinf(expected[i])) {
+            CHECK(std::isinf(ranges[i]));
+        } else {
+            CHECK(ranges[i] == Catch::Approx(expected[i]));
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("dev::LaserScanFilters_test", "[yarp::dev]")
+{
+    SECTION("Without filters the ranges are unchanged")
+    {
+        LaserScanFilters filters = configured("");
+        CHECK(filters.empty());
+        std::vector<float> ranges{0.1f, 2.0f, 100.0f};
+        filters.apply(0, degree, ranges);
+        checkRanges(ranges, {0.1f, 2.0f, 100.0f});
+    }
+
+    SECTION("The readings out of the range are removed")
+    {
+        LaserScanFilters filters = configured("(filters (range)) (filter_range_min 0.5) (filter_range_max 5.0)");
+        CHECK_FALSE(filters.empty());
+        std::vector<float> ranges{0.1f, 0.5f, 2.0f, 5.0f, 6.0f, removed};
+        filters.apply(0, degree, ranges);
+        checkRanges(ranges, {removed, 0.5f, 2.0f, 5.0f, removed, removed});
+    }
+
+    SECTION("The readings of a sector crossing 0 degrees are removed")
+    {
+        LaserScanFilters filters = configured("(filters (angular_mask)) (filter_angular_mask ((350 10)))");
+
+        // A reading every 5 degrees from -177.5 degrees, the masked ones are from -7.5 to 7.5 degrees
+        std::vector<float> ranges(72, 1.0f);
+        filters.apply(-177.5 * degree, 5 * degree, ranges);
+        for (size_t i = 0; i < ranges.size(); i++) {
+            INFO("reading " << i);
+            CHECK(std::isinf(ranges[i]) == (i >= 34 && i <= 37));
+        }
+
+        // The same sector at both ends of a scan from 2.5 to 357.5 degrees
+        std::vector<float> full(72, 1.0f);
+        filters.apply(2.5 * degree, 5 * degree, full);
+        for (size_t i = 0; i < full.size(); i++) {
+            INFO("reading " << i);
+            CHECK(std::isinf(full[i]) == (i <= 1 || i >= 70));
+        }
+    }
+
+    SECTION("Several sectors are removed")
+    {
+        LaserScanFilters filters = configured("(filters (angular_mask)) (filter_angular_mask ((-40 -20) (20 40)))");
+        std::vector<float> ranges(9, 1.0f);
+        // From -45 to 45 degrees every 11.25 degrees
+        filters.apply(-45 * degree, 11.25 * degree, ranges);
+        checkRanges(ranges, {1.0f, removed, removed, 1.0f, 1.0f, 1.0f, removed, removed, 1.0f});
+    }
+
+    SECTION("The median is computed on a shorter window at the ends of the scan")
+    {
+        LaserScanFilters filters = configured("(filters (median))");
+        std::vector<float> ranges{1.0f, 5.0f, 2.0f, 8.0f, 3.0f};
+        filters.apply(0, degree, ranges);
+        // The windows at the ends have two readings, the larger one is taken
+        checkRanges(ranges, {5.0f, 2.0f, 5.0f, 3.0f, 8.0f});
+
+        LaserScanFilters wide = configured("(filters (median)) (filter_median_window 5)");
+        ranges = {1.0f, 5.0f, 2.0f, 8.0f, 3.0f};
+        wide.apply(0, degree, ranges);
+        checkRanges(ranges, {2.0f, 5.0f, 3.0f, 5.0f, 3.0f});
+
+        // An isolated spike is removed
+        ranges = {2.0f, 2.0f, 9.0f, 2.0f, 2.0f};
+        filters.apply(0, degree, ranges);
+        checkRanges(ranges, {2.0f, 2.0f, 2.0f, 2.0f, 2.0f});
+    }
+
+    SECTION("The readings seen at a grazing angle are removed")
+    {
+        LaserScanFilters filters = configured("(filters (shadow)) (filter_shadow_min_angle 10)");
+
+        // A surface facing the sensor is kept, the farther reading of each edge of the
+        // jump between 1 m and 3 m is removed
+        std::vector<float> ranges{1.0f, 1.0f, 1.0f, 1.0f, 1.5f, 3.0f, 3.0f, 3.0f};
+        filters.apply(0, degree, ranges);
+        checkRanges(ranges, {1.0f, 1.0f, 1.0f, 1.0f, removed, removed, 3.0f, 3.0f});
+
+        // The missing readings are not compared
+        ranges = {1.0f, removed, 3.0f, 3.0f};
+        filters.apply(0, degree, ranges);
+        checkRanges(ranges, {1.0f, removed, 3.0f, 3.0f});
+
+        // With more neighbors, a jump hidden by a missing reading is found
+        LaserScanFilters neighbors = configured("(filters (shadow)) (filter_shadow_neighbors 2)");
+        ranges = {1.0f, removed, 3.0f, 3.0f};
+        neighbors.apply(0, degree, ranges);
+        checkRanges(ranges, {1.0f, removed, removed, 3.0f});
+    }
+
+    SECTION("The filters are applied in order")
+    {
+        // A reading too close is removed before the median, which then takes the larger neighbors
+        LaserScanFilters filters = configured("(filters (range median)) (filter_range_min 0.5)");
+        std::vector<float> ranges{1.0f, 0.1f, 1.2f};
+        filters.apply(0, degree, ranges);
+        checkRanges(ranges, {removed, 1.2f, removed});
+
+        // The median first replaces the reading too close, so the range filter keeps every reading
+        LaserScanFilters reversed = configured("(filters (median range)) (filter_range_min 0.5)");
+        ranges = {1.0f, 0.1f, 1.2f};
+        reversed.apply(0, degree, ranges);
+        checkRanges(ranges, {1.0f, 1.0f, 1.2f});
+    }
+
+    SECTION("The invalid configurations are rejected")
+    {
+        for (const char* config : {"(filters (unknown))",
+                                   "(filters (angular_mask))",
+                                   "(filters (angular_mask)) (filter_angular_mask ((10)))",
+                                   "(filters (median)) (filter_median_window 4)",
+                                   "(filters (range)) (filter_range_min 2.0) (filter_range_max 1.0)",
+                                   "(filters (shadow)) (filter_shadow_min_angle 90)",
+                                   "(filters (shadow)) (filter_shadow_neighbors 0)"}) {
+            INFO(config);
+            yarp::os::Property pcfg;
+            pcfg.fromString(config);
+            LaserScanFilters filters;
+            CHECK_FALSE(filters.configure(pcfg));
+        }
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Property.h>
+
+#include <LaserScanToPointCloud.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+struct Point
+{
+    float x;
+    float y;
+    float z;
+};
+
+sensor_msgs::msg::LaserScan makeScan(float angleMin, float angleIncrement, const std::vector<float>& ranges)
+{
+    sensor_msgs::msg::LaserScan scan;
+    scan.header.stamp.sec = 10;
+    scan.header.stamp.nanosec = 500000000;
+    scan.header.frame_id = "laser";
+    scan.angle_min = angleMin;
+    scan.angle_increment = angleIncrement;
+    scan.angle_max = angleMin + (ranges.size() - 1) * angleIncrement;
+    scan.range_min = 0.1f;
+    scan.range_max = 10.0f;
+    scan.ranges = ranges;
+    return scan;
+}
+
+LaserScanToPointCloud configured(const std::string& config)
+{
+    yarp::os::Property pcfg;
+    pcfg.fromString(config);
+    LaserScanToPointCloud converter;
+    REQUIRE(converter.configure(pcfg, "laser"));
+    return converter;
+}
+
+std::vector<Point> pointsOf(const sensor_msgs::msg::PointCloud2& cloud)
+{
+    REQUIRE(cloud.data.size() == cloud.row_step);
+    std::vector<Point> points(cloud.width);
+    for (size_t i = 0; i < points.size(); i++) {
+        std::memcpy(&points[i], cloud.data.data() + i * cloud.point_step, sizeof(Point));
+    }
+    return points;
+}
+
+void checkPoint(const Point& point, double x, double y, double z)
+{
+    CHECK(point.x == Catch::Approx(x).margin(1e-6));
+    CHECK(point.y == Catch::Approx(y).margin(1e-6));
+    CHECK(point.z == Catch::Approx(z).margin(1e-6));
+}
+} // namespace
+
+TEST_CASE("dev::LaserScanToPointCloud_test", "[yarp::dev]")
+{
+    sensor_msgs::msg::PointCloud2 cloud;
+
+    SECTION("The conversion is disabled without a topic")
+    {
+        yarp::os::Property pcfg;
+        LaserScanToPointCloud converter;
+        REQUIRE(converter.configure(pcfg, "laser"));
+        CHECK_FALSE(converter.enabled());
+    }
+
+    SECTION("The readings are converted in the frame of the laser")
+    {
+        LaserScanToPointCloud converter = configured("(pointcloud_topic /cloud)");
+        CHECK(converter.enabled());
+        CHECK(converter.topic() == "/cloud");
+
+        converter.convert(makeScan(-M_PI / 2, M_PI / 2, {1.0f, 2.0f, 3.0f}), cloud);
+        CHECK(cloud.header.frame_id == "laser");
+        CHECK(cloud.header.stamp.sec == 10);
+        CHECK(cloud.header.stamp.nanosec == 500000000);
+        REQUIRE(cloud.fields.size() == 3);
+        CHECK(cloud.fields[0].name == "x");
+        CHECK(cloud.fields[1].name == "y");
+        CHECK(cloud.fields[2].name == "z");
+        for (uint32_t i = 0; i < 3; i++) {
+            CHECK(cloud.fields[i].offset == i * sizeof(float));
+            CHECK(cloud.fields[i].datatype == sensor_msgs::msg::PointField::FLOAT32);
+            CHECK(cloud.fields[i].count == 1);
+        }
+        CHECK(cloud.height == 1);
+        CHECK(cloud.width == 3);
+        CHECK(cloud.point_step == 3 * sizeof(float));
+        CHECK(cloud.row_step == 3 * cloud.point_step);
+        CHECK(cloud.is_dense);
+        CHECK_FALSE(cloud.is_bigendian);
+
+        std::vector<Point> points = pointsOf(cloud);
+        checkPoint(points[0], 0, -1, 0);
+        checkPoint(points[1], 2, 0, 0);
+        checkPoint(points[2], 0, 3, 0);
+    }
+
+    SECTION("The invalid readings are skipped")
+    {
+        LaserScanToPointCloud converter = configured("(pointcloud_topic /cloud)");
+        const float inf = std::numeric_limits<float>::infinity();
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        converter.convert(makeScan(0, M_PI / 10, {1.0f, inf, nan, 0.05f, 20.0f, 3.0f}), cloud);
+        CHECK(cloud.width == 2);
+        CHECK(cloud.row_step == 2 * cloud.point_step);
+        std::vector<Point> points = pointsOf(cloud);
+        checkPoint(points[0], 1, 0, 0);
+        checkPoint(points[1], 0, 3, 0);
+
+        // A following scan with other angles and fewer valid readings
+        converter.convert(makeScan(M_PI, M_PI / 2, {inf, 2.0f}), cloud);
+        CHECK(cloud.width == 1);
+        CHECK(cloud.row_step == cloud.point_step);
+        points = pointsOf(cloud);
+        checkPoint(points[0], 0, -2, 0);
+
+        // Without valid readings the cloud is empty
+        converter.convert(makeScan(0, M_PI / 2, {inf, nan}), cloud);
+        CHECK(cloud.width == 0);
+        CHECK(cloud.row_step == 0);
+        CHECK(cloud.data.empty());
+    }
+
+    SECTION("The readings are moved to the frame of the points")
+    {
+        // The laser is at (1, 2, 0.5) and turned upside down, then rotated by 90 degrees around z
+        LaserScanToPointCloud converter = configured("(pointcloud_topic /cloud) (pointcloud_frame_id base_link) (pointcloud_transform (1.0 2.0 0.5 1.5707963267948966 0.0 1.5707963267948966))");
+        converter.convert(makeScan(0, M_PI / 2, {2.0f, 1.0f}), cloud);
+        CHECK(cloud.header.frame_id == "base_link");
+        REQUIRE(cloud.width == 2);
+        std::vector<Point> points = pointsOf(cloud);
+        // (2, 0, 0) is rotated to (0, 2, 0)
+        checkPoint(points[0], 1, 4, 0.5);
+        // (0, 1, 0) is rotated to (0, 0, 1)
+        checkPoint(points[1], 1, 2, 1.5);
+
+        LaserScanToPointCloud pitched = configured("(pointcloud_topic /cloud) (pointcloud_transform (0.0 0.0 0.0 0.0 1.5707963267948966 0.0))");
+        pitched.convert(makeScan(0, M_PI / 2, {2.0f}), cloud);
+        CHECK(cloud.header.frame_id == "laser");
+        REQUIRE(cloud.width == 1);
+        checkPoint(pointsOf(cloud)[0], 0, 0, -2);
+    }
+
+    SECTION("The invalid configurations are rejected")
+    {
+        for (const char* config : {"(pointcloud_topic /cloud) (pointcloud_transform (1.0 2.0 3.0))",
+                                   "(pointcloud_topic /cloud) (pointcloud_transform 1.0)"}) {
+            INFO(config);
+            yarp::os::Property pcfg;
+            pcfg.fromString(config);
+            LaserScanToPointCloud converter;
+            CHECK_FALSE(converter.configure(pcfg, "laser"));
+        }
+
+        yarp::os::Property pcfg;
+        pcfg.fromString("(pointcloud_topic /cloud)");
+        LaserScanToPointCloud converter;
+        CHECK_FALSE(converter.configure(pcfg, ""));
+    }
+}
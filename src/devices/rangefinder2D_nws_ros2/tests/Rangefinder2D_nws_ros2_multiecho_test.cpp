@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
+#include <yarp/dev/IRangefinder2D.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/WrapperSingle.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <sensor_msgs/msg/multi_echo_laser_scan.hpp>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+using namespace yarp::dev;
+using namespace yarp::os;
+
+namespace {
+bool sameStamp(const builtin_interfaces::msg::Time& a, const builtin_interfaces::msg::Time& b)
+{
+    return a.sec == b.sec && a.nanosec == b.nanosec;
+}
+
+// Receives the scans and the multi echo scans published by the nws
+class ScanListener
+{
+public:
+    ScanListener(const std::string& scanTopic, const std::string& multiEchoTopic)
+    {
+        if (!rclcpp::ok()) {
+            rclcpp::init(0, nullptr);
+        }
+        m_node = std::make_shared<rclcpp::Node>("rangefinder2D_nws_ros2_multiecho_test");
+        m_scanSubscription = m_node->create_subscription<sensor_msgs::msg::LaserScan>(scanTopic, 100,
+            [this](const sensor_msgs::msg::LaserScan::SharedPtr msg) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_scans.push_back(*msg);
+            });
+        m_multiEchoSubscription = m_node->create_subscription<sensor_msgs::msg::MultiEchoLaserScan>(multiEchoTopic, 100,
+            [this](const sensor_msgs::msg::MultiEchoLaserScan::SharedPtr msg) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_multiEchoes.push_back(*msg);
+            });
+        m_executor.add_node(m_node);
+    }
+
+    // Spins until a multi echo scan and the scan with the same stamp are received
+    bool waitPair(double timeout, sensor_msgs::msg::LaserScan& scan, sensor_msgs::msg::MultiEchoLaserScan& multiEcho)
+    {
+        const double end = Time::now() + timeout;
+        while (Time::now() < end) {
+            m_executor.spin_some();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& echoes : m_multiEchoes) {
+                for (const auto& received : m_scans) {
+                    if (sameStamp(echoes.header.stamp, received.header.stamp)) {
+                        scan = received;
+                        multiEcho = echoes;
+                        return true;
+                    }
+                }
+            }
+            Time::delay(0.001);
+        }
+        return false;
+    }
+
+private:
+    rclcpp::Node::SharedPtr m_node;
+    rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr m_scanSubscription;
+    rclcpp::Subscription<sensor_msgs::msg::MultiEchoLaserScan>::SharedPtr m_multiEchoSubscription;
+    rclcpp::executors::SingleThreadedExecutor m_executor;
+    std::mutex m_mutex;
+    std::vector<sensor_msgs::msg::LaserScan> m_scans;
+    std::vector<sensor_msgs::msg::MultiEchoLaserScan> m_multiEchoes;
+};
+} // namespace
+
+TEST_CASE("dev::Rangefinder2D_nws_ros2_multiecho_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("rangefinder2D_nws_ros2", "device");
+    YARP_REQUIRE_PLUGIN("fakeLaser", "device");
+
+    Network::setLocalMode(true);
+
+    PolyDriver ddnws;
+    PolyDriver ddfake;
+
+    Property pcfg;
+    pcfg.fromString("(device rangefinder2D_nws_ros2) (node_name lidar_multiecho_node) (topic_name /rangefinder2D_nws_ros2_multiecho/scan) "
+                    "(frame_id lidar_frame) (multiecho_topic /rangefinder2D_nws_ros2_multiecho/echoes)");
+    REQUIRE(ddnws.open(pcfg));
+
+    Property pcfg_fake;
+    pcfg_fake.put("device", "fakeLaser");
+    REQUIRE(ddfake.open(pcfg_fake));
+
+    ScanListener listener("/rangefinder2D_nws_ros2_multiecho/scan", "/rangefinder2D_nws_ros2_multiecho/echoes");
+
+    yarp::dev::WrapperSingle* ww_nws = nullptr;
+    REQUIRE(ddnws.view(ww_nws));
+    REQUIRE(ww_nws->attach(&ddfake));
+
+    SECTION("Every multi echo scan carries the readings of the scan published with it")
+    {
+        sensor_msgs::msg::LaserScan scan;
+        sensor_msgs::msg::MultiEchoLaserScan multiEcho;
+        REQUIRE(listener.waitPair(5.0, scan, multiEcho));
+
+        CHECK(multiEcho.header.frame_id == "lidar_frame");
+        CHECK(multiEcho.angle_min == scan.angle_min);
+        CHECK(multiEcho.angle_max == scan.angle_max);
+        CHECK(multiEcho.angle_increment == scan.angle_increment);
+        CHECK(multiEcho.time_increment == scan.time_increment);
+        CHECK(multiEcho.scan_time == scan.scan_time);
+        CHECK(multiEcho.range_min == scan.range_min);
+        CHECK(multiEcho.range_max == scan.range_max);
+
+        // The geometry is the one of the device, in radians
+        IRangefinder2D* irf = nullptr;
+        REQUIRE(ddfake.view(irf));
+        double min = 0;
+        double max = 0;
+        REQUIRE(irf->getScanLimits(min, max));
+        CHECK(multiEcho.angle_min == Catch::Approx(min * M_PI / 180.0));
+        CHECK(multiEcho.angle_max == Catch::Approx(max * M_PI / 180.0));
+
+        // A single echo per beam, no intensities
+        REQUIRE_FALSE(scan.ranges.empty());
+        REQUIRE(multiEcho.ranges.size() == scan.ranges.size());
+        for (size_t i = 0; i < scan.ranges.size(); i++) {
+            REQUIRE(multiEcho.ranges[i].echoes.size() == 1);
+            const float echo = multiEcho.ranges[i].echoes[0];
+            if (std::isinf(scan.ranges[i])) {
+                CHECK(std::isinf(echo));
+            } else {
+                CHECK(echo == scan.ranges[i]);
+            }
+        }
+        CHECK(multiEcho.intensities.empty());
+        CHECK(scan.intensities.empty());
+    }
+
+    CHECK(ddnws.close());
+    CHECK(ddfake.close());
+
+    Network::setLocalMode(false);
+}
@@ -4,6 +4,7 @@
  */
 
 #include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/WrapperSingle.h>
 
@@ -73,5 +74,99 @@ TEST_CASE("dev::Rangefinder2D_nws_ros2_test", "[yarp::dev]")
         }
     }
 
+    SECTION("Checking the nws with a filter chain")
+    {
+        PolyDriver ddnws;
+        PolyDriver ddfake;
+        yarp::dev::WrapperSingle* ww_nws = nullptr;
+
+        Property pcfg;
+        pcfg.fromString("(device rangefinder2D_nws_ros2) (node_name lidar_node) (topic_name /lidar) "
+                        "(filters (range angular_mask median shadow)) (filter_range_min 0.1) (filter_range_max 10.0) "
+                        "(filter_angular_mask ((170 190) (350 10))) (filter_median_window 5)");
+        REQUIRE(ddnws.open(pcfg));
+
+        Property pcfg_fake;
+        pcfg_fake.put("device", "fakeLaser");
+        REQUIRE(ddfake.open(pcfg_fake));
+
+        ddnws.view(ww_nws);
+        REQUIRE(ww_nws->attach(&ddfake));
+        yarp::os::Time::delay(0.1);
+
+        CHECK(ddnws.close());
+        CHECK(ddfake.close());
+    }
+
+    SECTION("Checking the nws publishing a point cloud")
+    {
+        PolyDriver ddnws;
+        PolyDriver ddfake;
+        yarp::dev::WrapperSingle* ww_nws = nullptr;
+
+        Property pcfg;
+        pcfg.fromString("(device rangefinder2D_nws_ros2) (node_name lidar_node) (topic_name /lidar) (publish_scan false) "
+                        "(pointcloud_topic /lidar_points) (pointcloud_frame_id base_link) (pointcloud_transform (0.2 0.0 0.3 0.0 0.0 3.14))");
+        REQUIRE(ddnws.open(pcfg));
+
+        Property pcfg_fake;
+        pcfg_fake.put("device", "fakeLaser");
+        REQUIRE(ddfake.open(pcfg_fake));
+
+        ddnws.view(ww_nws);
+        REQUIRE(ww_nws->attach(&ddfake));
+        yarp::os::Time::delay(0.1);
+
+        CHECK(ddnws.close());
+        CHECK(ddfake.close());
+    }
+
+    SECTION("Checking the nws publishing multi echo scans")
+    {
+        PolyDriver ddnws;
+        PolyDriver ddfake;
+        yarp::dev::WrapperSingle* ww_nws = nullptr;
+
+        Property pcfg;
+        // The content of the messages is checked by Rangefinder2D_nws_ros2_multiecho_test
+        pcfg.fromString("(device rangefinder2D_nws_ros2) (node_name lidar_node) (topic_name /lidar) (multiecho_topic /lidar_echoes)");
+        REQUIRE(ddnws.open(pcfg));
+
+        Property pcfg_fake;
+        pcfg_fake.put("device", "fakeLaser");
+        REQUIRE(ddfake.open(pcfg_fake));
+
+        ddnws.view(ww_nws);
+        REQUIRE(ww_nws->attach(&ddfake));
+        yarp::os::Time::delay(0.1);
+
+        CHECK(ddnws.close());
+        CHECK(ddfake.close());
+    }
+
+    SECTION("Checking the nws with nothing to publish")
+    {
+        PolyDriver ddnws;
+
+        Property pcfg;
+        pcfg.fromString("(device rangefinder2D_nws_ros2) (node_name lidar_node) (topic_name /lidar) (publish_scan false)");
+        CHECK_FALSE(ddnws.open(pcfg));
+
+        pcfg.fromString("(device rangefinder2D_nws_ros2) (node_name lidar_node) (pointcloud_topic /lidar_points) (pointcloud_transform (0.2 0.0 0.3))");
+        CHECK_FALSE(ddnws.open(pcfg));
+    }
+
+    SECTION("Checking the nws with an invalid filter chain")
+    {
+        PolyDriver ddnws;
+
+        Property pcfg;
+        pcfg.fromString("(device rangefinder2D_nws_ros2) (node_name lidar_node) (topic_name /lidar) (filters (range bilateral))");
+        CHECK_FALSE(ddnws.open(pcfg));
+
+        pcfg.fromString("(device rangefinder2D_nws_ros2) (node_name lidar_node) (topic_name /lidar) (filters (median)) (filter_median_window 4)");
+        CHECK_FALSE(ddnws.open(pcfg));
+    }
+
     Network::setLocalMode(false);
 }
@@ -0,0 +1,196 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include "Rangefinder2D_replay_ros2.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <cmath>
+#include <Ros2Utils.h>
+
+using namespace yarp::dev;
+
+namespace {
+YARP_LOG_COMPONENT(RANGEFINDER2D_REPLAY_ROS2, "yarp.ros2.rangefinder2D_replay_ros2", yarp::os::Log::TraceType);
+
+constexpr double RAD2DEG = 180.0 / M_PI;
+} // namespace
+
+bool Rangefinder2D_replay_ros2::open(yarp::os::Searchable& config)
+{
+    if (!config.check("bag_topic_name")) {
+        yCError(RANGEFINDER2D_REPLAY_ROS2) << "missing bag_topic_name parameter";
+        return false;
+    }
+    m_topic_name = config.find("bag_topic_name").asString();
+
+    Ros2BagPlayer::Options options;
+    if (!Ros2BagPlayer::parseOptions(config, options)) {
+        return false;
+    }
+
+    m_player.addTopic(m_topic_name, [this](const rosbag2_storage::SerializedBagMessage& bagMessage) { onScan(bagMessage); });
+    if (!m_player.open(options)) {
+        return false;
+    }
+
+    yCInfo(RANGEFINDER2D_REPLAY_ROS2) << "opened";
+    return true;
+}
+
+bool Rangefinder2D_replay_ros2::close()
+{
+    m_player.close();
+    return true;
+}
+
+void Rangefinder2D_replay_ros2::onScan(const rosbag2_storage::SerializedBagMessage& bagMessage)
+{
+    sensor_msgs::msg::LaserScan scan;
+    if (!Ros2BagPlayer::deserialize(bagMessage, scan)) {
+        yCError(RANGEFINDER2D_REPLAY_ROS2) << "Unable to deserialize a message of" << m_topic_name;
+        m_player.consumed();
+        return;
+    }
+
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    m_scan = std::move(scan);
+    m_data_valid = true;
+    m_data_fresh = true;
+}
+
+bool Rangefinder2D_replay_ros2::getRawData(yarp::sig::Vector& data, double* timestamp)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+
+    data.resize(m_scan.ranges.size());
+    for (size_t i = 0; i < m_scan.ranges.size(); i++) {
+        data[i] = m_scan.ranges[i];
+    }
+    if (timestamp) {
+        *timestamp = yarpTimeFromRos2(m_scan.header.stamp) + m_player.stampOffset();
+    }
+
+    if (m_data_fresh) {
+        m_data_fresh = false;
+        m_player.consumed();
+    }
+    return true;
+}
+
+bool Rangefinder2D_replay_ros2::getLaserMeasurement(std::vector<yarp::dev::LaserMeasurementData>& data, double* timestamp)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+
+    data.resize(m_scan.ranges.size());
+    for (size_t i = 0; i < m_scan.ranges.size(); i++) {
+        data[i].set_polar(m_scan.ranges[i], m_scan.angle_min + i * m_scan.angle_increment);
+    }
+    if (timestamp) {
+        *timestamp = yarpTimeFromRos2(m_scan.header.stamp) + m_player.stampOffset();
+    }
+
+    if (m_data_fresh) {
+        m_data_fresh = false;
+        m_player.consumed();
+    }
+    return true;
+}
+
+bool Rangefinder2D_replay_ros2::getDeviceStatus(Device_status& status)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        status = DEVICE_TIMEOUT;
+    } else if (m_player.isFinished()) {
+        status = DEVICE_GENERAL_ERROR;
+    } else {
+        status = DEVICE_OK_IN_USE;
+    }
+    return true;
+}
+
+bool Rangefinder2D_replay_ros2::getDistanceRange(double& min, double& max)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+    min = m_scan.range_min;
+    max = m_scan.range_max;
+    return true;
+}
+
+bool Rangefinder2D_replay_ros2::setDistanceRange(double min, double max)
+{
+    yCError(RANGEFINDER2D_REPLAY_ROS2) << "setDistanceRange is not supported by a recorded scan";
+    return false;
+}
+
+bool Rangefinder2D_replay_ros2::getScanLimits(double& min, double& max)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+    min = m_scan.angle_min * RAD2DEG;
+    max = m_scan.angle_max * RAD2DEG;
+    return true;
+}
+
+bool Rangefinder2D_replay_ros2::setScanLimits(double min, double max)
+{
+    yCError(RANGEFINDER2D_REPLAY_ROS2) << "setScanLimits is not supported by a recorded scan";
+    return false;
+}
+
+bool Rangefinder2D_replay_ros2::getHorizontalResolution(double& step)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid) {
+        return false;
+    }
+    step = m_scan.angle_increment * RAD2DEG;
+    return true;
+}
+
+bool Rangefinder2D_replay_ros2::setHorizontalResolution(double step)
+{
+    yCError(RANGEFINDER2D_REPLAY_ROS2) << "setHorizontalResolution is not supported by a recorded scan";
+    return false;
+}
+
+bool Rangefinder2D_replay_ros2::getScanRate(double& rate)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_data_valid || m_scan.scan_time <= 0) {
+        return false;
+    }
+    rate = 1.0 / m_scan.scan_time;
+    return true;
+}
+
+bool Rangefinder2D_replay_ros2::setScanRate(double rate)
+{
+    yCError(RANGEFINDER2D_REPLAY_ROS2) << "setScanRate is not supported by a recorded scan";
+    return false;
+}
+
+bool Rangefinder2D_replay_ros2::getDeviceInfo(std::string& device_info)
+{
+    device_info = "rangefinder2D_replay_ros2 playing " + m_topic_name;
+    return true;
+}
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_RANGEFINDER2D_REPLAY_ROS2_H
+#define YARP_ROS2_RANGEFINDER2D_REPLAY_ROS2_H
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IRangefinder2D.h>
+
+#include <sensor_msgs/msg/laser_scan.hpp>
+#include <Ros2BagPlayer.h>
+
+#include <mutex>
+
+/**
+ *  @ingroup dev_impl_fake dev_impl_lidar
+ *
+ * \brief `rangefinder2D_replay_ros2`: A 2D rangefinder that replays the LaserScan messages recorded in a rosbag2 bag.
+ *
+ * It is meant to run the NWS and NWC devices on recorded robot data, in a reproducible way.
+ * The scans are returned exactly as recorded, the ranges are not filtered.
+ *
+ * Parameters required by this device are:
+ * | Parameter name      | SubParameter   | Type    | Units          | Default Value | Required  | Description                                        | Notes |
+ * |:-------------------:|:--------------:|:-------:|:--------------:|:-------------:|:---------:|:--------------------------------------------------:|:-----:|
+ * | bag_uri             |      -         | string  | -              |   -           | Yes       | path of the bag to play                            | |
+ * | bag_topic_name      |      -         | string  | -              |   -           | Yes       | recorded topic of the sensor_msgs/LaserScan        | |
+ * | time_scale          |      -         | double  | -              |   1.0         | No        | playback speed                                     | |
+ * | as_fast_as_possible |      -         | bool    | -              |   false       | No        | a new scan is played after every getRawData() or getLaserMeasurement() that returned the previous one | |
+ * | loop                |      -         | bool    | -              |   false       | No        | restart from the beginning at the end of the bag   | |
+ *
+ * See Ros2BagPlayer for the other playback parameters.
+ *
+ * \code{.unparsed}
+ * yarpdev --device rangefinder2D_nws_ros2 --subdevice rangefinder2D_replay_ros2 --bag_uri /data/lidar_bag --bag_topic_name /scan --node_name laser_node
+ * \endcode
+ */
+class Rangefinder2D_replay_ros2 :
+        public yarp::dev::DeviceDriver,
+        public yarp::dev::IRangefinder2D
+{
+public:
+    Rangefinder2D_replay_ros2() = default;
+    Rangefinder2D_replay_ros2(const Rangefinder2D_replay_ros2&) = delete;
+    Rangefinder2D_replay_ros2(Rangefinder2D_replay_ros2&&) noexcept = delete;
+    Rangefinder2D_replay_ros2& operator=(const Rangefinder2D_replay_ros2&) = delete;
+    Rangefinder2D_replay_ros2& operator=(Rangefinder2D_replay_ros2&&) noexcept = delete;
+    ~Rangefinder2D_replay_ros2() override = default;
+
+    // DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    // IRangefinder2D
+    bool getLaserMeasurement(std::vector<yarp::dev::LaserMeasurementData> &data, double* timestamp = nullptr) override;
+    bool getRawData(yarp::sig::Vector &data, double* timestamp = nullptr) override;
+    bool getDeviceStatus(Device_status& status) override;
+    bool getDistanceRange(double& min, double& max) override;
+    bool setDistanceRange(double min, double max) override;
+    bool getScanLimits(double& min, double& max) override;
+    bool setScanLimits(double min, double max) override;
+    bool getHorizontalResolution(double& step) override;
+    bool setHorizontalResolution(double step) override;
+    bool getScanRate(double& rate) override;
+    bool setScanRate(double rate) override;
+    bool getDeviceInfo(std::string &device_info) override;
+
+private:
+    void onScan(const rosbag2_storage::SerializedBagMessage& bagMessage);
+
+    Ros2BagPlayer m_player;
+    std::string m_topic_name;
+
+    std::mutex m_mutex;
+    sensor_msgs::msg::LaserScan m_scan;
+    bool m_data_valid{false};
+    bool m_data_fresh{false};
+};
+
+#endif // YARP_ROS2_RANGEFINDER2D_REPLAY_ROS2_H
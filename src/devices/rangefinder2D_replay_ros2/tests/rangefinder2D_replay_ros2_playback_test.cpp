@@ -0,0 +1,180 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Time.h>
+#include <yarp/dev/IRangefinder2D.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <sensor_msgs/msg/laser_scan.hpp>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+#include <harness_bag.h>
+
+#include <cmath>
+
+using namespace yarp::dev;
+using namespace yarp::os;
+
+namespace {
+constexpr const char* s_topic = "/scan";
+constexpr size_t s_samples = 5;
+constexpr size_t s_beams = 4;
+constexpr double s_angleMin = -M_PI / 4;
+constexpr double s_angleIncrement = M_PI / 6;
+
+double rangeOf(size_t sample, size_t beam)
+{
+    return 1.0 + sample + 0.25 * beam;
+}
+
+// Records s_samples scans, the recording time of each message is its header stamp
+std::string recordScans()
+{
+    return recordBag("rangefinder2D_replay_ros2", s_topic, s_samples, [](size_t i, const rclcpp::Time& stamp) {
+        sensor_msgs::msg::LaserScan scan;
+        scan.header.stamp = stamp;
+        scan.angle_min = s_angleMin;
+        scan.angle_increment = s_angleIncrement;
+        scan.angle_max = s_angleMin + (s_beams - 1) * s_angleIncrement;
+        scan.scan_time = 0.1;
+        scan.range_min = 0.5;
+        scan.range_max = 20.0;
+        for (size_t j = 0; j < s_beams; j++) {
+            scan.ranges.push_back(rangeOf(i, j));
+        }
+        return scan;
+    });
+}
+} // namespace
+
+TEST_CASE("dev::rangefinder2D_replay_ros2_playback_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("rangefinder2D_replay_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    const std::string uri = recordScans();
+
+    SECTION("Playing as fast as possible")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "rangefinder2D_replay_ros2");
+        pcfg.put("bag_uri", uri);
+        pcfg.put("bag_topic_name", s_topic);
+        pcfg.put("as_fast_as_possible", Value(true));
+        REQUIRE(dd.open(pcfg));
+
+        IRangefinder2D* irf = nullptr;
+        REQUIRE(dd.view(irf));
+
+        // Every recorded scan is returned once, in order, each call of getRawData() releases the next one
+        for (size_t i = 0; i < s_samples; i++) {
+            yarp::sig::Vector data;
+            double timestamp = 0;
+            REQUIRE(waitFor([&] { return irf->getRawData(data, &timestamp) && timestamp == approxStamp(stampOf(i)); }));
+            REQUIRE(data.size() == s_beams);
+            for (size_t j = 0; j < s_beams; j++) {
+                CHECK(data[j] == Catch::Approx(rangeOf(i, j)));
+            }
+        }
+
+        double min = 0;
+        double max = 0;
+        CHECK(irf->getDistanceRange(min, max));
+        CHECK(min == Catch::Approx(0.5));
+        CHECK(max == Catch::Approx(20.0));
+        CHECK(irf->getScanLimits(min, max));
+        CHECK(min == Catch::Approx(-45.0));
+        CHECK(max == Catch::Approx(45.0));
+        double step = 0;
+        CHECK(irf->getHorizontalResolution(step));
+        CHECK(step == Catch::Approx(30.0));
+        double rate = 0;
+        CHECK(irf->getScanRate(rate));
+        CHECK(rate == Catch::Approx(10.0));
+
+        // The last scan was consumed, so the playback ends
+        IRangefinder2D::Device_status status;
+        CHECK(waitFor([&] { return irf->getDeviceStatus(status) && status == IRangefinder2D::DEVICE_GENERAL_ERROR; }));
+
+        CHECK(dd.close());
+    }
+
+    SECTION("Playing as fast as possible in a loop")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "rangefinder2D_replay_ros2");
+        pcfg.put("bag_uri", uri);
+        pcfg.put("bag_topic_name", s_topic);
+        pcfg.put("as_fast_as_possible", Value(true));
+        pcfg.put("loop", Value(true));
+        REQUIRE(dd.open(pcfg));
+
+        IRangefinder2D* irf = nullptr;
+        REQUIRE(dd.view(irf));
+
+        // The second loop continues the stamps one period after the last scan
+        for (size_t i = 0; i < 2 * s_samples; i++) {
+            std::vector<LaserMeasurementData> data;
+            double timestamp = 0;
+            REQUIRE(waitFor([&] { return irf->getLaserMeasurement(data, &timestamp) && timestamp == approxStamp(stampOf(i)); }));
+            REQUIRE(data.size() == s_beams);
+            for (size_t j = 0; j < s_beams; j++) {
+                double rho = 0;
+                double theta = 0;
+                data[j].get_polar(rho, theta);
+                CHECK(rho == Catch::Approx(rangeOf(i % s_samples, j)));
+                CHECK(theta == Catch::Approx(s_angleMin + j * s_angleIncrement));
+            }
+        }
+
+        IRangefinder2D::Device_status status;
+        CHECK(irf->getDeviceStatus(status));
+        CHECK(status == IRangefinder2D::DEVICE_OK_IN_USE);
+
+        CHECK(dd.close());
+    }
+
+    SECTION("Playing with the recorded timing")
+    {
+        PolyDriver dd;
+        Property pcfg;
+        pcfg.put("device", "rangefinder2D_replay_ros2");
+        pcfg.put("bag_uri", uri);
+        pcfg.put("bag_topic_name", s_topic);
+        REQUIRE(dd.open(pcfg));
+        const double start = Time::now();
+
+        IRangefinder2D* irf = nullptr;
+        REQUIRE(dd.view(irf));
+
+        // The scans are played without being read, and the playback ends after the recorded duration
+        IRangefinder2D::Device_status status;
+        REQUIRE(waitFor([&] { return irf->getDeviceStatus(status) && status == IRangefinder2D::DEVICE_GENERAL_ERROR; }));
+        const double elapsed = Time::now() - start;
+        const double expected = (s_samples - 1) * s_periodNs * 1e-9;
+        CHECK(elapsed > expected * 0.5);
+        CHECK(elapsed < expected + 0.5);
+
+        yarp::sig::Vector data;
+        double timestamp = 0;
+        CHECK(irf->getRawData(data, &timestamp));
+        CHECK(timestamp == approxStamp(stampOf(s_samples - 1)));
+
+        CHECK(dd.close());
+    }
+
+    std::filesystem::remove_all(uri);
+
+    Network::setLocalMode(false);
+}
@@ -20,6 +20,7 @@
 
 #include <Ros2Utils.h>
 #include <Ros2RGBDConversionUtils.h>
+#include <Ros2Tracer.h>
 
 using namespace std::chrono_literals;
 using namespace std::placeholders;
@@ -63,6 +64,9 @@ bool RgbdSensor_nwc_ros2::open(yarp::os::Searchable& config)
 
     m_verbose = config.check("verbose");
 
+    m_rgb_trace_channel = Ros2Tracer::channel(m_topic_rgb_image_raw);
+    m_depth_trace_channel = Ros2Tracer::channel(m_topic_depth_image_raw);
+
     m_node = NodeCreator::createNode(m_ros2_node_name);
     m_sub1= new Ros2Subscriber<RgbdSensor_nwc_ros2, sensor_msgs::msg::CameraInfo>(m_node, this);
     m_sub1->subscribe_to_topic(m_topic_rgb_camera_info);
@@ -85,6 +89,7 @@ bool RgbdSensor_nwc_ros2::close()
     delete m_sub1;
     delete m_sub2;
     delete m_spinner;
+    Ros2Tracer::flush();
     yCInfo(RGBDSENSOR_NWC_ROS2, "closed");
     return true;
 }
@@ -112,8 +117,11 @@ void RgbdSensor_nwc_ros2::callback(sensor_msgs::msg::CameraInfo::SharedPtr msg,
 void RgbdSensor_nwc_ros2::depth_raw_callback(const sensor_msgs::msg::Image::SharedPtr msg)
 {
     yCTrace(RGBDSENSOR_NWC_ROS2, "callback depth image");
+    Ros2Tracer::trace(m_depth_trace_channel, Ros2Tracer::NwcReceive, msg->header.stamp);
     std::lock_guard<std::mutex> depth_image_guard(m_depth_image_mutex);
     yarp::dev::Ros2RGBDConversionUtils::convertDepthImageRos2ToYarpImageOf(msg,m_current_depth_image);
+    m_current_depth_trace_key = msg->header.stamp;
+    Ros2Tracer::trace(m_depth_trace_channel, Ros2Tracer::NwcConverted, msg->header.stamp);
     m_depth_image_valid = true;
 }
 
@@ -130,8 +138,11 @@ void RgbdSensor_nwc_ros2::depth_info_callback(const sensor_msgs::msg::CameraInfo
 void RgbdSensor_nwc_ros2::color_raw_callback(const sensor_msgs::msg::Image::SharedPtr msg)
 {
     yCTrace(RGBDSENSOR_NWC_ROS2, "callback color image");
+    Ros2Tracer::trace(m_rgb_trace_channel, Ros2Tracer::NwcReceive, msg->header.stamp);
     std::lock_guard<std::mutex> rgb_image_guard(m_rgb_image_mutex);
     yarp::dev::Ros2RGBDConversionUtils::convertRGBImageRos2ToYarpFlexImage(msg, m_current_rgb_image);
+    m_current_rgb_trace_key = msg->header.stamp;
+    Ros2Tracer::trace(m_rgb_trace_channel, Ros2Tracer::NwcConverted, msg->header.stamp);
     m_rgb_image_valid = true;
 }
 
@@ -373,6 +384,7 @@ bool RgbdSensor_nwc_ros2::getRgbImage(yarp::sig::FlexImage& rgb_image, yarp::os:
                 rgb_image_stamp->update(m_current_rgb_stamp.getTime());
             }
             yarp::dev::Ros2RGBDConversionUtils::deepCopyFlexImage(m_current_rgb_image, rgb_image);
+            Ros2Tracer::trace(m_rgb_trace_channel, Ros2Tracer::ConsumerRead, m_current_rgb_trace_key);
             rgb_ok = true;
         }
         else
@@ -408,6 +420,7 @@ bool RgbdSensor_nwc_ros2::getDepthImage(depthImage& depth_image, yarp::os::Stamp
                 depth_image_stamp->update(m_current_depth_stamp.getTime());
             }
             yarp::dev::Ros2RGBDConversionUtils::deepCopyImageOf(m_current_depth_image, depth_image);
+            Ros2Tracer::trace(m_depth_trace_channel, Ros2Tracer::ConsumerRead, m_current_depth_trace_key);
             depth_ok = true;
         }
         else
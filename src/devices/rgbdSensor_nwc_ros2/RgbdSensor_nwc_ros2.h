@@ -97,6 +97,12 @@ class RgbdSensor_nwc_ros2:
             double                     m_max_rgb_width;
             double                     m_max_rgb_height;
 
+            // stamp of the received images, identifying them in the traces
+            builtin_interfaces::msg::Time m_current_rgb_trace_key;
+            builtin_interfaces::msg::Time m_current_depth_trace_key;
+            uint32_t m_rgb_trace_channel{0};
+            uint32_t m_depth_trace_channel{0};
+
             bool m_depth_image_valid = false;
             bool m_depth_stamp_valid = false;
             bool m_rgb_image_valid = false;
@@ -12,6 +12,7 @@
 #include <vector>
 #include <iostream>
 #include <Ros2Utils.h>
+#include <Ros2Tracer.h>
 
 #include <sensor_msgs/image_encodings.hpp>
 
@@ -166,6 +167,17 @@ bool RgbdSensor_nws_ros2::fromConfig(yarp::os::Searchable &config)
         forceInfoSync = config.find("forceInfoSync").asBool();
     }
 
+    Ros2BagRecorder::Options recorderOptions;
+    if (!Ros2BagRecorder::parseOptions(config, recorderOptions)) {
+        return false;
+    }
+    if (!recorderOptions.uri.empty()) {
+        m_recorder = std::make_unique<Ros2BagRecorder>();
+        if (!m_recorder->open(recorderOptions)) {
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -173,22 +185,64 @@ bool RgbdSensor_nws_ros2::fromConfig(yarp::os::Searchable &config)
 bool RgbdSensor_nws_ros2::initialize_ROS2(yarp::os::Searchable &params)
 {
     m_node = NodeCreator::createNode(m_node_name);
+    m_clockDriver = std::make_unique<Ros2ClockDriver>(m_node, [this]() { run(); });
+    if (!m_clockDriver->configure(params) || !m_clockDriver->setPeriod(getPeriod())) {
+        return false;
+    }
     rosPublisher_color = m_node->create_publisher<sensor_msgs::msg::Image>(m_color_topic_name, 10);
     rosPublisher_depth = m_node->create_publisher<sensor_msgs::msg::Image>(m_depth_topic_name, 10);
     rosPublisher_colorCaminfo = m_node->create_publisher<sensor_msgs::msg::CameraInfo>(m_color_info_topic_name, 10);
     rosPublisher_depthCaminfo = m_node->create_publisher<sensor_msgs::msg::CameraInfo>(m_depth_info_topic_name, 10);
-    return true;
+    m_colorTraceChannel = Ros2Tracer::channel(m_color_topic_name);
+    m_depthTraceChannel = Ros2Tracer::channel(m_depth_topic_name);
+    return initParameters();
+}
+
+
+bool RgbdSensor_nws_ros2::initParameters()
+{
+    m_parameters = std::make_unique<Ros2Parameters>(m_node);
+
+    bool ok = m_parameters->addDouble("period", getPeriod(), [this](double period) {
+        return period > 0 && m_clockDriver->setPeriod(period) && setPeriod(period);
+    });
+    ok &= m_parameters->addBool("publish_color", m_publishColor, [this](bool enable) {
+        m_publishColor = enable;
+        return true;
+    });
+    ok &= m_parameters->addBool("publish_depth", m_publishDepth, [this](bool enable) {
+        m_publishDepth = enable;
+        return true;
+    });
+    ok &= m_parameters->addBool("force_info_sync", forceInfoSync, [this](bool enable) {
+        forceInfoSync = enable;
+        return true;
+    });
+    if (!ok) {
+        yCError(RGBDSENSOR_NWS_ROS2) << "Unable to declare the ROS 2 parameters";
+        return false;
+    }
+
+    return m_parameters->start();
 }
 
 
 bool RgbdSensor_nws_ros2::close()
 {
     yCTrace(RGBDSENSOR_NWS_ROS2, "Close");
+    if (m_parameters) {
+        m_parameters->stop();
+    }
     detach();
 
     sensor_p = nullptr;
     fgCtrl = nullptr;
 
+    if (m_recorder) {
+        m_recorder->close();
+    }
+    Ros2Tracer::flush();
+
     return true;
 }
 
@@ -247,12 +301,18 @@ bool RgbdSensor_nws_ros2::attach(yarp::dev::PolyDriver* poly)
         yCWarning(RGBDSENSOR_NWS_ROS2) << "Attached device has no valid IFrameGrabberControls interface.";
     }
 
+    if (m_clockDriver->enabled()) {
+        return m_clockDriver->start();
+    }
     return PeriodicThread::start();
 }
 
 
 bool RgbdSensor_nws_ros2::detach()
 {
+    if (m_clockDriver) {
+        m_clockDriver->stop();
+    }
     if (yarp::os::PeriodicThread::isRunning())
         yarp::os::PeriodicThread::stop();
 
@@ -369,6 +429,17 @@ bool RgbdSensor_nws_ros2::setCamInfo(sensor_msgs::msg::CameraInfo& cameraInfo,
 }
 
 
+template <class MSG>
+void RgbdSensor_nws_ros2::publish(const typename rclcpp::Publisher<MSG>::SharedPtr& publisher, const MSG& msg)
+{
+    if (m_recorder) {
+        m_recorder->publish(publisher, msg);
+    } else {
+        publisher->publish(msg);
+    }
+}
+
+
 bool RgbdSensor_nws_ros2::writeData()
 {
     yarp::sig::FlexImage colorImage;
@@ -399,8 +470,19 @@ bool RgbdSensor_nws_ros2::writeData()
         oldDepthStamp = depthStamp;
     }
 
-    // TBD: We should check here somehow if the timestamp was correctly updated and, if not, update it ourselves.
+    builtin_interfaces::msg::Time colorRosStamp = ros2TimeFromYarp(colorStamp.getTime());
+    builtin_interfaces::msg::Time depthRosStamp = ros2TimeFromYarp(depthStamp.getTime());
     if (rgb_data_ok) {
+        Ros2Tracer::traceCapture(m_colorTraceChannel, colorRosStamp);
+        Ros2Tracer::trace(m_colorTraceChannel, Ros2Tracer::NwsRead, colorRosStamp);
+    }
+    if (depth_data_ok) {
+        Ros2Tracer::traceCapture(m_depthTraceChannel, depthRosStamp);
+        Ros2Tracer::trace(m_depthTraceChannel, Ros2Tracer::NwsRead, depthRosStamp);
+    }
+
+    // TBD: We should check here somehow if the timestamp was correctly updated and, if not, update it ourselves.
+    if (rgb_data_ok && m_publishColor) {
         sensor_msgs::msg::Image rColorImage;
         rColorImage.data.resize(colorImage.getRawImageSize());
         rColorImage.width = colorImage.width();
@@ -409,24 +491,25 @@ bool RgbdSensor_nws_ros2::writeData()
         rColorImage.encoding = yarp2RosPixelCode(colorImage.getPixelCode());
         rColorImage.step = colorImage.getRowSize();
         rColorImage.header.frame_id = m_color_frame_id;
-        rColorImage.header.stamp.sec = static_cast<int>(colorStamp.getTime()); // FIXME
-        rColorImage.header.stamp.nanosec = static_cast<int>(1000000000UL * (colorStamp.getTime() - int(colorStamp.getTime()))); // FIXME
+        rColorImage.header.stamp = colorRosStamp;
         rColorImage.is_bigendian = 0;
 
-        rosPublisher_color->publish(rColorImage);
+        Ros2Tracer::trace(m_colorTraceChannel, Ros2Tracer::NwsPublish, colorRosStamp);
+        publish(rosPublisher_color, rColorImage);
+        Ros2Tracer::trace(m_colorTraceChannel, Ros2Tracer::RmwSent, colorRosStamp);
 
         sensor_msgs::msg::CameraInfo camInfoC;
         if (setCamInfo(camInfoC, m_color_frame_id, colorStamp, COLOR_SENSOR)) {
             if(forceInfoSync) {
                 camInfoC.header.stamp = rColorImage.header.stamp;
             }
-            rosPublisher_colorCaminfo->publish(camInfoC);
+            publish(rosPublisher_colorCaminfo, camInfoC);
         } else {
             yCWarning(RGBDSENSOR_NWS_ROS2, "Missing color camera parameters... camera info messages will be not sent");
         }
     }
 
-    if (depth_data_ok)
+    if (depth_data_ok && m_publishDepth)
     {
         sensor_msgs::msg::Image rDepthImage;
         rDepthImage.data.resize(depthImage.getRawImageSize());
@@ -436,18 +519,19 @@ bool RgbdSensor_nws_ros2::writeData()
         rDepthImage.encoding = yarp2RosPixelCode(depthImage.getPixelCode());
         rDepthImage.step = depthImage.getRowSize();
         rDepthImage.header.frame_id = m_depth_frame_id;
-        rDepthImage.header.stamp.sec = static_cast<int>(depthStamp.getTime()); // FIXME
-        rDepthImage.header.stamp.nanosec = static_cast<int>(1000000000UL * (depthStamp.getTime() - int(depthStamp.getTime()))); // FIXME
+        rDepthImage.header.stamp = depthRosStamp;
         rDepthImage.is_bigendian = 0;
 
-        rosPublisher_depth->publish(rDepthImage);
+        Ros2Tracer::trace(m_depthTraceChannel, Ros2Tracer::NwsPublish, depthRosStamp);
+        publish(rosPublisher_depth, rDepthImage);
+        Ros2Tracer::trace(m_depthTraceChannel, Ros2Tracer::RmwSent, depthRosStamp);
 
         sensor_msgs::msg::CameraInfo camInfoD;
         if (setCamInfo(camInfoD, m_depth_frame_id, depthStamp, DEPTH_SENSOR)) {
             if(forceInfoSync) {
                 camInfoD.header.stamp = rDepthImage.header.stamp;
             }
-            rosPublisher_depthCaminfo->publish(camInfoD);
+            publish(rosPublisher_depthCaminfo, camInfoD);
         } else {
             yCWarning(RGBDSENSOR_NWS_ROS2, "Missing depth camera parameters... camera info messages will be not sent");
         }
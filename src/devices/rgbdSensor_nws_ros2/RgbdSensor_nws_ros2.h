@@ -17,7 +17,12 @@
 #include <std_msgs/msg/string.hpp>
 #include <sensor_msgs/msg/image.hpp>
 #include <sensor_msgs/msg/camera_info.hpp>
+#include <Ros2Parameters.h>
+#include <Ros2ClockDriver.h>
+#include <Ros2BagRecorder.h>
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 /**
@@ -27,6 +32,20 @@
  *
  *  Documentation to be added
  *
+ *  The following ROS 2 parameters of the node can be changed at runtime with `ros2 param set`:
+ *  | Parameter name   | Type   | Description                                              |
+ *  |:----------------:|:------:|:--------------------------------------------------------:|
+ *  | period           | double | period of the publishing thread, in seconds              |
+ *  | publish_color    | bool   | enable the color image and its camera info               |
+ *  | publish_depth    | bool   | enable the depth image and its camera info               |
+ *  | force_info_sync  | bool   | same as the `forceInfoSync` configuration parameter      |
+ *
+ *  With `clock_source` set to `ros` the images are published once per period of the simulated time,
+ *  see Ros2ClockDriver for the `clock_*` parameters.
+ *
+ *  If `record_uri` is set, the published images and camera infos are also recorded in an MCAP bag,
+ *  see Ros2BagRecorder for the `record_*` parameters.
+ *
 */
 class RgbdSensor_nws_ros2 :
         public yarp::dev::DeviceDriver,
@@ -76,6 +95,9 @@ private:
     rclcpp::Publisher<sensor_msgs::msg::Image>::SharedPtr rosPublisher_depth;
     rclcpp::Publisher<sensor_msgs::msg::CameraInfo>::SharedPtr rosPublisher_colorCaminfo;
     rclcpp::Publisher<sensor_msgs::msg::CameraInfo>::SharedPtr rosPublisher_depthCaminfo;
+    std::unique_ptr<Ros2Parameters> m_parameters;
+    std::unique_ptr<Ros2ClockDriver> m_clockDriver;
+    std::unique_ptr<Ros2BagRecorder> m_recorder;
 
     std::string m_node_name;
 
@@ -86,12 +108,18 @@ private:
     std::string m_color_topic_name;
     std::string m_color_info_topic_name;
     std::string m_color_frame_id;
+    uint32_t m_colorTraceChannel {0};
+    uint32_t m_depthTraceChannel {0};
 
     yarp::dev::IRGBDSensor* sensor_p {nullptr};
     yarp::dev::IFrameGrabberControls* fgCtrl {nullptr};
-    bool forceInfoSync {true};
+    std::atomic<bool> forceInfoSync {true};
+    std::atomic<bool> m_publishColor {true};
+    std::atomic<bool> m_publishDepth {true};
 
     bool writeData();
+    template <class MSG>
+    void publish(const typename rclcpp::Publisher<MSG>::SharedPtr& publisher, const MSG& msg);
     bool setCamInfo(sensor_msgs::msg::CameraInfo& cameraInfo,
                     const std::string& frame_id,
                     const yarp::os::Stamp& stamp,
@@ -102,6 +130,7 @@ private:
 
     bool fromConfig(yarp::os::Searchable &config);
     bool initialize_ROS2(yarp::os::Searchable& config);
+    bool initParameters();
 
     bool read(yarp::os::ConnectionReader& connection);
 
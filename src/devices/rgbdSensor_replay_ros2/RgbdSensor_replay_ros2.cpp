@@ -0,0 +1,389 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include "RgbdSensor_replay_ros2.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <cmath>
+#include <Ros2Utils.h>
+#include <Ros2RGBDConversionUtils.h>
+
+using namespace yarp::dev;
+
+namespace {
+YARP_LOG_COMPONENT(RGBDSENSOR_REPLAY_ROS2, "yarp.ros2.rgbdSensor_replay_ros2", yarp::os::Log::TraceType);
+
+std::string defaultCameraInfoTopic(const std::string& imageTopic)
+{
+    return imageTopic.substr(0, imageTopic.rfind('/')) + "/camera_info";
+}
+} // namespace
+
+bool RgbdSensor_replay_ros2::open(yarp::os::Searchable& config)
+{
+    if (!config.check("bag_color_topic_name")) {
+        yCError(RGBDSENSOR_REPLAY_ROS2) << "missing bag_color_topic_name parameter";
+        return false;
+    }
+    m_topic_rgb_image_raw = config.find("bag_color_topic_name").asString();
+
+    if (!config.check("bag_depth_topic_name")) {
+        yCError(RGBDSENSOR_REPLAY_ROS2) << "missing bag_depth_topic_name parameter";
+        return false;
+    }
+    m_topic_depth_image_raw = config.find("bag_depth_topic_name").asString();
+
+    m_topic_rgb_camera_info = config.check("bag_color_info_topic_name",
+                                           yarp::os::Value(defaultCameraInfoTopic(m_topic_rgb_image_raw))).asString();
+    m_topic_depth_camera_info = config.check("bag_depth_info_topic_name",
+                                             yarp::os::Value(defaultCameraInfoTopic(m_topic_depth_image_raw))).asString();
+
+    Ros2BagPlayer::Options options;
+    if (!Ros2BagPlayer::parseOptions(config, options)) {
+        return false;
+    }
+
+    m_player.addTopic(m_topic_rgb_image_raw, [this](const rosbag2_storage::SerializedBagMessage& bagMessage) { onColorImage(bagMessage); });
+    m_player.addTopic(m_topic_depth_image_raw, [this](const rosbag2_storage::SerializedBagMessage& bagMessage) { onDepthImage(bagMessage); });
+    m_player.addTopic(m_topic_rgb_camera_info, [this](const rosbag2_storage::SerializedBagMessage& bagMessage) {
+        onCameraInfo(bagMessage, m_rgb_params, m_max_rgb_width, m_max_rgb_height, m_rgb_info_valid);
+    });
+    if (m_topic_depth_camera_info != m_topic_rgb_camera_info) {
+        m_player.addTopic(m_topic_depth_camera_info, [this](const rosbag2_storage::SerializedBagMessage& bagMessage) {
+            onCameraInfo(bagMessage, m_depth_params, m_max_depth_width, m_max_depth_height, m_depth_info_valid);
+        });
+    }
+    if (!m_player.open(options)) {
+        return false;
+    }
+
+    yCInfo(RGBDSENSOR_REPLAY_ROS2) << "opened";
+    return true;
+}
+
+bool RgbdSensor_replay_ros2::close()
+{
+    m_player.close();
+    return true;
+}
+
+void RgbdSensor_replay_ros2::onColorImage(const rosbag2_storage::SerializedBagMessage& bagMessage)
+{
+    auto image = std::make_shared<sensor_msgs::msg::Image>();
+    if (!Ros2BagPlayer::deserialize(bagMessage, *image)) {
+        yCError(RGBDSENSOR_REPLAY_ROS2) << "Unable to deserialize a message of" << m_topic_rgb_image_raw;
+        m_player.consumed();
+        return;
+    }
+
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    Ros2RGBDConversionUtils::convertRGBImageRos2ToYarpFlexImage(image, m_current_rgb_image);
+    m_current_rgb_stamp.update(yarpTimeFromRos2(image->header.stamp) + m_player.stampOffset());
+    m_rgb_image_valid = true;
+    m_rgb_image_fresh = true;
+}
+
+void RgbdSensor_replay_ros2::onDepthImage(const rosbag2_storage::SerializedBagMessage& bagMessage)
+{
+    auto image = std::make_shared<sensor_msgs::msg::Image>();
+    if (!Ros2BagPlayer::deserialize(bagMessage, *image)) {
+        yCError(RGBDSENSOR_REPLAY_ROS2) << "Unable to deserialize a message of" << m_topic_depth_image_raw;
+        m_player.consumed();
+        return;
+    }
+
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    Ros2RGBDConversionUtils::convertDepthImageRos2ToYarpImageOf(image, m_current_depth_image);
+    m_current_depth_stamp.update(yarpTimeFromRos2(image->header.stamp) + m_player.stampOffset());
+    m_depth_image_valid = true;
+    m_depth_image_fresh = true;
+}
+
+void RgbdSensor_replay_ros2::onCameraInfo(const rosbag2_storage::SerializedBagMessage& bagMessage,
+                                          yarp::sig::IntrinsicParams& params,
+                                          double& width,
+                                          double& height,
+                                          bool& valid)
+{
+    sensor_msgs::msg::CameraInfo info;
+    bool ok = Ros2BagPlayer::deserialize(bagMessage, info);
+
+    // No getter consumes the camera infos, the player must not wait for them
+    m_player.consumed();
+
+    if (!ok) {
+        yCError(RGBDSENSOR_REPLAY_ROS2) << "Unable to deserialize a message of" << bagMessage.topic_name;
+        return;
+    }
+
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    params.focalLengthX = info.k[0];
+    params.focalLengthY = info.k[4];
+    params.principalPointX = info.k[2];
+    params.principalPointY = info.k[5];
+    if (info.distortion_model == "plumb_bob" && info.d.size() >= 5) {
+        params.distortionModel.type = yarp::sig::YarpDistortion::YARP_PLUMB_BOB;
+        params.distortionModel.k1 = info.d[0];
+        params.distortionModel.k2 = info.d[1];
+        params.distortionModel.t1 = info.d[2];
+        params.distortionModel.t2 = info.d[3];
+        params.distortionModel.k3 = info.d[4];
+    } else {
+        params.distortionModel.type = yarp::sig::YarpDistortion::YARP_UNSUPPORTED;
+    }
+    width = info.width;
+    height = info.height;
+    if (m_topic_depth_camera_info == m_topic_rgb_camera_info) {
+        m_depth_params = m_rgb_params;
+        m_max_depth_width = m_max_rgb_width;
+        m_max_depth_height = m_max_rgb_height;
+        m_depth_info_valid = true;
+    }
+    valid = true;
+}
+
+void RgbdSensor_replay_ros2::computeFOV(const yarp::sig::IntrinsicParams& params, double width, double height, double& horizontalFov, double& verticalFov)
+{
+    horizontalFov = 2 * atan(width / (2 * params.focalLengthX)) * 180.0 / M_PI;
+    verticalFov = 2 * atan(height / (2 * params.focalLengthY)) * 180.0 / M_PI;
+}
+
+int RgbdSensor_replay_ros2::getRgbHeight()
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    return m_rgb_image_valid ? static_cast<int>(m_current_rgb_image.height()) : 0;
+}
+
+int RgbdSensor_replay_ros2::getRgbWidth()
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    return m_rgb_image_valid ? static_cast<int>(m_current_rgb_image.width()) : 0;
+}
+
+bool RgbdSensor_replay_ros2::getRgbSupportedConfigurations(yarp::sig::VectorOf<yarp::dev::CameraConfig>& configurations)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "getRgbSupportedConfigurations not supported";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getRgbResolution(int& width, int& height)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_rgb_image_valid) {
+        width = 0;
+        height = 0;
+        return false;
+    }
+    width = m_current_rgb_image.width();
+    height = m_current_rgb_image.height();
+    return true;
+}
+
+bool RgbdSensor_replay_ros2::setRgbResolution(int width, int height)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "setRgbResolution is not supported by a recorded image";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getRgbFOV(double& horizontalFov, double& verticalFov)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_rgb_info_valid) {
+        horizontalFov = 0;
+        verticalFov = 0;
+        return false;
+    }
+    computeFOV(m_rgb_params, m_max_rgb_width, m_max_rgb_height, horizontalFov, verticalFov);
+    return true;
+}
+
+bool RgbdSensor_replay_ros2::setRgbFOV(double horizontalFov, double verticalFov)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "setRgbFOV is not supported by a recorded image";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getRgbMirroring(bool& mirror)
+{
+    mirror = false;
+    return true;
+}
+
+bool RgbdSensor_replay_ros2::setRgbMirroring(bool mirror)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "setRgbMirroring is not supported by a recorded image";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getRgbIntrinsicParam(yarp::os::Property& intrinsic)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_rgb_info_valid) {
+        return false;
+    }
+    intrinsic.clear();
+    m_rgb_params.toProperty(intrinsic);
+    return true;
+}
+
+int RgbdSensor_replay_ros2::getDepthHeight()
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    return m_depth_image_valid ? static_cast<int>(m_current_depth_image.height()) : 0;
+}
+
+int RgbdSensor_replay_ros2::getDepthWidth()
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    return m_depth_image_valid ? static_cast<int>(m_current_depth_image.width()) : 0;
+}
+
+bool RgbdSensor_replay_ros2::setDepthResolution(int width, int height)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "setDepthResolution is not supported by a recorded image";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getDepthFOV(double& horizontalFov, double& verticalFov)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_depth_info_valid) {
+        horizontalFov = 0;
+        verticalFov = 0;
+        return false;
+    }
+    computeFOV(m_depth_params, m_max_depth_width, m_max_depth_height, horizontalFov, verticalFov);
+    return true;
+}
+
+bool RgbdSensor_replay_ros2::setDepthFOV(double horizontalFov, double verticalFov)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "setDepthFOV is not supported by a recorded image";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getDepthIntrinsicParam(yarp::os::Property& intrinsic)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_depth_info_valid) {
+        return false;
+    }
+    intrinsic.clear();
+    m_depth_params.toProperty(intrinsic);
+    return true;
+}
+
+double RgbdSensor_replay_ros2::getDepthAccuracy()
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "getDepthAccuracy not supported";
+    return 0;
+}
+
+bool RgbdSensor_replay_ros2::setDepthAccuracy(double accuracy)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "setDepthAccuracy is not supported by a recorded image";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getDepthClipPlanes(double& nearPlane, double& farPlane)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "getDepthClipPlanes not supported";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::setDepthClipPlanes(double nearPlane, double farPlane)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "setDepthClipPlanes is not supported by a recorded image";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getDepthMirroring(bool& mirror)
+{
+    mirror = false;
+    return true;
+}
+
+bool RgbdSensor_replay_ros2::setDepthMirroring(bool mirror)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "setDepthMirroring is not supported by a recorded image";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getExtrinsicParam(yarp::sig::Matrix& extrinsic)
+{
+    yCWarning(RGBDSENSOR_REPLAY_ROS2) << "getExtrinsicParam not supported";
+    return false;
+}
+
+bool RgbdSensor_replay_ros2::getRgbImage(yarp::sig::FlexImage& rgb_image, yarp::os::Stamp* rgb_image_stamp)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_rgb_image_valid) {
+        return false;
+    }
+
+    Ros2RGBDConversionUtils::deepCopyFlexImage(m_current_rgb_image, rgb_image);
+    if (rgb_image_stamp) {
+        *rgb_image_stamp = m_current_rgb_stamp;
+    }
+
+    if (m_rgb_image_fresh) {
+        m_rgb_image_fresh = false;
+        m_player.consumed();
+    }
+    return true;
+}
+
+bool RgbdSensor_replay_ros2::getDepthImage(depthImage& depth_image, yarp::os::Stamp* depth_image_stamp)
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_depth_image_valid) {
+        return false;
+    }
+
+    Ros2RGBDConversionUtils::deepCopyImageOf(m_current_depth_image, depth_image);
+    if (depth_image_stamp) {
+        *depth_image_stamp = m_current_depth_stamp;
+    }
+
+    if (m_depth_image_fresh) {
+        m_depth_image_fresh = false;
+        m_player.consumed();
+    }
+    return true;
+}
+
+bool RgbdSensor_replay_ros2::getImages(yarp::sig::FlexImage& rgb_image, depthImage& depth_image, yarp::os::Stamp* rgb_image_stamp, yarp::os::Stamp* depth_image_stamp)
+{
+    bool rgb_ok = getRgbImage(rgb_image, rgb_image_stamp);
+    bool depth_ok = getDepthImage(depth_image, depth_image_stamp);
+    return rgb_ok && depth_ok;
+}
+
+RgbdSensor_replay_ros2::RGBDSensor_status RgbdSensor_replay_ros2::getSensorStatus()
+{
+    std::lock_guard<std::mutex> data_guard(m_mutex);
+    if (!m_rgb_image_valid || !m_depth_image_valid) {
+        return RGBD_SENSOR_NOT_READY;
+    }
+    if (m_player.isFinished()) {
+        return RGBD_SENSOR_GENERIC_ERROR;
+    }
+    return RGBD_SENSOR_OK_IN_USE;
+}
+
+std::string RgbdSensor_replay_ros2::getLastErrorMsg(yarp::os::Stamp* timeStamp)
+{
+    if (m_player.isFinished()) {
+        return "the playback of the bag is finished";
+    }
+    return "";
+}
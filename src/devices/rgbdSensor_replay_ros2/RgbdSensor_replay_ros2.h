@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_RGBDSENSOR_REPLAY_ROS2_H
+#define YARP_ROS2_RGBDSENSOR_REPLAY_ROS2_H
+
+#include <yarp/dev/DeviceDriver.h>
+#include <yarp/dev/IRGBDSensor.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/sig/Image.h>
+#include <yarp/sig/IntrinsicParams.h>
+
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <Ros2BagPlayer.h>
+
+#include <mutex>
+
+/**
+ *  @ingroup dev_impl_fake dev_impl_media
+ *
+ * \brief `rgbdSensor_replay_ros2`: An RGBD sensor that replays the images and camera infos recorded in a rosbag2 bag.
+ *
+ * It is meant to run the NWS and NWC devices on recorded robot data, in a reproducible way.
+ * The parameters naming the recorded topics start with `bag_`, so that they do not clash with the ones of the nws.
+ * The intrinsic parameters are read from the recorded camera info topics.
+ *
+ * Parameters required by this device are:
+ * | Parameter name         | SubParameter   | Type    | Units          | Default Value                      | Required  | Description                                        | Notes |
+ * |:----------------------:|:--------------:|:-------:|:--------------:|:----------------------------------:|:---------:|:--------------------------------------------------:|:-----:|
+ * | bag_uri                |      -         | string  | -              |   -                                | Yes       | path of the bag to play                            | |
+ * | bag_color_topic_name   |      -         | string  | -              |   -                                | Yes       | recorded topic of the color sensor_msgs/Image      | |
+ * | bag_depth_topic_name   |      -         | string  | -              |   -                                | Yes       | recorded topic of the depth sensor_msgs/Image      | |
+ * | bag_color_info_topic_name |      -         | string  | -              | `<bag_color_topic_name base>/camera_info` | No     | recorded topic of the color sensor_msgs/CameraInfo | |
+ * | bag_depth_info_topic_name |      -         | string  | -              | `<bag_depth_topic_name base>/camera_info` | No     | recorded topic of the depth sensor_msgs/CameraInfo | |
+ * | time_scale             |      -         | double  | -              |   1.0                              | No        | playback speed                                     | |
+ * | as_fast_as_possible    |      -         | bool    | -              |   false                            | No        | a new image is played after every get*Image() that returned the previous one | |
+ * | loop                   |      -         | bool    | -              |   false                            | No        | restart from the beginning at the end of the bag   | |
+ *
+ * See Ros2BagPlayer for the other playback parameters.
+ *
+ * \code{.unparsed}
+ * yarpdev --device rgbdSensor_nws_ros2 --subdevice rgbdSensor_replay_ros2 --bag_uri /data/camera_bag --bag_color_topic_name /camera/color/image_raw --bag_depth_topic_name /camera/depth/image_raw --node_name rgbd_node
+ * \endcode
+ */
+class RgbdSensor_replay_ros2 :
+        public yarp::dev::DeviceDriver,
+        public yarp::dev::IRGBDSensor
+{
+public:
+    typedef yarp::sig::ImageOf<yarp::sig::PixelFloat> depthImage;
+
+    RgbdSensor_replay_ros2() = default;
+    RgbdSensor_replay_ros2(const RgbdSensor_replay_ros2&) = delete;
+    RgbdSensor_replay_ros2(RgbdSensor_replay_ros2&&) noexcept = delete;
+    RgbdSensor_replay_ros2& operator=(const RgbdSensor_replay_ros2&) = delete;
+    RgbdSensor_replay_ros2& operator=(RgbdSensor_replay_ros2&&) noexcept = delete;
+    ~RgbdSensor_replay_ros2() override = default;
+
+    // DeviceDriver
+    bool open(yarp::os::Searchable& config) override;
+    bool close() override;
+
+    // IRGBDSensor
+    int    getRgbHeight() override;
+    int    getRgbWidth() override;
+    bool   getRgbSupportedConfigurations(yarp::sig::VectorOf<yarp::dev::CameraConfig>& configurations) override;
+    bool   getRgbResolution(int& width, int& height) override;
+    bool   setRgbResolution(int width, int height) override;
+    bool   getRgbFOV(double& horizontalFov, double& verticalFov) override;
+    bool   setRgbFOV(double horizontalFov, double verticalFov) override;
+    bool   getRgbMirroring(bool& mirror) override;
+    bool   setRgbMirroring(bool mirror) override;
+    bool   getRgbIntrinsicParam(yarp::os::Property& intrinsic) override;
+    int    getDepthHeight() override;
+    int    getDepthWidth() override;
+    bool   setDepthResolution(int width, int height) override;
+    bool   getDepthFOV(double& horizontalFov, double& verticalFov) override;
+    bool   setDepthFOV(double horizontalFov, double verticalFov) override;
+    bool   getDepthIntrinsicParam(yarp::os::Property& intrinsic) override;
+    double getDepthAccuracy() override;
+    bool   setDepthAccuracy(double accuracy) override;
+    bool   getDepthClipPlanes(double& nearPlane, double& farPlane) override;
+    bool   setDepthClipPlanes(double nearPlane, double farPlane) override;
+    bool   getDepthMirroring(bool& mirror) override;
+    bool   setDepthMirroring(bool mirror) override;
+    bool   getExtrinsicParam(yarp::sig::Matrix& extrinsic) override;
+    bool   getRgbImage(yarp::sig::FlexImage& rgb_image, yarp::os::Stamp* rgb_image_stamp = nullptr) override;
+    bool   getDepthImage(depthImage& depth_image, yarp::os::Stamp* depth_image_stamp = nullptr) override;
+    bool   getImages(yarp::sig::FlexImage& rgb_image, depthImage& depth_image, yarp::os::Stamp* rgb_image_stamp = nullptr, yarp::os::Stamp* depth_image_stamp = nullptr) override;
+    RGBDSensor_status getSensorStatus() override;
+    std::string getLastErrorMsg(yarp::os::Stamp* timeStamp = nullptr) override;
+
+private:
+    void onColorImage(const rosbag2_storage::SerializedBagMessage& bagMessage);
+    void onDepthImage(const rosbag2_storage::SerializedBagMessage& bagMessage);
+    void onCameraInfo(const rosbag2_storage::SerializedBagMessage& bagMessage, yarp::sig::IntrinsicParams& params, double& width, double& height, bool& valid);
+    static void computeFOV(const yarp::sig::IntrinsicParams& params, double width, double height, double& horizontalFov, double& verticalFov);
+
+    Ros2BagPlayer m_player;
+    std::string m_topic_rgb_image_raw;
+    std::string m_topic_rgb_camera_info;
+    std::string m_topic_depth_image_raw;
+    std::string m_topic_depth_camera_info;
+
+    std::mutex m_mutex;
+
+    yarp::sig::FlexImage       m_current_rgb_image;
+    yarp::os::Stamp            m_current_rgb_stamp;
+    yarp::sig::IntrinsicParams m_rgb_params;
+    double                     m_max_rgb_width{0};
+    double                     m_max_rgb_height{0};
+    bool                       m_rgb_image_valid{false};
+    bool                       m_rgb_image_fresh{false};
+    bool                       m_rgb_info_valid{false};
+
+    depthImage                 m_current_depth_image;
+    yarp::os::Stamp            m_current_depth_stamp;
+    yarp::sig::IntrinsicParams m_depth_params;
+    double                     m_max_depth_width{0};
+    double                     m_max_depth_height{0};
+    bool                       m_depth_image_valid{false};
+    bool                       m_depth_image_fresh{false};
+    bool                       m_depth_info_valid{false};
+};
+
+#endif // YARP_ROS2_RGBDSENSOR_REPLAY_ROS2_H
@@ -0,0 +1,238 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <yarp/os/Network.h>
+#include <yarp/dev/IRGBDSensor.h>
+#include <yarp/dev/PolyDriver.h>
+
+#include <sensor_msgs/msg/camera_info.hpp>
+#include <sensor_msgs/msg/image.hpp>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+#include <harness_bag.h>
+
+#include <cmath>
+#include <cstring>
+
+using namespace yarp::dev;
+using namespace yarp::os;
+
+namespace {
+constexpr const char* s_colorTopic = "/camera/color/image_raw";
+constexpr const char* s_depthTopic = "/camera/depth/image_raw";
+constexpr const char* s_colorInfoTopic = "/camera/color/camera_info";
+constexpr const char* s_depthInfoTopic = "/camera/depth/camera_info";
+constexpr size_t s_samples = 4;
+constexpr size_t s_width = 8;
+constexpr size_t s_height = 2;
+constexpr int64_t s_messageSpacingNs = 1000000;
+constexpr double s_focalLengthX = 200.0;
+constexpr double s_focalLengthY = 100.0;
+
+unsigned char colorOf(size_t sample, size_t x, size_t y, size_t channel)
+{
+    return static_cast<unsigned char>(10 * sample + 3 * (y * s_width + x) + channel);
+}
+
+uint16_t depthOf(size_t sample, size_t x, size_t y)
+{
+    return static_cast<uint16_t>(1000 + 100 * sample + 10 * y + x); // mm
+}
+
+sensor_msgs::msg::CameraInfo cameraInfo(const rclcpp::Time& stamp)
+{
+    sensor_msgs::msg::CameraInfo info;
+    info.header.stamp = stamp;
+    info.width = s_width;
+    info.height = s_height;
+    info.k = {s_focalLengthX, 0.0, 4.0, 0.0, s_focalLengthY, 1.0, 0.0, 0.0, 1.0};
+    info.distortion_model = "plumb_bob";
+    info.d = {0.1, 0.01, 0.0, 0.0, 0.001};
+    return info;
+}
+
+// Records s_samples frames, each made of the camera infos, a rgb8 color image and a 16UC1 depth
+// image stamped with the frame stamp, recorded in this order a millisecond apart
+std::string recordFrames()
+{
+    return recordBag("rgbdSensor_replay_ros2", s_samples, [](Ros2BagRecorder& recorder, size_t i, const rclcpp::Time& stamp) {
+        const int64_t frameNs = stamp.nanoseconds();
+
+        sensor_msgs::msg::Image color;
+        color.header.stamp = stamp;
+        color.width = s_width;
+        color.height = s_height;
+        color.encoding = "rgb8";
+        color.step = s_width * 3;
+        for (size_t y = 0; y < s_height; y++) {
+            for (size_t x = 0; x < s_width; x++) {
+                for (size_t c = 0; c < 3; c++) {
+                    color.data.push_back(colorOf(i, x, y, c));
+                }
+            }
+        }
+
+        sensor_msgs::msg::Image depth;
+        depth.header.stamp = stamp;
+        depth.width = s_width;
+        depth.height = s_height;
+        depth.encoding = "16UC1";
+        depth.step = s_width * sizeof(uint16_t);
+        std::vector<uint16_t> depthData;
+        for (size_t y = 0; y < s_height; y++) {
+            for (size_t x = 0; x < s_width; x++) {
+                depthData.push_back(depthOf(i, x, y));
+            }
+        }
+        depth.data.resize(depthData.size() * sizeof(uint16_t));
+        memcpy(depth.data.data(), depthData.data(), depth.data.size());
+
+        REQUIRE(recorder.write(cameraInfo(stamp), s_colorInfoTopic, stamp));
+        REQUIRE(recorder.write(cameraInfo(stamp), s_depthInfoTopic, rclcpp::Time(frameNs + s_messageSpacingNs)));
+        REQUIRE(recorder.write(color, s_colorTopic, rclcpp::Time(frameNs + 2 * s_messageSpacingNs)));
+        REQUIRE(recorder.write(depth, s_depthTopic, rclcpp::Time(frameNs + 3 * s_messageSpacingNs)));
+    });
+}
+
+// Waits for the frame stamped stamp and checks it. Reading the color image releases the depth
+// image, and reading the depth image releases the next frame
+void checkFrame(IRGBDSensor* irgbd, size_t sample, double stamp)
+{
+    yarp::sig::FlexImage color;
+    yarp::sig::ImageOf<yarp::sig::PixelFloat> depth;
+    Stamp colorStamp;
+    Stamp depthStamp;
+    REQUIRE(waitFor([&] {
+        return irgbd->getImages(color, depth, &colorStamp, &depthStamp) &&
+               colorStamp.getTime() == approxStamp(stamp) &&
+               depthStamp.getTime() == approxStamp(stamp);
+    }));
+
+    REQUIRE(color.width() == s_width);
+    REQUIRE(color.height() == s_height);
+    CHECK(color.getPixelCode() == VOCAB_PIXEL_RGB);
+    REQUIRE(depth.width() == s_width);
+    REQUIRE(depth.height() == s_height);
+    for (size_t y = 0; y < s_height; y++) {
+        for (size_t x = 0; x < s_width; x++) {
+            const unsigned char* pixel = color.getPixelAddress(x, y);
+            for (size_t c = 0; c < 3; c++) {
+                CHECK(pixel[c] == colorOf(sample, x, y, c));
+            }
+            CHECK(depth.pixel(x, y) == Catch::Approx(depthOf(sample, x, y) / 1000.0));
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("dev::rgbdSensor_replay_ros2_playback_test", "[yarp::dev]")
+{
+    YARP_REQUIRE_PLUGIN("rgbdSensor_replay_ros2", "device");
+
+    Network::setLocalMode(true);
+
+    const std::string uri = recordFrames();
+
+    Property pcfg;
+    pcfg.put("device", "rgbdSensor_replay_ros2");
+    pcfg.put("bag_uri", uri);
+    pcfg.put("bag_color_topic_name", s_colorTopic);
+    pcfg.put("bag_depth_topic_name", s_depthTopic);
+
+    SECTION("Playing as fast as possible")
+    {
+        PolyDriver dd;
+        pcfg.put("as_fast_as_possible", Value(true));
+        REQUIRE(dd.open(pcfg));
+
+        IRGBDSensor* irgbd = nullptr;
+        REQUIRE(dd.view(irgbd));
+
+        // Every recorded frame is returned once, in order
+        for (size_t i = 0; i < s_samples; i++) {
+            checkFrame(irgbd, i, stampOf(i));
+        }
+
+        // The intrinsic parameters are read from the recorded camera infos
+        Property intrinsic;
+        CHECK(irgbd->getRgbIntrinsicParam(intrinsic));
+        CHECK(intrinsic.find("focalLengthX").asFloat64() == Catch::Approx(s_focalLengthX));
+        CHECK(intrinsic.find("focalLengthY").asFloat64() == Catch::Approx(s_focalLengthY));
+        CHECK(intrinsic.find("principalPointX").asFloat64() == Catch::Approx(4.0));
+        CHECK(intrinsic.find("principalPointY").asFloat64() == Catch::Approx(1.0));
+        CHECK(intrinsic.find("k1").asFloat64() == Catch::Approx(0.1));
+        CHECK(intrinsic.find("k3").asFloat64() == Catch::Approx(0.001));
+        CHECK(irgbd->getDepthIntrinsicParam(intrinsic));
+        CHECK(intrinsic.find("focalLengthX").asFloat64() == Catch::Approx(s_focalLengthX));
+
+        double horizontalFov = 0;
+        double verticalFov = 0;
+        CHECK(irgbd->getRgbFOV(horizontalFov, verticalFov));
+        CHECK(horizontalFov == Catch::Approx(2 * atan(s_width / (2 * s_focalLengthX)) * 180.0 / M_PI));
+        CHECK(verticalFov == Catch::Approx(2 * atan(s_height / (2 * s_focalLengthY)) * 180.0 / M_PI));
+
+        // The last frame was consumed, so the playback ends
+        CHECK(waitFor([&] { return irgbd->getSensorStatus() == IRGBDSensor::RGBD_SENSOR_GENERIC_ERROR; }));
+
+        CHECK(dd.close());
+    }
+
+    SECTION("Playing as fast as possible in a loop")
+    {
+        PolyDriver dd;
+        pcfg.put("as_fast_as_possible", Value(true));
+        pcfg.put("loop", Value(true));
+        REQUIRE(dd.open(pcfg));
+
+        IRGBDSensor* irgbd = nullptr;
+        REQUIRE(dd.view(irgbd));
+
+        for (size_t i = 0; i < s_samples; i++) {
+            checkFrame(irgbd, i, stampOf(i));
+        }
+
+        // The frames of the second loop are shifted by the same offset, after the end of the first loop
+        yarp::sig::FlexImage color;
+        yarp::sig::ImageOf<yarp::sig::PixelFloat> depth;
+        Stamp colorStamp;
+        Stamp depthStamp;
+        REQUIRE(waitFor([&] {
+            return irgbd->getImages(color, depth, &colorStamp, &depthStamp) &&
+                   colorStamp.getTime() > stampOf(s_samples - 1) &&
+                   depthStamp.getTime() == approxStamp(colorStamp.getTime());
+        }));
+        const double offset = colorStamp.getTime() - stampOf(0);
+        CHECK(offset > stampOf(s_samples - 1) - stampOf(0));
+        for (size_t i = 1; i < s_samples; i++) {
+            checkFrame(irgbd, i, stampOf(i) + offset);
+        }
+
+        CHECK(dd.close());
+    }
+
+    SECTION("Playing with the recorded timing")
+    {
+        PolyDriver dd;
+        REQUIRE(dd.open(pcfg));
+
+        IRGBDSensor* irgbd = nullptr;
+        REQUIRE(dd.view(irgbd));
+
+        // The frames are played without being read, the last one stays available at the end
+        REQUIRE(waitFor([&] { return irgbd->getSensorStatus() == IRGBDSensor::RGBD_SENSOR_GENERIC_ERROR; }));
+        checkFrame(irgbd, s_samples - 1, stampOf(s_samples - 1));
+
+        CHECK(dd.close());
+    }
+
+    std::filesystem::remove_all(uri);
+
+    Network::setLocalMode(false);
+}
@@ -85,7 +85,20 @@ bool RgbdToPointCloudSensor_nws_ros2::initialize_ROS2(yarp::os::Searchable &para
 {
 
     m_node = NodeCreator::createNode(m_nodeName);
+    m_clockDriver = std::make_unique<Ros2ClockDriver>(m_node, [this]() { run(); });
+    if (!m_clockDriver->configure(params) || !m_clockDriver->setPeriod(getPeriod())) {
+        return false;
+    }
     m_rosPublisher_pointCloud2 = m_node->create_publisher<sensor_msgs::msg::PointCloud2>(m_pointCloudTopicName, 10);
+
+    m_parameters = std::make_unique<Ros2Parameters>(m_node);
+    bool ok = m_parameters->addDouble("period", getPeriod(), [this](double period) {
+        return period > 0 && m_clockDriver->setPeriod(period) && setPeriod(period);
+    });
+    if (!ok || !m_parameters->start()) {
+        yCError(RGBDTOPOINTCLOUDSENSOR_NWS_ROS2) << "Unable to initialize the ROS 2 parameters";
+        return false;
+    }
     return true;
 }
 
@@ -93,6 +106,9 @@ bool RgbdToPointCloudSensor_nws_ros2::initialize_ROS2(yarp::os::Searchable &para
 bool RgbdToPointCloudSensor_nws_ros2::close()
 {
     yCTrace(RGBDTOPOINTCLOUDSENSOR_NWS_ROS2, "Close");
+    if (m_parameters) {
+        m_parameters->stop();
+    }
     detachAll();
 
     return true;
@@ -149,12 +165,18 @@ bool RgbdToPointCloudSensor_nws_ros2::attach(yarp::dev::PolyDriver* poly)
         yCWarning(RGBDTOPOINTCLOUDSENSOR_NWS_ROS2) << "Attached device has no valid IFrameGrabberControls interface.";
     }
 
+    if (m_clockDriver->enabled()) {
+        return m_clockDriver->start();
+    }
     return PeriodicThread::start();
 }
 
 
 bool RgbdToPointCloudSensor_nws_ros2::detach()
 {
+    if (m_clockDriver) {
+        m_clockDriver->stop();
+    }
     if (yarp::os::PeriodicThread::isRunning())
         yarp::os::PeriodicThread::stop();
 
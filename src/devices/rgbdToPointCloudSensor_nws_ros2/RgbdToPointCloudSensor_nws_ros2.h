@@ -16,7 +16,10 @@
 #include <rclcpp/rclcpp.hpp>
 #include <std_msgs/msg/string.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
+#include <Ros2Parameters.h>
+#include <Ros2ClockDriver.h>
 
+#include <memory>
 #include <mutex>
 
 namespace RGBDToPointCloudRos2Impl {
@@ -44,6 +47,10 @@ const std::string pointCloudTopicName_param = "topic_name";
  * | topic_name             |      -                  | string  |  -             |   -           |  Yes                            | set the name for ROS point cloud topic                                                              | must start with a leading '/' |
  * | frame_id               |      -                  | string  |  -             |               |  Yes                            | set the name of the reference frame                                                                 |                               |
  * | node_name              |      -                  | string  |  -             |   -           |  Yes                            | set the name for ROS node                                                                           | must start with a leading '/' |
+ * | clock_source           |      -                  | string  |  -             |   system      |  No                             | clock the publishing cycle runs on                                                                  | `system` or `ros`, see Ros2ClockDriver |
+ * | clock_topic            |      -                  | string  |  -             |   /clock      |  No                             | clock topic used when clock_source is `ros`                                                         |                               |
+ *
+ * The `period` is also exposed as a ROS 2 parameter of the node, so it can be changed at runtime with `ros2 param set`.
  *
  * ROS2 message type used is sensor_msgs/PointCloud2.msg ( https://github.com/ros2/common_interfaces/blob/master/sensor_msgs/msg/PointCloud2.msg)
  * Some example of configuration files:
@@ -72,6 +79,8 @@ private:
     typedef unsigned int UInt;
     rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_rosPublisher_pointCloud2;
     rclcpp::Node::SharedPtr m_node;
+    std::unique_ptr<Ros2Parameters> m_parameters;
+    std::unique_ptr<Ros2ClockDriver> m_clockDriver;
 
     enum SensorType
     {
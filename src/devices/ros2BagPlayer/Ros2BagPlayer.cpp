@@ -0,0 +1,222 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Ros2BagPlayer.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
+
+#include <rosbag2_cpp/converter_options.hpp>
+#include <rosbag2_storage/storage_filter.hpp>
+#include <rosbag2_storage/storage_options.hpp>
+
+#include <set>
+
+namespace {
+YARP_LOG_COMPONENT(ROS2BAGPLAYER, "yarp.ros2.Ros2BagPlayer")
+
+constexpr const char* s_serialization_format = "cdr";
+constexpr double s_ns_to_s = 1e-9;
+} // namespace
+
+Ros2BagPlayer::~Ros2BagPlayer()
+{
+    close();
+}
+
+bool Ros2BagPlayer::parseOptions(yarp::os::Searchable& config, Options& options)
+{
+    if (!config.check("bag_uri")) {
+        yCError(ROS2BAGPLAYER) << "Missing bag_uri parameter";
+        return false;
+    }
+    options.uri = config.find("bag_uri").asString();
+
+    if (config.check("storage_id")) {
+        options.storageId = config.find("storage_id").asString();
+    }
+
+    if (config.check("time_scale")) {
+        options.timeScale = config.find("time_scale").asFloat64();
+        if (options.timeScale <= 0) {
+            yCError(ROS2BAGPLAYER) << "time_scale must be positive";
+            return false;
+        }
+    }
+
+    options.asFastAsPossible = config.check("as_fast_as_possible") && config.find("as_fast_as_possible").asBool();
+    options.loop = config.check("loop") && config.find("loop").asBool();
+
+    return true;
+}
+
+void Ros2BagPlayer::addTopic(const std::string& topicName, Callback callback)
+{
+    m_callbacks[topicName] = std::move(callback);
+}
+
+bool Ros2BagPlayer::openReader()
+{
+    rosbag2_storage::StorageOptions storageOptions;
+    storageOptions.uri = m_options.uri;
+    // An empty storage_id is read from the metadata of the bag
+    storageOptions.storage_id = m_options.storageId;
+
+    try {
+        m_reader.close();
+        m_reader.open(storageOptions, rosbag2_cpp::ConverterOptions{s_serialization_format, s_serialization_format});
+    } catch (const std::exception& e) {
+        yCError(ROS2BAGPLAYER) << "Unable to open bag" << m_options.uri << ":" << e.what();
+        return false;
+    }
+
+    rosbag2_storage::StorageFilter filter;
+    for (const auto& topic : m_callbacks) {
+        filter.topics.push_back(topic.first);
+    }
+    m_reader.set_filter(filter);
+
+    return true;
+}
+
+bool Ros2BagPlayer::open(const Options& options)
+{
+    if (isRunning()) {
+        yCError(ROS2BAGPLAYER) << "Player is already open on" << m_options.uri;
+        return false;
+    }
+    m_options = options;
+
+    if (!openReader()) {
+        return false;
+    }
+
+    std::set<std::string> available;
+    for (const auto& topic : m_reader.get_all_topics_and_types()) {
+        available.insert(topic.name);
+    }
+    for (const auto& topic : m_callbacks) {
+        if (available.find(topic.first) == available.end()) {
+            yCError(ROS2BAGPLAYER) << "Topic" << topic.first << "is not recorded in" << m_options.uri;
+            return false;
+        }
+    }
+
+    m_finished = false;
+    m_stampOffset = 0.0;
+
+    if (!start()) {
+        yCError(ROS2BAGPLAYER) << "Unable to start the player thread";
+        return false;
+    }
+
+    if (m_options.asFastAsPossible) {
+        yCInfo(ROS2BAGPLAYER) << "Playing" << m_options.uri << "as fast as possible";
+    } else {
+        yCInfo(ROS2BAGPLAYER) << "Playing" << m_options.uri << "with time scale" << m_options.timeScale;
+    }
+    return true;
+}
+
+void Ros2BagPlayer::close()
+{
+    if (isRunning()) {
+        stop();
+    }
+    try {
+        m_reader.close();
+    } catch (const std::exception& e) {
+        yCWarning(ROS2BAGPLAYER) << "Error while closing" << m_options.uri << ":" << e.what();
+    }
+}
+
+void Ros2BagPlayer::consumed()
+{
+    if (m_options.asFastAsPossible) {
+        m_consumed.post();
+    }
+}
+
+bool Ros2BagPlayer::isFinished() const
+{
+    return m_finished;
+}
+
+double Ros2BagPlayer::stampOffset() const
+{
+    return m_stampOffset;
+}
+
+void Ros2BagPlayer::run()
+{
+    while (true) {
+        bool first = true;
+        rcutils_time_point_value_t firstTime = 0;
+        rcutils_time_point_value_t lastTime = 0;
+        rcutils_time_point_value_t previousTime = 0;
+        double wallStart = 0.0;
+
+        while (!isStopping() && m_reader.has_next()) {
+            std::shared_ptr<rosbag2_storage::SerializedBagMessage> message;
+            try {
+                message = m_reader.read_next();
+            } catch (const std::exception& e) {
+                yCError(ROS2BAGPLAYER) << "Unable to read" << m_options.uri << ":" << e.what();
+                break;
+            }
+
+            if (first) {
+                firstTime = message->time_stamp;
+                lastTime = firstTime;
+                wallStart = yarp::os::Time::now();
+                first = false;
+            }
+
+            if (!m_options.asFastAsPossible) {
+                double target = wallStart + (message->time_stamp - firstTime) * s_ns_to_s / m_options.timeScale;
+                double wait = target - yarp::os::Time::now();
+                if (wait > 0) {
+                    yarp::os::Time::delay(wait);
+                }
+            }
+            if (isStopping()) {
+                break;
+            }
+
+            auto it = m_callbacks.find(message->topic_name);
+            if (it != m_callbacks.end()) {
+                it->second(*message);
+                if (m_options.asFastAsPossible) {
+                    m_consumed.wait();
+                }
+            }
+
+            previousTime = lastTime;
+            lastTime = message->time_stamp;
+        }
+
+        if (isStopping() || !m_options.loop || first) {
+            break;
+        }
+
+        // The next loop starts one sample period after the end of this one
+        double duration = (lastTime - firstTime) * s_ns_to_s;
+        double period = (lastTime - previousTime) * s_ns_to_s;
+        m_stampOffset = m_stampOffset + duration + period;
+
+        if (!openReader()) {
+            break;
+        }
+    }
+
+    m_finished = true;
+    yCInfo(ROS2BAGPLAYER) << "Playback of" << m_options.uri << "finished";
+}
+
+void Ros2BagPlayer::onStop()
+{
+    m_consumed.post();
+}
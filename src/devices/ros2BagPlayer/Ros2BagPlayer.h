@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ROS2BAGPLAYER_H
+#define YARP_ROS2_ROS2BAGPLAYER_H
+
+#include <yarp/os/Searchable.h>
+#include <yarp/os/Semaphore.h>
+#include <yarp/os/Thread.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp/serialization.hpp>
+#include <rclcpp/serialized_message.hpp>
+#include <rosbag2_cpp/reader.hpp>
+#include <rosbag2_storage/serialized_bag_message.hpp>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <string>
+
+/**
+ * Plays back the messages of some topics of a rosbag2 bag (MCAP or sqlite3) and
+ * hands them, still serialized, to a callback per topic.
+ *
+ * Messages are delivered on the player thread with the timing they were recorded
+ * with, scaled by `time_scale`. With `as_fast_as_possible` there is no timing at
+ * all: a message is delivered as soon as the previous one was consumed, i.e. the
+ * device calls consumed() every time one of its getters returned new data, so
+ * that a benchmark sees every recorded sample exactly once.
+ *
+ * When the bag is looped, the recorded header stamps are shifted by
+ * stampOffset() so that the devices keep returning increasing stamps.
+ *
+ * The player is configured by the following device parameters:
+ * | Parameter name      | Type   | Units | Default Value | Required | Description                                                      |
+ * |:-------------------:|:------:|:-----:|:-------------:|:--------:|:----------------------------------------------------------------:|
+ * | bag_uri             | string | -     | -             | Yes      | path of the bag to play                                          |
+ * | storage_id          | string | -     | -             | No       | storage plugin of the bag, detected from the bag if not set      |
+ * | time_scale          | double | -     | 1.0           | No       | playback speed, 2.0 plays twice as fast as recorded              |
+ * | as_fast_as_possible | bool   | -     | false         | No       | ignore the recorded timing, see above                            |
+ * | loop                | bool   | -     | false         | No       | restart from the beginning at the end of the bag                 |
+ */
+class Ros2BagPlayer : public yarp::os::Thread
+{
+public:
+    struct Options
+    {
+        std::string uri;
+        std::string storageId;
+        double timeScale{1.0};
+        bool asFastAsPossible{false};
+        bool loop{false};
+    };
+
+    using Callback = std::function<void(const rosbag2_storage::SerializedBagMessage&)>;
+
+    Ros2BagPlayer() = default;
+    Ros2BagPlayer(const Ros2BagPlayer&) = delete;
+    Ros2BagPlayer& operator=(const Ros2BagPlayer&) = delete;
+    ~Ros2BagPlayer() override;
+
+    static bool parseOptions(yarp::os::Searchable& config, Options& options);
+
+    /**
+     * Registers the callback of a topic. Must be called before open().
+     */
+    void addTopic(const std::string& topicName, Callback callback);
+
+    /**
+     * Checks that the bag contains the registered topics and starts the playback.
+     */
+    bool open(const Options& options);
+    void close();
+
+    /**
+     * Releases the next message when playing as fast as possible, does nothing otherwise.
+     */
+    void consumed();
+
+    bool isFinished() const;
+    double stampOffset() const;
+
+    template <class MSG>
+    static bool deserialize(const rosbag2_storage::SerializedBagMessage& bagMessage, MSG& msg);
+
+    // Thread
+    void run() override;
+    void onStop() override;
+
+private:
+    bool openReader();
+
+    Options m_options;
+    rosbag2_cpp::Reader m_reader;
+    std::map<std::string, Callback> m_callbacks;
+    yarp::os::Semaphore m_consumed{0};
+    std::atomic<bool> m_finished{false};
+    std::atomic<double> m_stampOffset{0.0};
+};
+
+template <class MSG>
+bool Ros2BagPlayer::deserialize(const rosbag2_storage::SerializedBagMessage& bagMessage, MSG& msg)
+{
+    static rclcpp::Serialization<MSG> serializer;
+    if (!bagMessage.serialized_data) {
+        return false;
+    }
+    rclcpp::SerializedMessage serialized(*bagMessage.serialized_data);
+    try {
+        serializer.deserialize_message(&serialized, &msg);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+#endif // YARP_ROS2_ROS2BAGPLAYER_H
@@ -0,0 +1,244 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Ros2BagRecorder.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Os.h>
+
+#ifdef YARP_ROS2_HAS_ROSBAG2
+#include <rosbag2_cpp/converter_options.hpp>
+#include <rosbag2_storage/storage_options.hpp>
+#endif
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace {
+YARP_LOG_COMPONENT(ROS2BAGRECORDER, "yarp.ros2.Ros2BagRecorder")
+
+#ifdef YARP_ROS2_HAS_ROSBAG2
+constexpr const char* s_storage_id = "mcap";
+constexpr const char* s_serialization_format = "cdr";
+
+// Distinguishes the storage configurations of the recorders of the same process
+std::atomic<unsigned int> s_storageConfigCount{0};
+#endif
+} // namespace
+
+Ros2BagRecorder::~Ros2BagRecorder()
+{
+    close();
+}
+
+bool Ros2BagRecorder::parseOptions(yarp::os::Searchable& config, Options& options)
+{
+    if (!config.check("record_uri")) {
+        options.uri.clear();
+        return true;
+    }
+    options.uri = config.find("record_uri").asString();
+    if (options.uri.empty()) {
+        yCError(ROS2BAGRECORDER) << "record_uri cannot be empty";
+        return false;
+    }
+
+    if (config.check("record_compression")) {
+        options.compression = config.find("record_compression").asString();
+        if (options.compression != "none" && options.compression != "lz4" && options.compression != "zstd") {
+            yCError(ROS2BAGRECORDER) << "Invalid record_compression" << options.compression << ", must be one of none, lz4, zstd";
+            return false;
+        }
+    }
+
+    if (config.check("record_chunk_size")) {
+        int chunkSize = config.find("record_chunk_size").asInt32();
+        if (chunkSize <= 0) {
+            yCError(ROS2BAGRECORDER) << "record_chunk_size must be positive";
+            return false;
+        }
+        options.chunkSize = static_cast<size_t>(chunkSize);
+    }
+
+    if (config.check("record_queue_size")) {
+        int queueSize = config.find("record_queue_size").asInt32();
+        if (queueSize <= 0) {
+            yCError(ROS2BAGRECORDER) << "record_queue_size must be positive";
+            return false;
+        }
+        options.queueSize = static_cast<size_t>(queueSize);
+    }
+
+    return true;
+}
+
+#ifdef YARP_ROS2_HAS_ROSBAG2
+bool Ros2BagRecorder::writeStorageConfig(const Options& options, std::string& configUri)
+{
+    // The bag directory is created by the writer, and the storage reads the configuration only
+    // while it is opened, so the configuration is a temporary file removed by open()
+    std::error_code ec;
+    std::filesystem::path directory = std::filesystem::temp_directory_path(ec);
+    if (ec) {
+        yCError(ROS2BAGRECORDER) << "Unable to find a temporary directory for the storage configuration:" << ec.message();
+        return false;
+    }
+    configUri = (directory / ("yarp_ros2_storage_config_" + std::to_string(yarp::os::getpid()) + "_" + std::to_string(s_storageConfigCount++) + ".yaml")).string();
+    std::ofstream file(configUri);
+    if (!file.is_open()) {
+        yCError(ROS2BAGRECORDER) << "Unable to write the storage configuration" << configUri;
+        return false;
+    }
+
+    std::string compression = "None";
+    if (options.compression == "lz4") {
+        compression = "Lz4";
+    } else if (options.compression == "zstd") {
+        compression = "Zstd";
+    }
+
+    file << "noChunking: false\n";
+    file << "chunkSize: " << options.chunkSize << "\n";
+    file << "compression: \"" << compression << "\"\n";
+    file << "compressionLevel: \"Fast\"\n";
+    return file.good();
+}
+#endif
+
+bool Ros2BagRecorder::open(const Options& options)
+{
+    if (isRunning()) {
+        yCError(ROS2BAGRECORDER) << "Recorder is already open on" << m_options.uri;
+        return false;
+    }
+    m_options = options;
+
+#ifdef YARP_ROS2_HAS_ROSBAG2
+    rosbag2_storage::StorageOptions storageOptions;
+    storageOptions.uri = m_options.uri;
+    storageOptions.storage_id = s_storage_id;
+    // Writes are already moved off the publishing thread by this class, the writer does not need its own cache
+    storageOptions.max_cache_size = 0;
+    if (!writeStorageConfig(m_options, storageOptions.storage_config_uri)) {
+        std::error_code ec;
+        std::filesystem::remove(storageOptions.storage_config_uri, ec);
+        return false;
+    }
+
+    bool opened = true;
+    try {
+        m_writer.open(storageOptions, rosbag2_cpp::ConverterOptions{s_serialization_format, s_serialization_format});
+    } catch (const std::exception& e) {
+        yCError(ROS2BAGRECORDER) << "Unable to open bag" << m_options.uri << ":" << e.what();
+        opened = false;
+    }
+    std::error_code ec;
+    std::filesystem::remove(storageOptions.storage_config_uri, ec);
+    if (!opened) {
+        return false;
+    }
+    m_isOpen = true;
+#else
+    yCError(ROS2BAGRECORDER) << "Unable to record to" << m_options.uri << ", built without rosbag2";
+    return false;
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = false;
+        m_dropped = 0;
+    }
+
+    if (!start()) {
+        yCError(ROS2BAGRECORDER) << "Unable to start the writer thread";
+        return false;
+    }
+
+    yCInfo(ROS2BAGRECORDER) << "Recording to" << m_options.uri << "with" << m_options.compression << "compression";
+    return true;
+}
+
+void Ros2BagRecorder::close()
+{
+    if (isRunning()) {
+        stop();
+    }
+    if (!m_isOpen) {
+        return;
+    }
+#ifdef YARP_ROS2_HAS_ROSBAG2
+    m_writer.close();
+#endif
+    m_isOpen = false;
+    if (m_dropped > 0) {
+        yCWarning(ROS2BAGRECORDER) << m_dropped << "messages were dropped while recording" << m_options.uri;
+    }
+}
+
+bool Ros2BagRecorder::write(std::shared_ptr<const rclcpp::SerializedMessage> message,
+                            const std::string& topicName,
+                            const std::string& typeName,
+                            const rclcpp::Time& time)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closing) {
+            return false;
+        }
+        if (m_queue.size() >= m_options.queueSize) {
+            m_dropped++;
+            yCWarningThrottle(ROS2BAGRECORDER, 5.0) << "Recording queue is full, dropping messages of" << topicName;
+            return false;
+        }
+        m_queue.push_back(Entry{std::move(message), topicName, typeName, time});
+    }
+    m_cv.notify_one();
+    return true;
+}
+
+size_t Ros2BagRecorder::droppedMessages() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped;
+}
+
+void Ros2BagRecorder::run()
+{
+    std::deque<Entry> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_closing || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                // Closing, and everything has been written
+                return;
+            }
+            batch.swap(m_queue);
+        }
+
+#ifdef YARP_ROS2_HAS_ROSBAG2
+        for (auto& entry : batch) {
+            try {
+                m_writer.write(entry.message, entry.topicName, entry.typeName, entry.time);
+            } catch (const std::exception& e) {
+                yCErrorThrottle(ROS2BAGRECORDER, 5.0) << "Unable to write a message of" << entry.topicName << ":" << e.what();
+            }
+        }
+#endif
+        batch.clear();
+    }
+}
+
+void Ros2BagRecorder::onStop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_cv.notify_one();
+}
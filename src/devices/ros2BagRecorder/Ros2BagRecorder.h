@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ROS2BAGRECORDER_H
+#define YARP_ROS2_ROS2BAGRECORDER_H
+
+#include <yarp/os/Searchable.h>
+#include <yarp/os/Thread.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp/serialization.hpp>
+#include <rclcpp/serialized_message.hpp>
+#ifdef YARP_ROS2_HAS_ROSBAG2
+#include <rosbag2_cpp/writer.hpp>
+#endif
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Records the messages published by a device into an MCAP bag, in the same process.
+ *
+ * The message is serialized only once: the serialized buffer is published on the
+ * topic and then queued for a background thread that writes it to the bag, so
+ * the publishing thread never waits for the disk.
+ * The queue is bounded, when it is full new messages are dropped (and counted)
+ * instead of blocking the publisher.
+ *
+ * The bag is written by the `mcap` storage plugin (`rosbag2_storage_mcap`) in
+ * compressed chunks, so that the disk only sees large sequential writes.
+ * When the project is built without rosbag2, open() always fails.
+ *
+ * The recorder is enabled by the following device parameters:
+ * | Parameter name     | Type   | Units | Default Value | Required | Description                                                   |
+ * |:------------------:|:------:|:-----:|:-------------:|:--------:|:-------------------------------------------------------------:|
+ * | record_uri         | string | -     | -             | No       | directory of the bag to write, recording is disabled if unset |
+ * | record_compression | string | -     | zstd          | No       | chunk compression: `none`, `lz4` or `zstd`                    |
+ * | record_chunk_size  | int    | bytes | 4194304       | No       | size of the MCAP chunks                                       |
+ * | record_queue_size  | int    | -     | 64            | No       | maximum number of messages waiting to be written              |
+ */
+class Ros2BagRecorder : public yarp::os::Thread
+{
+public:
+    struct Options
+    {
+        std::string uri;
+        std::string compression{"zstd"};
+        size_t chunkSize{4 * 1024 * 1024};
+        size_t queueSize{64};
+    };
+
+    Ros2BagRecorder() = default;
+    Ros2BagRecorder(const Ros2BagRecorder&) = delete;
+    Ros2BagRecorder& operator=(const Ros2BagRecorder&) = delete;
+    ~Ros2BagRecorder() override;
+
+    /**
+     * Reads the `record_*` parameters.
+     * Returns false if they are invalid, options.uri is left empty if recording is not requested.
+     */
+    static bool parseOptions(yarp::os::Searchable& config, Options& options);
+
+    bool open(const Options& options);
+    void close();
+
+    /**
+     * Queues a message that is already serialized. Never blocks on the disk.
+     */
+    bool write(std::shared_ptr<const rclcpp::SerializedMessage> message,
+               const std::string& topicName,
+               const std::string& typeName,
+               const rclcpp::Time& time);
+
+    /**
+     * Serializes the message and queues it for the bag, without publishing it.
+     */
+    template <class MSG>
+    bool write(const MSG& msg, const std::string& topicName, const rclcpp::Time& time);
+
+    /**
+     * Serializes the message once, publishes the serialized buffer and queues it for the bag.
+     */
+    template <class MSG>
+    void publish(const typename rclcpp::Publisher<MSG>::SharedPtr& publisher, const MSG& msg);
+
+    size_t droppedMessages() const;
+
+    // Thread
+    void run() override;
+    void onStop() override;
+
+private:
+    template <class MSG>
+    static std::shared_ptr<rclcpp::SerializedMessage> serialize(const MSG& msg);
+
+    struct Entry
+    {
+        std::shared_ptr<const rclcpp::SerializedMessage> message;
+        std::string topicName;
+        std::string typeName;
+        rclcpp::Time time;
+    };
+
+#ifdef YARP_ROS2_HAS_ROSBAG2
+    bool writeStorageConfig(const Options& options, std::string& configUri);
+
+    rosbag2_cpp::Writer m_writer;
+#endif
+    bool m_isOpen{false};
+    Options m_options;
+    std::deque<Entry> m_queue;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_closing{false};
+    size_t m_dropped{0};
+};
+
+template <class MSG>
+std::shared_ptr<rclcpp::SerializedMessage> Ros2BagRecorder::serialize(const MSG& msg)
+{
+    static rclcpp::Serialization<MSG> serializer;
+    auto serialized = std::make_shared<rclcpp::SerializedMessage>();
+    serializer.serialize_message(&msg, serialized.get());
+    return serialized;
+}
+
+template <class MSG>
+bool Ros2BagRecorder::write(const MSG& msg, const std::string& topicName, const rclcpp::Time& time)
+{
+    return write(serialize(msg), topicName, rosidl_generator_traits::name<MSG>(), time);
+}
+
+template <class MSG>
+void Ros2BagRecorder::publish(const typename rclcpp::Publisher<MSG>::SharedPtr& publisher, const MSG& msg)
+{
+    auto serialized = serialize(msg);
+    publisher->publish(*serialized);
+    write(serialized, publisher->get_topic_name(), rosidl_generator_traits::name<MSG>(), rclcpp::Clock().now());
+}
+
+#endif // YARP_ROS2_ROS2BAGRECORDER_H
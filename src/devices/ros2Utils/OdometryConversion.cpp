@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include "OdometryConversion.h"
+#include "Ros2Utils.h"
+
+#include <cmath>
+
+namespace {
+constexpr double RAD2DEG = 180.0 / M_PI;
+} // namespace
+
+OdometrySample odometrySampleFromRos2(const nav_msgs::msg::Odometry& msg)
+{
+    const auto& q = msg.pose.pose.orientation;
+    const double yaw = std::atan2(2.0 * (q.w * q.z + q.x * q.y), 1.0 - 2.0 * (q.y * q.y + q.z * q.z));
+    const double cosYaw = std::cos(yaw);
+    const double sinYaw = std::sin(yaw);
+
+    OdometrySample sample;
+    sample.timestamp = yarpTimeFromRos2(msg.header.stamp);
+    sample.x = msg.pose.pose.position.x;
+    sample.y = msg.pose.pose.position.y;
+    sample.theta = yaw * RAD2DEG;
+    sample.baseVelX = msg.twist.twist.linear.x;
+    sample.baseVelY = msg.twist.twist.linear.y;
+    sample.baseVelTheta = msg.twist.twist.angular.z * RAD2DEG;
+    sample.odomVelX = cosYaw * sample.baseVelX - sinYaw * sample.baseVelY;
+    sample.odomVelY = sinYaw * sample.baseVelX + cosYaw * sample.baseVelY;
+    sample.odomVelTheta = sample.baseVelTheta;
+    return sample;
+}
+
+void toOdometryData(const OdometrySample& sample, yarp::dev::OdometryData& odom)
+{
+    odom.odom_x = sample.x;
+    odom.odom_y = sample.y;
+    odom.odom_theta = sample.theta;
+    odom.base_vel_x = sample.baseVelX;
+    odom.base_vel_y = sample.baseVelY;
+    odom.base_vel_theta = sample.baseVelTheta;
+    odom.odom_vel_x = sample.odomVelX;
+    odom.odom_vel_y = sample.odomVelY;
+    odom.odom_vel_theta = sample.odomVelTheta;
+}
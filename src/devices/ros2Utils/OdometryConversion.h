@@ -0,0 +1,23 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ODOMETRYCONVERSION_H
+#define YARP_ROS2_ODOMETRYCONVERSION_H
+
+#include <yarp/dev/OdometryData.h>
+#include <nav_msgs/msg/odometry.hpp>
+
+#include "OdometryHistory.h"
+
+/**
+ * Converts a nav_msgs/Odometry to the units of yarp::dev::OdometryData: the orientation to the
+ * yaw in degrees, the angular velocity to deg/s and the velocity of the base, which ROS2 gives in
+ * the frame of the base, also to the odometry frame.
+ */
+OdometrySample odometrySampleFromRos2(const nav_msgs::msg::Odometry& msg);
+
+void toOdometryData(const OdometrySample& sample, yarp::dev::OdometryData& odom);
+
+#endif // YARP_ROS2_ODOMETRYCONVERSION_H
@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "OdometryHistory.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// The angle in (-180, 180]
+double wrapDegrees(double angle)
+{
+    angle = std::fmod(angle, 360.0);
+    if (angle > 180.0) {
+        angle -= 360.0;
+    } else if (angle <= -180.0) {
+        angle += 360.0;
+    }
+    return angle;
+}
+
+double lerp(double a, double b, double alpha)
+{
+    return a + alpha * (b - a);
+}
+} // namespace
+
+OdometryHistory::OdometryHistory(double length) :
+        m_length(length)
+{
+}
+
+void OdometryHistory::add(const OdometrySample& sample)
+{
+    if (!m_samples.empty() && sample.timestamp <= m_samples.back().timestamp) {
+        if (sample.timestamp == m_samples.back().timestamp) {
+            m_samples.back() = sample;
+            return;
+        }
+        m_samples.clear();
+    }
+    m_samples.push_back(sample);
+    while (m_samples.front().timestamp < sample.timestamp - m_length) {
+        m_samples.pop_front();
+    }
+}
+
+bool OdometryHistory::get(double time, OdometrySample& sample, std::string& error) const
+{
+    if (m_samples.empty()) {
+        error = "No odometry received yet";
+        return false;
+    }
+    if (time < m_samples.front().timestamp || time > m_samples.back().timestamp) {
+        error = "The time is outside the history, which goes from " + std::to_string(m_samples.front().timestamp) + " to " + std::to_string(m_samples.back().timestamp);
+        return false;
+    }
+
+    auto after = std::lower_bound(m_samples.begin(), m_samples.end(), time, [](const OdometrySample& s, double t) {
+        return s.timestamp < t;
+    });
+    if (after->timestamp == time || after == m_samples.begin()) {
+        sample = *after;
+        return true;
+    }
+    const OdometrySample& a = *(after - 1);
+    const OdometrySample& b = *after;
+    const double alpha = (time - a.timestamp) / (b.timestamp - a.timestamp);
+
+    sample.timestamp = time;
+    sample.x = lerp(a.x, b.x, alpha);
+    sample.y = lerp(a.y, b.y, alpha);
+    sample.theta = wrapDegrees(a.theta + alpha * wrapDegrees(b.theta - a.theta));
+    sample.baseVelX = lerp(a.baseVelX, b.baseVelX, alpha);
+    sample.baseVelY = lerp(a.baseVelY, b.baseVelY, alpha);
+    sample.baseVelTheta = lerp(a.baseVelTheta, b.baseVelTheta, alpha);
+    sample.odomVelX = lerp(a.odomVelX, b.odomVelX, alpha);
+    sample.odomVelY = lerp(a.odomVelY, b.odomVelY, alpha);
+    sample.odomVelTheta = lerp(a.odomVelTheta, b.odomVelTheta, alpha);
+    return true;
+}
@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ODOMETRYHISTORY_H
+#define YARP_ROS2_ODOMETRYHISTORY_H
+
+#include <deque>
+#include <string>
+
+/**
+ * An odometry sample, already in the units of yarp::dev::OdometryData: meters, degrees, m/s and deg/s.
+ */
+struct OdometrySample
+{
+    double timestamp;
+    double x;
+    double y;
+    double theta;
+    double baseVelX;
+    double baseVelY;
+    double baseVelTheta;
+    double odomVelX;
+    double odomVelY;
+    double odomVelTheta;
+};
+
+/**
+ * The odometry samples received in the last `length` seconds, to compute the odometry at a past time,
+ * e.g. the odometry at the time of a pose estimated by a localization.
+ *
+ * The odometry at a time between two samples is interpolated linearly, the orientation along the
+ * shortest arc. A sample older than the newest one means that the time of the publisher went
+ * back, as when a simulation is restarted, so the history is cleared.
+ */
+class OdometryHistory
+{
+public:
+    explicit OdometryHistory(double length);
+
+    void add(const OdometrySample& sample);
+
+    bool get(double time, OdometrySample& sample, std::string& error) const;
+
+private:
+    double m_length;
+    std::deque<OdometrySample> m_samples;
+};
+
+#endif // YARP_ROS2_ODOMETRYHISTORY_H
@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Ros2ClockDriver.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <chrono>
+#include <cmath>
+
+namespace {
+YARP_LOG_COMPONENT(ROS2CLOCKDRIVER, "yarp.ros2.Ros2ClockDriver")
+
+// Cycles run for a single clock message before skipping ahead, e.g. after the simulation was paused
+constexpr size_t max_catch_up = 100;
+}
+
+Ros2ClockDriver::Ros2ClockDriver(rclcpp::Node::SharedPtr node, std::function<void()> step) :
+        m_node(node),
+        m_step(std::move(step))
+{
+}
+
+Ros2ClockDriver::~Ros2ClockDriver()
+{
+    stop();
+}
+
+bool Ros2ClockDriver::configure(yarp::os::Searchable& config)
+{
+    std::string source = config.check("clock_source") ? config.find("clock_source").asString() : "system";
+    if (source == "ros") {
+        m_enabled = true;
+    } else if (source == "system") {
+        m_enabled = false;
+    } else {
+        yCError(ROS2CLOCKDRIVER) << "Invalid clock_source" << source << "(valid values are system and ros)";
+        return false;
+    }
+    if (config.check("clock_topic")) {
+        m_topic = config.find("clock_topic").asString();
+    }
+    return true;
+}
+
+bool Ros2ClockDriver::setPeriod(double period)
+{
+    if (period <= 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_period = period;
+    return true;
+}
+
+bool Ros2ClockDriver::start()
+{
+    if (m_running) {
+        return true;
+    }
+    m_node->set_parameter(rclcpp::Parameter("use_sim_time", true));
+
+    m_callbackGroup = m_node->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+    rclcpp::SubscriptionOptions options;
+    options.callback_group = m_callbackGroup;
+    m_subscription = m_node->create_subscription<rosgraph_msgs::msg::Clock>(m_topic,
+                                                                            rclcpp::ClockQoS(),
+                                                                            std::bind(&Ros2ClockDriver::clockCallback, this, std::placeholders::_1),
+                                                                            options);
+    m_executor.add_callback_group(m_callbackGroup, m_node->get_node_base_interface());
+
+    m_first = true;
+    m_running = true;
+    m_thread = std::thread([this]() {
+        while (m_running && rclcpp::ok()) {
+            m_executor.spin_once(std::chrono::milliseconds(100));
+        }
+    });
+    yCInfo(ROS2CLOCKDRIVER) << "Running on the clock published on" << m_topic;
+    return true;
+}
+
+void Ros2ClockDriver::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    m_executor.cancel();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_executor.remove_callback_group(m_callbackGroup);
+    m_subscription.reset();
+    m_callbackGroup.reset();
+}
+
+void Ros2ClockDriver::clockCallback(const rosgraph_msgs::msg::Clock::SharedPtr msg)
+{
+    int64_t now = static_cast<int64_t>(msg->clock.sec) * 1000000000LL + msg->clock.nanosec;
+    int64_t period;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        period = std::llround(m_period * 1e9);
+    }
+
+    // First message, or the simulation went back in time
+    if (m_first || now < m_next - period) {
+        m_first = false;
+        m_next = now;
+    }
+
+    size_t cycles = 0;
+    while (now >= m_next && m_running) {
+        if (cycles == max_catch_up) {
+            yCWarning(ROS2CLOCKDRIVER) << "The clock jumped forward, skipping" << (now - m_next) / period << "cycles";
+            m_next = now + period;
+            break;
+        }
+        m_step();
+        m_steps++;
+        m_next += period;
+        cycles++;
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ROS2CLOCKDRIVER_H
+#define YARP_ROS2_ROS2CLOCKDRIVER_H
+
+#include <rclcpp/rclcpp.hpp>
+#include <rosgraph_msgs/msg/clock.hpp>
+#include <yarp/os/Searchable.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Runs the cycle of a periodic device on the simulated time instead of the wall clock.
+ *
+ * The periodic nws read the parameters
+ * | Parameter name | Type   | Default | Description |
+ * |:--------------:|:------:|:-------:|:------------|
+ * | clock_source   | string | system  | `system`: the device runs on its own thread, on the YARP clock (the network clock if `YARP_CLOCK` is set). `ros`: the device runs one cycle for every period of the time published on clock_topic |
+ * | clock_topic    | string | /clock  | The rosgraph_msgs/Clock topic used when clock_source is `ros` |
+ *
+ * With the `ros` clock source the cycles are run on a thread spinning only the
+ * clock subscription: when the simulation runs faster or slower than real
+ * time the device still processes exactly one cycle per simulated period.
+ * The node is also switched to `use_sim_time`, so its stamps follow the
+ * simulation.
+ */
+class Ros2ClockDriver
+{
+public:
+    Ros2ClockDriver(rclcpp::Node::SharedPtr node, std::function<void()> step);
+    Ros2ClockDriver(const Ros2ClockDriver&) = delete;
+    Ros2ClockDriver& operator=(const Ros2ClockDriver&) = delete;
+    ~Ros2ClockDriver();
+
+    /**
+     * Reads clock_source and clock_topic, returns false if they are invalid.
+     */
+    bool configure(yarp::os::Searchable& config);
+
+    /**
+     * True if the device must be stepped by this object instead of its own thread.
+     */
+    bool enabled() const
+    {
+        return m_enabled;
+    }
+
+    bool setPeriod(double period);
+    bool start();
+    void stop();
+
+    bool isRunning() const
+    {
+        return m_running;
+    }
+
+    uint64_t steps() const
+    {
+        return m_steps;
+    }
+
+private:
+    void clockCallback(const rosgraph_msgs::msg::Clock::SharedPtr msg);
+
+    rclcpp::Node::SharedPtr m_node;
+    std::function<void()> m_step;
+    bool m_enabled{false};
+    std::string m_topic{"/clock"};
+
+    std::mutex m_mutex;
+    double m_period{0.01};
+    int64_t m_next{0};
+    bool m_first{true};
+    std::atomic<uint64_t> m_steps{0};
+    std::atomic<bool> m_running{false};
+
+    rclcpp::CallbackGroup::SharedPtr m_callbackGroup;
+    rclcpp::Subscription<rosgraph_msgs::msg::Clock>::SharedPtr m_subscription;
+    rclcpp::executors::SingleThreadedExecutor m_executor;
+    std::thread m_thread;
+};
+
+#endif // YARP_ROS2_ROS2CLOCKDRIVER_H
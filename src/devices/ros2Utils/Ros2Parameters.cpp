@@ -0,0 +1,140 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Ros2Parameters.h"
+
+#include <yarp/os/Log.h>
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+namespace {
+YARP_LOG_COMPONENT(ROS2PARAMETERS, "yarp.ros2.Ros2Parameters")
+
+// Declares the parameter, or takes the value it already has if it was declared from the overrides
+template <typename T>
+T declareOrGet(const rclcpp::Node::SharedPtr& node, const std::string& name, const T& value)
+{
+    if (node->has_parameter(name)) {
+        return node->get_parameter(name).get_value<T>();
+    }
+    return node->declare_parameter<T>(name, value);
+}
+} // namespace
+
+Ros2Parameters::Ros2Parameters(rclcpp::Node::SharedPtr node) :
+        m_node(node)
+{
+}
+
+Ros2Parameters::~Ros2Parameters()
+{
+    stop();
+}
+
+bool Ros2Parameters::addDouble(const std::string& name, double value, std::function<bool(double)> setter)
+{
+    double current = value;
+    try {
+        current = declareOrGet<double>(m_node, name, value);
+    } catch (const std::exception& e) {
+        yCError(ROS2PARAMETERS) << "Unable to declare parameter" << name << ":" << e.what();
+        return false;
+    }
+    if (current != value && !setter(current)) {
+        yCError(ROS2PARAMETERS) << "Invalid value" << current << "for parameter" << name;
+        return false;
+    }
+    m_setters[name] = [setter](const rclcpp::Parameter& p) { return setter(p.as_double()); };
+    return true;
+}
+
+bool Ros2Parameters::addInt(const std::string& name, int64_t value, std::function<bool(int64_t)> setter)
+{
+    int64_t current = value;
+    try {
+        current = declareOrGet<int64_t>(m_node, name, value);
+    } catch (const std::exception& e) {
+        yCError(ROS2PARAMETERS) << "Unable to declare parameter" << name << ":" << e.what();
+        return false;
+    }
+    if (current != value && !setter(current)) {
+        yCError(ROS2PARAMETERS) << "Invalid value" << current << "for parameter" << name;
+        return false;
+    }
+    m_setters[name] = [setter](const rclcpp::Parameter& p) { return setter(p.as_int()); };
+    return true;
+}
+
+bool Ros2Parameters::addBool(const std::string& name, bool value, std::function<bool(bool)> setter)
+{
+    bool current = value;
+    try {
+        current = declareOrGet<bool>(m_node, name, value);
+    } catch (const std::exception& e) {
+        yCError(ROS2PARAMETERS) << "Unable to declare parameter" << name << ":" << e.what();
+        return false;
+    }
+    if (current != value && !setter(current)) {
+        yCError(ROS2PARAMETERS) << "Invalid value" << current << "for parameter" << name;
+        return false;
+    }
+    m_setters[name] = [setter](const rclcpp::Parameter& p) { return setter(p.as_bool()); };
+    return true;
+}
+
+bool Ros2Parameters::start(bool spin)
+{
+    m_callbackHandle = m_node->add_on_set_parameters_callback(std::bind(&Ros2Parameters::onSetParameters, this, std::placeholders::_1));
+
+    if (spin && !m_spinner) {
+        m_spinner = std::make_unique<Ros2Spinner>(m_node);
+        if (!m_spinner->start()) {
+            yCError(ROS2PARAMETERS) << "Unable to start the spinner of node" << m_node->get_name();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Ros2Parameters::stop()
+{
+    if (m_spinner && m_spinner->isRunning()) {
+        m_spinner->stop();
+    }
+    m_spinner.reset();
+    if (m_callbackHandle) {
+        m_node->remove_on_set_parameters_callback(m_callbackHandle.get());
+        m_callbackHandle.reset();
+    }
+}
+
+rcl_interfaces::msg::SetParametersResult Ros2Parameters::onSetParameters(const std::vector<rclcpp::Parameter>& parameters)
+{
+    rcl_interfaces::msg::SetParametersResult result;
+    result.successful = true;
+
+    for (const auto& parameter : parameters) {
+        auto it = m_setters.find(parameter.get_name());
+        if (it == m_setters.end()) {
+            // Not handled here, e.g. use_sim_time
+            continue;
+        }
+        try {
+            if (!it->second(parameter)) {
+                result.successful = false;
+                result.reason = "invalid value for " + parameter.get_name();
+                break;
+            }
+        } catch (const rclcpp::ParameterTypeException& e) {
+            result.successful = false;
+            result.reason = e.what();
+            break;
+        }
+        yCInfo(ROS2PARAMETERS) << "Parameter" << parameter.get_name() << "set to" << parameter.value_to_string();
+    }
+
+    return result;
+}
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ROS2PARAMETERS_H
+#define YARP_ROS2_ROS2PARAMETERS_H
+
+#include <rclcpp/rclcpp.hpp>
+#include <rcl_interfaces/msg/set_parameters_result.hpp>
+
+#include <Ros2Spinner.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Exposes some settings of a device as ROS 2 parameters of its node.
+ *
+ * Each parameter is declared with the value read from the device configuration
+ * (or, if the node already declared it from its overrides, with that value) and
+ * a setter. The setter is called every time the parameter is set, e.g. with
+ * `ros2 param set`, and can refuse the new value by returning false.
+ *
+ * Parameters must be added before calling start(), which also spins the
+ * default callback group of the node on its own thread, so that the parameter
+ * services are served even by devices that never spin their node.
+ */
+class Ros2Parameters
+{
+public:
+    explicit Ros2Parameters(rclcpp::Node::SharedPtr node);
+    Ros2Parameters(const Ros2Parameters&) = delete;
+    Ros2Parameters& operator=(const Ros2Parameters&) = delete;
+    ~Ros2Parameters();
+
+    bool addDouble(const std::string& name, double value, std::function<bool(double)> setter);
+    bool addInt(const std::string& name, int64_t value, std::function<bool(int64_t)> setter);
+    bool addBool(const std::string& name, bool value, std::function<bool(bool)> setter);
+
+    bool start(bool spin = true);
+    void stop();
+
+private:
+    rcl_interfaces::msg::SetParametersResult onSetParameters(const std::vector<rclcpp::Parameter>& parameters);
+
+    rclcpp::Node::SharedPtr m_node;
+    std::map<std::string, std::function<bool(const rclcpp::Parameter&)>> m_setters;
+    rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr m_callbackHandle;
+    std::unique_ptr<Ros2Spinner> m_spinner;
+};
+
+#endif // YARP_ROS2_ROS2PARAMETERS_H
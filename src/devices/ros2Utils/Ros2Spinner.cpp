@@ -17,20 +17,42 @@ Ros2Spinner::Ros2Spinner(std::shared_ptr<rclcpp::Node> input_node) :
 m_node(input_node)
 {}
 
+Ros2Spinner::Ros2Spinner(std::shared_ptr<rclcpp::Node> input_node, rclcpp::CallbackGroup::SharedPtr callback_group) :
+m_node(input_node),
+m_callbackGroup(callback_group)
+{}
+
 void Ros2Spinner::run()
 {
-    if(!m_spun)
+    if(!m_added)
+    {
+        m_added = true;
+        if(m_callbackGroup)
+        {
+            m_executor.add_callback_group(m_callbackGroup, m_node->get_node_base_interface());
+        }
+        else
+        {
+            m_executor.add_node(m_node);
+        }
+    }
+    // A single spin() would miss a cancel() issued before it starts, and then never return
+    while(!isStopping())
     {
-        m_spun = true;
-        rclcpp::spin(m_node);
+        m_executor.spin_once(m_spinTimeout);
     }
 }
 
+void Ros2Spinner::onStop()
+{
+    // Wakes up the executor waiting for work
+    m_executor.cancel();
+}
+
 Ros2Spinner::~Ros2Spinner()
 {
-    if(m_spun)
+    if(isRunning())
     {
-        rclcpp::shutdown();
-        m_spun = false;
+        stop();
     }
 }
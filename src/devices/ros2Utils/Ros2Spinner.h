@@ -3,19 +3,39 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#ifndef YARP_ROS2_ROS2SPINNER_H
+#define YARP_ROS2_ROS2SPINNER_H
+
 #include <rclcpp/rclcpp.hpp>
+#include <chrono>
 #include <yarp/os/Thread.h>
 #include <yarp/os/LogStream.h>
 #include <yarp/os/LogComponent.h>
 
+/**
+ * Spins a node, or a single callback group of a node, on its own executor.
+ * Callback groups spun this way must be created with
+ * `automatically_add_to_executor_with_node` set to false.
+ *
+ * The spinner can be stopped and started again, the executor keeps the node or the group.
+ * Deleting the spinner stops it, the ROS2 context and the other nodes of the process keep running.
+ */
 class Ros2Spinner : public yarp::os::Thread
 {
 private:
-    bool m_spun{false};
+    // How long an iteration waits for work, a stop is noticed at most after this time
+    static constexpr std::chrono::milliseconds m_spinTimeout{100};
+    bool m_added{false};
     std::shared_ptr<rclcpp::Node> m_node;
+    rclcpp::CallbackGroup::SharedPtr m_callbackGroup;
+    rclcpp::executors::SingleThreadedExecutor m_executor;
 public:
     Ros2Spinner(std::shared_ptr<rclcpp::Node> input_node);
+    Ros2Spinner(std::shared_ptr<rclcpp::Node> input_node, rclcpp::CallbackGroup::SharedPtr callback_group);
     ~Ros2Spinner();
 
     void run() override;
+    void onStop() override;
 };
+
+#endif // YARP_ROS2_ROS2SPINNER_H
@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Ros2Tracer.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Os.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+YARP_LOG_COMPONENT(ROS2TRACER, "yarp.ros2.Ros2Tracer")
+
+constexpr size_t default_capacity = 65536;
+
+const char* stageName(uint8_t stage)
+{
+    static const char* names[] = {"capture", "nws_read", "nws_publish", "rmw_sent", "nwc_receive", "nwc_converted", "consumer_read"};
+    return (stage < sizeof(names) / sizeof(names[0])) ? names[stage] : "unknown";
+}
+
+// The fields are relaxed atomics, as the words of a SeqLock, so that flush() may read a record
+// while it is overwritten
+struct Record
+{
+    // Index of the record + 1, 0 while it is being written
+    std::atomic<uint64_t> seq{0};
+    std::atomic<int64_t> key{0};
+    std::atomic<int64_t> time{0};
+    std::atomic<uint32_t> channel{0};
+    std::atomic<uint8_t> stage{0};
+};
+
+class TraceBuffer
+{
+public:
+    TraceBuffer()
+    {
+        const char* capacity = std::getenv("YARP_ROS2_TRACE_CAPACITY");
+        m_capacity = (capacity && std::atoll(capacity) > 0) ? static_cast<size_t>(std::atoll(capacity)) : default_capacity;
+        m_records.reset(new Record[m_capacity]);
+    }
+
+    ~TraceBuffer()
+    {
+        flush();
+    }
+
+    uint32_t channel(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(m_channelsMutex);
+        for (size_t i = 0; i < m_channels.size(); i++) {
+            if (m_channels[i] == name) {
+                return static_cast<uint32_t>(i);
+            }
+        }
+        m_channels.push_back(name);
+        return static_cast<uint32_t>(m_channels.size() - 1);
+    }
+
+    void record(uint32_t channel, uint8_t stage, int64_t key, int64_t time)
+    {
+        uint64_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+        Record& r = m_records[index % m_capacity];
+        r.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        r.key.store(key, std::memory_order_relaxed);
+        r.time.store(time, std::memory_order_relaxed);
+        r.channel.store(channel, std::memory_order_relaxed);
+        r.stage.store(stage, std::memory_order_relaxed);
+        r.seq.store(index + 1, std::memory_order_release);
+    }
+
+    void flush()
+    {
+        const char* prefix = std::getenv("YARP_ROS2_TRACE");
+        if (!prefix) {
+            return;
+        }
+
+        // Every plugin linking Ros2Utils may have its own buffer, the address keeps their files apart
+        std::ostringstream path;
+        path << prefix << "." << yarp::os::getpid() << "." << std::hex << reinterpret_cast<uintptr_t>(this) << ".csv";
+
+        std::vector<std::string> channels;
+        {
+            std::lock_guard<std::mutex> lock(m_channelsMutex);
+            channels = m_channels;
+        }
+
+        std::ofstream file(path.str());
+        if (!file.is_open()) {
+            yCError(ROS2TRACER) << "Unable to write the trace" << path.str();
+            return;
+        }
+        file << "time_ns,stage,channel,key_ns\n";
+
+        uint64_t end = m_next.load(std::memory_order_acquire);
+        uint64_t begin = (end > m_capacity) ? end - m_capacity : 0;
+        size_t written = 0;
+        for (uint64_t index = begin; index < end; index++) {
+            const Record& r = m_records[index % m_capacity];
+            if (r.seq.load(std::memory_order_acquire) != index + 1) {
+                // Overwritten or still being written
+                continue;
+            }
+            const int64_t key = r.key.load(std::memory_order_relaxed);
+            const int64_t time = r.time.load(std::memory_order_relaxed);
+            const uint32_t channel = r.channel.load(std::memory_order_relaxed);
+            const uint8_t stage = r.stage.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (r.seq.load(std::memory_order_relaxed) != index + 1) {
+                // Overwritten while it was copied
+                continue;
+            }
+            if (channel >= channels.size()) {
+                continue;
+            }
+            file << time << "," << stageName(stage) << "," << channels[channel] << "," << key << "\n";
+            written++;
+        }
+        yCInfo(ROS2TRACER) << "Written" << written << "trace records to" << path.str();
+    }
+
+private:
+    size_t m_capacity{default_capacity};
+    std::unique_ptr<Record[]> m_records;
+    std::atomic<uint64_t> m_next{0};
+    std::mutex m_channelsMutex;
+    std::vector<std::string> m_channels;
+};
+
+TraceBuffer& buffer()
+{
+    static TraceBuffer instance;
+    return instance;
+}
+} // namespace
+
+const bool Ros2Tracer::s_enabled = (std::getenv("YARP_ROS2_TRACE") != nullptr);
+
+uint32_t Ros2Tracer::channel(const std::string& name)
+{
+    if (!s_enabled) {
+        return 0;
+    }
+    return buffer().channel(name);
+}
+
+void Ros2Tracer::flush()
+{
+    if (s_enabled) {
+        buffer().flush();
+    }
+}
+
+int64_t Ros2Tracer::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void Ros2Tracer::record(uint32_t channel, Stage stage, int64_t key, int64_t time)
+{
+    buffer().record(channel, stage, key, time);
+}
@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ROS2TRACER_H
+#define YARP_ROS2_ROS2TRACER_H
+
+#include <builtin_interfaces/msg/time.hpp>
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Trace points to follow a frame from its capture to the consumer reading it.
+ *
+ * Tracing is enabled by setting the environment variable `YARP_ROS2_TRACE` to a
+ * path prefix before starting the process. Every trace point is then recorded,
+ * with the system time, in an in-memory ring buffer of `YARP_ROS2_TRACE_CAPACITY`
+ * records (65536 by default): when it is full the oldest records are overwritten.
+ * The buffer is written to `<prefix>.<pid>.<address>.csv` by flush() and at exit,
+ * where address is the hexadecimal address of the buffer: every plugin linking
+ * Ros2Utils has its own buffer, so a process may write several files. When
+ * tracing is disabled a trace point costs a single branch.
+ *
+ * A frame is identified across processes by its channel name (usually the topic)
+ * and by the stamp of its header, so all the files written by the nws and nwc
+ * processes (`<prefix>.*.csv`) can be merged by `scripts/ros2_trace_latency.py`
+ * to get the per-frame latency of each stage. Processes on different hosts need
+ * synchronized clocks.
+ */
+class Ros2Tracer
+{
+public:
+    enum Stage : uint8_t
+    {
+        Capture = 0,      ///< stamp given by the driver, the record time is the stamp itself
+        NwsRead = 1,      ///< the nws got the data from the driver
+        NwsPublish = 2,   ///< the nws is about to publish the message
+        RmwSent = 3,      ///< publish() returned, the message was handed to the middleware
+        NwcReceive = 4,   ///< the nwc callback was called
+        NwcConverted = 5, ///< the nwc converted the message to its yarp type
+        ConsumerRead = 6  ///< the data was returned to the user of the nwc
+    };
+
+    static bool enabled()
+    {
+        return s_enabled;
+    }
+
+    /**
+     * Returns the id of a channel, registering it on the first call.
+     */
+    static uint32_t channel(const std::string& name);
+
+    static void trace(uint32_t channel, Stage stage, const builtin_interfaces::msg::Time& key)
+    {
+        if (s_enabled) {
+            record(channel, stage, toNs(key), nowNs());
+        }
+    }
+
+    /**
+     * Records the capture stage, whose time is the capture stamp itself.
+     */
+    static void traceCapture(uint32_t channel, const builtin_interfaces::msg::Time& stamp)
+    {
+        if (s_enabled) {
+            record(channel, Capture, toNs(stamp), toNs(stamp));
+        }
+    }
+
+    static void flush();
+
+private:
+    static int64_t nowNs();
+    static int64_t toNs(const builtin_interfaces::msg::Time& time)
+    {
+        return static_cast<int64_t>(time.sec) * 1000000000LL + time.nanosec;
+    }
+    static void record(uint32_t channel, Stage stage, int64_t key, int64_t time);
+
+    static const bool s_enabled;
+};
+
+#endif // YARP_ROS2_ROS2TRACER_H
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Ros2WorkerPool.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+namespace {
+YARP_LOG_COMPONENT(ROS2WORKERPOOL, "yarp.ros2.Ros2WorkerPool")
+}
+
+Ros2WorkerPool::Ros2WorkerPool(size_t workers)
+{
+    if (workers == 0) {
+        workers = 1;
+    }
+    m_threads.reserve(workers);
+    for (size_t i = 0; i < workers; i++) {
+        m_threads.emplace_back(&Ros2WorkerPool::work, this);
+    }
+}
+
+Ros2WorkerPool::~Ros2WorkerPool()
+{
+    stop();
+}
+
+bool Ros2WorkerPool::post(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return false;
+        }
+        m_jobs.push_back(std::move(job));
+    }
+    m_cv.notify_one();
+    return true;
+}
+
+void Ros2WorkerPool::stop()
+{
+    size_t discarded = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return;
+        }
+        m_stopping = true;
+        discarded = m_jobs.size();
+        m_jobs.clear();
+    }
+    m_cv.notify_all();
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    if (discarded > 0) {
+        yCWarning(ROS2WORKERPOOL) << discarded << "queued jobs were discarded";
+    }
+}
+
+size_t Ros2WorkerPool::pending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_jobs.size();
+}
+
+void Ros2WorkerPool::work()
+{
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
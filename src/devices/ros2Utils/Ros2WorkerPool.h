@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ROS2WORKERPOOL_H
+#define YARP_ROS2_ROS2WORKERPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of threads running the jobs posted by the service callbacks,
+ * so that the executor is never blocked by an expensive request.
+ *
+ * Used together with the deferred response services of rclcpp: the callback
+ * posts a job that computes the response and sends it with `send_response()`.
+ */
+class Ros2WorkerPool
+{
+public:
+    explicit Ros2WorkerPool(size_t workers);
+    Ros2WorkerPool(const Ros2WorkerPool&) = delete;
+    Ros2WorkerPool& operator=(const Ros2WorkerPool&) = delete;
+    ~Ros2WorkerPool();
+
+    /**
+     * Queues a job. Returns false if the pool has been stopped.
+     */
+    bool post(std::function<void()> job);
+
+    /**
+     * Waits for the running jobs and joins the threads, the queued jobs are discarded.
+     */
+    void stop();
+
+    size_t pending() const;
+
+private:
+    void work();
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_jobs;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stopping{false};
+};
+
+#endif // YARP_ROS2_ROS2WORKERPOOL_H
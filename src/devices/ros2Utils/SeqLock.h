@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_SEQLOCK_H
+#define YARP_ROS2_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Holds the latest value written by a single thread, readable by any thread without locks.
+ *
+ * The writer never waits. A reader copies the value and retries only if a write happened
+ * meanwhile, so it never sees a torn value and never blocks the writer. The value is stored in
+ * atomic words, so the concurrent copies are not data races.
+ */
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+    static constexpr size_t words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+    // To be called by one thread only
+    void store(const T& value)
+    {
+        uint64_t buffer[words] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        const uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+        // An odd sequence marks a write in progress
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < words; i++) {
+            m_words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Returns false if no value was stored yet
+    bool load(T& value) const
+    {
+        uint64_t buffer[words];
+        uint64_t before = 0;
+        uint64_t after = 0;
+        do {
+            before = m_sequence.load(std::memory_order_acquire);
+            if (before < 2) {
+                return false;
+            }
+            for (size_t i = 0; i < words; i++) {
+                buffer[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+        std::memcpy(&value, buffer, sizeof(T));
+        return true;
+    }
+
+    bool empty() const
+    {
+        return m_sequence.load(std::memory_order_acquire) < 2;
+    }
+
+private:
+    std::atomic<uint64_t> m_sequence{0};
+    std::atomic<uint64_t> m_words[words]{};
+};
+
+#endif // YARP_ROS2_SEQLOCK_H
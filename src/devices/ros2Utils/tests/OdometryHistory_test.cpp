@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <OdometryHistory.h>
+
+#include <catch2/catch_amalgamated.hpp>
+#include <harness.h>
+
+#include <string>
+
+namespace {
+// A sample whose velocities are (1, 2, 3) times the time
+OdometrySample makeSample(double timestamp, double x, double y, double theta)
+{
+    return OdometrySample{timestamp, x, y, theta,
+                          timestamp, 2 * timestamp, 3 * timestamp,
+                          -timestamp, -2 * timestamp, -3 * timestamp};
+}
+
+OdometrySample check(const OdometryHistory& history, double time)
+{
+    OdometrySample sample{};
+    std::string error;
+    INFO("time " << time);
+    REQUIRE(history.get(time, sample, error));
+    CHECK(sample.timestamp == time);
+    return sample;
+}
+
+bool isOutside(const OdometryHistory& history, double time)
+{
+    OdometrySample sample{};
+    std::string error;
+    const bool ok = history.get(time, sample, error);
+    return !ok && !error.empty();
+}
+} // namespace
+
+TEST_CASE("dev::OdometryHistory_test", "[yarp::dev]")
+{
+    SECTION("Nothing is returned before the first sample")
+    {
+        OdometryHistory history(1.0);
+        CHECK(isOutside(history, 0.0));
+    }
+
+    SECTION("The samples are returned at their time and interpolated in between")
+    {
+        OdometryHistory history(10.0);
+        history.add(makeSample(1.0, 0.0, 0.0, 10.0));
+        history.add(makeSample(2.0, 2.0, -4.0, 30.0));
+
+        OdometrySample sample = check(history, 1.0);
+        CHECK(sample.x == 0.0);
+        CHECK(sample.theta == 10.0);
+
+        sample = check(history, 2.0);
+        CHECK(sample.x == 2.0);
+        CHECK(sample.y == -4.0);
+
+        sample = check(history, 1.25);
+        CHECK(sample.x == Catch::Approx(0.5).epsilon(0).margin(1e-12));
+        CHECK(sample.y == Catch::Approx(-1.0).epsilon(0).margin(1e-12));
+        CHECK(sample.theta == Catch::Approx(15.0).epsilon(0).margin(1e-12));
+        CHECK(sample.baseVelX == Catch::Approx(1.25).epsilon(0).margin(1e-12));
+        CHECK(sample.baseVelY == Catch::Approx(2.5).epsilon(0).margin(1e-12));
+        CHECK(sample.baseVelTheta == Catch::Approx(3.75).epsilon(0).margin(1e-12));
+        CHECK(sample.odomVelX == Catch::Approx(-1.25).epsilon(0).margin(1e-12));
+        CHECK(sample.odomVelY == Catch::Approx(-2.5).epsilon(0).margin(1e-12));
+        CHECK(sample.odomVelTheta == Catch::Approx(-3.75).epsilon(0).margin(1e-12));
+
+        // Out of the history
+        CHECK(isOutside(history, 0.9));
+        CHECK(isOutside(history, 2.1));
+    }
+
+    SECTION("The yaw is interpolated along the shortest arc across 180 degrees")
+    {
+        OdometryHistory history(10.0);
+        history.add(makeSample(1.0, 0.0, 0.0, 170.0));
+        history.add(makeSample(2.0, 0.0, 0.0, -170.0));
+        CHECK(check(history, 1.25).theta == Catch::Approx(175.0).epsilon(0).margin(1e-9));
+        CHECK(check(history, 1.5).theta == Catch::Approx(180.0).epsilon(0).margin(1e-9));
+        CHECK(check(history, 1.75).theta == Catch::Approx(-175.0).epsilon(0).margin(1e-9));
+
+        // And the other way around, the result is always in (-180, 180]
+        history.add(makeSample(3.0, 0.0, 0.0, 170.0));
+        CHECK(check(history, 2.25).theta == Catch::Approx(-175.0).epsilon(0).margin(1e-9));
+        CHECK(check(history, 2.5).theta == Catch::Approx(180.0).epsilon(0).margin(1e-9));
+        CHECK(check(history, 2.75).theta == Catch::Approx(175.0).epsilon(0).margin(1e-9));
+
+        // Near 0 nothing wraps
+        history.add(makeSample(4.0, 0.0, 0.0, -10.0));
+        history.add(makeSample(5.0, 0.0, 0.0, 10.0));
+        CHECK(check(history, 4.5).theta == Catch::Approx(0.0).epsilon(0).margin(1e-9));
+        CHECK(check(history, 4.75).theta == Catch::Approx(5.0).epsilon(0).margin(1e-9));
+    }
+
+    SECTION("The samples older than the length of the history are removed")
+    {
+        OdometryHistory history(1.0);
+        for (double t : {0.0, 0.5, 1.0, 1.5}) {
+            history.add(makeSample(t, t, 0.0, 0.0));
+        }
+        CHECK(isOutside(history, 0.25));
+        CHECK(check(history, 0.5).x == 0.5);
+        CHECK(check(history, 1.25).x == Catch::Approx(1.25).epsilon(0).margin(1e-12));
+    }
+
+    SECTION("A sample with the same time replaces the newest one")
+    {
+        OdometryHistory history(10.0);
+        history.add(makeSample(1.0, 0.0, 0.0, 0.0));
+        history.add(makeSample(2.0, 1.0, 0.0, 0.0));
+        history.add(makeSample(2.0, 3.0, 0.0, 0.0));
+        CHECK(check(history, 2.0).x == 3.0);
+        CHECK(check(history, 1.5).x == Catch::Approx(1.5).epsilon(0).margin(1e-12));
+    }
+
+    SECTION("The history is cleared when the time goes back")
+    {
+        OdometryHistory history(10.0);
+        history.add(makeSample(5.0, 5.0, 0.0, 0.0));
+        history.add(makeSample(6.0, 6.0, 0.0, 0.0));
+        history.add(makeSample(1.0, 1.0, 0.0, 0.0));
+        CHECK(isOutside(history, 5.0));
+        CHECK(check(history, 1.0).x == 1.0);
+    }
+}
@@ -13,10 +13,21 @@
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/LogStream.h>
 
+#include <Ros2Utils.h>
+
 using namespace std::chrono_literals;
 
 YARP_LOG_COMPONENT(ROS2TEST, "yarp.ros2.ros2test", yarp::os::Log::TraceType);
 
+namespace {
+constexpr double default_rate = 30.0;
+constexpr int default_message_size = 640 * 480 * 3;
+constexpr double default_report_period = 5.0;
+constexpr int default_qos_depth = 10;
+// Time given to the echoes of the last messages to come back before the final report
+constexpr double drain_time = 0.5;
+} // namespace
+
 
 Ros2Init::Ros2Init()
 {
@@ -42,22 +53,150 @@ bool Ros2Test::open(yarp::os::Searchable& config)
     m_topic = config.check("topic", yarp::os::Value("ros2test_topic"), "Name of the ROS topic").asString();
     yCInfo(ROS2TEST, "Ros2Test::open - %s", m_topic.c_str());
 
-    m_publisher = Ros2Init::get().node->create_publisher<std_msgs::msg::String>(m_topic, 10);
+    std::string mode = config.check("mode", yarp::os::Value("hello")).asString();
+    if (mode == "hello") {
+        m_mode = Mode::Hello;
+    } else if (mode == "generator") {
+        m_mode = Mode::Generator;
+    } else if (mode == "echo") {
+        m_mode = Mode::Echo;
+    } else {
+        yCError(ROS2TEST) << "Invalid mode" << mode << ", must be one of hello, generator, echo";
+        return false;
+    }
+
+    if (m_mode == Mode::Hello) {
+        m_publisher = Ros2Init::get().node->create_publisher<std_msgs::msg::String>(m_topic, 10);
+        start();
+        return true;
+    }
+
+    std::string messageType = config.check("message_type", yarp::os::Value("image")).asString();
+    if (messageType != "image" && messageType != "pointcloud2" && messageType != "joint_state") {
+        yCError(ROS2TEST) << "Invalid message_type" << messageType << ", must be one of image, pointcloud2, joint_state";
+        return false;
+    }
+
+    int qosDepth = config.check("qos_depth", yarp::os::Value(default_qos_depth)).asInt32();
+    if (qosDepth <= 0) {
+        yCError(ROS2TEST) << "qos_depth must be positive";
+        return false;
+    }
+    rclcpp::QoS qos(static_cast<size_t>(qosDepth));
+    if (config.check("best_effort") && config.find("best_effort").asBool()) {
+        qos.best_effort();
+    } else {
+        qos.reliable();
+    }
+
+    m_echoTopic = config.check("echo_topic", yarp::os::Value("")).asString();
+    m_node = NodeCreator::createNode(config.check("node_name", yarp::os::Value("ros2test_node")).asString());
+
+    if (m_mode == Mode::Echo) {
+        if (m_echoTopic.empty()) {
+            yCError(ROS2TEST) << "echo_topic is required by the echo";
+            return false;
+        }
+        if (messageType == "image") {
+            createEcho<sensor_msgs::msg::Image>(qos);
+        } else if (messageType == "pointcloud2") {
+            createEcho<sensor_msgs::msg::PointCloud2>(qos);
+        } else {
+            createEcho<sensor_msgs::msg::JointState>(qos);
+        }
+        m_spinner = std::make_unique<Ros2Spinner>(m_node);
+        m_spinner->start();
+        yCInfo(ROS2TEST) << "Echoing" << m_topic << "on" << m_echoTopic;
+        return true;
+    }
+
+    double rate = config.check("rate", yarp::os::Value(default_rate)).asFloat64();
+    int threads = config.check("threads", yarp::os::Value(1)).asInt32();
+    int size = config.check("message_size", yarp::os::Value(default_message_size)).asInt32();
+    double reportPeriod = config.check("report_period", yarp::os::Value(default_report_period)).asFloat64();
+    if (rate <= 0 || threads <= 0 || size <= 0 || reportPeriod <= 0) {
+        yCError(ROS2TEST) << "rate, threads, message_size and report_period must be positive";
+        return false;
+    }
+
+    if (messageType == "image") {
+        createGenerator<sensor_msgs::msg::Image>(threads, size, 1.0 / rate, qos);
+    } else if (messageType == "pointcloud2") {
+        createGenerator<sensor_msgs::msg::PointCloud2>(threads, size, 1.0 / rate, qos);
+    } else {
+        createGenerator<sensor_msgs::msg::JointState>(threads, size, 1.0 / rate, qos);
+    }
+
+    if (!m_echoTopic.empty()) {
+        m_spinner = std::make_unique<Ros2Spinner>(m_node);
+        m_spinner->start();
+        setPeriod(reportPeriod);
+        start();
+    }
 
-    start();
+    for (auto& generator : m_generators) {
+        if (!generator->start()) {
+            yCError(ROS2TEST) << "Unable to start a generator thread";
+            return false;
+        }
+    }
+
+    yCInfo(ROS2TEST) << "Generating" << threads << "x" << rate << "Hz of" << messageType << "of" << size << "bytes on" << m_topic;
     return true;
 }
 
+template <class MSG>
+void Ros2Test::createGenerator(size_t threads, size_t size, double period, const rclcpp::QoS& qos)
+{
+    for (size_t i = 0; i < threads; i++) {
+        m_generators.emplace_back(std::make_unique<TrafficPublisher<MSG>>(m_node, m_topic, qos, i, size, period, m_statistics));
+    }
+    if (!m_echoTopic.empty()) {
+        m_subscription = m_node->create_subscription<MSG>(m_echoTopic, qos,
+            [this](const typename MSG::SharedPtr msg) {
+                m_statistics.received(msg->header);
+            });
+    }
+}
+
+template <class MSG>
+void Ros2Test::createEcho(const rclcpp::QoS& qos)
+{
+    auto publisher = m_node->create_publisher<MSG>(m_echoTopic, qos);
+    m_subscription = m_node->create_subscription<MSG>(m_topic, qos,
+        [publisher](std::unique_ptr<MSG> msg) {
+            publisher->publish(std::move(msg));
+        });
+    m_echoPublisher = publisher;
+}
+
 bool Ros2Test::close()
 {
     yCTrace(ROS2TEST);
     yCInfo(ROS2TEST, "Ros2Test::close");
+
+    for (auto& generator : m_generators) {
+        generator->stop();
+    }
+    if (m_mode == Mode::Generator && !m_echoTopic.empty()) {
+        stop();
+        yarp::os::SystemClock::delaySystem(drain_time);
+        m_statistics.report();
+    } else if (m_mode == Mode::Hello) {
+        stop();
+    }
+    m_spinner.reset();
     return true;
 }
 
 void Ros2Test::run()
 {
     yCTrace(ROS2TEST);
+    if (m_mode == Mode::Generator) {
+        m_statistics.report();
+        return;
+    }
+
     auto message = std_msgs::msg::String();
     message.data = "Hello, " + m_topic + "! " + std::to_string(m_count++);
     yCInfo(ROS2TEST, "Publishing: '%s'", message.data.c_str());
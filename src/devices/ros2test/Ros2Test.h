@@ -12,7 +12,12 @@
 #include <rclcpp/rclcpp.hpp>
 #include <std_msgs/msg/string.hpp>
 
+#include <Ros2Spinner.h>
+#include "Ros2TestTraffic.h"
+
+#include <memory>
 #include <mutex>
+#include <vector>
 
 class Ros2Init
 {
@@ -25,14 +30,6 @@ public:
 };
 
 
-/**
- *  @ingroup dev_impl_nws_ros2 dev_impl_fake
- *
- * \brief `ros2test`: A Network publisher test
- *
- *  Documentation to be added
- *
-*/
 class MinimalPublisher
 {
 public:
@@ -40,6 +37,40 @@ public:
 };
 
 
+/**
+ *  @ingroup dev_impl_nws_ros2 dev_impl_fake
+ *
+ * \brief `ros2test`: A Network publisher test
+ *
+ * By default it publishes a "Hello" string on `topic` every 0.5 s.
+ *
+ * With `mode generator` it becomes a load generator to measure the capacity of
+ * a DDS setup: `threads` threads publish messages of type `message_type` and of
+ * about `message_size` bytes on `topic`, each at `rate` Hz.
+ * A second instance opened with `mode echo` on the same topic publishes every
+ * message back on `echo_topic`; when the generator is also given `echo_topic`
+ * it receives them and logs, every `report_period` seconds, the distribution of
+ * the round trip times and the number of lost messages.
+ *
+ * | Parameter name | Type   | Units | Default Value   | Required | Description                                                         |
+ * |:--------------:|:------:|:-----:|:---------------:|:--------:|:-------------------------------------------------------------------:|
+ * | mode           | string | -     | hello           | No       | `hello`, `generator` or `echo`                                      |
+ * | topic          | string | -     | ros2test_topic  | No       | topic of the generated messages                                     |
+ * | node_name      | string | -     | ros2test_node   | No       | node of the generator and of the echo                               |
+ * | message_type   | string | -     | image           | No       | `image`, `pointcloud2` or `joint_state`                             |
+ * | message_size   | int    | bytes | 921600          | No       | payload size, a joint_state has one joint every 24 bytes            |
+ * | rate           | double | Hz    | 30.0            | No       | publishing rate of each thread                                      |
+ * | threads        | int    | -     | 1               | No       | number of publishing threads                                        |
+ * | echo_topic     | string | -     | -               | No       | topic of the echoed messages, required by the echo                  |
+ * | report_period  | double | s     | 5.0             | No       | period of the latency reports of the generator                      |
+ * | qos_depth      | int    | -     | 10              | No       | history depth of publishers and subscriptions                       |
+ * | best_effort    | bool   | -     | false           | No       | use best effort instead of reliable QoS                             |
+ *
+ * \code{.unparsed}
+ * yarpdev --device ros2test --mode echo --topic /load --echo_topic /load_echo --message_type pointcloud2 --node_name load_echo
+ * yarpdev --device ros2test --mode generator --topic /load --echo_topic /load_echo --message_type pointcloud2 --message_size 1000000 --rate 10 --threads 4
+ * \endcode
+ */
 class Ros2Test :
         public yarp::dev::DeviceDriver,
         public yarp::os::PeriodicThread
@@ -60,9 +91,30 @@ public:
     void run() override;
 
 private:
+    enum class Mode
+    {
+        Hello,
+        Generator,
+        Echo
+    };
+
+    template <class MSG>
+    void createGenerator(size_t threads, size_t size, double period, const rclcpp::QoS& qos);
+    template <class MSG>
+    void createEcho(const rclcpp::QoS& qos);
+
     rclcpp::Publisher<std_msgs::msg::String>::SharedPtr m_publisher;
     std::string m_topic;
     size_t m_count {0};
+
+    Mode m_mode {Mode::Hello};
+    std::string m_echoTopic;
+    rclcpp::Node::SharedPtr m_node;
+    std::unique_ptr<Ros2Spinner> m_spinner;
+    std::vector<std::unique_ptr<yarp::os::PeriodicThread>> m_generators;
+    rclcpp::SubscriptionBase::SharedPtr m_subscription;
+    rclcpp::PublisherBase::SharedPtr m_echoPublisher;
+    TrafficStatistics m_statistics;
 };
 
 #endif // YARP_ROS2_ROS2TEST_H
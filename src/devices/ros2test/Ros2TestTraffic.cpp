@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "Ros2TestTraffic.h"
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/os/LogStream.h>
+
+#include <sensor_msgs/image_encodings.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace {
+YARP_LOG_COMPONENT(ROS2TESTTRAFFIC, "yarp.ros2.ros2test.traffic", yarp::os::Log::TraceType);
+
+constexpr size_t image_max_width = 640;
+constexpr size_t rgb_pixel_size = 3;
+constexpr size_t joint_size = 3 * sizeof(double);
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+} // namespace
+
+void fillTrafficMessage(sensor_msgs::msg::Image& msg, size_t size)
+{
+    size_t pixels = std::max<size_t>(1, size / rgb_pixel_size);
+    msg.width = static_cast<uint32_t>(std::min(pixels, image_max_width));
+    msg.height = static_cast<uint32_t>(std::max<size_t>(1, pixels / msg.width));
+    msg.encoding = sensor_msgs::image_encodings::RGB8;
+    msg.is_bigendian = false;
+    msg.step = msg.width * rgb_pixel_size;
+    msg.data.assign(static_cast<size_t>(msg.step) * msg.height, 0x7f);
+}
+
+void fillTrafficMessage(sensor_msgs::msg::PointCloud2& msg, size_t size)
+{
+    const char* names[] = {"x", "y", "z", "intensity"};
+    msg.fields.resize(4);
+    for (uint32_t i = 0; i < 4; i++) {
+        msg.fields[i].name = names[i];
+        msg.fields[i].offset = i * sizeof(float);
+        msg.fields[i].datatype = sensor_msgs::msg::PointField::FLOAT32;
+        msg.fields[i].count = 1;
+    }
+    msg.point_step = 4 * sizeof(float);
+    msg.height = 1;
+    msg.width = static_cast<uint32_t>(std::max<size_t>(1, size / msg.point_step));
+    msg.row_step = msg.point_step * msg.width;
+    msg.is_bigendian = false;
+    msg.is_dense = true;
+    msg.data.assign(msg.row_step, 0);
+}
+
+void fillTrafficMessage(sensor_msgs::msg::JointState& msg, size_t size)
+{
+    size_t joints = std::max<size_t>(1, size / joint_size);
+    msg.name.resize(joints);
+    for (size_t i = 0; i < joints; i++) {
+        msg.name[i] = "joint_" + std::to_string(i);
+    }
+    msg.position.assign(joints, 0.0);
+    msg.velocity.assign(joints, 0.0);
+    msg.effort.assign(joints, 0.0);
+}
+
+std::string encodeTrafficId(size_t publisherId, uint64_t seq)
+{
+    return "ros2test/" + std::to_string(publisherId) + "/" + std::to_string(seq);
+}
+
+bool decodeTrafficId(const std::string& frameId, size_t& publisherId, uint64_t& seq)
+{
+    unsigned long id = 0;
+    uint64_t s = 0;
+    if (std::sscanf(frameId.c_str(), "ros2test/%lu/%" SCNu64, &id, &s) != 2) {
+        return false;
+    }
+    publisherId = id;
+    seq = s;
+    return true;
+}
+
+void TrafficStatistics::sent()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sent++;
+}
+
+void TrafficStatistics::received(const std_msgs::msg::Header& header)
+{
+    double now = yarp::os::SystemClock::nowSystem();
+
+    size_t publisherId = 0;
+    uint64_t seq = 0;
+    bool valid = decodeTrafficId(header.frame_id, publisherId, seq);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!valid) {
+        m_malformed++;
+        return;
+    }
+    m_received++;
+    m_window.push_back(now - yarpTimeFromRos2(header.stamp));
+
+    auto it = m_lastSeq.find(publisherId);
+    if (it != m_lastSeq.end() && seq <= it->second) {
+        m_outOfOrder++;
+    } else {
+        m_lastSeq[publisherId] = seq;
+    }
+}
+
+void TrafficStatistics::report()
+{
+    std::vector<double> window;
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    uint64_t outOfOrder = 0;
+    uint64_t malformed = 0;
+    double now = yarp::os::SystemClock::nowSystem();
+    double elapsed = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        window.swap(m_window);
+        sent = m_sent;
+        received = m_received;
+        outOfOrder = m_outOfOrder;
+        malformed = m_malformed;
+        elapsed = now - m_windowStart;
+        m_windowStart = now;
+    }
+
+    // Messages still in flight are counted as lost until they arrive
+    uint64_t lost = (sent > received) ? sent - received : 0;
+    double lossPercent = (sent > 0) ? 100.0 * lost / sent : 0.0;
+
+    if (window.empty()) {
+        yCInfo(ROS2TESTTRAFFIC, "no echo received in the last %.1f s; received %" PRIu64 " of %" PRIu64 " sent (%.2f%% lost)",
+               elapsed, received, sent, lossPercent);
+        return;
+    }
+
+    std::sort(window.begin(), window.end());
+    constexpr double s_to_ms = 1000.0;
+    yCInfo(ROS2TESTTRAFFIC, "rtt [ms] min %.3f p50 %.3f p90 %.3f p99 %.3f max %.3f over %zu samples (%.1f Hz)",
+           window.front() * s_to_ms,
+           percentile(window, 0.50) * s_to_ms,
+           percentile(window, 0.90) * s_to_ms,
+           percentile(window, 0.99) * s_to_ms,
+           window.back() * s_to_ms,
+           window.size(),
+           (elapsed > 0) ? window.size() / elapsed : 0.0);
+    yCInfo(ROS2TESTTRAFFIC, "received %" PRIu64 " of %" PRIu64 " sent (%.2f%% lost), %" PRIu64 " out of order, %" PRIu64 " malformed",
+           received, sent, lossPercent, outOfOrder, malformed);
+}
@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_ROS2_ROS2TESTTRAFFIC_H
+#define YARP_ROS2_ROS2TESTTRAFFIC_H
+
+#include <yarp/os/PeriodicThread.h>
+#include <yarp/os/SystemClock.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <sensor_msgs/msg/joint_state.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <std_msgs/msg/header.hpp>
+
+#include <Ros2Utils.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Fills a message of about `size` bytes of payload. Called once per publisher,
+ * the same message is then published at every cycle with a new header.
+ */
+void fillTrafficMessage(sensor_msgs::msg::Image& msg, size_t size);
+void fillTrafficMessage(sensor_msgs::msg::PointCloud2& msg, size_t size);
+void fillTrafficMessage(sensor_msgs::msg::JointState& msg, size_t size);
+
+/**
+ * The header of the generated messages carries the send time in the stamp and
+ * the publisher id and sequence number in the frame id.
+ */
+std::string encodeTrafficId(size_t publisherId, uint64_t seq);
+bool decodeTrafficId(const std::string& frameId, size_t& publisherId, uint64_t& seq);
+
+/**
+ * Round trip times and losses of the messages coming back from an echo.
+ * The send and receive times are taken on the same host, so clocks need not be synchronized.
+ */
+class TrafficStatistics
+{
+public:
+    void sent();
+    void received(const std_msgs::msg::Header& header);
+
+    /**
+     * Logs the round trip time distribution since the previous report, and the total losses.
+     */
+    void report();
+
+private:
+    std::mutex m_mutex;
+    std::vector<double> m_window;
+    std::map<size_t, uint64_t> m_lastSeq;
+    uint64_t m_sent{0};
+    uint64_t m_received{0};
+    uint64_t m_outOfOrder{0};
+    uint64_t m_malformed{0};
+    double m_windowStart{yarp::os::SystemClock::nowSystem()};
+};
+
+/**
+ * Publishes the same preallocated message at a fixed rate, one instance per generator thread.
+ */
+template <class MSG>
+class TrafficPublisher : public yarp::os::PeriodicThread
+{
+public:
+    TrafficPublisher(rclcpp::Node::SharedPtr node,
+                     const std::string& topic,
+                     const rclcpp::QoS& qos,
+                     size_t id,
+                     size_t size,
+                     double period,
+                     TrafficStatistics& statistics) :
+            yarp::os::PeriodicThread(period),
+            m_id(id),
+            m_statistics(statistics)
+    {
+        m_publisher = node->create_publisher<MSG>(topic, qos);
+        fillTrafficMessage(m_msg, size);
+    }
+
+    void run() override
+    {
+        m_msg.header.frame_id = encodeTrafficId(m_id, m_seq++);
+        m_msg.header.stamp = ros2TimeFromYarp(yarp::os::SystemClock::nowSystem());
+        m_publisher->publish(m_msg);
+        m_statistics.sent();
+    }
+
+private:
+    typename rclcpp::Publisher<MSG>::SharedPtr m_publisher;
+    MSG m_msg;
+    size_t m_id;
+    uint64_t m_seq{0};
+    TrafficStatistics& m_statistics;
+};
+
+#endif // YARP_ROS2_ROS2TESTTRAFFIC_H
@@ -7,7 +7,9 @@
 #define YARP_TESTS_HARNESS_H
 
 #if !defined(WITHOUT_NETWORK)
+#  include <yarp/os/Time.h>
 #  include <yarp/os/YarpPluginSelector.h>
+#  include <functional>
 #endif // WITHOUT_NETWORK
 
 #include <iostream>
@@ -29,6 +31,20 @@ void increment_tests_skipped();
         YARP_SKIP_TEST("Required plugin is missing: " << type << " - " << name); \
     } \
 }
+
+// Polls the condition until it holds or the timeout (in seconds) expires, for
+// the data that the devices receive on their own threads
+inline bool waitFor(const std::function<bool()>& condition, double timeout = 5.0)
+{
+    const double end = yarp::os::Time::now() + timeout;
+    while (yarp::os::Time::now() < end) {
+        if (condition()) {
+            return true;
+        }
+        yarp::os::Time::delay(0.001);
+    }
+    return false;
+}
 #endif // WITHOUT_NETWORK
 
 #endif // YARP_TESTS_HARNESS_H
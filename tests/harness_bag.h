@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: 2023 Istituto Italiano di Tecnologia (IIT)
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef YARP_TESTS_HARNESS_BAG_H
+#define YARP_TESTS_HARNESS_BAG_H
+
+#include <Ros2BagRecorder.h>
+
+#include <rclcpp/time.hpp>
+
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// The samples recorded by recordBag() are stamped every s_periodNs from s_firstStampNs
+constexpr int64_t s_firstStampNs = 1000000000000;
+constexpr int64_t s_periodNs = 100000000;
+
+inline int64_t stampNsOf(size_t sample)
+{
+    return s_firstStampNs + static_cast<int64_t>(sample) * s_periodNs;
+}
+
+inline double stampOf(size_t sample)
+{
+    return stampNsOf(sample) * 1e-9;
+}
+
+// The default relative tolerance is too large for absolute stamps
+inline Catch::Approx approxStamp(double stamp)
+{
+    return Catch::Approx(stamp).epsilon(0).margin(1e-6);
+}
+
+// Records a bag named after the test in the temporary directory and returns its uri.
+// writeSample(recorder, i, stamp) writes the messages of the sample i, stamped stampNsOf(i)
+template <typename WriteSample>
+std::string recordBag(const std::string& name, size_t samples, WriteSample writeSample)
+{
+    std::filesystem::path uri = std::filesystem::temp_directory_path() / (name + "_test_bag");
+    std::filesystem::remove_all(uri);
+
+    Ros2BagRecorder recorder;
+    Ros2BagRecorder::Options options;
+    options.uri = uri.string();
+    REQUIRE(recorder.open(options));
+    for (size_t i = 0; i < samples; i++) {
+        writeSample(recorder, i, rclcpp::Time(stampNsOf(i)));
+    }
+    recorder.close();
+    return uri.string();
+}
+
+// Records the message makeMessage(i, stamp) of each sample on the topic, the recording time of
+// each message is its stamp
+template <typename MakeMessage>
+std::string recordBag(const std::string& name, const std::string& topic, size_t samples, MakeMessage makeMessage)
+{
+    return recordBag(name, samples, [&](Ros2BagRecorder& recorder, size_t i, const rclcpp::Time& stamp) {
+        REQUIRE(recorder.write(makeMessage(i, stamp), topic, stamp));
+    });
+}
+
+#endif // YARP_TESTS_HARNESS_BAG_H